@@ -3,17 +3,110 @@
 *@brief provide functions for interfacing with button
 *
 *This header file provide functions for interfacing with button.
+*Button service sample all buttons from a periodic software timer (stm32f407xx_soft_timer module): each port holding buttons is read once per tick,
+*and all buttons of a port are debounced in parallel with a 2 bits vertical counter (one bit plane per counter bit, one lane per pin),
+*so a level must be stable for 4 ticks before it is accepted. Press, release, long-press and auto-repeat events are pushed into a queue
+*which is read by application with button_get_event.
+*
+*@note SWTIM_init is to be called by user application before button_service_init.
 *
 *@author Tran Thanh Nhan
 *@date 16/08/2019
 */
 
+/**
+*@Version 1.1
+*button_read read the port of the given button (was always port A)
+*add debouncing button service with event queue
+*add following functions:
+*button_service_init
+*button_service_stop
+*button_get_event
+*button_is_pressed
+*19/10/2026
+*/
+
 #ifndef BUTTON_H
 #define BUTTON_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "../../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+
+/*
+*@BUTTON_SERVICE
+*Button service configuration
+*/
+#define BUTTON_MAX_NUM 32	/*number of buttons handled by service*/
+#define BUTTON_MAX_PORT 4	/*number of different ports holding buttons*/
+#define BUTTON_TICK_MS 5	/*sampling period, debounce time is 4 ticks*/
+#define BUTTON_EVENT_QUEUE_SIZE 16	/*must be a power of 2*/
+#define BUTTON_LONG_PRESS_MS 1000	/*hold time before long-press event*/
+#define BUTTON_REPEAT_DELAY_MS 500	/*hold time before first repeat event*/
+#define BUTTON_REPEAT_PERIOD_MS 100	/*time between repeat events*/
+
+/*
+*@BUTTON_HOLD
+*Event generated while a button is held
+*/
+#define BUTTON_HOLD_NONE 0
+#define BUTTON_HOLD_LONG_PRESS 1	/*one long-press event after BUTTON_LONG_PRESS_MS*/
+#define BUTTON_HOLD_REPEAT 2	/*repeat events every BUTTON_REPEAT_PERIOD_MS after BUTTON_REPEAT_DELAY_MS*/
+
+/*
+*@BUTTON_EVENT
+*Button events
+*/
+#define BUTTON_EV_PRESS 0
+#define BUTTON_EV_RELEASE 1
+#define BUTTON_EV_LONG_PRESS 2
+#define BUTTON_EV_REPEAT 3
+
+typedef struct{
+	GPIO_TypeDef *GPIOxPtr;
+	uint8_t pinNumber;
+	uint8_t puPdr;	/*possible value from @GPIO_PUPDR_MODE*/
+	uint8_t activeLevel;	/*SET: pressed when pin is high, CLEAR: pressed when pin is low*/
+	uint8_t holdMode;	/*possible value from @BUTTON_HOLD*/
+}Button_Config_t;
+
+typedef struct{
+	uint8_t button;	/*index of button in config array*/
+	uint8_t event;	/*possible value from @BUTTON_EVENT*/
+}Button_Event_t;
 
 void button_init (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t puPdr);	
 uint8_t button_read (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
-#endif
\ No newline at end of file
+
+/**
+*@brief Initialize button pins and start sampling
+*
+*Config array is kept by reference, it must stay valid while service is running. Buttons pressed at start generate no press event.
+*
+*@param Pointer to array of button config
+*@param Number of buttons
+*@return 0 if success, -1 if there are more than BUTTON_MAX_NUM buttons or BUTTON_MAX_PORT ports
+*/
+int8_t button_service_init (const Button_Config_t *buttonsPtr, uint8_t buttonNum);
+
+/**
+*@brief Stop sampling, events in queue are kept
+*@param none
+*@return none
+*/
+void button_service_stop (void);
+
+/**
+*@brief Take oldest event from queue
+*@param Pointer to event struct receiving event
+*@return 1 if an event was taken, 0 if queue is empty
+*/
+uint8_t button_get_event (Button_Event_t *eventPtr);
+
+/**
+*@brief Get debounced state of a button
+*@param Index of button in config array
+*@return 1 if pressed, 0 if released or button index is out of registered buttons
+*/
+uint8_t button_is_pressed (uint8_t button);
+#endif
@@ -4,16 +4,53 @@
 *
 *This header file provide functions for interfacing with buzzer.
 *Buzzer is driven with sinewave signal from DAC output (user can select channel 1 or channel 2).
-*Timer 6 is used to create time step between samples (Reload value of timer 6 is varied to generate signal with different frequencies) 
-*Timer 7 is used to create sound duration (Reload value of timer 7 is varied to generate different sound duaration)
+*Sinewave is generated by a direct digital synthesis (DDS) engine: every voice own a 32-bits phase accumulator which is advanced at fixed sample rate,
+*the phase is used to look up a quarter-wave sine table and all voices are mixed in fixed-point into blocks of samples.
+*Timer 6 trigger DAC conversion at fixed sample rate, DMA1 feed DAC from a double buffer (one half is refilled while the other half is converted).
+*Timer 7 generate 1 milisecond tick which time sound duration and advance the melody sequencer in background.
 *
-*@note Due to the fact that prescaler value of TIM6 and TIM7 is consider fixed (for simplicity), possible range of sound frequency is 24 Hz - 160 Khz,
-*possible range of sound duration is 0.625 milisecond - 40.96 second					
+*@note Frequency resolution is BUZZER_SAMPLE_RATE/2^32 (under 0.01 mHz), possible range of sound frequency is 1 Hz - BUZZER_SAMPLE_RATE/2.
+*Sequencer play notes on voice BUZZER_SEQ_VOICE, do not drive this voice directly while a sequence is playing.
 *
 *@author Tran Thanh Nhan
 *@date 21/08/2019
 */
 
+/**
+*@Version 1.1
+*replace per-frequency timer retuning with DDS engine and multi-voice mixing
+*add following functions:
+*buzzer_voice_set
+*buzzer_voice_sweep
+*buzzer_voice_off
+*buzzer_wait
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*add non-blocking melody sequencer driven by TIM7 tick
+*add following functions:
+*buzzer_sequence_play
+*buzzer_sequence_stop
+*buzzer_sequence_busy
+*buzzer_application_event_callback
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*buzzer_wait (and buzzer_play_sound) sleep between ticks instead of spinning
+*buzzer hold a stop lock (stm32f407xx_pwr) while TIM6 or TIM7 run, until buzzer_stop_sound
+*19/10/2026
+*/
+
+/**
+*@Version 1.4
+*DMA1 stream of selected DAC channel stay reserved for buzzer, interrupt of the other stream (5 or 6) is forwarded to DMA_intrpt_handler
+*19/10/2026
+*/
+
 #ifndef BUZZER_H
 #define BUZZER_H
 
@@ -22,17 +59,81 @@
 #include "../../Peripheral_drivers/inc/stm32f407xx_rcc.h"
 #include "../../Peripheral_drivers/inc/stm32f407xx_dac.h"
 #include "../../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_pwr.h"
+
+/*
+*@BUZZER_DDS
+*DDS engine configuration
+*/
+#define BUZZER_SAMPLE_RATE 32000	/*DAC sample rate (in Hz)*/
+#define BUZZER_VOICE_NUM 4	/*number of voices that can sound at the same time*/
+#define BUZZER_MIX_SHIFT 2	/*log2 of BUZZER_VOICE_NUM, used to scale mix of all voices into DAC range*/
+#define BUZZER_BLOCK_SIZE 64	/*number of samples computed for each half of DMA double buffer*/
+#define BUZZER_VOLUME_MAX 255
+
+/*
+*@BUZZER_SEQUENCER
+*Melody sequencer configuration
+*/
+#define BUZZER_TICK_FREQ 1000	/*TIM7 tick frequency (in Hz), sequencer time unit is 1 milisecond*/
+#define BUZZER_SEQ_VOICE 0	/*voice used by sequencer and buzzer_play_sound*/
+#define BUZZER_SEQ_QUEUE_SIZE 8	/*number of sequences that can wait in queue*/
+#define BUZZER_IRQ_PRIORITY 8	/*DMA and TIM7 interrupts share priority so that they never preempt each other*/
 
-#define SAMPLE_NUM 10
-#define TIM6_PRESCALE_VAL 99
-#define TIM7_PRESCALE_VAL 9999
+/*
+*@BUZZER_SEQ_STATUS
+*Status of request to play a sequence
+*/
+#define BUZZER_SEQ_QUEUED 0
+#define BUZZER_SEQ_QUEUE_FULL 1
+#define BUZZER_SEQ_INVALID 2	/*no note given, sequence is not queued*/
+
+/*
+*@BUZZER_EVENT
+*Event of melody sequencer
+*/
+#define BUZZER_EV_SEQUENCE_CMPLT 0	/*last note of a sequence was played*/
+
+/***********************************************************************
+Buzzer structure definition
+***********************************************************************/
+
+typedef struct{
+	uint32_t phase;	/*phase accumulator, 2^32 is one period of sinewave*/
+	uint32_t phaseInc;	/*phase increment per sample, proportional to frequency*/
+	int32_t phaseIncStep;	/*change of phase increment per sample during frequency sweep*/
+	uint32_t sweepCount;	/*number of samples left in frequency sweep*/
+	uint8_t volume;	/*0 (voice is silent) to BUZZER_VOLUME_MAX*/
+}Buzzer_Voice_t;
+
+typedef struct{
+	uint32_t freq;	/*frequency of note (in Hz), 0 for a rest*/
+	uint16_t duration;	/*note duration (in milisecond)*/
+	uint16_t rest;	/*silence after note (in milisecond)*/
+	uint8_t volume;	/*peak volume (0 to BUZZER_VOLUME_MAX)*/
+	uint8_t attack;	/*time for volume to rise from 0 to peak (in milisecond)*/
+	uint8_t release;	/*time for volume to fall from peak to 0 at the end of note (in milisecond)*/
+}Buzzer_Note_t;
+
+typedef struct{
+	const Buzzer_Note_t *notesPtr;	/*array of notes, must stay valid until sequence is completed*/
+	uint16_t noteCount;
+	uint8_t loop;	/*ENABLE: sequence restart after last note until buzzer_sequence_stop is called*/
+}Buzzer_Sequence_t;
+
+/***********************************************************************
+Buzzer functions prototype
+***********************************************************************/
 
 /**
 *@brief Initialize buzzer (driven by DAC channer 1 or 2)
 *
 *This initilize GPIO PA4 (or PA5) as analog pin,
-*then initialize DAC channel 1 (or channel 2) with 12 bits resolution, right alligned, output buffer enabled.
-*Initilize and enable interrupt for TIM6 and TIM7
+*then initialize DAC channel 1 (or channel 2) with 12 bits resolution, right alligned, output buffer enabled, triggered by TIM6.
+*Initilize TIM6 as sample rate clock, DMA1 stream 5 (or stream 6) as double buffer feeding DAC.
+*Initilize TIM7 as 1 milisecond tick and enable its interrupt
+*DMA1 stream 5 and stream 6 interrupt handlers are defined by buzzer and must not be defined by application:
+*stream not used by buzzer may be allocated by DMA_init, its interrupt is forwarded to DMA_intrpt_handler.
 *
 *@param DAC channel
 *@return none
@@ -42,21 +143,98 @@ void buzzer_init (uint8_t DAC_channel);
 /**
 *@brief Generate sound with given frequency for given duration
 *
-*This calculate and set reload value for TIM6 and TIM7 based on given frequency and duaration,
-*then start TIM6 and TIM7
+*This play given frequency on voice BUZZER_SEQ_VOICE and block until TIM7 tick count given duration.
+*Use buzzer_sequence_play to play sound without blocking.
 *
-*@param Frequency of sound to be genereted (in Hz, possible range is 24 Hz - 160 Khz)
-*@param Sound duration (in milisecond, possible range is 0.625 milisecond - 40.96 second)	
+*@param Frequency of sound to be genereted (in Hz), 0 means rest
+*@param Sound duration (in milisecond)
 *@return none
 */
 void buzzer_play_sound (uint32_t freq, uint32_t duration);
 
+/**
+*@brief Wait for given duration while voices keep sounding
+*@param Duration (in milisecond)
+*@return none
+*/
+void buzzer_wait (uint32_t duration);
+
 /**
 *@brief Stop sound
 *
+*Silence all voices, flush sequencer queue and stop timers
+*
 *@param none
 *@return none
 */
 void buzzer_stop_sound (void);
 
-#endif
\ No newline at end of file
+/**
+*@brief Start playing a voice with given frequency and volume
+*
+*Voice keep sounding until it is changed or turned off, several voices can be set to play a chord.
+*
+*@param Voice number (0 to BUZZER_VOICE_NUM - 1)
+*@param Frequency (in Hz)
+*@param Volume (0 to BUZZER_VOLUME_MAX)
+*@return none
+*/
+void buzzer_voice_set (uint8_t voice, uint32_t freq, uint8_t volume);
+
+/**
+*@brief Sweep frequency of a voice linearly from start frequency to end frequency
+*
+*Voice keep sounding at end frequency once sweep is finished.
+*
+*@param Voice number (0 to BUZZER_VOICE_NUM - 1)
+*@param Start frequency (in Hz)
+*@param End frequency (in Hz)
+*@param Sweep duration (in milisecond)
+*@param Volume (0 to BUZZER_VOLUME_MAX)
+*@return none
+*/
+void buzzer_voice_sweep (uint8_t voice, uint32_t startFreq, uint32_t endFreq, uint32_t duration, uint8_t volume);
+
+/**
+*@brief Turn off a voice
+*@param Voice number (0 to BUZZER_VOICE_NUM - 1)
+*@return none
+*/
+void buzzer_voice_off (uint8_t voice);
+
+/**
+*@brief Queue a sequence of notes to be played in background
+*
+*Notes are advanced by TIM7 tick, function return immediately. 
+*buzzer_application_event_callback is called with BUZZER_EV_SEQUENCE_CMPLT at the end of each sequence (each pass if sequence loop).
+*
+*@param Pointer to array of notes (must stay valid until sequence is completed)
+*@param Number of notes
+*@param ENABLE to repeat sequence until buzzer_sequence_stop is called, DISABLE to play it once
+*@return Refer to @BUZZER_SEQ_STATUS
+*/
+uint8_t buzzer_sequence_play (const Buzzer_Note_t *notesPtr, uint16_t noteCount, uint8_t loop);
+
+/**
+*@brief Stop playing sequence and discard all queued sequences
+*@param none
+*@return none
+*/
+void buzzer_sequence_stop (void);
+
+/**
+*@brief Check whether sequencer is playing
+*@param none
+*@return 1 if a sequence is playing, 0 otherwise
+*/
+uint8_t buzzer_sequence_busy (void);
+
+/**
+*@brief Inform application of sequencer event
+*@param Pointer to notes of sequence which generated the event
+*@param Event macro (refer to @BUZZER_EVENT)
+*@return none
+*/
+void buzzer_application_event_callback (const Buzzer_Note_t *notesPtr, uint8_t event);
+
+#endif
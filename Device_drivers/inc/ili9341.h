@@ -16,6 +16,24 @@
 *03/09/2019
 */
 
+/**
+*@Version 1.1
+*reset and wake up delays are timed by stm32f407xx_time module instead of empty loops
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*CSX and DCX are driven by inline single store GPIO writes
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*ILI9341_init return -1 if SPI pins are claimed by another pins pack
+*19/10/2026
+*/
+
 #ifndef ILI9341_H
 #define ILI9341_H
 
@@ -23,6 +41,7 @@
 #include "../../Peripheral_drivers/inc/stm32f407xx_common_macro.h"
 #include "../../Peripheral_drivers/inc/stm32f407xx_gpio.h"
 #include "../../Peripheral_drivers/inc/stm32f407xx_spi.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_time.h"
 #include "../../Miscellaneous/inc/tm_stm32f4_fonts.h"
 #include <stdint.h>
 #include <stdlib.h>
@@ -59,6 +78,14 @@ ILI9341 macro definition
 #define ILI9341_RST_PORT  GPIOB
 #define ILI9341_RST_PIN	GPIO_PIN_NO_10
 
+/*
+*@ILI9341_DELAY
+*ILI9341 reset and wake up timing (in milisecond), from ILI9341 datasheet
+*/
+#define ILI9341_RST_PULSE_MS 1	/*RST low pulse, at least 10 us*/
+#define ILI9341_RESET_WAIT_MS 5	/*wait after hardware or software reset before next command*/
+#define ILI9341_SLEEP_OUT_WAIT_MS 120	/*wait after SLEEP OUT before display on*/
+
 /*
 *@ILI9341_COMMAND
 *ILI9341 command
@@ -122,10 +149,10 @@ ILI9341 macro definition
 #define ILI9341_HEIGHT		320
 #define ILI9341_PIXEL			76800
 
-#define ILI9341_CSX_SET			GPIO_write_pin(ILI9341_CSX_PORT,ILI9341_CSX_PIN,SET)
-#define ILI9341_CSX_CLEAR 	GPIO_write_pin(ILI9341_CSX_PORT,ILI9341_CSX_PIN,CLEAR)
-#define ILI9341_DCX_SET 			GPIO_write_pin(ILI9341_DCX_PORT,ILI9341_DCX_PIN,SET)
-#define ILI9341_DCX_CLEAR 	GPIO_write_pin(ILI9341_DCX_PORT,ILI9341_DCX_PIN,CLEAR)
+#define ILI9341_CSX_SET			GPIO_fast_set_pin(ILI9341_CSX_PORT,ILI9341_CSX_PIN)
+#define ILI9341_CSX_CLEAR 	GPIO_fast_clear_pin(ILI9341_CSX_PORT,ILI9341_CSX_PIN)
+#define ILI9341_DCX_SET 			GPIO_fast_set_pin(ILI9341_DCX_PORT,ILI9341_DCX_PIN)
+#define ILI9341_DCX_CLEAR 	GPIO_fast_clear_pin(ILI9341_DCX_PORT,ILI9341_DCX_PIN)
 #define ILI9341_RST_SET 			GPIO_write_pin(ILI9341_RST_PORT,ILI9341_RST_PIN,SET)
 #define ILI9341_RST_CLEAR 	GPIO_write_pin(ILI9341_RST_PORT,ILI9341_RST_PIN,CLEAR)
 
@@ -151,9 +178,9 @@ ILII9341 driver function prototype
 /**
 *@brief  		Initilaize related hardware (GPIO pins, SPI peripheral and initilize display with default settings
 *@param 	None
-*@return 	None
+*@return 	0 if success, -1 if SPI pins are claimed by another pins pack
 */
-void ILI9341_init (void);
+int8_t ILI9341_init (void);
 
 /**
 *@brief 		Turn on display
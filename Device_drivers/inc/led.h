@@ -3,16 +3,65 @@
 *@brief provide functions for interfacing with led
 *
 *This header file provide functions for interfacing with led.
+*Dimming engine drive up to 16 leds per port with 8 bits brightness by binary code modulation: a refresh cycle is split into 8 bit planes,
+*plane k last 2^k time units and output bit k of each led brightness. Plane durations are streamed into reload register of TIM8
+*by its update DMA request, and one BSRR word per plane (set bits of leds which are on, reset bits of the others) is streamed into GPIO BSRR
+*by a compare DMA request of the same timer (compare value 0, so request occur at start of each period). Both streams are circular,
+*so no CPU is used per refresh cycle, CPU only rewrite plane words when a brightness change.
+*Each port use one compare channel: ports are served by TIM8 channel 1 - 4 (DMA2 stream 2, 3, 4, 7), reload values by DMA2 stream 1.
+*
+*@note TIM8 and DMA2 stream 1, 2, 3, 4, 7 are reserved by dimming engine. Fading use stm32f407xx_soft_timer service,
+*SWTIM_init is to be called by user application before led_fade.
 *
 *@author Tran Thanh Nhan
 *@date 13/08/2019
 */
 
+/**
+*@Version 1.1
+*led_init configure the given port (was always port D)
+*add BCM dimming engine driven by timer triggered DMA into GPIO BSRR, with fading
+*add following functions:
+*led_dim_init
+*led_dim_stop
+*led_set_brightness
+*led_get_brightness
+*led_fade
+*led_is_fading
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*dimming engine hold a stop lock (stm32f407xx_pwr) while it run
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*DMA streams of dimming engine are reserved in DMA driver (stm32f407xx_dma), led_dim_init return -1 if one is allocated to a DMA handle
+*19/10/2026
+*/
+
 #ifndef LED_H
 #define LED_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "../../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_pwr.h"
+#include "../../Peripheral_drivers/inc/stm32f407xx_dma.h"
+
+/*
+*@LED_DIM
+*Dimming engine configuration
+*/
+#define LED_DIM_MAX_PORT 4	/*one TIM8 compare channel per port*/
+#define LED_DIM_BITS 8	/*brightness resolution, refresh cycle is 2^LED_DIM_BITS - 1 time units*/
+#define LED_DIM_REFRESH_FREQ 200	/*refresh cycles per second*/
+#define LED_FADE_TICK_MS 10	/*brightness of fading leds is updated every tick*/
 
 /**
 *@brief Initilize led 
@@ -45,4 +94,58 @@ void led_off (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
 *@return none
 */
 void led_toggle (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
+
+/**
+*@brief Add leds of a port to dimming engine, then (re)start engine
+*
+*Pins are configured as outputs and start at brightness 0. Calling again for a registered port add pins to it.
+*Engine is restarted so that all streams stay in step, outputs may glitch during one refresh cycle.
+*
+*@param Pointer to base address of GPIO port x registers
+*@param Mask of pins (bit n for pin n)
+*@return 0 if success, -1 if LED_DIM_MAX_PORT ports are already used or a DMA stream of engine is taken by a DMA handle or an other driver
+*/
+int8_t led_dim_init (GPIO_TypeDef *GPIOxPtr, uint16_t pinMask);
+
+/**
+*@brief Stop dimming engine, turn off all dimmed leds and forget registered ports
+*@param none
+*@return none
+*/
+void led_dim_stop (void);
+
+/**
+*@brief Set brightness of a dimmed led, fading in progress on led is cancelled
+*@param Pointer to base address of GPIO port x registers
+*@param Pin number
+*@param Brightness (0: off, 255: fully on)
+*@return none
+*/
+void led_set_brightness (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t brightness);
+
+/**
+*@brief Get current brightness of a dimmed led
+*@param Pointer to base address of GPIO port x registers
+*@param Pin number
+*@return Brightness, 0 if led is not dimmed
+*/
+uint8_t led_get_brightness (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
+
+/**
+*@brief Fade a dimmed led linearly from its current brightness to a target
+*@param Pointer to base address of GPIO port x registers
+*@param Pin number
+*@param Target brightness
+*@param Fade time (in millisecond), rounded down to LED_FADE_TICK_MS
+*@return none
+*/
+void led_fade (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t target, uint32_t durationMs);
+
+/**
+*@brief Check whether a dimmed led is fading
+*@param Pointer to base address of GPIO port x registers
+*@param Pin number
+*@return 1 if fading, 0 otherwise
+*/
+uint8_t led_is_fading (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
 #endif
@@ -10,6 +10,35 @@
 
 #include "../inc/button.h"
 
+#define BUTTON_LONG_PRESS_TICKS (BUTTON_LONG_PRESS_MS/BUTTON_TICK_MS)
+#define BUTTON_REPEAT_DELAY_TICKS (BUTTON_REPEAT_DELAY_MS/BUTTON_TICK_MS)
+#define BUTTON_REPEAT_PERIOD_TICKS (BUTTON_REPEAT_PERIOD_MS/BUTTON_TICK_MS)
+
+typedef struct{
+	GPIO_TypeDef *GPIOxPtr;
+	uint16_t pinMask;	/*pins holding buttons*/
+	uint16_t invertMask;	/*pins of active low buttons*/
+	uint16_t holdMask;	/*pins of buttons generating hold events*/
+	uint16_t state;	/*debounced state, 1 for pressed*/
+	uint16_t count0;	/*vertical counter bit 0 of each lane*/
+	uint16_t count1;	/*vertical counter bit 1 of each lane*/
+	uint8_t buttonIndex[16];	/*button index of each pin*/
+}Button_Port_t;
+
+static void button_tick (void *argPtr);
+static void button_push_event (uint8_t button, uint8_t event);
+
+static const Button_Config_t *buttonConfigPtr = NULL;
+static uint8_t buttonCount = 0;	/*number of buttons given to button_service_init*/
+static Button_Port_t buttonPorts[BUTTON_MAX_PORT];
+static uint8_t buttonPortNum = 0;
+static uint8_t buttonPortIndex[BUTTON_MAX_NUM];
+static uint16_t holdTicks[BUTTON_MAX_NUM];
+static SWTIM_Timer_t buttonTimer;
+static Button_Event_t eventQueue[BUTTON_EVENT_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;	/*written by tick only*/
+static volatile uint8_t queueTail = 0;	/*written by button_get_event only*/
+
 void button_init (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t puPdr)
 {
 	GPIO_Pin_config_t GPIO_button_config = {.pinNumber=pinNumber,.mode=GPIO_MODE_IN,.puPdr=puPdr};
@@ -19,6 +48,158 @@ void button_init (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t puPdr)
 
 uint8_t button_read (GPIO_TypeDef *GPIOxPtr,uint8_t pinNumber)
 {
-	return GPIO_read_pin(GPIOA,pinNumber);
+	return GPIO_read_pin(GPIOxPtr,pinNumber);
+}
+
+int8_t button_service_init (const Button_Config_t *buttonsPtr, uint8_t buttonNum)
+{
+	if(buttonNum > BUTTON_MAX_NUM){
+		return -1;
+	}
+	button_service_stop();
+
+	buttonPortNum = 0;
+	for(uint8_t i = 0; i < buttonNum; i++){
+		const Button_Config_t *configPtr = &buttonsPtr[i];
+		uint8_t portIndex = 0;
+
+		while(portIndex < buttonPortNum && buttonPorts[portIndex].GPIOxPtr != configPtr->GPIOxPtr){
+			portIndex++;
+		}
+		if(portIndex == buttonPortNum){
+			if(buttonPortNum == BUTTON_MAX_PORT){
+				buttonPortNum = 0;
+				return -1;
+			}
+			buttonPorts[portIndex].GPIOxPtr = configPtr->GPIOxPtr;
+			buttonPorts[portIndex].pinMask = 0;
+			buttonPorts[portIndex].invertMask = 0;
+			buttonPorts[portIndex].holdMask = 0;
+			buttonPortNum++;
+		}
+
+		Button_Port_t *portPtr = &buttonPorts[portIndex];
+		uint16_t pinBit = 1<<configPtr->pinNumber;
+		portPtr->pinMask |= pinBit;
+		if(configPtr->activeLevel == CLEAR){
+			portPtr->invertMask |= pinBit;
+		}
+		if(configPtr->holdMode != BUTTON_HOLD_NONE){
+			portPtr->holdMask |= pinBit;
+		}
+		portPtr->buttonIndex[configPtr->pinNumber] = i;
+		buttonPortIndex[i] = portIndex;
+		holdTicks[i] = 0;
+		button_init(configPtr->GPIOxPtr,configPtr->pinNumber,configPtr->puPdr);
+	}
+
+	/*current levels are taken as debounced state, all counters are idle (3)*/
+	for(uint8_t i = 0; i < buttonPortNum; i++){
+		Button_Port_t *portPtr = &buttonPorts[i];
+		portPtr->state = (portPtr->GPIOxPtr->IDR ^ portPtr->invertMask) & portPtr->pinMask;
+		portPtr->count0 = 0xFFFF;
+		portPtr->count1 = 0xFFFF;
+	}
+	buttonConfigPtr = buttonsPtr;
+	buttonCount = buttonNum;
+
+	SWTIM_timer_init(&buttonTimer,button_tick,NULL);
+	SWTIM_start(&buttonTimer,SWTIM_MS_TO_TICKS(BUTTON_TICK_MS),SWTIM_MS_TO_TICKS(BUTTON_TICK_MS));
+	return 0;
+}
+
+void button_service_stop (void)
+{
+	if(buttonConfigPtr != NULL){
+		SWTIM_cancel(&buttonTimer);
+	}
+}
+
+uint8_t button_get_event (Button_Event_t *eventPtr)
+{
+	uint8_t tail = queueTail;
+
+	if(tail == queueHead){
+		return 0;
+	}
+	*eventPtr = eventQueue[tail];
+	queueTail = (tail + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+	return 1;
+}
+
+uint8_t button_is_pressed (uint8_t button)
+{
+	if(buttonConfigPtr == NULL || button >= buttonCount){
+		return 0;
+	}
+	return (buttonPorts[buttonPortIndex[button]].state >> buttonConfigPtr[button].pinNumber) & 0x01;
+}
+
+/***********************************************************************
+Private function: sample and debounce all buttons, generate events
+***********************************************************************/
+static void button_tick (void *argPtr)
+{
+	for(uint8_t i = 0; i < buttonPortNum; i++){
+		Button_Port_t *portPtr = &buttonPorts[i];
+		uint16_t sample = (portPtr->GPIOxPtr->IDR ^ portPtr->invertMask) & portPtr->pinMask;
+		uint16_t changed = sample ^ portPtr->state;
+
+		/*lanes which differ from debounced state count down 3, 2, 1, 0, then state toggle as counter wrap to 3,
+		lanes which agree are reset to 3, so a bounce restart the count*/
+		portPtr->count0 = ~(portPtr->count0 & changed);
+		portPtr->count1 = portPtr->count0 ^ (portPtr->count1 & changed);
+		changed &= portPtr->count0 & portPtr->count1;
+		portPtr->state ^= changed;
+
+		uint32_t pending = changed;
+		while(pending){
+			uint8_t pin = 31 - __CLZ(pending);
+			uint8_t button = portPtr->buttonIndex[pin];
+			pending &= ~(1UL<<pin);
+			holdTicks[button] = 0;
+			button_push_event(button,(portPtr->state & (1<<pin)) ? BUTTON_EV_PRESS : BUTTON_EV_RELEASE);
+		}
+
+		/*only held buttons with hold events are visited*/
+		pending = portPtr->state & portPtr->holdMask & ~changed;
+		while(pending){
+			uint8_t pin = 31 - __CLZ(pending);
+			uint8_t button = portPtr->buttonIndex[pin];
+			pending &= ~(1UL<<pin);
+
+			if(buttonConfigPtr[button].holdMode == BUTTON_HOLD_LONG_PRESS){
+				if(holdTicks[button] < BUTTON_LONG_PRESS_TICKS){
+					holdTicks[button]++;
+					if(holdTicks[button] == BUTTON_LONG_PRESS_TICKS){
+						button_push_event(button,BUTTON_EV_LONG_PRESS);
+					}
+				}
+			}else{
+				holdTicks[button]++;
+				if(holdTicks[button] == BUTTON_REPEAT_DELAY_TICKS + BUTTON_REPEAT_PERIOD_TICKS){
+					holdTicks[button] = BUTTON_REPEAT_DELAY_TICKS;
+				}
+				if(holdTicks[button] == BUTTON_REPEAT_DELAY_TICKS){
+					button_push_event(button,BUTTON_EV_REPEAT);
+				}
+			}
+		}
+	}
 }
 
+/***********************************************************************
+Private function: push event into queue, event is dropped if queue is full
+***********************************************************************/
+static void button_push_event (uint8_t button, uint8_t event)
+{
+	uint8_t head = queueHead;
+	uint8_t next = (head + 1) & (BUTTON_EVENT_QUEUE_SIZE - 1);
+
+	if(next == queueTail){
+		return;
+	}
+	eventQueue[head].button = button;
+	eventQueue[head].event = event;
+	queueHead = next;
+}
@@ -4,8 +4,8 @@
 *
 *This source file provide functions for interfacing with buzzer.
 *Buzzer is driven with sinewave signal output from DAC output (user can select channel 1 or channel 2).
-*Timer 6 is used to create time interval between samples of signal (Timer 6 's time base is changed to create signal with different frequencies) 
-*Timer 7 is used to create duration for playing sound
+*Sinewave samples are synthesized by DDS engine and fed to DAC by DMA at fixed sample rate set by timer 6.
+*Timer 7 generate 1 milisecond tick used to create duration for playing sound and to advance melody sequencer
 *
 *@author Tran Thanh Nhan
 *@date 21/08/2019
@@ -13,103 +13,474 @@
 
 #include "../inc/buzzer.h"
 
-uint16_t sineWaveTable[SAMPLE_NUM] = {2048,3251,3995,3996,3253,2051,847,101,98,839};
-uint8_t count = 0;
-uint8_t TIM7_flag = 0;
+static void buzzer_fill_block (uint16_t *blockPtr);
+static int32_t buzzer_sine (uint32_t phase);
+static uint32_t buzzer_phase_inc_calc (uint32_t freq);
+static void buzzer_sequencer_step (void);
+static void buzzer_sequencer_start_note (void);
+static uint8_t buzzer_envelope_calc (const Buzzer_Note_t *notePtr, uint32_t elapsed);
+static void buzzer_timer_ctr (TIM_TypeDef *TIMxPtr, uint8_t startOrStop);
 
-/*debug purpose*/
-#include "../inc/led.h"
+/*first quarter of sinewave in Q15 format, 64 steps + end point*/
+static const int16_t quarterSineTable[65] = {
+	0,804,1608,2410,3212,4011,4808,5602,
+	6393,7179,7962,8739,9512,10278,11039,11793,
+	12539,13279,14010,14732,15446,16151,16846,17530,
+	18204,18868,19519,20159,20787,21403,22005,22594,
+	23170,23731,24279,24811,25329,25832,26319,26790,
+	27245,27683,28105,28510,28898,29268,29621,29956,
+	30273,30571,30852,31113,31356,31580,31785,31971,
+	32137,32285,32412,32521,32609,32678,32728,32757,
+	32767,
+};
+
+static Buzzer_Voice_t buzzerVoice[BUZZER_VOICE_NUM];
+static uint16_t buzzerDMABuffer[2*BUZZER_BLOCK_SIZE];
+static int32_t buzzerMixBuffer[BUZZER_BLOCK_SIZE];
+static uint32_t buzzerSampleRate = BUZZER_SAMPLE_RATE;
+static uint8_t buzzerDMAIRQnumber = IRQ_DMA1_STREAM5;
+static uint8_t buzzerDMAReady = 0;	/*DMA stream of DAC channel is reserved and running*/
+static volatile uint32_t buzzerWaitCount = 0;
+static uint8_t buzzerTimerRunning = 0;	/*bit 0: TIM6, bit 1: TIM7, stop lock is held while not 0*/
+
+/*sequence queue: filled by application, emptied by TIM7 interrupt*/
+static Buzzer_Sequence_t buzzerSeqQueue[BUZZER_SEQ_QUEUE_SIZE];
+static volatile uint8_t buzzerSeqHead = 0;
+static volatile uint8_t buzzerSeqTail = 0;
+static volatile uint8_t buzzerSeqActive = 0;
+static uint16_t buzzerNoteIndex = 0;
+static uint32_t buzzerNoteElapsed = 0;
 
 DAC_Handle_t DAC_Handle;
 
 void buzzer_init (uint8_t DAC_channel)
 {
-	/*debug purpose*/
-	led_init(GPIOD,GPIO_PIN_NO_14);
-	
 	if (DAC_channel == DAC_CHANNEL_1){
 
 		/*configure GPIO PIN PA4*/
 		GPIO_Pin_config_t GPIO_DAC_CH1_pin_config = {.pinNumber = GPIO_PIN_NO_4,.mode = GPIO_MODE_ANL,};
 		GPIO_Handle_t GPIO_DAC_CH1_Handle = {GPIOA,GPIO_DAC_CH1_pin_config};
 		GPIO_init(&GPIO_DAC_CH1_Handle);
-		
+
 		/*initilize DAC channel 1*/
-		static DAC_Config_t DAC_CH1_config = {.channel = DAC_CHANNEL_1,.resolution = DAC_RES_12_bits,.alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_NO_TRIGGER_EV, .outputBuffer = DAC_OBUFFER_EN};
+		static DAC_Config_t DAC_CH1_config = {.channel = DAC_CHANNEL_1,.resolution = DAC_RES_12_bits,.alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_TRIGGER_EV_TIM6, .outputBuffer = DAC_OBUFFER_EN};
 		DAC_Handle.DACxPtr = DAC1;
 		DAC_Handle.DACxConfigPtr = &DAC_CH1_config;
 		DAC_init(&DAC_Handle);
-		
+		buzzerDMAIRQnumber = IRQ_DMA1_STREAM5;
+
 	}else if(DAC_channel == DAC_CHANNEL_2){
-		
+
 		/*configure GPIO PIN PA5*/
 		GPIO_Pin_config_t GPIO_DAC_CH2_pin_config = {.pinNumber = GPIO_PIN_NO_5,.mode = GPIO_MODE_ANL,};
 		GPIO_Handle_t GPIO_DAC_CH2_Handle = {GPIOA,GPIO_DAC_CH2_pin_config};
 		GPIO_init(&GPIO_DAC_CH2_Handle);
-		
+
 		/*initilize DAC channel 2*/
-		static DAC_Config_t DAC_CH2_config = {.channel = DAC_CHANNEL_2,.resolution = DAC_RES_12_bits,.alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_NO_TRIGGER_EV, .outputBuffer = DAC_OBUFFER_EN};
+		static DAC_Config_t DAC_CH2_config = {.channel = DAC_CHANNEL_2,.resolution = DAC_RES_12_bits,.alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_TRIGGER_EV_TIM6, .outputBuffer = DAC_OBUFFER_EN};
 		DAC_Handle.DACxPtr = DAC1;
 		DAC_Handle.DACxConfigPtr = &DAC_CH2_config;
 		DAC_init(&DAC_Handle);
+		buzzerDMAIRQnumber = IRQ_DMA1_STREAM6;
 	}
-	
-	/*initilize TIM6,TIM7*/
-	TIM_Config_t TIMConfig = {.reloadVal = 1,.prescaler = TIM6_PRESCALE_VAL};
+
+	/*initilize TIM6 as sample rate clock (prescaler 1), and TIM7 as 1 milisecond tick (10 kHz counter clock)*/
+	uint32_t TIM6reloadVal = RCC_get_TIMCLK_value(APB1)/BUZZER_SAMPLE_RATE - 1;
+	TIM_Config_t TIMConfig = {.reloadVal = TIM6reloadVal,.prescaler = 0};
 	TIM_Handle_t TIM6Handle = {TIM6,&TIMConfig};
 	TIM_init(&TIM6Handle);
-	TIMConfig.prescaler = TIM7_PRESCALE_VAL;
+	TIM_update_event_TRGO(TIM6);
+	TIMConfig.reloadVal = 10000/BUZZER_TICK_FREQ - 1;
+	TIMConfig.prescaler = RCC_get_TIMCLK_value(APB1)/10000 - 1;
 	TIM_Handle_t TIM7Handle = {TIM7,&TIMConfig};
 	TIM_init(&TIM7Handle);
-	
-	/*enable TIM6,TIM7 update event interrupt and enable TIM6,TIM7 interrupt vector in NVIC*/
-	TIM_interrupt_ctr(TIM6,ENABLE);
+
+	/*actual sample rate may differ from BUZZER_SAMPLE_RATE due to integer division of timer clock*/
+	buzzerSampleRate = RCC_get_TIMCLK_value(APB1)/(TIM6reloadVal + 1);
+
+	/*start DMA from mid scale (silence), DDS engine fill each half of buffer when it is consumed*/
+	for(uint16_t i = 0; i < 2*BUZZER_BLOCK_SIZE; i++){
+		buzzerDMABuffer[i] = 2048;
+	}
+	/*stream stay reserved for buzzer, it may already be allocated to a DMA handle*/
+	buzzerDMAReady = (DAC_DMA_start_circular(&DAC_Handle,buzzerDMABuffer,2*BUZZER_BLOCK_SIZE) == 0);
+	if(buzzerDMAReady){
+		DAC_intrpt_priority_config(buzzerDMAIRQnumber,BUZZER_IRQ_PRIORITY);
+		DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,ENABLE);
+	}
+
+	/*TIM7 share priority of DAC DMA stream, so that sequencer tick never preempt mixing of a block (refer to BUZZER_IRQ_PRIORITY).
+	Priority is set before TIM7 update event interrupt and its vector are enabled*/
+	TIM_intrpt_priority_config(IRQ_TIM7,BUZZER_IRQ_PRIORITY);
 	TIM_interrupt_ctr(TIM7,ENABLE);
-	TIM_intrpt_vector_ctr(IRQ_TIM6_DAC,ENABLE);
 	TIM_intrpt_vector_ctr(IRQ_TIM7,ENABLE);
 }
 
 void buzzer_play_sound (uint32_t freq, uint32_t duration){
-	uint16_t TIM6reloadVal = 0;
-	uint16_t TIM7reloadVal = 0;
-	uint32_t APB1_clock = RCC_get_PCLK_value(APB1);
-	
-	TIM7_flag = 0;
-	
-	TIM6reloadVal = APB1_clock/(freq*SAMPLE_NUM*(TIM6_PRESCALE_VAL+1))-1;
-	TIM7reloadVal =	((APB1_clock/(TIM7_PRESCALE_VAL+1))*duration)/1000 -1;
-	
-	TIM_set_reload_val(TIM6,TIM6reloadVal);
-	TIM_set_reload_val(TIM7,TIM7reloadVal);
-	
-	TIM_ctr(TIM6,START);
-	TIM_ctr(TIM7,START);
-	
-	while(!TIM7_flag);
+	if(freq){
+		buzzer_voice_set(BUZZER_SEQ_VOICE,freq,BUZZER_VOLUME_MAX);
+	}else{
+		buzzer_voice_off(BUZZER_SEQ_VOICE);
+	}
+
+	buzzer_wait(duration);
+
+	buzzer_voice_off(BUZZER_SEQ_VOICE);
+}
+
+void buzzer_wait (uint32_t duration)
+{
+	buzzerWaitCount = (duration*BUZZER_TICK_FREQ)/1000;
+	buzzer_timer_ctr(TIM7,START);
+
+	/*count is checked with interrupts masked, so that last tick can not occur between check and sleep*/
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	while(buzzerWaitCount){
+		PWR_sleep();
+		__set_PRIMASK(primask);
+		__disable_irq();
+	}
+	__set_PRIMASK(primask);
 }
 
 void buzzer_stop_sound (void)
 {
-	TIM_ctr(TIM6,STOP);
-	TIM_ctr(TIM7,STOP);
+	buzzer_sequence_stop();
+	buzzerWaitCount = 0;
+	for(uint8_t voice = 0; voice < BUZZER_VOICE_NUM; voice++){
+		buzzer_voice_off(voice);
+	}
+	buzzer_timer_ctr(TIM6,STOP);
+	buzzer_timer_ctr(TIM7,STOP);
+}
+
+void buzzer_voice_set (uint8_t voice, uint32_t freq, uint8_t volume)
+{
+	if(voice >= BUZZER_VOICE_NUM){
+		return;
+	}
+
+	/*mask DMA interrupt so that mixer does not write back stale voice state*/
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,DISABLE);
+	buzzerVoice[voice].sweepCount = 0;
+	buzzerVoice[voice].phaseInc = buzzer_phase_inc_calc(freq);
+	buzzerVoice[voice].volume = volume;
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,ENABLE);
+
+	buzzer_timer_ctr(TIM6,START);
 }
 
-void TIM6_DAC_IRQHandler (void)
+void buzzer_voice_sweep (uint8_t voice, uint32_t startFreq, uint32_t endFreq, uint32_t duration, uint8_t volume)
 {
-	TIM_intrpt_handler(TIM6);
-	DAC_write(&DAC_Handle,sineWaveTable[count++]);
-	if(count == SAMPLE_NUM){
-		count = 0;
+	if(voice >= BUZZER_VOICE_NUM){
+		return;
+	}
+
+	uint32_t sampleCount = ((uint64_t)buzzerSampleRate*duration)/1000;
+	uint32_t startInc = buzzer_phase_inc_calc(startFreq);
+	uint32_t endInc = buzzer_phase_inc_calc(endFreq);
+
+	if(!sampleCount){
+		buzzer_voice_set(voice,endFreq,volume);
+		return;
 	}
-	
-	/*debug purpose*/
-	led_toggle(GPIOD,GPIO_PIN_NO_14);
+
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,DISABLE);
+	buzzerVoice[voice].phaseInc = startInc;
+	buzzerVoice[voice].phaseIncStep = ((int64_t)endInc - (int64_t)startInc)/(int32_t)sampleCount;
+	buzzerVoice[voice].volume = volume;
+	buzzerVoice[voice].sweepCount = sampleCount;
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,ENABLE);
+
+	buzzer_timer_ctr(TIM6,START);
+}
+
+void buzzer_voice_off (uint8_t voice)
+{
+	if(voice >= BUZZER_VOICE_NUM){
+		return;
+	}
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,DISABLE);
+	buzzerVoice[voice].sweepCount = 0;
+	buzzerVoice[voice].volume = 0;
+	DAC_intrpt_vector_ctr(buzzerDMAIRQnumber,ENABLE);
+}
+
+/***********************************************************************
+DMA has consumed one half of double buffer, refill it with next block of samples
+***********************************************************************/
+void DAC_application_event_callback (DAC_Handle_t *DACxHandlePtr,uint8_t event)
+{
+	if(event == DAC_EV_DMA_HALF_CMPLT){
+		buzzer_fill_block(&buzzerDMABuffer[0]);
+	}else if(event == DAC_EV_DMA_CMPLT){
+		buzzer_fill_block(&buzzerDMABuffer[BUZZER_BLOCK_SIZE]);
+	}
+}
+
+/*stream of DAC channel is reserved for buzzer, the other one may be allocated to a DMA handle*/
+void DMA1_Stream5_IRQHandler (void)
+{
+	if(buzzerDMAReady && buzzerDMAIRQnumber == IRQ_DMA1_STREAM5){
+		DAC_DMA_intrpt_handler(&DAC_Handle);
+	}else{
+		DMA_intrpt_handler(IRQ_DMA1_STREAM5);
+	}
+}
+
+void DMA1_Stream6_IRQHandler (void)
+{
+	if(buzzerDMAReady && buzzerDMAIRQnumber == IRQ_DMA1_STREAM6){
+		DAC_DMA_intrpt_handler(&DAC_Handle);
+	}else{
+		DMA_intrpt_handler(IRQ_DMA1_STREAM6);
+	}
+}
+
+uint8_t buzzer_sequence_play (const Buzzer_Note_t *notesPtr, uint16_t noteCount, uint8_t loop)
+{
+	uint8_t nextHead = (buzzerSeqHead + 1) % BUZZER_SEQ_QUEUE_SIZE;
+
+	if(notesPtr == NULL || noteCount == 0){
+		return BUZZER_SEQ_INVALID;
+	}
+	if(nextHead == buzzerSeqTail){
+		return BUZZER_SEQ_QUEUE_FULL;
+	}
+
+	buzzerSeqQueue[buzzerSeqHead].notesPtr = notesPtr;
+	buzzerSeqQueue[buzzerSeqHead].noteCount = noteCount;
+	buzzerSeqQueue[buzzerSeqHead].loop = loop;
+
+	/*mask TIM7 update interrupt while sequencer state is touched from thread mode*/
+	TIM_interrupt_ctr(TIM7,DISABLE);
+	buzzerSeqHead = nextHead;
+	if(!buzzerSeqActive){
+		buzzerSeqActive = 1;
+		buzzerNoteIndex = 0;
+		buzzer_sequencer_start_note();
+	}
+	TIM_interrupt_ctr(TIM7,ENABLE);
+	buzzer_timer_ctr(TIM7,START);
+
+	return BUZZER_SEQ_QUEUED;
+}
+
+void buzzer_sequence_stop (void)
+{
+	TIM_interrupt_ctr(TIM7,DISABLE);
+	buzzerSeqActive = 0;
+	buzzerSeqTail = buzzerSeqHead;
+	buzzer_voice_off(BUZZER_SEQ_VOICE);
+	TIM_interrupt_ctr(TIM7,ENABLE);
+}
+
+uint8_t buzzer_sequence_busy (void)
+{
+	return buzzerSeqActive;
+}
+
+/***********************************************************************
+Inform application of sequencer event
+@Note: this is to be define in user application
+***********************************************************************/
+__attribute__((weak)) void buzzer_application_event_callback (const Buzzer_Note_t *notesPtr, uint8_t event)
+{
 }
 
 void TIM7_IRQHandler (void)
 {
 	TIM_intrpt_handler(TIM7);
-	TIM_ctr(TIM6,STOP);
-	TIM_ctr(TIM7,STOP);
-	TIM7_flag = 1;
-}
\ No newline at end of file
+
+	if(buzzerWaitCount){
+		buzzerWaitCount--;
+	}
+	if(buzzerSeqActive){
+		buzzer_sequencer_step();
+	}
+
+	/*no need to tick while idle*/
+	if(!buzzerWaitCount && !buzzerSeqActive){
+		buzzer_timer_ctr(TIM7,STOP);
+	}
+}
+
+/***********************************************************************
+Private function: advance sequencer by one tick
+***********************************************************************/
+static void buzzer_sequencer_step (void)
+{
+	const Buzzer_Note_t *notePtr = &buzzerSeqQueue[buzzerSeqTail].notesPtr[buzzerNoteIndex];
+
+	buzzerNoteElapsed++;
+
+	/*shape volume while note sound, then keep silent during rest*/
+	if(buzzerNoteElapsed < notePtr->duration){
+		if(notePtr->freq){
+			buzzerVoice[BUZZER_SEQ_VOICE].volume = buzzer_envelope_calc(notePtr,buzzerNoteElapsed);
+		}
+	}else if(buzzerNoteElapsed == notePtr->duration){
+		buzzer_voice_off(BUZZER_SEQ_VOICE);
+	}
+
+	if(buzzerNoteElapsed < (uint32_t)notePtr->duration + notePtr->rest){
+		return;
+	}
+
+	/*move to next note, at the end of sequence inform application then loop or take next sequence from queue*/
+	buzzerNoteIndex++;
+	if(buzzerNoteIndex >= buzzerSeqQueue[buzzerSeqTail].noteCount){
+		buzzer_application_event_callback(buzzerSeqQueue[buzzerSeqTail].notesPtr,BUZZER_EV_SEQUENCE_CMPLT);
+		buzzerNoteIndex = 0;
+
+		if(!buzzerSeqQueue[buzzerSeqTail].loop || ((buzzerSeqTail + 1) % BUZZER_SEQ_QUEUE_SIZE) != buzzerSeqHead){
+			buzzerSeqTail = (buzzerSeqTail + 1) % BUZZER_SEQ_QUEUE_SIZE;
+		}
+		if(buzzerSeqTail == buzzerSeqHead){
+			buzzerSeqActive = 0;
+			return;
+		}
+	}
+
+	buzzer_sequencer_start_note();
+}
+
+/***********************************************************************
+Private function: start note at current position of sequencer
+***********************************************************************/
+static void buzzer_sequencer_start_note (void)
+{
+	const Buzzer_Note_t *notePtr = &buzzerSeqQueue[buzzerSeqTail].notesPtr[buzzerNoteIndex];
+
+	buzzerNoteElapsed = 0;
+	if(notePtr->freq && notePtr->duration){
+		buzzer_voice_set(BUZZER_SEQ_VOICE,notePtr->freq,buzzer_envelope_calc(notePtr,0));
+	}else{
+		buzzer_voice_off(BUZZER_SEQ_VOICE);
+	}
+}
+
+/***********************************************************************
+Private function: calculate volume of note at given time (in milisecond) from start of note
+@note linear attack ramp, flat sustain, linear release ramp ending at note duration
+***********************************************************************/
+static uint8_t buzzer_envelope_calc (const Buzzer_Note_t *notePtr, uint32_t elapsed)
+{
+	uint32_t volume = notePtr->volume;
+
+	if(elapsed < notePtr->attack){
+		volume = (volume*elapsed)/notePtr->attack;
+	}
+	if(elapsed + notePtr->release > notePtr->duration){
+		uint32_t releaseVol = (notePtr->volume*(notePtr->duration - elapsed))/notePtr->release;
+		if(releaseVol < volume){
+			volume = releaseVol;
+		}
+	}
+
+	return volume;
+}
+
+/***********************************************************************
+Private function: synthesize and mix all voices into one block of DAC samples
+***********************************************************************/
+static void buzzer_fill_block (uint16_t *blockPtr)
+{
+	for(uint16_t i = 0; i < BUZZER_BLOCK_SIZE; i++){
+		buzzerMixBuffer[i] = 0;
+	}
+
+	/*voice by voice so that voice state is kept in registers for the whole block*/
+	for(uint8_t voice = 0; voice < BUZZER_VOICE_NUM; voice++){
+		Buzzer_Voice_t *voicePtr = &buzzerVoice[voice];
+		int32_t volume = voicePtr->volume;
+		uint32_t phase = voicePtr->phase;
+		uint32_t phaseInc = voicePtr->phaseInc;
+		uint32_t sweepCount = voicePtr->sweepCount;
+
+		if(!volume){
+			continue;
+		}
+
+		for(uint16_t i = 0; i < BUZZER_BLOCK_SIZE; i++){
+			/*Q15 sample scaled by volume (0-255) is still Q15*/
+			buzzerMixBuffer[i] += (buzzer_sine(phase)*volume) >> 8;
+			phase += phaseInc;
+			if(sweepCount){
+				phaseInc += voicePtr->phaseIncStep;
+				sweepCount--;
+			}
+		}
+
+		voicePtr->phase = phase;
+		voicePtr->phaseInc = phaseInc;
+		voicePtr->sweepCount = sweepCount;
+	}
+
+	/*sum of BUZZER_VOICE_NUM Q15 values is within +-2^(15+BUZZER_MIX_SHIFT), scale it to +-2047 around DAC mid scale*/
+	for(uint16_t i = 0; i < BUZZER_BLOCK_SIZE; i++){
+		blockPtr[i] = 2048 + (buzzerMixBuffer[i] >> (4 + BUZZER_MIX_SHIFT));
+	}
+}
+
+/***********************************************************************
+Private function: get Q15 sine value of 32-bits phase
+@note full period is made of 4 mirrored quarter-wave table, value between table entries is linearly interpolated
+***********************************************************************/
+static int32_t buzzer_sine (uint32_t phase)
+{
+	int32_t sample[2];
+	uint8_t index = phase >> 24;
+	int32_t fraction = (phase >> 8) & 0xFFFF;
+
+	for(uint8_t i = 0; i < 2; i++, index++){
+		uint8_t quarterIndex = index & 0x3F;
+		uint8_t quarter = index >> 6;
+
+		if(quarter == 0){
+			sample[i] = quarterSineTable[quarterIndex];
+		}else if(quarter == 1){
+			sample[i] = quarterSineTable[64 - quarterIndex];
+		}else if(quarter == 2){
+			sample[i] = -quarterSineTable[quarterIndex];
+		}else{
+			sample[i] = -quarterSineTable[64 - quarterIndex];
+		}
+	}
+
+	return sample[0] + (((sample[1] - sample[0])*fraction) >> 16);
+}
+
+/***********************************************************************
+Private function: calculate phase increment per sample for given frequency
+***********************************************************************/
+static uint32_t buzzer_phase_inc_calc (uint32_t freq)
+{
+	return (uint32_t)(((uint64_t)freq << 32)/buzzerSampleRate);
+}
+
+/***********************************************************************
+Private function: start or stop TIM6 (sample clock) or TIM7 (tick), buzzer hold a stop lock while one of them run
+***********************************************************************/
+static void buzzer_timer_ctr (TIM_TypeDef *TIMxPtr, uint8_t startOrStop)
+{
+	uint8_t timerBit = (TIMxPtr == TIM6) ? 1 : 2;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(startOrStop == START){
+		if(!buzzerTimerRunning){
+			PWR_stop_lock(PWR_LOCK_BUZZER);
+		}
+		buzzerTimerRunning |= timerBit;
+	}else if(buzzerTimerRunning & timerBit){
+		buzzerTimerRunning &= ~timerBit;
+		if(!buzzerTimerRunning){
+			PWR_stop_unlock(PWR_LOCK_BUZZER);
+		}
+	}
+	TIM_ctr(TIMxPtr,startOrStop);
+
+	__set_PRIMASK(primask);
+}
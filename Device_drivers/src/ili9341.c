@@ -13,13 +13,12 @@
 
 #include "../inc/ili9341.h"
 
-static void ILI9341_HW_init (void);
+static int8_t ILI9341_HW_init (void);
 static void ILI9341_LCD_init (void);
 static void ILI9341_send_command (uint8_t cmd);
 static void ILI9341_send_parameter (uint8_t  param);
 static void ILI9341_send_parameter_16_bits (uint16_t param);
 static void ILI9341_set_active_area (uint16_t startColum, uint16_t startPage, uint16_t endColumn, uint16_t endPage);
-static void ILI9341_delay(volatile uint32_t delay);
 static void ILI9341_fill_area (uint16_t startColumn, uint16_t endColumn, uint16_t startPage, uint16_t endPage, uint16_t color);
 
 ILI9341_Config_t ILI9341_config;
@@ -29,14 +28,17 @@ uint16_t ILI9341_y;
 /***********************************************************************
 Initilaize related hardware (GPIO pins, SPI peripheral and initilize display with default settings
 ***********************************************************************/
-void ILI9341_init (void)
+int8_t ILI9341_init (void)
 {
-	ILI9341_HW_init();
+	if(ILI9341_HW_init() < 0){
+		return -1;
+	}
 	ILI9341_LCD_init();
 	
 	ILI9341_config.width = ILI9341_WIDTH;
 	ILI9341_config.height = ILI9341_HEIGHT;
 	ILI9341_config.orientation = ILI9341_orientation_landscape_1;
+	return 0;
 }
 
 /***********************************************************************
@@ -205,10 +207,12 @@ void ILI9341_put_string(uint16_t x, uint16_t y, char *str, TM_FontDef_t *font, u
 /***********************************************************************
 Private function: Initilize related hardware (SPI peripheral and GPIO pins)
 ***********************************************************************/
-void ILI9341_HW_init (void)
+int8_t ILI9341_HW_init (void)
 {
-	/*Initilize SPI peripheral*/
-	SPI_general_init(ILI9341_SPI,ILI9341_SPI_PINS_PACK,SPI_MODE_MASTER,SPI_BUS_FULL_DUPLEX,SPI_DATA_8BITS,SPI_CLK_PHASE_1ST_E,SPI_CLK_POL_LIDLE,SPI_SSM_EN,SPI_CLK_SPEED_DIV2);
+	/*Initilize SPI peripheral, pins may be claimed by another pins pack*/
+	if(SPI_general_init(ILI9341_SPI,ILI9341_SPI_PINS_PACK,SPI_MODE_MASTER,SPI_BUS_FULL_DUPLEX,SPI_DATA_8BITS,SPI_CLK_PHASE_1ST_E,SPI_CLK_POL_LIDLE,SPI_SSM_EN,SPI_CLK_SPEED_DIV2) == NULL){
+		return -1;
+	}
 	SPI_SSI_ctr(ILI9341_SPI,ENABLE);
 	
 	/*Initilize CSX pin*/
@@ -220,6 +224,9 @@ void ILI9341_HW_init (void)
 	/*Initilize RST pin*/
 	GPIO_init_direct(ILI9341_RST_PORT,ILI9341_RST_PIN,GPIO_MODE_OUT,GPIO_OUTPUT_TYPE_PP,GPIO_OUTPUT_LOW_SPEED,GPIO_PU,0);
 
+	/*Initilize time base used for reset and wake up delays*/
+	TIME_init();
+	return 0;
 }
 
 /***********************************************************************
@@ -229,15 +236,15 @@ void ILI9341_LCD_init (void)
 {
 	/* Force reset */
 	ILI9341_RST_CLEAR;
-	ILI9341_delay(20000);
+	TIME_delay_ms(ILI9341_RST_PULSE_MS);
 	ILI9341_RST_SET;
 	
 	/* Delay for RST response */
-	ILI9341_delay(20000);
+	TIME_delay_ms(ILI9341_RESET_WAIT_MS);
 	
 	/* Software reset */
 	ILI9341_send_command(ILI9341_RESET);
-	ILI9341_delay(50000);
+	TIME_delay_ms(ILI9341_RESET_WAIT_MS);
 	
 	ILI9341_send_command(ILI9341_POWERA);
 	ILI9341_send_parameter(0x39);
@@ -331,7 +338,7 @@ void ILI9341_LCD_init (void)
 	ILI9341_send_parameter(0x0F);
 	ILI9341_send_command(ILI9341_SLEEP_OUT);
 
-	ILI9341_delay(1000000);
+	TIME_delay_ms(ILI9341_SLEEP_OUT_WAIT_MS);
 
 	ILI9341_send_command(ILI9341_DISPLAY_ON);
 }
@@ -385,13 +392,6 @@ void ILI9341_set_active_area (uint16_t startColumn, uint16_t endColumn, uint16_t
 	ILI9341_send_parameter_16_bits(endPage);
 }
 
-/***********************************************************************
-Private function: Create delay
-***********************************************************************/
-void ILI9341_delay(volatile uint32_t delay) {
-	for (; delay != 0; delay--); 
-}
-
 /***********************************************************************
 Private function: Fill area
 ***********************************************************************/
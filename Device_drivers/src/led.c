@@ -10,10 +10,47 @@
 
 #include "../inc/led.h"
 
+/*DMA2 channel 7 serve TIM8 requests: update on stream 1, compare channel 1 - 4 on stream 2, 3, 4, 7*/
+#define LED_DIM_DMA_CHANNEL 7
+#define LED_DIM_RELOAD_STREAM 1
+static const uint8_t portStream[LED_DIM_MAX_PORT] = {2,3,4,7};
+
+/*each stream has 6 bits of flags, at bit 0, 6, 16, 22 of LISR/LIFCR (stream 0-3) and HISR/HIFCR (stream 4-7)*/
+static const uint8_t flagShift[4] = {0,6,16,22};
+#define LED_DIM_DMA_FLAG_ALL 0x3D
+
+#define LED_DIM_DATA_16_BITS 1
+#define LED_DIM_DATA_32_BITS 2
+
+typedef struct{
+	GPIO_TypeDef *GPIOxPtr;
+	uint16_t pinMask;
+	uint16_t fadeMask;	/*pins which are fading*/
+	uint8_t brightness[16];
+	uint8_t fadeTarget[16];
+	uint16_t fadeLevel[16];	/*8.8 fixed point brightness*/
+	int32_t fadeStep[16];	/*8.8 fixed point increment per tick*/
+	uint16_t fadeTicks[16];	/*ticks left*/
+	uint32_t planeWord[LED_DIM_BITS];	/*BSRR word of each bit plane, read by DMA*/
+}LED_Dim_port_t;
+
+static LED_Dim_port_t dimPort[LED_DIM_MAX_PORT];
+static uint8_t dimPortNum;
+static uint16_t reloadBuffer[LED_DIM_BITS];
+static SWTIM_Timer_t fadeTimer;
+static uint8_t dimRunning = 0;	/*engine hold a stop lock while running*/
+
+static LED_Dim_port_t *led_dim_find_port (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
+static void led_dim_write (LED_Dim_port_t *portPtr, uint8_t pinNumber, uint8_t brightness);
+static void led_dim_start (void);
+static void led_dim_DMA_start (uint8_t streamNo, volatile void *periphPtr, const void *bufferPtr, uint8_t dataSize);
+static void led_dim_DMA_stop (uint8_t streamNo);
+static void led_fade_tick (void *argPtr);
+
 void led_init (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
 {
 	GPIO_Pin_config_t GPIO_led_config={.pinNumber=pinNumber,.mode=GPIO_MODE_OUT,.speed = GPIO_OUTPUT_LOW_SPEED,.outType = GPIO_OUTPUT_TYPE_PP,.puPdr=GPIO_NO_PUPDR};
-	GPIO_Handle_t GPIO_led_Handle = {GPIOD,GPIO_led_config};
+	GPIO_Handle_t GPIO_led_Handle = {GPIOxPtr,GPIO_led_config};
 	GPIO_init(&GPIO_led_Handle);
 }
 
@@ -30,4 +67,285 @@ void led_off (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
 void led_toggle (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
 {
 	GPIO_toggle_pin(GPIOxPtr, pinNumber);
-}
\ No newline at end of file
+}
+
+/***********************************************************************
+Add leds of a port to dimming engine
+***********************************************************************/
+int8_t led_dim_init (GPIO_TypeDef *GPIOxPtr, uint16_t pinMask)
+{
+	LED_Dim_port_t *portPtr = NULL;
+
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		if(dimPort[i].GPIOxPtr == GPIOxPtr){
+			portPtr = &dimPort[i];
+		}
+	}
+	if(portPtr == NULL){
+		if(dimPortNum >= LED_DIM_MAX_PORT || DMA_stream_reserve(DMA_get_stream(DMA2,LED_DIM_RELOAD_STREAM),dimPort) < 0
+			|| DMA_stream_reserve(DMA_get_stream(DMA2,portStream[dimPortNum]),dimPort) < 0){
+			return -1;
+		}
+		portPtr = &dimPort[dimPortNum++];
+		portPtr->GPIOxPtr = GPIOxPtr;
+		portPtr->pinMask = 0;
+		portPtr->fadeMask = 0;
+		for(uint8_t k = 0; k < LED_DIM_BITS; k++){
+			portPtr->planeWord[k] = 0;
+		}
+	}
+
+	/*new pins start off, pins already dimmed keep their brightness*/
+	uint16_t newPins = pinMask & ~portPtr->pinMask;
+	while(newPins){
+		uint8_t pinNumber = 31 - __CLZ(newPins);
+		newPins &= ~(1U<<pinNumber);
+		led_init(GPIOxPtr,pinNumber);
+		led_dim_write(portPtr,pinNumber,0);
+	}
+	portPtr->pinMask |= pinMask;
+
+	led_dim_start();
+	return 0;
+}
+
+/***********************************************************************
+Stop dimming engine
+***********************************************************************/
+void led_dim_stop (void)
+{
+	if(dimRunning){
+		PWR_stop_unlock(PWR_LOCK_LED);
+		dimRunning = 0;
+	}
+	TIM_ctr(TIM8,STOP);
+	TIM8->DIER = 0;
+	if(fadeTimer.callback != NULL){
+		SWTIM_cancel(&fadeTimer);
+	}
+	led_dim_DMA_stop(LED_DIM_RELOAD_STREAM);
+	DMA_stream_release(DMA_get_stream(DMA2,LED_DIM_RELOAD_STREAM),dimPort);
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		led_dim_DMA_stop(portStream[i]);
+		DMA_stream_release(DMA_get_stream(DMA2,portStream[i]),dimPort);
+		dimPort[i].GPIOxPtr->BSRR = (uint32_t)dimPort[i].pinMask<<16;
+	}
+	dimPortNum = 0;
+}
+
+/***********************************************************************
+Set brightness of a dimmed led
+***********************************************************************/
+void led_set_brightness (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t brightness)
+{
+	LED_Dim_port_t *portPtr = led_dim_find_port(GPIOxPtr,pinNumber);
+	if(portPtr == NULL){
+		return;
+	}
+
+	/*fade tick run from interrupt, it must not see a half cancelled fade*/
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	portPtr->fadeMask &= ~(1U<<pinNumber);
+	led_dim_write(portPtr,pinNumber,brightness);
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Get current brightness of a dimmed led
+***********************************************************************/
+uint8_t led_get_brightness (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
+{
+	LED_Dim_port_t *portPtr = led_dim_find_port(GPIOxPtr,pinNumber);
+	return (portPtr != NULL) ? portPtr->brightness[pinNumber] : 0;
+}
+
+/***********************************************************************
+Fade a dimmed led to a target brightness
+***********************************************************************/
+void led_fade (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t target, uint32_t durationMs)
+{
+	LED_Dim_port_t *portPtr = led_dim_find_port(GPIOxPtr,pinNumber);
+	uint32_t ticks = durationMs/LED_FADE_TICK_MS;
+
+	if(portPtr == NULL){
+		return;
+	}
+	if(ticks == 0){
+		led_set_brightness(GPIOxPtr,pinNumber,target);
+		return;
+	}
+	if(ticks > 0xFFFF){
+		ticks = 0xFFFF;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	portPtr->fadeTarget[pinNumber] = target;
+	portPtr->fadeLevel[pinNumber] = (uint16_t)portPtr->brightness[pinNumber]<<8;
+	portPtr->fadeStep[pinNumber] = ((int32_t)target - portPtr->brightness[pinNumber])*256/(int32_t)ticks;
+	portPtr->fadeTicks[pinNumber] = ticks;
+	portPtr->fadeMask |= 1U<<pinNumber;
+	if(fadeTimer.callback == NULL){
+		SWTIM_timer_init(&fadeTimer,led_fade_tick,NULL);
+	}
+	if(!SWTIM_is_active(&fadeTimer)){
+		SWTIM_start(&fadeTimer,SWTIM_MS_TO_TICKS(LED_FADE_TICK_MS),SWTIM_MS_TO_TICKS(LED_FADE_TICK_MS));
+	}
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Check whether a dimmed led is fading
+***********************************************************************/
+uint8_t led_is_fading (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
+{
+	LED_Dim_port_t *portPtr = led_dim_find_port(GPIOxPtr,pinNumber);
+	return (portPtr != NULL && (portPtr->fadeMask & (1U<<pinNumber))) ? 1 : 0;
+}
+
+/***********************************************************************
+Private function: find port entry holding a dimmed led
+***********************************************************************/
+static LED_Dim_port_t *led_dim_find_port (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
+{
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		if(dimPort[i].GPIOxPtr == GPIOxPtr && pinNumber < 16 && (dimPort[i].pinMask & (1U<<pinNumber))){
+			return &dimPort[i];
+		}
+	}
+	return NULL;
+}
+
+/***********************************************************************
+Private function: store brightness of a led into its bit of each plane word
+***********************************************************************/
+static void led_dim_write (LED_Dim_port_t *portPtr, uint8_t pinNumber, uint8_t brightness)
+{
+	uint32_t setBit = 1UL<<pinNumber;
+	uint32_t resetBit = 1UL<<(pinNumber + 16);
+
+	/*plane words are shared by all leds of port, read-modify-write must not be interleaved with fade tick*/
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	portPtr->brightness[pinNumber] = brightness;
+	for(uint8_t k = 0; k < LED_DIM_BITS; k++){
+		uint32_t word = portPtr->planeWord[k] & ~(setBit | resetBit);
+		portPtr->planeWord[k] = word | ((brightness & (1U<<k)) ? setBit : resetBit);
+	}
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Private function: (re)start TIM8 and all DMA streams of engine in step
+***********************************************************************/
+static void led_dim_start (void)
+{
+	/*plane k last 2^(k+1) counter ticks (reload value 0 would stop counter), refresh cycle is 2*(2^LED_DIM_BITS - 1) ticks*/
+	uint32_t counterFreq = (uint32_t)LED_DIM_REFRESH_FREQ*2*((1UL<<LED_DIM_BITS) - 1);
+	TIM_Config_t TIM8Config = {.reloadVal = 1,.prescaler = RCC_get_TIMCLK_value(APB2)/counterFreq - 1};
+	TIM_Handle_t TIM8Handle = {TIM8,&TIM8Config};
+
+	if(!dimRunning){
+		PWR_stop_lock(PWR_LOCK_LED);
+		dimRunning = 1;
+	}
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+	TIM_init(&TIM8Handle);
+	TIM8->DIER = 0;
+	led_dim_DMA_stop(LED_DIM_RELOAD_STREAM);
+	/*streams of unused ports may be allocated to other requests*/
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		led_dim_DMA_stop(portStream[i]);
+	}
+
+	/*channels are frozen output compare with compare value 0: compare request occur right after each update event,
+	outputs of channels are not enabled*/
+	TIM8->CR1 |= TIM_CR1_ARPE;
+	TIM8->CCMR1 = 0;
+	TIM8->CCMR2 = 0;
+	TIM8->CCR1 = 0;
+	TIM8->CCR2 = 0;
+	TIM8->CCR3 = 0;
+	TIM8->CCR4 = 0;
+
+	/*reload value written at an update event is preloaded and define the period after next one, so reload buffer is one plane ahead
+	of plane words; active reload value of plane 0 is loaded by TIM_init*/
+	for(uint8_t k = 0; k < LED_DIM_BITS; k++){
+		reloadBuffer[k] = (2UL<<((k + 1) % LED_DIM_BITS)) - 1;
+	}
+	led_dim_DMA_start(LED_DIM_RELOAD_STREAM,&TIM8->ARR,reloadBuffer,LED_DIM_DATA_16_BITS);
+	TIM_DMA_request_ctr(TIM8,TIM_DMA_REQ_UPDATE,ENABLE);
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		led_dim_DMA_start(portStream[i],&dimPort[i].GPIOxPtr->BSRR,dimPort[i].planeWord,LED_DIM_DATA_32_BITS);
+		TIM_DMA_request_ctr(TIM8,TIM_DMA_REQ_CC1 + i,ENABLE);
+	}
+
+	/*first update event occur on first counter tick, every stream start at plane 0 there*/
+	TIM8->CNT = TIM8->ARR;
+	TIM_ctr(TIM8,START);
+}
+
+/***********************************************************************
+Private function: start circular DMA of one word per plane from memory to peripheral register
+***********************************************************************/
+static void led_dim_DMA_start (uint8_t streamNo, volatile void *periphPtr, const void *bufferPtr, uint8_t dataSize)
+{
+	DMA_Stream_TypeDef *streamPtr = DMA_get_stream(DMA2,streamNo);
+
+	streamPtr->PAR = (uint32_t)periphPtr;
+	streamPtr->M0AR = (uint32_t)bufferPtr;
+	streamPtr->NDTR = LED_DIM_BITS;
+	streamPtr->FCR = 0;
+
+	/*only DMA2 reach GPIO (AHB1) through its peripheral port, very high priority since a late transfer stretch a plane*/
+	streamPtr->CR = (LED_DIM_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | (dataSize << DMA_SxCR_MSIZE_Pos) | (dataSize << DMA_SxCR_PSIZE_Pos)
+									| DMA_SxCR_MINC | DMA_SxCR_CIRC | (0x01 << DMA_SxCR_DIR_Pos) | (0x03 << DMA_SxCR_PL_Pos);
+	streamPtr->CR |= DMA_SxCR_EN;
+}
+
+/***********************************************************************
+Private function: disable a DMA stream and clear its flags
+***********************************************************************/
+static void led_dim_DMA_stop (uint8_t streamNo)
+{
+	DMA_Stream_TypeDef *streamPtr = DMA_get_stream(DMA2,streamNo);
+	volatile uint32_t *IFCRPtr = (streamNo < 4) ? &DMA2->LIFCR : &DMA2->HIFCR;
+
+	streamPtr->CR &= ~DMA_SxCR_EN;
+	while(streamPtr->CR & DMA_SxCR_EN);
+	*IFCRPtr = LED_DIM_DMA_FLAG_ALL << flagShift[streamNo % 4];
+}
+
+/***********************************************************************
+Private function: step brightness of fading leds, called from software timer
+***********************************************************************/
+static void led_fade_tick (void *argPtr)
+{
+	uint8_t fading = 0;
+
+	for(uint8_t i = 0; i < dimPortNum; i++){
+		LED_Dim_port_t *portPtr = &dimPort[i];
+		uint16_t pending = portPtr->fadeMask;
+
+		while(pending){
+			uint8_t pinNumber = 31 - __CLZ(pending);
+			pending &= ~(1U<<pinNumber);
+			if(--portPtr->fadeTicks[pinNumber] == 0){
+				/*last tick land exactly on target whatever rounding of step*/
+				portPtr->fadeMask &= ~(1U<<pinNumber);
+				led_dim_write(portPtr,pinNumber,portPtr->fadeTarget[pinNumber]);
+			}else{
+				portPtr->fadeLevel[pinNumber] += portPtr->fadeStep[pinNumber];
+				led_dim_write(portPtr,pinNumber,portPtr->fadeLevel[pinNumber]>>8);
+			}
+		}
+		if(portPtr->fadeMask){
+			fading = 1;
+		}
+	}
+
+	if(!fading){
+		SWTIM_cancel(&fadeTimer);
+	}
+}
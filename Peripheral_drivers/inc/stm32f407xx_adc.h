@@ -20,6 +20,7 @@
 #include "stm32f407xx.h"                  // Device header
 #include "stm32f407xx_common_macro.h"
 #include "stm32f407xx_gpio.h"
+#include "stm32f407xx_time.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -64,6 +65,12 @@ Macro definition
 #define ADC_CVSMODE_SINGLE 0
 #define ADC_CVSMODE_CONT 1
 
+/*
+*@ADC_TIMEOUT
+*Longest wait for end of conversion in ADC_read (in microsecond)
+*/
+#define ADC_TIMEOUT_US 100
+
 /***********************************************************************
 ADC structure definition
 ***********************************************************************/
@@ -138,7 +145,7 @@ void ADC_deinit(void);
 *@brief Read value from ADC channel
 *@param Pointer to ADCx 's base address
 *@param ADC channel
-*@return Value from ADC
+*@return Value from ADC, 0 if conversion does not end within ADC_TIMEOUT_US
 */
 uint16_t ADC_read(ADC_TypeDef *ADCxPtr, uint8_t channel);
 #endif
\ No newline at end of file
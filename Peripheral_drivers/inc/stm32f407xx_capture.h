@@ -0,0 +1,152 @@
+/**
+*@file stm32f407xx_capture.h
+*@brief provide frequency and duty cycle measurement of external signals on stm32f407xx MCUs.
+*
+*This header file provide APIs for measuring period and active time of a signal connected to channel 1 or channel 2 input of a timer.
+*Timer is used in PWM input mode: both channels capture the same input, one on active edge and one on opposite edge,
+*and slave mode controller reset counter on active edge. Each active edge therefore capture period in one CCR and active time
+*in the other, without any software timestamp subtraction.
+*Capture pairs are stored in a ring buffer, either by capture interrupt or by circular DMA (DMA burst reading CCR1 and CCR2
+*through DMAR), so that fast signals (tens of kHz) are measured without one interrupt per edge.
+*
+*@note Supported timers: TIM1-TIM5, TIM8 (interrupt or DMA), TIM9 and TIM12 (interrupt only).
+*Counter frequency must be chosen so that slowest period fit in counter (16 bits, 32 bits on TIM2 and TIM5).
+*GPIO pin of timer input is to be configured in alternate function mode by user application.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_CAPTURE_H
+#define STM32F407XX_CAPTURE_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_timer.h"
+#include "stm32f407xx_dma.h"
+#include "stm32f407xx_pwr.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@CAPTURE_MODE
+*How capture pairs are moved into ring buffer
+*/
+#define CAPTURE_MODE_INTRPT 0	/*capture interrupt of period channel, timer IRQ must call CAPTURE_intrpt_handler*/
+#define CAPTURE_MODE_DMA 1	/*circular DMA, no interrupt*/
+
+/*
+*@CAPTURE_ERROR
+*Error flags reported in statistics
+*/
+#define CAPTURE_ERR_OVERRUN 0x01	/*ring buffer was full, samples were lost (interrupt mode)*/
+#define CAPTURE_ERR_OVERFLOW 0x02	/*counter overflowed between two active edges, signal is slower than counter range*/
+
+/*
+*@CAPTURE_BUFFER
+*Ring buffer size (in word) needed for given number of samples
+*/
+#define CAPTURE_BUFFER_SIZE(sampleNum) (2*(sampleNum))
+
+/***********************************************************************
+Capture structure definition
+***********************************************************************/
+
+typedef struct{
+	uint8_t inputChannel;	/*TIM_CHANNEL_1 or TIM_CHANNEL_2, timer input on which signal is connected*/
+	uint8_t activeEdge;	/*TIM_IC_POLARITY_RISING or TIM_IC_POLARITY_FALLING, edge starting a period*/
+	uint8_t filter;	/*0 (no filter) to 15, refer to ICxF bits in reference manual*/
+	uint32_t countFreq;	/*counter frequency (in Hz), resolution of measurement*/
+	uint8_t mode;	/*refer to @CAPTURE_MODE for possible value*/
+	uint32_t *bufferPtr;	/*ring buffer of CAPTURE_BUFFER_SIZE(sampleNum) words*/
+	uint16_t sampleNum;	/*number of samples ring buffer can hold (2 - 32767)*/
+}CAPTURE_Config_t;
+
+typedef struct{
+	TIM_TypeDef *TIMxPtr;
+	CAPTURE_Config_t *CAPTUREConfigPtr;
+	DMA_Stream_TypeDef *DMAStreamPtr;	/*internal: DMA stream in DMA mode*/
+	uint32_t countFreq;	/*internal: actual counter frequency*/
+	volatile uint16_t writeIdx;	/*internal: next sample written (interrupt mode)*/
+	uint16_t readIdx;	/*internal: next sample read*/
+	uint8_t discard;	/*internal: first sample after start measure a partial period*/
+	volatile uint8_t error;	/*internal: refer to @CAPTURE_ERROR*/
+	uint8_t busy;	/*internal: measurement is running, stop lock is held*/
+}CAPTURE_Handle_t;
+
+typedef struct{
+	uint16_t sampleCount;	/*number of periods in window, 0 if signal stopped*/
+	uint32_t frequency;	/*average frequency (in Hz)*/
+	uint32_t periodAvg;	/*average period (in nanosecond)*/
+	uint32_t periodMin;	/*in nanosecond*/
+	uint32_t periodMax;	/*in nanosecond*/
+	uint16_t dutyAvg;	/*average duty cycle (in 0.01 %), active time over period of whole window*/
+	uint16_t dutyMin;	/*in 0.01 %*/
+	uint16_t dutyMax;	/*in 0.01 %*/
+	uint8_t error;	/*refer to @CAPTURE_ERROR, errors since previous window*/
+}CAPTURE_Stats_t;
+
+/***********************************************************************
+Capture APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize timer in PWM input mode and ring buffer
+*
+*In DMA mode, DMA stream serving capture request of input channel is taken:
+*TIM1 DMA2 stream 1/2, TIM2 DMA1 stream 5/6, TIM3 DMA1 stream 4/5, TIM4 DMA1 stream 0/3, TIM5 DMA1 stream 2/4, TIM8 DMA2 stream 2/3 (channel 1/2).
+*
+*@param Pointer to capture handle struct
+*@return Actual counter frequency (in Hz), -1 if timer or mode is not supported or DMA stream is taken by a DMA handle or an other driver
+*/
+int32_t CAPTURE_init(CAPTURE_Handle_t *CAPTUREHandlePtr);
+
+/**
+*@brief Start measurement
+*
+*Ring buffer is emptied, first sample after start is dropped. In interrupt mode, timer interrupt vector is to be enabled by user application.
+*Stop mode is prevented until CAPTURE_stop (PWR_LOCK_CAPTURE), timer does not count in stop mode.
+*
+*@param Pointer to capture handle struct
+*@return none
+*/
+void CAPTURE_start(CAPTURE_Handle_t *CAPTUREHandlePtr);
+
+/**
+*@brief Stop measurement
+*@param Pointer to capture handle struct
+*@return none
+*/
+void CAPTURE_stop(CAPTURE_Handle_t *CAPTUREHandlePtr);
+
+/**
+*@brief Read oldest sample from ring buffer
+*@param Pointer to capture handle struct
+*@param Pointer to period (in counter tick)
+*@param Pointer to active time (in counter tick)
+*@return 1 if a sample was read, 0 if ring buffer is empty
+*/
+uint8_t CAPTURE_read(CAPTURE_Handle_t *CAPTUREHandlePtr, uint32_t *periodPtr, uint32_t *activePtr);
+
+/**
+*@brief Compute statistics over window of samples captured since previous call
+*
+*All samples in ring buffer are consumed, so ring buffer must hold samples of at least one window.
+*
+*@param Pointer to capture handle struct
+*@param Pointer to statistics struct
+*@return none
+*/
+void CAPTURE_get_stats(CAPTURE_Handle_t *CAPTUREHandlePtr, CAPTURE_Stats_t *statsPtr);
+
+/**
+*@brief Capture interrupt handler, to be called from timer IRQ handler in interrupt mode
+*@param Pointer to capture handle struct
+*@return none
+*/
+void CAPTURE_intrpt_handler(CAPTURE_Handle_t *CAPTUREHandlePtr);
+#endif
@@ -0,0 +1,93 @@
+/**
+*@file stm32f407xx_clock_measure.h
+*@brief provide measurement of internal clocks on stm32f407xx MCUs.
+*
+*This header file provide APIs for measuring LSI, LSE and HSE frequencies with timer input capture, and for correcting
+*HSE frequency used by clock computation so that baud rates and timer periods are compensated at run time.
+*Clocks are routed internally, no pin is needed: LSI and LSE to TIM5 channel 4 (TI4 remap), HSE divided by RTC prescaler
+*to TIM11 channel 1 (TI1 remap). Captures are taken every 8 input periods and accumulated over given duration,
+*measured frequency is therefore expressed in units of timer clock, i.e. of system clock.
+*
+*@note Measurement is blocking and polled. Interrupts stay enabled: if an interrupt handler delay a capture long enough for
+*the next one to overwrite it, measurement fail and is to be retried (or called with interrupts masked).
+*TIM5 may be shared with software timer (stm32f407xx_soft_timer): its counter is then used as it is (1 MHz, 1 ppm resolution
+*over 1 second), channel 4 is borrowed and given back. TIM11 must not be used by application during measurement.
+*HSE can only be measured while system clock does not derive from HSE (measurement would always return nominal value),
+*RTC must not be clocked by HSE since RTC prescaler is changed during measurement.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_CLOCK_MEASURE_H
+#define STM32F407XX_CLOCK_MEASURE_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_rcc.h"
+#include "stm32f407xx_timer.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@CLOCK_SRC
+*Clocks which can be measured
+*/
+#define CLOCK_SRC_LSI 0	/*TIM5 channel 4, LSI is started if needed and stopped afterward*/
+#define CLOCK_SRC_LSE 1	/*TIM5 channel 4, LSE must be running*/
+#define CLOCK_SRC_HSE 2	/*TIM11 channel 1 through RTC prescaler, HSE must be running*/
+
+/*
+*@CLOCK_NOMINAL_FREQ
+*Nominal frequencies of low speed oscillators (LSI is only specified between 17 kHz and 47 kHz)
+*/
+#define CLOCK_LSI_FREQ 32000
+#define CLOCK_LSE_FREQ 32768
+
+/*
+*@CLOCK_MEASURE_LIMIT
+*/
+#define CLOCK_DURATION_MAX_MS 1000	/*longer duration is clipped*/
+#define CLOCK_HSE_RTC_DIV 31	/*HSE prescaler (RTCPRE) used during measurement, keep capture rate low*/
+#define CLOCK_CAL_MAX_PPM 2000	/*larger HSE error is rejected by CLOCK_calibrate_HSE (reference is not a crystal)*/
+
+/***********************************************************************
+Clock measure structure definition
+***********************************************************************/
+
+typedef struct{
+	uint32_t frequency;	/*measured frequency (in Hz)*/
+	uint32_t nominalFreq;	/*nominal frequency of source (in Hz)*/
+	int32_t errorPpm;	/*deviation from nominal frequency (in ppm)*/
+	uint32_t captureNum;	/*number of capture periods (8 input periods each) accumulated*/
+}CLOCK_Measure_t;
+
+/***********************************************************************
+Clock measure APIs prototype
+***********************************************************************/
+
+/**
+*@brief Measure an internal clock
+*@param Clock to be measured (refer to @CLOCK_SRC)
+*@param Measurement duration (in ms), resolution improve with duration
+*@param Pointer to result struct
+*@return 0: success, -1: invalid source, clock not running, timer busy, lost capture or no edge for 100 ms
+*/
+int8_t CLOCK_measure(uint8_t source, uint32_t durationMs, CLOCK_Measure_t *measurePtr);
+
+/**
+*@brief Measure HSE against LSE crystal and correct HSE frequency used by clock computation
+*
+*LSE is measured with system clock derived from HSE: deviation of LSE from 32768 Hz is deviation of HSE.
+*RCC_set_HSE_freq is then called, drivers registered to RCC clock hooks (UART, I2C, timers, time base) are re-timed.
+*
+*@param Measurement duration (in ms)
+*@param Pointer to HSE error (in ppm) against RCC_HSE_FREQ, may be NULL
+*@return 0: success, -1: system clock does not derive from HSE, LSE measurement failed or error above CLOCK_CAL_MAX_PPM
+*/
+int8_t CLOCK_calibrate_HSE(uint32_t durationMs, int32_t *errorPpmPtr);
+#endif
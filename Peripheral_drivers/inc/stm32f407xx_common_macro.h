@@ -22,6 +22,19 @@
 #define READ 1
 #define WRITE 0
 
+/*
+*Placement of time critical code and data. Sections are only named here, they are placed by linker script (scatter file)
+*of application, which this repo does not provide:
+*RAM_FUNC: function in section ".RamFunc". It runs from SRAM1 without flash wait states (timing independent of ART cache hits)
+*only if linker script place that section with initialized data, so that startup code copy it to SRAM
+*(e.g. "*(.RamFunc)" in ".data" output section of GCC linker script, or an execution region in SRAM in a scatter file).
+*Otherwise section is linked in flash and function run from flash like any other.
+*CCM_DATA: variable in 64 KB CCM RAM (section ".ccmram", to be zeroed or loaded by startup code), zero wait state for CPU
+*and no contention with DMA on SRAM, but DMA can not reach it. CCM RAM is on data bus only, code can not run from it.
+*/
+#define RAM_FUNC __attribute__((section(".RamFunc"), noinline))
+#define CCM_DATA __attribute__((section(".ccmram")))
+
 /*
 *ARM cortex M4 Processor NVIC IPR register base address
 */
@@ -36,6 +49,22 @@
 #define IRQ_EXTI2 8
 #define IRQ_EXTI3 9
 #define IRQ_EXTI4 10
+#define IRQ_DMA1_STREAM0 11
+#define IRQ_DMA1_STREAM1 12
+#define IRQ_DMA1_STREAM2 13
+#define IRQ_DMA1_STREAM3 14
+#define IRQ_DMA1_STREAM4 15
+#define IRQ_DMA1_STREAM5 16
+#define IRQ_DMA1_STREAM6 17
+#define IRQ_DMA1_STREAM7 47
+#define IRQ_DMA2_STREAM0 56
+#define IRQ_DMA2_STREAM1 57
+#define IRQ_DMA2_STREAM2 58
+#define IRQ_DMA2_STREAM3 59
+#define IRQ_DMA2_STREAM4 60
+#define IRQ_DMA2_STREAM5 68
+#define IRQ_DMA2_STREAM6 69
+#define IRQ_DMA2_STREAM7 70
 #define IRQ_EXTI9_5 23
 #define IRQ_EXTI15_10 40
 #define IRQ_SPI1	35
@@ -53,7 +82,20 @@
 #define IRQ_USART4 52
 #define IRQ_USART5 53
 #define IRQ_USART6 71
+#define IRQ_TIM1_BRK_TIM9 24
+#define IRQ_TIM1_UP_TIM10 25
+#define IRQ_TIM1_TRG_COM_TIM11 26
+#define IRQ_TIM1_CC 27
+#define IRQ_TIM2 28
+#define IRQ_TIM3 29
+#define IRQ_TIM4 30
+#define IRQ_TIM8_BRK_TIM12 43
+#define IRQ_TIM8_UP_TIM13 44
+#define IRQ_TIM8_TRG_COM_TIM14 45
+#define IRQ_TIM8_CC 46
+#define IRQ_TIM5 50
 #define IRQ_TIM6_DAC 54
 #define IRQ_TIM7 55
+#define IRQ_HASH_RNG 80
 
 #endif 
@@ -8,11 +8,67 @@
 *@date 19/08/2019
 */
 
+/**
+*@Version 1.1
+*add following functions:
+*DAC_DMA_start_circular
+*DAC_DMA_stop
+*DAC_intrpt_vector_ctr
+*DAC_intrpt_priority_config
+*DAC_DMA_intrpt_handler
+*DAC_application_event_callback
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*add PCM streaming (8/12 bits, mono or stereo through dual channel registers) at configurable sample rate
+*add DAC_CHANNEL_DUAL option
+*add following functions:
+*DAC_sample_rate_config
+*DAC_PCM_start
+*DAC_PCM_stop
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*add noise/triangle wave generation, software trigger and dual channel write
+*DAC_write store to data holding register precomputed at initilization
+*add following functions:
+*DAC_write_dual
+*DAC_software_trigger
+*19/10/2026
+*/
+
+/**
+*@Version 1.4
+*DMA stream of channel is reserved in DMA driver while it is running, so that it is not allocated to an other request
+*DAC_PCM_start return -1 if stream is allocated to a DMA handle
+*19/10/2026
+*/
+
+/**
+*@Version 1.5
+*PCM streaming hold a stop lock (PWR_LOCK_DAC) from DAC_PCM_start to DAC_PCM_stop
+*19/10/2026
+*/
+
+/**
+*@Version 1.6
+*DMA stream is reserved with DAC handle as owner, DAC_DMA_start_circular return -1 if stream is taken by an other driver
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_DAC_H
 #define STM32F407XX_DAC_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_rcc.h"
+#include "stm32f407xx_timer.h"
+#include "stm32f407xx_dma.h"
+#include "stm32f407xx_pwr.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -26,6 +82,7 @@ Macro definition
 */
 #define DAC_CHANNEL_1	0 /*DAC channel 1 on PA4*/
 #define DAC_CHANNEL_2	1	/*DAC channel 2 on PA5*/
+#define DAC_CHANNEL_DUAL	2	/*both channels, converted together from dual data holding registers (stereo)*/
 
 /*
 *@DAC_RESOLUTION
@@ -62,6 +119,55 @@ Macro definition
 #define DAC_OBUFFER_EN 0
 #define DAC_OBUFFER_DIS 1
 
+/*
+*@DAC_WAVE_GEN
+*DAC wave generation selection, wave is added to value of data holding register on every trigger event
+*/
+#define DAC_WAVE_NONE 0
+#define DAC_WAVE_NOISE 1	/*LFSR noise*/
+#define DAC_WAVE_TRIANGLE 2
+
+/*
+*@DAC_WAVE_AMPLITUDE
+*Unmasked bits of LFSR (noise) or triangle amplitude
+*/
+#define DAC_WAVE_AMPL_1 0	/*noise: LFSR bit 0, triangle: amplitude 1*/
+#define DAC_WAVE_AMPL_3 1
+#define DAC_WAVE_AMPL_7 2
+#define DAC_WAVE_AMPL_15 3
+#define DAC_WAVE_AMPL_31 4
+#define DAC_WAVE_AMPL_63 5
+#define DAC_WAVE_AMPL_127 6
+#define DAC_WAVE_AMPL_255 7
+#define DAC_WAVE_AMPL_511 8
+#define DAC_WAVE_AMPL_1023 9
+#define DAC_WAVE_AMPL_2047 10
+#define DAC_WAVE_AMPL_4095 11	/*noise: LFSR bit 0-11, triangle: amplitude 4095*/
+
+/*
+*@DAC_EVENT
+*Event during DAC DMA transfer
+*/
+#define DAC_EV_DMA_HALF_CMPLT 0	/*first half of circular buffer was transferred*/
+#define DAC_EV_DMA_CMPLT 1	/*second half of circular buffer was transferred*/
+
+/*
+*@DAC_DMA_STREAM
+*DMA1 stream and channel serving DAC requests
+*/
+#define DAC_CH1_DMA_STREAM	DMA1_Stream5
+#define DAC_CH2_DMA_STREAM	DMA1_Stream6
+#define DAC_DMA_CHANNEL	7
+
+/*
+*@DAC_PCM_FORMAT
+*Layout of one PCM sample in memory, selected by resolution, alignment and channel of DAC configuration
+*8 bits mono: uint8_t
+*12 bits mono: uint16_t (right alligned: bit 0-11, left alligned: bit 4-15)
+*8 bits stereo (DAC_CHANNEL_DUAL): uint16_t, channel 1 in bit 0-7, channel 2 in bit 8-15
+*12 bits stereo (DAC_CHANNEL_DUAL): uint32_t, channel 1 in lower half-word, channel 2 in upper half-word (alligned as mono)
+*/
+
 /***********************************************************************
 DAC structure definition
 ***********************************************************************/
@@ -72,11 +178,18 @@ typedef struct{
 	uint8_t alignment;	/*refer to @DAC_12BITS_ALIGNMENT for possible value*/
 	uint8_t triggerEV;	/*refer to @DAC_TRIGGER_EV for possible value*/	
 	uint8_t outputBuffer;	/*refer to @DAC_OUTPUT_BUFFER for possible value*/
+	uint8_t waveGen;	/*refer to @DAC_WAVE_GEN for possible value, require trigger event*/
+	uint8_t waveAmplitude;	/*refer to @DAC_WAVE_AMPLITUDE for possible value*/
 }DAC_Config_t;
 
 typedef struct{
 	DAC_TypeDef *DACxPtr;
 	DAC_Config_t *DACxConfigPtr;
+	volatile uint32_t *DHRxPtr;	/*data holding register matching channel, resolution and alignment, set by DAC_init*/
+	uint16_t dataMask;	/*valid bits of a sample, set by DAC_init*/
+	uint8_t dataShift;	/*shift of a sample into data holding register, set by DAC_init*/
+	uint8_t dualShift;	/*shift of channel 2 sample in dual data holding register (0 if not dual), set by DAC_init*/
+	uint8_t PCMBusy;	/*internal: PCM streaming is running, stop lock is held*/
 }DAC_Handle_t;
 
 /***********************************************************************
@@ -118,9 +231,122 @@ void DAC_deinit(DAC_TypeDef *DACxPtr);
 
 /**
 *@brief write digital value to DAC for conversion
+*
+*Value is stored to data holding register selected at initilization, in dual mode same value is written to both channels.
+*
 *@param Pointer to DAC handle struct
-*@param Pointer to digital value
+*@param Digital value
 *@return none
 */
 void DAC_write(DAC_Handle_t *DACxHandlePtr, uint16_t digiVal);
+
+/**
+*@brief write digital values to both DAC channels with one register store
+*
+*DAC must be initialized with DAC_CHANNEL_DUAL, both channels are updated at the same time.
+*
+*@param Pointer to DAC handle struct
+*@param Digital value of channel 1
+*@param Digital value of channel 2
+*@return none
+*/
+void DAC_write_dual(DAC_Handle_t *DACxHandlePtr, uint16_t ch1Val, uint16_t ch2Val);
+
+/**
+*@brief Generate software trigger event on DAC channel (or both channels in dual mode)
+*
+*DAC must be initialized with DAC_TRIGGER_EV_SW.
+*
+*@param Pointer to DAC handle struct
+*@return none
+*/
+void DAC_software_trigger(DAC_Handle_t *DACxHandlePtr);
+
+/**
+*@brief Start circular DMA transfer from memory buffer to DAC
+*
+*The buffer is sent repeatedly, one sample per trigger event. Half transfer and transfer complete interrupt are enabled 
+*so that application can refill one half of the buffer while the other half is being converted (double buffering).
+*DAC must be initialized with a trigger event (refer to @DAC_TRIGGER_EV).
+*
+*@param Pointer to DAC handle struct
+*@param Pointer to buffer of samples
+*@param Number of samples in buffer
+*@return 0 if success, -1 if stream is allocated to a DMA handle or reserved by an other driver
+*/
+int8_t DAC_DMA_start_circular(DAC_Handle_t *DACxHandlePtr, uint16_t *bufferPtr, uint16_t Length);
+
+/**
+*@brief Stop DMA transfer to DAC
+*@param Pointer to DAC handle struct
+*@return none
+*/
+void DAC_DMA_stop(DAC_Handle_t *DACxHandlePtr);
+
+/**
+*@brief Enable or disable DAC DMA stream 's interrupt vector in NVIC 
+*@param IRQ number
+*@param Enable or disable action
+*@return none
+*/
+void DAC_intrpt_vector_ctr (uint8_t IRQnumber, uint8_t enOrDis);
+
+/**
+*@brief Config priority for DAC DMA stream 's interrupt 
+*@param IRQ number
+*@param Priority
+*@return none
+*/
+void DAC_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority);
+
+/**
+*@brief DAC DMA stream interrupt handler
+*@param Pointer to DAC handle struct
+*@return none
+*/
+void DAC_DMA_intrpt_handler (DAC_Handle_t *DACxHandlePtr);
+
+/**
+*@brief Config timer selected as DAC trigger event to overflow at given sample rate
+*
+*Only TIM6 and TIM7 trigger event are supported. Timer is configured but not started.
+*
+*@param Pointer to DAC handle struct
+*@param Sample rate (in Hz)
+*@return Actual sample rate (in Hz), -1 if trigger event is not supported or sample rate is out of range
+*/
+int32_t DAC_sample_rate_config(DAC_Handle_t *DACxHandlePtr, uint32_t sampleRate);
+
+/**
+*@brief Start streaming PCM samples from a ping-pong buffer to DAC
+*
+*This config trigger timer at given sample rate, start circular DMA transfer with transfer size matching sample format (refer to @DAC_PCM_FORMAT), 
+*then start trigger timer. DAC_application_event_callback is called with DAC_EV_DMA_HALF_CMPLT when first half of buffer may be refilled, 
+*and with DAC_EV_DMA_CMPLT when second half of buffer may be refilled. Stop mode is prevented until DAC_PCM_stop.
+*
+*@param Pointer to DAC handle struct
+*@param Pointer to buffer of samples
+*@param Number of samples in buffer (both halves, a stereo sample count as one)
+*@param Sample rate (in Hz)
+*@return Actual sample rate (in Hz), -1 if stream can not be started
+*/
+int32_t DAC_PCM_start(DAC_Handle_t *DACxHandlePtr, const void *bufferPtr, uint16_t sampleCount, uint32_t sampleRate);
+
+/**
+*@brief Stop streaming PCM samples to DAC
+*
+*This stop trigger timer and DMA transfer, DAC output hold last sample.
+*
+*@param Pointer to DAC handle struct
+*@return none
+*/
+void DAC_PCM_stop(DAC_Handle_t *DACxHandlePtr);
+
+/**
+*@brief Inform application of DAC event
+*@param Pointer to DAC handle struct
+*@param Event macro (refer to @DAC_EVENT)
+*@return none
+*/
+void DAC_application_event_callback (DAC_Handle_t *DACxHandlePtr,uint8_t event);
 #endif
\ No newline at end of file
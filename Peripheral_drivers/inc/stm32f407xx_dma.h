@@ -0,0 +1,332 @@
+/**
+*@file stm32f407xx_dma.h
+*@brief provide APIs for DMA controllers (DMA1, DMA2) of stm32f407xx MCUs.
+*
+*This header file provide APIs for allocating a DMA stream to a peripheral request and running transfers on it.
+*Request map of reference manual (which stream and channel of which controller serve each request) is built in:
+*DMA_init take first free stream serving requested peripheral, so application does not need to track stream usage.
+*Normal, circular and double buffer modes, FIFO threshold and bursts are configured per stream. Half transfer, transfer complete
+*and error events are dispatched to a callback registered with stream.
+*
+*@note Stream interrupt handler is to be defined by application for streams it may get (refer to DMA_init return value),
+*and call DMA_intrpt_handler with IRQ number of stream. Drivers which drive fixed streams themselves (DAC, capture, pulse train,
+*led dimming engine) reserve them, so that they are never allocated to an other request nor shared by two drivers.
+*Buzzer define DMA1 stream 5 and 6 interrupt handlers and forward the stream it does not use to DMA_intrpt_handler.
+*Only DMA2 can do memory to memory transfers, and only DMA2 reach AHB1 peripherals (GPIO) through its peripheral port.
+*DMA can not reach CCM RAM.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_DMA_H
+#define STM32F407XX_DMA_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@DMA_REQUEST
+*Peripheral requests, refer to DMA1 and DMA2 request mapping in reference manual
+*/
+#define DMA_REQ_MEM2MEM 0	/*memory to memory, any DMA2 stream*/
+#define DMA_REQ_SPI1_RX 1
+#define DMA_REQ_SPI1_TX 2
+#define DMA_REQ_SPI2_RX 3
+#define DMA_REQ_SPI2_TX 4
+#define DMA_REQ_SPI3_RX 5
+#define DMA_REQ_SPI3_TX 6
+#define DMA_REQ_I2C1_RX 7
+#define DMA_REQ_I2C1_TX 8
+#define DMA_REQ_I2C2_RX 9
+#define DMA_REQ_I2C2_TX 10
+#define DMA_REQ_I2C3_RX 11
+#define DMA_REQ_I2C3_TX 12
+#define DMA_REQ_USART1_RX 13
+#define DMA_REQ_USART1_TX 14
+#define DMA_REQ_USART2_RX 15
+#define DMA_REQ_USART2_TX 16
+#define DMA_REQ_USART3_RX 17
+#define DMA_REQ_USART3_TX 18
+#define DMA_REQ_UART4_RX 19
+#define DMA_REQ_UART4_TX 20
+#define DMA_REQ_UART5_RX 21
+#define DMA_REQ_UART5_TX 22
+#define DMA_REQ_USART6_RX 23
+#define DMA_REQ_USART6_TX 24
+#define DMA_REQ_ADC1 25
+#define DMA_REQ_ADC2 26
+#define DMA_REQ_ADC3 27
+#define DMA_REQ_DAC1 28
+#define DMA_REQ_DAC2 29
+#define DMA_REQ_SDIO 30
+#define DMA_REQ_DCMI 31
+#define DMA_REQ_TIM1_UP 32
+#define DMA_REQ_TIM1_CH1 33
+#define DMA_REQ_TIM1_CH2 34
+#define DMA_REQ_TIM1_CH3 35
+#define DMA_REQ_TIM1_CH4 36
+#define DMA_REQ_TIM2_UP 37
+#define DMA_REQ_TIM2_CH1 38
+#define DMA_REQ_TIM2_CH2 39
+#define DMA_REQ_TIM2_CH3 40
+#define DMA_REQ_TIM2_CH4 41
+#define DMA_REQ_TIM3_UP 42
+#define DMA_REQ_TIM3_CH1 43
+#define DMA_REQ_TIM3_CH2 44
+#define DMA_REQ_TIM3_CH3 45
+#define DMA_REQ_TIM3_CH4 46
+#define DMA_REQ_TIM4_UP 47
+#define DMA_REQ_TIM4_CH1 48
+#define DMA_REQ_TIM4_CH2 49
+#define DMA_REQ_TIM4_CH3 50
+#define DMA_REQ_TIM5_UP 51
+#define DMA_REQ_TIM5_CH1 52
+#define DMA_REQ_TIM5_CH2 53
+#define DMA_REQ_TIM5_CH3 54
+#define DMA_REQ_TIM5_CH4 55
+#define DMA_REQ_TIM6_UP 56
+#define DMA_REQ_TIM7_UP 57
+#define DMA_REQ_TIM8_UP 58
+#define DMA_REQ_TIM8_CH1 59
+#define DMA_REQ_TIM8_CH2 60
+#define DMA_REQ_TIM8_CH3 61
+#define DMA_REQ_TIM8_CH4 62
+
+/*
+*@DMA_DIR
+*Transfer direction
+*/
+#define DMA_DIR_P2M 0	/*peripheral to memory*/
+#define DMA_DIR_M2P 1	/*memory to peripheral*/
+#define DMA_DIR_M2M 2	/*memory to memory, peripheral address is source address*/
+
+/*
+*@DMA_SIZE
+*Data size of one transfer on peripheral or memory side
+*/
+#define DMA_SIZE_BYTE 0
+#define DMA_SIZE_HALFWORD 1
+#define DMA_SIZE_WORD 2
+
+/*
+*@DMA_MODE
+*Transfer mode
+*/
+#define DMA_MODE_NORMAL 0	/*stream stop after last transfer*/
+#define DMA_MODE_CIRCULAR 1	/*stream restart from beginning of buffer after last transfer*/
+#define DMA_MODE_DOUBLE_BUFFER 2	/*stream switch between memory 0 and memory 1 after last transfer, idle buffer may be changed*/
+
+/*
+*@DMA_PRIORITY
+*Priority of stream among streams of same controller
+*/
+#define DMA_PRIORITY_LOW 0
+#define DMA_PRIORITY_MEDIUM 1
+#define DMA_PRIORITY_HIGH 2
+#define DMA_PRIORITY_VERY_HIGH 3
+
+/*
+*@DMA_FIFO
+*FIFO (4 words) threshold, direct mode write each peripheral request straight through
+*/
+#define DMA_FIFO_DIRECT 0	/*not allowed for memory to memory, FIFO full threshold is then used*/
+#define DMA_FIFO_1_4 1
+#define DMA_FIFO_1_2 2
+#define DMA_FIFO_3_4 3
+#define DMA_FIFO_FULL 4
+
+/*
+*@DMA_BURST
+*Number of beats of a burst, bursts need FIFO mode and must fit FIFO threshold
+*/
+#define DMA_BURST_SINGLE 0
+#define DMA_BURST_INC4 1
+#define DMA_BURST_INC8 2
+#define DMA_BURST_INC16 3
+
+/*
+*@DMA_EVENT
+*Stream event reported to callback
+*/
+#define DMA_EV_HALF_CMPLT 0	/*half of data items were transferred*/
+#define DMA_EV_CMPLT 1	/*all data items were transferred (end of one buffer in circular and double buffer modes)*/
+#define DMA_EV_ERROR 2	/*bus error (stream is disabled by hardware) or direct mode error*/
+
+#define DMA_STREAM_NUM 16	/*stream index 0 - 7 is DMA1 stream 0 - 7, 8 - 15 is DMA2 stream 0 - 7*/
+#define DMA_IRQ_PRIORITY 5
+
+/***********************************************************************
+DMA structure definition
+***********************************************************************/
+
+typedef void (*DMA_Callback_t)(uint8_t event, void *argPtr);
+
+typedef struct{
+	uint8_t request;	/*refer to @DMA_REQUEST for possible value*/
+	uint8_t direction;	/*refer to @DMA_DIR for possible value*/
+	uint8_t periphSize;	/*refer to @DMA_SIZE for possible value (source size in memory to memory)*/
+	uint8_t memSize;	/*refer to @DMA_SIZE for possible value*/
+	uint8_t periphInc;	/*ENABLE to increment peripheral address after each transfer (source address in memory to memory)*/
+	uint8_t memInc;	/*ENABLE to increment memory address after each transfer*/
+	uint8_t mode;	/*refer to @DMA_MODE for possible value*/
+	uint8_t priority;	/*refer to @DMA_PRIORITY for possible value*/
+	uint8_t FIFOThreshold;	/*refer to @DMA_FIFO for possible value*/
+	uint8_t periphBurst;	/*refer to @DMA_BURST for possible value*/
+	uint8_t memBurst;	/*refer to @DMA_BURST for possible value*/
+	DMA_Callback_t callback;	/*function called on stream events (interrupt context), NULL for no interrupt*/
+	void *argPtr;	/*argument passed to callback*/
+}DMA_Config_t;
+
+typedef struct{
+	DMA_Config_t *DMAConfigPtr;
+	DMA_TypeDef *DMAxPtr;	/*internal: controller of allocated stream*/
+	DMA_Stream_TypeDef *streamPtr;	/*internal: allocated stream, NULL if none*/
+	uint8_t streamIdx;	/*internal: refer to DMA_STREAM_NUM*/
+	uint8_t channel;	/*internal: channel of stream serving request*/
+	uint32_t CRVal;	/*internal: stream configuration, without enable bit*/
+}DMA_Handle_t;
+
+/***********************************************************************
+DMA APIs prototype
+***********************************************************************/
+
+/**
+*@brief Allocate a stream serving configured request and configure it
+*
+*Stream interrupt vector is enabled (priority DMA_IRQ_PRIORITY) when a callback is given.
+*
+*@param Pointer to DMA handle struct
+*@return Stream index (0 - 7: DMA1 stream 0 - 7, 8 - 15: DMA2 stream 0 - 7), -1 if configuration is invalid or no stream is free
+*/
+int8_t DMA_init(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Apply changed configuration (data sizes, increments, mode, priority, FIFO, bursts) to allocated stream
+*
+*Stream must be idle. Request must not change, interrupt vector of stream is only enabled by DMA_init (if a callback is given).
+*
+*@param Pointer to DMA handle struct
+*@return 0: success, -1: configuration is invalid
+*/
+int8_t DMA_reconfig(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Stop transfer and release stream
+*@param Pointer to DMA handle struct
+*@return none
+*/
+void DMA_deinit(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Start a transfer
+*
+*In memory to memory mode, peripheral address is source and memory 0 is destination.
+*
+*@param Pointer to DMA handle struct
+*@param Peripheral register address (source address in memory to memory)
+*@param Memory 0 address
+*@param Memory 1 address (double buffer mode only, NULL otherwise)
+*@param Number of data items (1 - 65535), counted in peripheral data size
+*@return none
+*/
+void DMA_start(DMA_Handle_t *DMAHandlePtr, volatile void *periphPtr, void *mem0Ptr, void *mem1Ptr, uint16_t length);
+
+/**
+*@brief Stop transfer, stream is kept allocated
+*@param Pointer to DMA handle struct
+*@return none
+*/
+void DMA_stop(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Check whether a transfer is running
+*@param Pointer to DMA handle struct
+*@return 1 if stream is enabled, 0 otherwise
+*/
+uint8_t DMA_is_busy(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Get number of data items left to transfer
+*@param Pointer to DMA handle struct
+*@return Data items left (in current buffer for circular and double buffer modes)
+*/
+uint16_t DMA_get_remaining(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Get memory being accessed by stream in double buffer mode
+*@param Pointer to DMA handle struct
+*@return 0: memory 0, 1: memory 1
+*/
+uint8_t DMA_get_current_memory(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Change address of idle memory in double buffer mode
+*@param Pointer to DMA handle struct
+*@param Memory number (0 or 1)
+*@param Memory address
+*@return 0: success, -1: memory is being accessed by stream
+*/
+int8_t DMA_set_memory(DMA_Handle_t *DMAHandlePtr, uint8_t memNo, void *memPtr);
+
+/**
+*@brief Get IRQ number of allocated stream
+*@param Pointer to DMA handle struct
+*@return IRQ number (refer to IRQ number in stm32f407xx_common_macro.h)
+*/
+uint8_t DMA_get_IRQ_number(DMA_Handle_t *DMAHandlePtr);
+
+/**
+*@brief Get stream of a controller
+*@param DMA1 or DMA2
+*@param Stream number (0 - 7)
+*@return Stream (e.g. DMA1_Stream5)
+*/
+DMA_Stream_TypeDef* DMA_get_stream(DMA_TypeDef *DMAxPtr, uint8_t streamNo);
+
+/**
+*@brief Reserve a stream driven directly by a driver, it is then never allocated by DMA_init nor reserved by an other owner
+*@param Stream (e.g. DMA1_Stream5)
+*@param Owner of reservation (handle of driver), not NULL
+*@return 0: success (or already reserved by same owner), -1: stream is allocated to a DMA handle or reserved by an other owner
+*/
+int8_t DMA_stream_reserve(DMA_Stream_TypeDef *streamPtr, const void *ownerPtr);
+
+/**
+*@brief Release a reserved stream, nothing is done if stream is reserved by an other owner
+*@param Stream
+*@param Owner of reservation
+*@return none
+*/
+void DMA_stream_release(DMA_Stream_TypeDef *streamPtr, const void *ownerPtr);
+
+/**
+*@brief Enable or disable DMA stream 's interrupt vector in NVIC
+*@param IRQ number
+*@param Enable or disable
+*@return none
+*/
+void DMA_intrpt_vector_ctr(uint8_t IRQnumber, uint8_t enOrDis);
+
+/**
+*@brief Config priority for DMA stream 's interrupt
+*@param IRQ number
+*@param Priority
+*@return none
+*/
+void DMA_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority);
+
+/**
+*@brief DMA stream interrupt handler, dispatch events of stream to its callback
+*@note Flags of a stream not allocated to a DMA handle (free or reserved) are left untouched
+*@param IRQ number of stream
+*@return none
+*/
+void DMA_intrpt_handler(uint8_t IRQNumber);
+#endif
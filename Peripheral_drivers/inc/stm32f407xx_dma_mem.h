@@ -0,0 +1,111 @@
+/**
+*@file stm32f407xx_dma_mem.h
+*@brief provide asynchronous memory copy and fill on a DMA2 memory to memory stream of stm32f407xx MCUs.
+*
+*This header file provide APIs for copying and filling memory in background, so that large copies (framebuffer bands, sample blocks,
+*buffer clears) overlap with computation. Requests are queued and served in order by one DMA2 stream (stm32f407xx_dma) in FIFO mode:
+*data size and bursts of each request are chosen from alignment of addresses and length (16 bytes aligned: 4 words bursts).
+*Short requests, requests before DMAMEM_init and requests touching CCM RAM (not reachable by DMA) are done by CPU right away.
+*A stop lock (PWR_LOCK_DMA) is held while requests are pending.
+*
+*@note Request struct is owned by caller and must stay valid until request is done. Buffers of a pending request must not be touched,
+*and source and destination must not overlap. A request done by CPU is done ahead of pending DMA requests.
+*Interrupt handler of stream returned by DMAMEM_init is to be defined by application and call DMA_intrpt_handler.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_DMA_MEM_H
+#define STM32F407XX_DMA_MEM_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_dma.h"
+#include "stm32f407xx_pwr.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+#define DMAMEM_CPU_THRESHOLD 64	/*requests shorter than this (in bytes) are done by CPU, DMA setup and interrupt cost more*/
+
+/*
+*@DMAMEM_STATE
+*State of a request
+*/
+#define DMAMEM_STATE_IDLE 0	/*never submitted*/
+#define DMAMEM_STATE_PENDING 1	/*queued or being transferred*/
+#define DMAMEM_STATE_DONE 2
+#define DMAMEM_STATE_ERROR 3	/*bus error, part of destination may not be written*/
+
+/***********************************************************************
+DMAMEM structure definition
+***********************************************************************/
+
+typedef void (*DMAMEM_Callback_t)(void *argPtr);
+
+typedef struct DMAMEM_Request{
+	struct DMAMEM_Request *nextPtr;	/*internal: next request in queue*/
+	uint8_t *dstPtr;	/*internal: next byte to write*/
+	const uint8_t *srcPtr;	/*internal: next byte to read, NULL for fill*/
+	uint32_t remaining;	/*internal: bytes left*/
+	uint32_t value;	/*internal: fill word, read by DMA*/
+	volatile uint8_t state;	/*refer to @DMAMEM_STATE*/
+	DMAMEM_Callback_t callback;	/*internal: function called when request is done (interrupt context for DMA requests)*/
+	void *argPtr;	/*internal: argument passed to callback*/
+}DMAMEM_Request_t;
+
+/***********************************************************************
+DMAMEM APIs prototype
+***********************************************************************/
+
+/**
+*@brief Allocate a DMA2 stream for memory copies
+*@param none
+*@return Stream index (refer to DMA_init), -1 if no DMA2 stream is free
+*/
+int8_t DMAMEM_init(void);
+
+/**
+*@brief Copy memory in background
+*@param Pointer to request struct
+*@param Pointer to destination
+*@param Pointer to source
+*@param Number of bytes
+*@param Function called when copy is done, NULL for none
+*@param Argument passed to callback
+*@return 0: request is queued, 1: copy was done by CPU (callback was called), -1: request struct is still pending
+*/
+int8_t DMAMEM_memcpy(DMAMEM_Request_t *reqPtr, void *dstPtr, const void *srcPtr, uint32_t len, DMAMEM_Callback_t callback, void *argPtr);
+
+/**
+*@brief Fill memory with a 32-bits value in background
+*@param Pointer to request struct
+*@param Pointer to destination
+*@param Value
+*@param Number of words
+*@param Function called when fill is done, NULL for none
+*@param Argument passed to callback
+*@return 0: request is queued, 1: fill was done by CPU (callback was called), -1: request struct is still pending
+*/
+int8_t DMAMEM_memset32(DMAMEM_Request_t *reqPtr, uint32_t *dstPtr, uint32_t value, uint32_t wordNum, DMAMEM_Callback_t callback, void *argPtr);
+
+/**
+*@brief Get state of a request
+*@param Pointer to request struct
+*@return State (refer to @DMAMEM_STATE)
+*/
+uint8_t DMAMEM_get_state(DMAMEM_Request_t *reqPtr);
+
+/**
+*@brief Wait until a request is done
+*@note Stream interrupt must be able to preempt caller
+*@param Pointer to request struct
+*@return 0: done, -1: bus error
+*/
+int8_t DMAMEM_wait(DMAMEM_Request_t *reqPtr);
+#endif
@@ -0,0 +1,125 @@
+/**
+*@file stm32f407xx_drbg.h
+*@brief provide fast software random generators seeded from hardware RNG.
+*
+*This header file provide APIs for a ChaCha20 based deterministic random bit generator (DRBG) and a xoshiro128** generator.
+*Generators are seeded and periodically reseeded from an entropy callback, which is RNG_get (stm32f407xx_rng) on target.
+*ChaCha20 DRBG output ChaCha20 keystream (20 rounds, 64 bits block counter, nonce 0) of a 256 bits key. Key is replaced by
+*first half of next block every 16 blocks and at end of each DRBG_fill (fast key erasure), and served bytes are erased from
+*block buffer, so that state read later does not reveal previous output. It is suited to nonces, keys and IVs.
+*xoshiro128** is not cryptographic: it is for simulation, jitter and test data, about 4 times faster than ChaCha20.
+*
+*@note Module depend on no peripheral and build on host (known answer test: Test_applications/test_drbg.c).
+*A handle is not to be used from thread and interrupt context at same time.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_DRBG_H
+#define STM32F407XX_DRBG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@DRBG_TYPE
+*Generator algorithm
+*/
+#define DRBG_TYPE_CHACHA20 0
+#define DRBG_TYPE_XOSHIRO 1
+
+/*
+*@DRBG_RESEED
+*Reseed interval (in bytes of output)
+*/
+#define DRBG_RESEED_DEFAULT 0x100000	/*1 MB*/
+#define DRBG_RESEED_NEVER 0	/*generator is only seeded by DRBG_init, DRBG_seed or DRBG_reseed*/
+
+#define DRBG_SEED_WORDS_MAX 8	/*256 bits key of ChaCha20, xoshiro128** use 4 words*/
+
+/***********************************************************************
+DRBG structure definition
+***********************************************************************/
+
+typedef uint32_t (*DRBG_Entropy_t)(void);	/*return a 32-bits word of true random data*/
+
+typedef struct{
+	uint8_t type;	/*refer to @DRBG_TYPE for possible value*/
+	DRBG_Entropy_t entropy;	/*entropy source, e.g. RNG_get, NULL for deterministic output only*/
+	uint32_t reseedInterval;	/*refer to @DRBG_RESEED, reseed happen at start of first call past interval*/
+}DRBG_Config_t;
+
+typedef struct{
+	DRBG_Config_t *DRBGConfigPtr;
+	uint32_t state[DRBG_SEED_WORDS_MAX + 2];	/*internal: ChaCha20 key and block counter, or xoshiro128** state*/
+	uint32_t block[16];	/*internal: ChaCha20 keystream block*/
+	uint8_t blockIdx;	/*internal: next byte served from block, 64 if block is used up*/
+	uint8_t blockNum;	/*internal: blocks generated since key was replaced*/
+	uint32_t outputNum;	/*internal: bytes generated since last reseed*/
+}DRBG_Handle_t;
+
+/***********************************************************************
+DRBG APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize generator and seed it from entropy callback
+*@param Pointer to DRBG handle struct
+*@return 0: success, -1: invalid type or no entropy callback
+*/
+int8_t DRBG_init(DRBG_Handle_t *DRBGHandlePtr);
+
+/**
+*@brief Seed generator with given words, output is then reproducible until next reseed
+*
+*ChaCha20 seed is the key (missing words are 0) and block counter restart from 0. xoshiro128** seed is its state,
+*an all zero state is replaced by a non zero one.
+*
+*@param Pointer to DRBG handle struct
+*@param Pointer to seed words
+*@param Number of seed words (up to DRBG_SEED_WORDS_MAX)
+*@return none
+*/
+void DRBG_seed(DRBG_Handle_t *DRBGHandlePtr, const uint32_t *seedPtr, uint8_t wordNum);
+
+/**
+*@brief Mix fresh words from entropy callback into generator state
+*@param Pointer to DRBG handle struct
+*@return 0: success, -1: no entropy callback
+*/
+int8_t DRBG_reseed(DRBG_Handle_t *DRBGHandlePtr);
+
+/**
+*@brief Fill a buffer with random bytes
+*
+*Bulk output is generated block by block (ChaCha20) or word by word (xoshiro128**) straight into buffer,
+*so that cost per byte does not depend on request size.
+*
+*@param Pointer to DRBG handle struct
+*@param Pointer to buffer
+*@param Number of bytes
+*@return none
+*/
+void DRBG_fill(DRBG_Handle_t *DRBGHandlePtr, void *bufferPtr, uint32_t len);
+
+/**
+*@brief Get a 32-bits random value
+*@param Pointer to DRBG handle struct
+*@return 32-bits random value
+*/
+uint32_t DRBG_get(DRBG_Handle_t *DRBGHandlePtr);
+
+/**
+*@brief Get a random value uniformly distributed in [0, range)
+*@param Pointer to DRBG handle struct
+*@param Range (not 0)
+*@return Random value lower than range
+*/
+uint32_t DRBG_get_range(DRBG_Handle_t *DRBGHandlePtr, uint32_t range);
+#endif
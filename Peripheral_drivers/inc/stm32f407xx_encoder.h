@@ -0,0 +1,136 @@
+/**
+*@file stm32f407xx_encoder.h
+*@brief provide quadrature encoder position and velocity measurement on stm32f407xx MCUs.
+*
+*This header file provide APIs for reading a quadrature encoder with a timer in encoder interface mode, position is counted entirely by hardware
+*and extended to 32 bits in software.
+*Velocity is estimated each time ENCODER_update is called (at fixed rate updateFreq):
+*	without timestamp timer: counts per update interval (M method), resolution is updateFreq counts per second.
+*	with timestamp timer: counts between the last A edges of two updates divided by exact time between these edges (M/T method).
+*	Encoder timer capture its counter on each A edge and send a trigger pulse (TRGO) to timestamp timer, which capture its own counter on
+*	the same edge, so both position and time of the edge are latched by hardware. Between updates without edge, velocity is bounded by
+*	last counts over time elapsed since last edge, and drop to 0 after ENCODER_STOP_TIMEOUT_MS.
+*
+*@note Encoder timer: TIM1-TIM5 or TIM8 (channel 1 and 2 inputs), timestamp timer: another one of TIM1-TIM5, TIM8 connected by internal trigger.
+*GPIO pins of encoder inputs are to be configured in alternate function mode by user application.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_ENCODER_H
+#define STM32F407XX_ENCODER_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_timer.h"
+#include "stm32f407xx_pwr.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@ENCODER_TIMING
+*Velocity estimator timing
+*/
+#define ENCODER_STOP_TIMEOUT_MS 500	/*velocity is 0 when no A edge occur for this time*/
+
+/***********************************************************************
+Encoder structure definition
+***********************************************************************/
+
+typedef struct{
+	uint8_t mode;	/*TIM_SLAVE_MODE_ENCODER_1, TIM_SLAVE_MODE_ENCODER_2 or TIM_SLAVE_MODE_ENCODER_3 (refer to @TIM_SLAVE_MODE)*/
+	uint8_t polarityA;	/*TIM_IC_POLARITY_RISING (non-inverted) or TIM_IC_POLARITY_FALLING (inverted)*/
+	uint8_t polarityB;	/*TIM_IC_POLARITY_RISING (non-inverted) or TIM_IC_POLARITY_FALLING (inverted)*/
+	uint8_t filter;	/*0 (no filter) to 15, refer to ICxF bits in reference manual*/
+	uint32_t countsPerRev;	/*counts per revolution in selected mode (x4 in mode 3), used for speed in rpm*/
+	uint32_t updateFreq;	/*rate (in Hz) at which ENCODER_update is called*/
+	TIM_TypeDef *timestampTIMxPtr;	/*free running timer timestamping A edges, NULL for counts per interval only*/
+	uint8_t timestampChannel;	/*capture channel of timestamp timer (refer to @TIM_CHANNEL)*/
+	uint32_t timestampFreq;	/*timestamp timer counter frequency (in Hz)*/
+}ENCODER_Config_t;
+
+typedef struct{
+	TIM_TypeDef *TIMxPtr;
+	ENCODER_Config_t *ENCODERConfigPtr;
+	int32_t position;	/*internal: position (in count) at last update*/
+	int32_t velocity;	/*internal: velocity (in 0.01 count per second) at last update*/
+	uint32_t lastCount;	/*internal: encoder counter value at last update*/
+	uint32_t countMask;	/*internal: encoder counter range*/
+	uint32_t timestampFreq;	/*internal: actual timestamp counter frequency*/
+	uint32_t timestampMask;	/*internal: timestamp counter range*/
+	int32_t lastEdgePos;	/*internal: position at last A edge*/
+	uint32_t lastEdgeTime;	/*internal: timestamp of last A edge*/
+	int32_t lastEdgeDelta;	/*internal: counts between two last A edges used for velocity*/
+	uint32_t lastUpdateTime;	/*internal: timestamp counter value at last update*/
+	uint32_t idleTicks;	/*internal: timestamp ticks from last A edge to last update*/
+	uint8_t edgeValid;	/*internal: last A edge can start a measurement*/
+	uint8_t busy;	/*internal: timers are running, stop lock is held*/
+}ENCODER_Handle_t;
+
+/***********************************************************************
+Encoder APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize encoder timer and timestamp timer, then start them
+*
+*Timers do not count in stop mode, so stop mode is prevented until ENCODER_stop (PWR_LOCK_ENCODER).
+*A running encoder is to be stopped before being initialized again.
+*
+*@param Pointer to encoder handle struct
+*@return 0 if success, -1 if timers are not supported or not connected by internal trigger
+*/
+int8_t ENCODER_init(ENCODER_Handle_t *ENCODERHandlePtr);
+
+/**
+*@brief Stop encoder timer and timestamp timer, position and velocity keep their last update
+*@param Pointer to encoder handle struct
+*@return none
+*/
+void ENCODER_stop(ENCODER_Handle_t *ENCODERHandlePtr);
+
+/**
+*@brief Update position and velocity, to be called at updateFreq (from a periodic timer interrupt for example)
+*
+*Interval between 2 calls must be shorter than half of encoder counter range in counts,
+*and shorter than timestamp counter range in time.
+*
+*@param Pointer to encoder handle struct
+*@return none
+*/
+void ENCODER_update(ENCODER_Handle_t *ENCODERHandlePtr);
+
+/**
+*@brief Get position at last update
+*@param Pointer to encoder handle struct
+*@return Position (in count)
+*/
+int32_t ENCODER_get_position(ENCODER_Handle_t *ENCODERHandlePtr);
+
+/**
+*@brief Set position, for example at reference (index) position
+*@param Pointer to encoder handle struct
+*@param New position (in count)
+*@return none
+*/
+void ENCODER_set_position(ENCODER_Handle_t *ENCODERHandlePtr, int32_t position);
+
+/**
+*@brief Get velocity at last update
+*@param Pointer to encoder handle struct
+*@return Velocity (in 0.01 count per second), positive when counting up
+*/
+int32_t ENCODER_get_velocity(ENCODER_Handle_t *ENCODERHandlePtr);
+
+/**
+*@brief Get shaft speed at last update
+*@param Pointer to encoder handle struct
+*@return Speed (in 0.01 rpm), positive when counting up
+*/
+int32_t ENCODER_get_rpm(ENCODER_Handle_t *ENCODERHandlePtr);
+#endif
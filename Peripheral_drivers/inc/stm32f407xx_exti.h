@@ -0,0 +1,111 @@
+/**
+*@file stm32f407xx_exti.h
+*@brief provide per-pin external interrupt dispatch on stm32f407xx MCUs.
+*
+*This header file provide APIs for registering a callback on each of the 16 EXTI lines (GPIO pin n of any port drive line n).
+*IRQ handlers of EXTI vectors call EXTI_intrpt_handler, which take a timestamp and scan pending lines of the vector with CLZ,
+*so shared vectors (lines 5 - 9 and 10 - 15) are demultiplexed in one pass, highest line first.
+*A line may be debounced: it is triggered on both edges, first edge mask the line and start a software timer, pin level is read
+*when timer expire and callback is called only if level changed to the one of selected edge, with timestamp of first edge.
+*A oneshot line is disarmed after its callback, EXTI_arm re-arm it without reconfiguring pin.
+*
+*@note Pin is to be configured as input by user application. Timestamps come from stm32f407xx_time module (TIME_init is called on
+*first registration), debouncing use stm32f407xx_soft_timer service which is to be initialized by user application (SWTIM_init).
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_EXTI_H
+#define STM32F407XX_EXTI_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_gpio.h"
+#include "stm32f407xx_time.h"
+#include "stm32f407xx_soft_timer.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@EXTI_LINE
+*Number of EXTI lines connected to GPIO pins
+*/
+#define EXTI_LINE_NUM 16
+
+/*
+*@EXTI_IRQ
+*Priority of EXTI vectors enabled by EXTI_register
+*/
+#define EXTI_IRQ_PRIORITY 5
+
+/***********************************************************************
+EXTI structure definition
+***********************************************************************/
+
+/*line number (same as pin number), pin level after edge (debounced level if debounce is used), time of edge (in microsecond), user argument*/
+typedef void (*EXTI_Callback_t)(uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr);
+
+typedef struct{
+	GPIO_TypeDef *GPIOxPtr;	/*port of pin driving line*/
+	uint8_t edge;	/*GPIO_MODE_INTRPT_FE, GPIO_MODE_INTRPT_RE or GPIO_MODE_INTRPT_RFE (refer to @GPIO_MODE)*/
+	uint8_t oneshot;	/*ENABLE: line is disarmed after callback until EXTI_arm*/
+	uint32_t debounceUs;	/*time (in microsecond) pin must be stable, 0 for no debouncing*/
+	EXTI_Callback_t callback;
+	void *argPtr;	/*argument passed to callback*/
+}EXTI_Config_t;
+
+/***********************************************************************
+EXTI APIs prototype
+***********************************************************************/
+
+/**
+*@brief Register callback of a line, then arm line and enable its vector
+*
+*Config struct is kept by reference, it must stay valid while line is registered.
+*
+*@param Line number (0 - 15)
+*@param Pointer to line config struct
+*@return 0 if success, -1 if line number is invalid
+*/
+int8_t EXTI_register(uint8_t line, const EXTI_Config_t *EXTIConfigPtr);
+
+/**
+*@brief Disarm a line and remove its callback, vector is left enabled (it may be shared)
+*@param Line number (0 - 15)
+*@return none
+*/
+void EXTI_unregister(uint8_t line);
+
+/**
+*@brief Arm a registered line: clear its pending edge and unmask it
+*@param Line number (0 - 15)
+*@return none
+*/
+void EXTI_arm(uint8_t line);
+
+/**
+*@brief Disarm a line: mask it and cancel debouncing in progress
+*@param Line number (0 - 15)
+*@return none
+*/
+void EXTI_disarm(uint8_t line);
+
+/**
+*@brief Check whether a line is armed
+*@param Line number (0 - 15)
+*@return 1 if armed, 0 otherwise
+*/
+uint8_t EXTI_is_armed(uint8_t line);
+
+/**
+*@brief EXTI interrupt handler, to be called from IRQ handler of EXTI vector
+*@param IRQ number of vector: IRQ_EXTI0 - IRQ_EXTI4, IRQ_EXTI9_5 or IRQ_EXTI15_10
+*@return none
+*/
+void EXTI_intrpt_handler(uint8_t IRQNumber);
+#endif
@@ -8,12 +8,44 @@
 *@date 23/07/2019
 */
 
+/**
+*@Version 1.1
+*GPIO_write_pin and GPIO_toggle_pin write BSRR with a single store (atomic against interrupts)
+*add following functions:
+*GPIO_write_pins
+*GPIO_write_masked
+*GPIO_toggle_pins
+*GPIO_fast_set_pin
+*GPIO_fast_clear_pin
+*GPIO_fast_write_pins
+*GPIO_fast_write_masked
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*GPIO_Intrpt_handler only clear pending bit of given pin
+*add following functions:
+*GPIO_EXTI_line_config
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*add pin tables folded at compile time into per port register values (GPIO_PORT_TABLE)
+*add following functions:
+*GPIO_table_apply
+*GPIO_table_release
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_GPIO_H
 #define STM32F407XX_GPIO_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "stm32f407xx_common_macro.h"
 #include <stdint.h>
+#include <stdlib.h>
 
 /*
 *@GPIO_PIN_NO
@@ -72,6 +104,47 @@
 #define GPIO_PU 1
 #define GPIO_PDR 2
 
+/*
+*@GPIO_PORT
+*GPIO port index used by pin tables (same order as port clock enable bits)
+*/
+#define GPIO_PORT_A 0
+#define GPIO_PORT_B 1
+#define GPIO_PORT_C 2
+#define GPIO_PORT_D 3
+#define GPIO_PORT_E 4
+#define GPIO_PORT_F 5
+#define GPIO_PORT_G 6
+#define GPIO_PORT_H 7
+#define GPIO_PORT_I 8
+#define GPIO_PORT_NUM 9
+
+/*
+*@GPIO_TABLE
+*A pin list is a macro taking an entry macro X and a port index, which expand X once per pin:
+*	#define BOARD_PINS(X,port) \
+*		X(port,GPIO_PORT_A,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+*		X(port,GPIO_PORT_D,GPIO_PIN_NO_12,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0)
+*	static const GPIO_Port_table_t boardTable[] = {GPIO_PORT_TABLE(BOARD_PINS,GPIO_PORT_A),GPIO_PORT_TABLE(BOARD_PINS,GPIO_PORT_D)};
+*GPIO_PORT_TABLE fold pins of one port into constant register values, so nothing of the list remain in flash.
+*Pin mode is GPIO_MODE_IN to GPIO_MODE_ANL (interrupt modes are not supported), each port is to appear once in a table.
+*/
+#define GPIO_TABLE_MAX_APPLIED 16	/*tables applied at the same time, re-applying a table is recognised up to this number*/
+
+#define GPIO_TBL_BIT(port,entryPort,pin) (((entryPort) == (port)) ? (1UL<<(pin)) : 0)
+#define GPIO_TBL_PIN_MASK(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | GPIO_TBL_BIT(port,entryPort,pin)
+#define GPIO_TBL_PIN_SUM(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) + GPIO_TBL_BIT(port,entryPort,pin)
+#define GPIO_TBL_OTYPER(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | (GPIO_TBL_BIT(port,entryPort,pin) ? ((uint32_t)(outType)<<(pin)) : 0)
+#define GPIO_TBL_MODER(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | (GPIO_TBL_BIT(port,entryPort,pin) ? ((uint32_t)(mode)<<(2*(pin))) : 0)
+#define GPIO_TBL_OSPEEDR(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | (GPIO_TBL_BIT(port,entryPort,pin) ? ((uint32_t)(speed)<<(2*(pin))) : 0)
+#define GPIO_TBL_PUPDR(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | (GPIO_TBL_BIT(port,entryPort,pin) ? ((uint32_t)(puPdr)<<(2*(pin))) : 0)
+#define GPIO_TBL_AFRL(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | ((GPIO_TBL_BIT(port,entryPort,pin) && (pin) < 8) ? ((uint32_t)(altFunc)<<(4*((pin)%8))) : 0)
+#define GPIO_TBL_AFRH(port,entryPort,pin,mode,speed,outType,puPdr,altFunc) | ((GPIO_TBL_BIT(port,entryPort,pin) && (pin) >= 8) ? ((uint32_t)(altFunc)<<(4*((pin)%8))) : 0)
+
+#define GPIO_PORT_TABLE(list,port) {(port),(uint16_t)(0 list(GPIO_TBL_PIN_MASK,port)),(uint16_t)(0 list(GPIO_TBL_OTYPER,port)),\
+																		(0 list(GPIO_TBL_PIN_SUM,port)),(0 list(GPIO_TBL_MODER,port)),(0 list(GPIO_TBL_OSPEEDR,port)),\
+																		(0 list(GPIO_TBL_PUPDR,port)),{(0 list(GPIO_TBL_AFRL,port)),(0 list(GPIO_TBL_AFRH,port))}}
+
 typedef struct
 {
 	uint8_t pinNumber; /*possible value from @GPIO_PIN_NO*/
@@ -88,6 +161,18 @@ typedef struct
 	GPIO_Pin_config_t GPIO_Pin_config; /*This hold configuration of GPIO pin*/
 }GPIO_Handle_t;
 
+typedef struct
+{
+	uint8_t port;	/*possible value from @GPIO_PORT*/
+	uint16_t pinMask;	/*pins configured by table*/
+	uint16_t OTYPERVal;
+	uint32_t pinSum;	/*sum of pin bits, differ from pinMask when a pin is listed twice*/
+	uint32_t MODERVal;
+	uint32_t OSPEEDRVal;
+	uint32_t PUPDRVal;
+	uint32_t AFRVal[2];
+}GPIO_Port_table_t;
+
 /**
 *@brief GPIO port clock setup 
 *@param Pointer to base address of GPIO port x registers
@@ -157,6 +242,63 @@ void GPIO_write_port (GPIO_TypeDef *GPIOxPtr,uint16_t value);
 */
 void GPIO_toggle_pin (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber);
 
+/**
+*@brief Set and clear several GPIO output pins at once
+*@param Pointer to base address of GPIO port x registers
+*@param Mask of pins to set (bit n for pin n)
+*@param Mask of pins to clear, pins in both masks are set
+*@return none
+*/
+void GPIO_write_pins (GPIO_TypeDef *GPIOxPtr, uint16_t setMask, uint16_t clearMask);
+
+/**
+*@brief Write value to masked GPIO output pins at once, other pins of port are unchanged
+*@param Pointer to base address of GPIO port x registers
+*@param Mask of pins to write (bit n for pin n)
+*@param Value of pins (bit n for pin n)
+*@return none
+*/
+void GPIO_write_masked (GPIO_TypeDef *GPIOxPtr, uint16_t mask, uint16_t value);
+
+/**
+*@brief Toggle several GPIO output pins at once
+*@param Pointer to base address of GPIO port x registers
+*@param Mask of pins to toggle (bit n for pin n)
+*@return none
+*/
+void GPIO_toggle_pins (GPIO_TypeDef *GPIOxPtr, uint16_t mask);
+
+/**
+*@brief Connect EXTI line to GPIO pin and select trigger edge, line mask is not changed
+*@param Pointer to base address of GPIO port x registers
+*@param GPIO pin number (same as EXTI line number)
+*@param Trigger edge: GPIO_MODE_INTRPT_FE, GPIO_MODE_INTRPT_RE or GPIO_MODE_INTRPT_RFE (refer to @GPIO_MODE)
+*@return none
+*/
+void GPIO_EXTI_line_config (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t edge);
+
+/**
+*@brief Apply a pin table, each register of each port is written once
+*
+*Pins of table are claimed until table is released. Nothing is written if a pin is listed twice in table,
+*or is claimed by another applied table (a pin pack using the same pin for example), or if GPIO_TABLE_MAX_APPLIED tables are
+*already applied. Applying a table again rewrite its pins.
+*
+*@param Pointer to table (array of port tables built with GPIO_PORT_TABLE)
+*@param Number of port tables in array
+*@param Pointer to array of GPIO_PORT_NUM masks receiving conflicting pins of each port (all pins of port if a pin is listed twice), may be NULL
+*@return 0 if success, -1 if pins conflict or no table slot is left
+*/
+int8_t GPIO_table_apply (const GPIO_Port_table_t *tablePtr, uint8_t portNum, uint16_t *conflictPtr);
+
+/**
+*@brief Release pins claimed by an applied table, pin configuration is not changed
+*@param Pointer to table
+*@param Number of port tables in array
+*@return none
+*/
+void GPIO_table_release (const GPIO_Port_table_t *tablePtr, uint8_t portNum);
+
 /**
 *@brief Config interrupt priority
 *@param IRQ number
@@ -180,4 +322,29 @@ void GPIO_Intrpt_ctrl (uint8_t IRQnumber, uint8_t enOrDis);
 */
 void GPIO_Intrpt_handler (uint8_t pinNumber);
 
+/*
+*@GPIO_FAST_WRITE
+*Inline variants of output writes for hot paths (display control lines, bit-banged protocols),
+*each one compile to a single store to BSRR: lower half set pins, upper half reset pins.
+*/
+static inline void GPIO_fast_set_pin (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
+{
+	GPIOxPtr->BSRR = 1UL<<pinNumber;
+}
+
+static inline void GPIO_fast_clear_pin (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
+{
+	GPIOxPtr->BSRR = 1UL<<(pinNumber + 16);
+}
+
+static inline void GPIO_fast_write_pins (GPIO_TypeDef *GPIOxPtr, uint16_t setMask, uint16_t clearMask)
+{
+	GPIOxPtr->BSRR = ((uint32_t)clearMask<<16) | setMask;
+}
+
+static inline void GPIO_fast_write_masked (GPIO_TypeDef *GPIOxPtr, uint16_t mask, uint16_t value)
+{
+	GPIOxPtr->BSRR = ((uint32_t)(mask & ~value)<<16) | (mask & value);
+}
+
 #endif 
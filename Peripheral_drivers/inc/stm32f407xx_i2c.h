@@ -8,12 +8,27 @@
 *@date 31/07/2019
 */
 
+/**
+*@Version 1.1
+*SCL timing set by I2C_init is kept across system clock changes: CR2 FREQ, CCR and TRISE of each initialized I2C are re-derived
+*by a RCC clock hook
+*fast mode now set CCR FS bit, and duty cycle is set in CCR (was written into CR2)
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*master interrupt transfers hold a stop lock (stm32f407xx_pwr) until they are closed
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_I2C_H
 #define STM32F407XX_I2C_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "stm32f407xx_common_macro.h"
 #include "stm32f407xx_rcc.h"
+#include "stm32f407xx_pwr.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -0,0 +1,153 @@
+/**
+*@file stm32f407xx_pulse_train.h
+*@brief provide DMA driven pulse trains on timer outputs of stm32f407xx MCUs.
+*
+*This header file provide APIs for streaming timer register values (CCRx, ARR) from memory into a timer, one set of values per timer period.
+*On each update event, timer request DMA burst which write regNum consecutive registers from baseReg through DMAR. Registers are preloaded,
+*so values written at an update event take effect for the following period: timing is cycle-exact and no CPU is used per pulse.
+*Typical uses:
+*	WS2812 LEDs: 1 register (CCRx) per bit, fixed period.
+*	stepper ramp: ARR, RCR, CCR1 per step (RCR is ignored on general purpose timers).
+*	PWM sequences: CCR1 - CCR4 per period.
+*
+*@note Timer (period, prescaler, output compare channels in PWM mode) is to be initialized by user application with timer driver APIs,
+*supported timers: TIM1-TIM5 and TIM8. DMA stream and both interrupt vectors used by engine are enabled by PULSE_init,
+*user application must call PULSE_DMA_intrpt_handler and PULSE_TIM_intrpt_handler from their IRQ handlers.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_PULSE_TRAIN_H
+#define STM32F407XX_PULSE_TRAIN_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_timer.h"
+#include "stm32f407xx_dma.h"
+#include "stm32f407xx_pwr.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@PULSE_DATA_SIZE
+*Size of one register value in memory buffer
+*/
+#define PULSE_DATA_16_BITS 1	/*16 bits timers only (TIM1, TIM3, TIM4, TIM8)*/
+#define PULSE_DATA_32_BITS 2	/*required for TIM2 and TIM5*/
+
+/*
+*@PULSE_MODE
+*Pulse train playing mode
+*/
+#define PULSE_MODE_ONESHOT 0	/*play buffer once, then stop timer*/
+#define PULSE_MODE_CIRCULAR 1	/*play buffer repeatedly until PULSE_stop, halves may be refilled on events*/
+
+/*
+*@PULSE_EVENT
+*Pulse train event
+*/
+#define PULSE_EV_HALF_CMPLT 0	/*circular mode: first half of buffer was transferred*/
+#define PULSE_EV_CMPLT 1	/*circular mode: second half of buffer was transferred*/
+#define PULSE_EV_DONE 2	/*oneshot mode: train ended, timer is stopped*/
+
+/*
+*@PULSE_IRQ
+*Priority of DMA stream and timer interrupts used by engine
+*/
+#define PULSE_IRQ_PRIORITY 3
+
+/***********************************************************************
+Pulse train structure definition
+***********************************************************************/
+
+typedef struct{
+	uint8_t baseReg;	/*first register written each period (refer to @TIM_DMA_BASE)*/
+	uint8_t regNum;	/*number of consecutive registers written each period (1 - 18)*/
+	uint8_t dataSize;	/*refer to @PULSE_DATA_SIZE for possible value*/
+}PULSE_Config_t;
+
+typedef struct{
+	TIM_TypeDef *TIMxPtr;
+	PULSE_Config_t *PULSEConfigPtr;
+	DMA_TypeDef *DMAxPtr;	/*internal: DMA serving timer update request*/
+	DMA_Stream_TypeDef *DMAStreamPtr;	/*internal*/
+	uint8_t streamNo;	/*internal*/
+	uint8_t DMAChannel;	/*internal*/
+	uint8_t mode;	/*internal: refer to @PULSE_MODE*/
+	volatile uint8_t remainingUpdates;	/*internal: update events left before timer is stopped (oneshot mode)*/
+	volatile uint8_t busy;	/*internal: train is playing*/
+}PULSE_Handle_t;
+
+/***********************************************************************
+Pulse train APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize DMA burst engine of timer
+*
+*DMA stream serving update request: TIM1 DMA2 stream 5, TIM2 DMA1 stream 1, TIM3 DMA1 stream 2,
+*TIM4 DMA1 stream 6, TIM5 DMA1 stream 0, TIM8 DMA2 stream 1.
+*
+*@param Pointer to pulse train handle struct
+*@return 0 if success, -1 if timer is not supported or DMA stream is taken by a DMA handle or an other driver
+*/
+int8_t PULSE_init(PULSE_Handle_t *PULSEHandlePtr);
+
+/**
+*@brief Start a pulse train
+*
+*Buffer hold regNum values for each period.
+*In oneshot mode, first 2 periods are loaded immediately and following periods by DMA, timer is stopped at end of last period.
+*Values of last period stay in registers while timer is stopped, so they are to be idle values (for example compare value 0 for a low output);
+*if timer interrupt is delayed by more than one period, last period is played once more.
+*In circular mode, buffer is played from its start after 2 periods with current register values, which is the DMA preload latency.
+*
+*@param Pointer to pulse train handle struct
+*@param Pointer to buffer (uint16_t or uint32_t according to dataSize)
+*@param Number of periods in buffer
+*@param Mode (refer to @PULSE_MODE)
+*@return 0 if success, -1 if a train is playing or buffer is too long (more than 65535 values)
+*/
+int8_t PULSE_start(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t periodNum, uint8_t mode);
+
+/**
+*@brief Stop pulse train immediately
+*@param Pointer to pulse train handle struct
+*@return none
+*/
+void PULSE_stop(PULSE_Handle_t *PULSEHandlePtr);
+
+/**
+*@brief Check whether a pulse train is playing
+*@param Pointer to pulse train handle struct
+*@return 1 if playing, 0 otherwise
+*/
+uint8_t PULSE_is_busy(PULSE_Handle_t *PULSEHandlePtr);
+
+/**
+*@brief DMA stream interrupt handler, to be called from IRQ handler of DMA stream
+*@param Pointer to pulse train handle struct
+*@return none
+*/
+void PULSE_DMA_intrpt_handler(PULSE_Handle_t *PULSEHandlePtr);
+
+/**
+*@brief Timer update interrupt handler, to be called from IRQ handler of timer
+*@param Pointer to pulse train handle struct
+*@return none
+*/
+void PULSE_TIM_intrpt_handler(PULSE_Handle_t *PULSEHandlePtr);
+
+/**
+*@brief Inform application of pulse train event
+*@param Pointer to pulse train handle struct
+*@param Event macro (refer to @PULSE_EVENT)
+*@return none
+*/
+void PULSE_application_event_callback(PULSE_Handle_t *PULSEHandlePtr, uint8_t event);
+#endif
@@ -0,0 +1,138 @@
+/**
+*@file stm32f407xx_pwr.h
+*@brief provide low power idle management on stm32f407xx MCUs.
+*
+*This header file provide APIs for putting the core to sleep between interrupts and into stop mode when the system is quiescent.
+*Drivers take a stop lock while a transfer or an output depending on peripheral clocks is in progress (UART, SPI, I2C interrupt transfers,
+*armed software timers, pulse trains, led dimming engine, buzzer, DMA memory copies, PCM streaming, running capture and encoder timers) and release it when it ends; user application may take PWR_LOCK_APP.
+*PWR_idle enter sleep mode (WFI, all clocks running, any interrupt wake core) while a stop lock is held, stop mode otherwise.
+*On wake up from stop mode, system clock set by RCC configurator (RCC_clock_config, RCC_set_perf_level) is restored before any interrupt
+*handler run, and drivers are re-timed by RCC clock hooks.
+*
+*@note In stop mode all clocks of 1.2 V domain are stopped: only EXTI lines (stm32f407xx_exti, button service) wake core up,
+*time base (stm32f407xx_time) does not advance during stop mode. Time spent in sleep mode is added to time base.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_PWR_H
+#define STM32F407XX_PWR_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_rcc.h"
+#include "stm32f407xx_time.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@PWR_LOCK
+*Sources of stop locks, each source is reference counted
+*/
+#define PWR_LOCK_UART 0
+#define PWR_LOCK_SPI 1
+#define PWR_LOCK_I2C 2
+#define PWR_LOCK_SWTIM 3
+#define PWR_LOCK_PULSE 4
+#define PWR_LOCK_LED 5
+#define PWR_LOCK_BUZZER 6
+#define PWR_LOCK_APP 7	/*free for user application*/
+#define PWR_LOCK_DMA 8
+#define PWR_LOCK_DAC 9
+#define PWR_LOCK_CAPTURE 10
+#define PWR_LOCK_ENCODER 11
+#define PWR_LOCK_NUM 12
+
+/*
+*@PWR_MODE
+*Low power mode entered by PWR_idle
+*/
+#define PWR_MODE_SLEEP 1
+#define PWR_MODE_STOP 2
+
+/*
+*@PWR_EVENT
+*Power manager event
+*/
+#define PWR_EV_STOP_ENTER 0	/*core is about to enter stop mode (interrupts are masked)*/
+#define PWR_EV_STOP_EXIT 1	/*core woke up from stop mode, system clock is restored (interrupts are masked)*/
+
+/***********************************************************************
+PWR structure definition
+***********************************************************************/
+
+typedef struct{
+	uint8_t stopMode;	/*ENABLE: enter stop mode when no stop lock is held, DISABLE: sleep mode only*/
+	uint8_t lowPowerRegulator;	/*ENABLE: regulator in low power mode during stop (lower current, longer wake up)*/
+	uint8_t flashPowerDown;	/*ENABLE: flash is powered down during stop (lower current, longer wake up)*/
+}PWR_Config_t;
+
+/***********************************************************************
+PWR APIs prototype
+***********************************************************************/
+
+/**
+*@brief Configure power manager, stop mode is disabled until it is called
+*@param Pointer to PWR config struct
+*@return none
+*/
+void PWR_init(const PWR_Config_t *PWRConfigPtr);
+
+/**
+*@brief Take a stop lock: PWR_idle only enter sleep mode until lock is released
+*
+*Locks are reference counted, each PWR_stop_lock is to be paired with a PWR_stop_unlock of same source.
+*It may be called from interrupts.
+*
+*@param Lock source (refer to @PWR_LOCK)
+*@return none
+*/
+void PWR_stop_lock(uint8_t source);
+
+/**
+*@brief Release a stop lock
+*@param Lock source (refer to @PWR_LOCK)
+*@return none
+*/
+void PWR_stop_unlock(uint8_t source);
+
+/**
+*@brief Get sources holding a stop lock
+*@param none
+*@return Bit n set if source n hold a lock (refer to @PWR_LOCK)
+*/
+uint16_t PWR_get_stop_locks(void);
+
+/**
+*@brief Sleep until next interrupt (sleep mode), time base keep counting
+*
+*To wait for a flag set by an interrupt, check flag and call PWR_sleep with interrupts masked (PRIMASK):
+*pending interrupt still wake core, and it is handled once interrupts are unmasked by caller.
+*
+*@param none
+*@return none
+*/
+void PWR_sleep(void);
+
+/**
+*@brief Enter lowest allowed low power mode until next interrupt
+*
+*Same masking rule as PWR_sleep apply to flags checked by main loop before PWR_idle.
+*
+*@param none
+*@return Mode which was entered (refer to @PWR_MODE)
+*/
+uint8_t PWR_idle(void);
+
+/**
+*@brief Inform application of power manager event
+*@param Event macro (refer to @PWR_EVENT)
+*@return none
+*/
+void PWR_application_event_callback(uint8_t event);
+#endif
@@ -23,6 +23,81 @@
 *06/09/2019
 */
 
+/**
+*@Version 1.2
+*add following functions:
+*RCC_get_TIMCLK_value
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*add following functions:
+*RCC_get_HCLK_value
+*19/10/2026
+*/
+
+/**
+*@Version 1.4
+*add PLL solver and clock tree configurator (SYSCLK up to 168 MHz, flash wait states and regulator scale follow clock),
+*RCC_set_SYSCLK_PLL_84_MHz is built on it and no longer use 5 wait states
+*add following functions:
+*RCC_clock_solve
+*RCC_clock_apply
+*RCC_clock_config
+*RCC_set_SYSCLK_PLL_168_MHz
+*19/10/2026
+*/
+
+/**
+*@Version 1.5
+*clock values are read from a snapshot which is refreshed when clock is changed through RCC driver,
+*drivers register hooks to re-derive their timings from new snapshot
+*add following functions:
+*RCC_get_clock_freq
+*RCC_clock_update
+*RCC_clock_hook_register
+*RCC_clock_hook_unregister
+*19/10/2026
+*/
+
+/**
+*@Version 1.6
+*add performance levels (dynamic frequency scaling), RCC_clock_apply only change prescalers when PLL configuration is unchanged
+*add following functions:
+*RCC_perf_level_config
+*RCC_set_perf_level
+*RCC_get_perf_level
+*19/10/2026
+*/
+
+/**
+*@Version 1.7
+*add flash interface control: ART accelerator caches, prefetch, wait states computed from supply voltage range,
+*caches and prefetch are enabled by default on each clock change
+*add following functions:
+*FLASH_config
+*FLASH_get_latency
+*FLASH_cache_reset
+*19/10/2026
+*/
+
+/**
+*@Version 1.8
+*add following functions:
+*RCC_clock_restore
+*19/10/2026
+*/
+
+/**
+*@Version 1.9
+*HSE frequency used for clock computation can be corrected at run time (measured against an other clock)
+*add following functions:
+*RCC_set_HSE_freq
+*RCC_get_HSE_freq
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_RCC_H
 #define STM32F407XX_RCC_H
 
@@ -73,14 +148,119 @@ Macro definition
 #define RCC_SYSCLK_HSE 	1
 #define RCC_SYSCLK_PLL		2
 
-#define RCC_PLL_84_VCO_INPUT_DIV				8
-#define RCC_PLL_84_VCO_OUTPUT_MUL 	168
-#define RCC_PLL_84_PLL_OUTPUT_DIV			0
-#define RCC_PLL_84_MAIN_PLL_DIV						7
-
 #define APB1 0
 #define APB2 1
 
+/*
+*@RCC_OSC_FREQ
+*Oscillator frequencies (HSE is the 8 MHz crystal of STM32F4 discovery board)
+*RCC_HSE_FREQ is nominal value, value used for clock computation may be corrected by RCC_set_HSE_freq
+*/
+#define RCC_HSI_FREQ 16000000
+#define RCC_HSE_FREQ 8000000
+
+/*
+*@RCC_CLOCK_LIMIT
+*Clock tree limits of stm32f407xx
+*/
+#define RCC_SYSCLK_MAX 168000000
+#define RCC_PCLK1_MAX 42000000
+#define RCC_PCLK2_MAX 84000000
+#define RCC_PLL48_FREQ 48000000	/*USB OTG FS, SDIO and RNG clock*/
+#define RCC_VCO_INPUT_MIN 1000000
+#define RCC_VCO_INPUT_MAX 2000000
+#define RCC_VCO_OUTPUT_MIN 100000000
+#define RCC_VCO_OUTPUT_MAX 432000000
+#define RCC_SCALE2_HCLK_MAX 144000000	/*above this, regulator must be in scale 1*/
+
+/*
+*@FLASH_VDD_RANGE
+*Supply voltage range, it set HCLK range of each flash wait state
+*/
+#define FLASH_VDD_2V7_3V6 0	/*30 MHz per wait state*/
+#define FLASH_VDD_2V4_2V7 1	/*24 MHz per wait state*/
+#define FLASH_VDD_2V1_2V4 2	/*22 MHz per wait state*/
+#define FLASH_VDD_1V8_2V1 3	/*20 MHz per wait state (HCLK up to 160 MHz), prefetch is not allowed*/
+
+#define FLASH_LATENCY_MAX 7
+
+/*
+*@RCC_OSC
+*Oscillator feeding PLL (or system clock when PLL is not needed)
+*/
+#define RCC_OSC_HSI 0
+#define RCC_OSC_HSE 1
+
+/*
+*@RCC_PERF_LEVEL
+*Performance levels, default clock trees:
+*HIGH: SYSCLK 168 MHz (PLL from HSE), HCLK 168 MHz, APB1 42 MHz, APB2 84 MHz, PLL48CLK 48 MHz
+*MEDIUM: SYSCLK 168 MHz (same PLL), HCLK 84 MHz, APB1 42 MHz, APB2 84 MHz, PLL48CLK 48 MHz
+*LOW: HSI 16 MHz on all buses, PLL and HSE are off
+*/
+#define RCC_PERF_HIGH 0
+#define RCC_PERF_MEDIUM 1
+#define RCC_PERF_LOW 2
+#define RCC_PERF_LEVEL_NUM 3
+#define RCC_PERF_LEVEL_NONE 0xFF	/*clock was set by other RCC functions*/
+
+/***********************************************************************
+RCC structure definition
+***********************************************************************/
+
+typedef struct{
+	uint8_t oscillator;	/*refer to @RCC_OSC for possible value*/
+	uint32_t SYSCLKFreq;	/*target system clock (in Hz), up to RCC_SYSCLK_MAX*/
+	uint32_t HCLKFreq;	/*highest allowed AHB clock, 0 for SYSCLKFreq*/
+	uint32_t PCLK1Freq;	/*highest allowed APB1 clock, 0 for RCC_PCLK1_MAX*/
+	uint32_t PCLK2Freq;	/*highest allowed APB2 clock, 0 for RCC_PCLK2_MAX*/
+	uint8_t PLL48Clock;	/*ENABLE: PLL48CLK must be exactly 48 MHz (USB, SDIO, RNG), DISABLE: PLL48CLK is only kept below 48 MHz*/
+}RCC_Clock_config_t;
+
+typedef struct{
+	uint8_t SYSCLKSource;	/*refer to @RCC_SYSCLK*/
+	uint8_t oscillator;	/*refer to @RCC_OSC*/
+	uint8_t PLLM;	/*VCO input division factor (2 - 63)*/
+	uint16_t PLLN;	/*VCO multiplication factor (50 - 432)*/
+	uint8_t PLLP;	/*main output division factor (2, 4, 6, 8)*/
+	uint8_t PLLQ;	/*PLL48CLK division factor (2 - 15)*/
+	uint8_t HPRE;	/*CFGR HPRE field value*/
+	uint8_t PPRE1;	/*CFGR PPRE1 field value*/
+	uint8_t PPRE2;	/*CFGR PPRE2 field value*/
+	uint8_t flashLatency;	/*flash wait states*/
+	uint8_t scale1;	/*1: regulator scale 1 is needed*/
+	uint32_t SYSCLKFreq;	/*resulting clock values (in Hz)*/
+	uint32_t HCLKFreq;
+	uint32_t PCLK1Freq;
+	uint32_t PCLK2Freq;
+	uint32_t PLL48Freq;	/*0 if PLL is not used*/
+}RCC_Clock_setting_t;
+
+/*clock values (in Hz), -1 if PLL is system clock source and its configuration is wrong*/
+typedef struct{
+	int32_t SYSCLK;
+	int32_t HCLK;
+	int32_t PCLK1;
+	int32_t PCLK2;
+	int32_t TIMCLK1;	/*clock of timers on APB1*/
+	int32_t TIMCLK2;	/*clock of timers on APB2*/
+}RCC_Clock_freq_t;
+
+typedef struct{
+	uint8_t VDDRange;	/*refer to @FLASH_VDD_RANGE for possible value*/
+	uint8_t prefetch;	/*ENABLE or DISABLE, always disabled in range FLASH_VDD_1V8_2V1*/
+	uint8_t instructionCache;	/*ENABLE or DISABLE (ART accelerator, 64 lines of 128 bits)*/
+	uint8_t dataCache;	/*ENABLE or DISABLE (8 lines of 128 bits, constants read from flash)*/
+}FLASH_Config_t;
+
+typedef void (*RCC_Clock_callback_t)(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr);
+
+typedef struct RCC_Clock_hook{
+	struct RCC_Clock_hook *nextPtr;	/*internal: next hook in list*/
+	RCC_Clock_callback_t callback;	/*function called after clock change, with new clock values*/
+	void *argPtr;	/*argument passed to callback*/
+}RCC_Clock_hook_t;
+
 /***********************************************************************
 RCC driver functions prototype
 ***********************************************************************/
@@ -115,6 +295,46 @@ void RCC_set_SYSCLK_HSE (void);
 */
 void RCC_set_SYSCLK_PLL_84_MHz (void);
 
+/**
+*@brief 		Set system clock as PLL 168 MHz from HSE, AHB 168 MHz, APB1 42 MHz, APB2 84 MHz, PLL48CLK 48 MHz
+*@param 	None
+*@return 	None
+*/
+void RCC_set_SYSCLK_PLL_168_MHz (void);
+
+/**
+*@brief 		Search PLL factors and bus prescalers for a clock tree requirement
+*
+*PLLM, PLLN, PLLP are chosen so that SYSCLK is closest to target, with VCO input as high as possible (lowest jitter),
+*and PLLQ so that PLL48CLK is 48 MHz or below. PLL is not used when target equal oscillator frequency and 48 MHz is not required.
+*Each bus prescaler is the smallest one keeping bus clock below its limit. Flash wait states and regulator scale are derived from HCLK.
+*
+*@param 	Pointer to requirement struct
+*@param	Pointer to setting struct filled with solution (closest one if no exact solution exist)
+*@return 	0:	exact solution found
+*								-1: SYSCLK target can not be reached exactly (or with PLL48CLK at 48 MHz when required), or exceed RCC_SYSCLK_MAX
+*/
+int8_t RCC_clock_solve (const RCC_Clock_config_t *clockConfigPtr, RCC_Clock_setting_t *settingPtr);
+
+/**
+*@brief 		Apply a clock setting
+*
+*System clock is moved to HSI while PLL is reprogrammed. Flash wait states are raised before clock increase and lowered after
+*clock decrease, bus prescalers are changed while running on HSI, so no bus nor flash is overclocked at any time.
+*Oscillators and PLL not used by new setting are turned off.
+*
+*@param	Pointer to setting struct (from RCC_clock_solve)
+*@return 	None
+*/
+void RCC_clock_apply (const RCC_Clock_setting_t *settingPtr);
+
+/**
+*@brief 		Solve and apply a clock tree requirement
+*@param 	Pointer to requirement struct
+*@return 	0: success, -1: no exact solution, clock is left unchanged
+*/
+int8_t RCC_clock_config (const RCC_Clock_config_t *clockConfigPtr);
+
 /**
 *@brief 		Get system clock value
 *@return 	-1:	PLL is configured as system clock source however configration is wrong
@@ -122,6 +342,13 @@ void RCC_set_SYSCLK_PLL_84_MHz (void);
 */
 int32_t RCC_get_SYSCLK_value (void);
 
+/**
+*@brief 		Get AHB bus clock value (HCLK, clock of CPU core, DWT and SysTick)
+*@return 	-1:	PLL is configured as system clock source however configration is wrong
+*								AHB bus clock value
+*/
+int32_t RCC_get_HCLK_value (void);
+
 /**
 *@brief 		Get APB bus clock value
 *@param 	APB1 or APB2
@@ -130,4 +357,136 @@ int32_t RCC_get_SYSCLK_value (void);
 */
 int32_t RCC_get_PCLK_value(uint8_t APBx);
 
+/**
+*@brief 		Replace clock requirement of a performance level
+*
+*Requirement is solved at once, it takes effect at next switch to level.
+*
+*@param 	Performance level (refer to @RCC_PERF_LEVEL)
+*@param	Pointer to requirement struct
+*@return 	0: success, -1: invalid level or no exact solution (level is left unchanged)
+*/
+int8_t RCC_perf_level_config (uint8_t level, const RCC_Clock_config_t *clockConfigPtr);
+
+/**
+*@brief 		Switch to a performance level
+*
+*Switching between levels which share PLL configuration (HIGH and MEDIUM by default) only change bus prescalers and flash wait states,
+*other switches go through HSI while PLL lock. Drivers registered to RCC clock hooks (UART, I2C, timers, time base) are re-timed
+*before return, so switch is to be made between transfers. PLL48CLK users (USB, SDIO, RNG) stop at a level without PLL.
+*
+*@param 	Performance level (refer to @RCC_PERF_LEVEL)
+*@return 	0: success, -1: invalid level or its requirement has no exact solution
+*/
+int8_t RCC_set_perf_level (uint8_t level);
+
+/**
+*@brief 		Get current performance level
+*@return 	Performance level (refer to @RCC_PERF_LEVEL), RCC_PERF_LEVEL_NONE if clock was set by other RCC functions
+*/
+uint8_t RCC_get_perf_level (void);
+
+/**
+*@brief 		Re-apply last setting applied by RCC_clock_apply (directly or through RCC_clock_config, performance levels)
+*
+*It is used after wake up from stop mode, when system clock is HSI and PLL, HSE are off. Performance level is kept.
+*
+*@param 	None
+*@return 	0: success, -1: clock was not set by RCC_clock_apply (reset clock or RCC_set_SYSCLK_HSE)
+*/
+int8_t RCC_clock_restore (void);
+
+/**
+*@brief 		Set actual HSE frequency, e.g. measured by stm32f407xx_clock_measure
+*
+*Clock tree snapshot is refreshed and registered hooks are called, so baud rates and timer periods are compensated.
+*Clock configurator keep solving settings with nominal value RCC_HSE_FREQ.
+*
+*@param 	HSE frequency (in Hz)
+*@return 	None
+*/
+void RCC_set_HSE_freq (uint32_t freq);
+
+/**
+*@brief 		Get HSE frequency used for clock computation
+*@param 	None
+*@return 	HSE frequency (in Hz), RCC_HSE_FREQ unless it was corrected by RCC_set_HSE_freq
+*/
+uint32_t RCC_get_HSE_freq (void);
+
+/**
+*@brief 		Configure flash interface
+*
+*Default is FLASH_VDD_2V7_3V6 with prefetch and both caches enabled, it is applied by every clock change.
+*Caches are reset when they are enabled. Supply voltage range is used by RCC_clock_solve to compute wait states,
+*so it is to be set before clock configuration.
+*
+*@param 	Pointer to flash config struct
+*@return 	None
+*/
+void FLASH_config (const FLASH_Config_t *FLASHConfigPtr);
+
+/**
+*@brief 		Get flash wait states needed at an AHB clock for configured supply voltage range
+*@param 	HCLK value (in Hz)
+*@return 	Wait states, -1 if HCLK is above limit of voltage range
+*/
+int8_t FLASH_get_latency (uint32_t HCLKFreq);
+
+/**
+*@brief 		Reset ART accelerator caches, to be called after flash is erased or programmed
+*@param 	None
+*@return 	None
+*/
+void FLASH_cache_reset (void);
+
+/**
+*@brief 		Get clock value of timers connected to APB bus
+*
+*Timer clock equal APB bus clock if APB prescaler is 1, otherwise it is twice APB bus clock.
+*
+*@param 	APB1 or APB2
+*@return 	-1:	PLL is configured as system clock source however configration is wrong
+*								APB1 or APB2 timer clock value
+*/
+int32_t RCC_get_TIMCLK_value(uint8_t APBx);
+
+/**
+*@brief 		Get clock tree snapshot
+*
+*Snapshot is read from RCC registers on first call, then only when clock is changed, so clock lookups cost nothing.
+*
+*@return 	Pointer to clock values
+*/
+const RCC_Clock_freq_t* RCC_get_clock_freq (void);
+
+/**
+*@brief 		Refresh clock tree snapshot from RCC registers, then call every registered hook
+*
+*This is called by RCC functions which change clock, user application is to call it after writing RCC clock registers directly.
+*
+*@param 	None
+*@return 	None
+*/
+void RCC_clock_update (void);
+
+/**
+*@brief 		Register a hook called after each clock change (from the context which changed clock)
+*
+*Hook struct is kept by reference, it must stay valid while registered. Registering a hook already registered do nothing.
+*
+*@param 	Pointer to hook struct
+*@param	Callback
+*@param	Argument passed to callback
+*@return 	None
+*/
+void RCC_clock_hook_register (RCC_Clock_hook_t *hookPtr, RCC_Clock_callback_t callback, void *argPtr);
+
+/**
+*@brief 		Unregister a clock change hook
+*@param 	Pointer to hook struct
+*@return 	None
+*/
+void RCC_clock_hook_unregister (RCC_Clock_hook_t *hookPtr);
+
 #endif
\ No newline at end of file
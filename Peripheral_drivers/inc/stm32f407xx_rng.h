@@ -12,6 +12,17 @@
 *@date 		09/09/2019
 */
 
+/**
+*@Version 1.1
+*Interrupt handler collect random words into a pool (lock-free ring buffer) which is read without waiting,
+*seed errors are recovered by restarting RNG, clock errors are cleared and reported
+*add following functions:
+*RNG_read
+*RNG_get_available
+*RNG_get_error
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_RNG_H
 #define STM32F407XX_RNG_H
 
@@ -19,6 +30,24 @@
 #include "stm32f407xx_common_macro.h"
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@RNG_POOL_SIZE
+*Number of 32-bits words pool can hold (power of 2)
+*/
+#define RNG_POOL_SIZE 64
+
+/*
+*@RNG_ERROR
+*Errors detected since last call of RNG_get_error
+*/
+#define RNG_ERR_SEED 0x01	/*seed error (bad entropy sequence), RNG was restarted and faulty word dropped*/
+#define RNG_ERR_CLOCK 0x02	/*RNG_CLK too slow (RNG_CLK < HCLK/16 or PLL stopped), generation resume once clock is correct*/
 
 /***********************************************************************
 RNG driver functions prototype
@@ -53,14 +82,46 @@ void RNG_init(void);
 void RNG_deinit(void);
 
 /**
-*@brief 		Read 32-bits random value generated by RNG (interrupt base)
+*@brief 		Read 32-bits random value generated by RNG
+*
+*								Value is taken from pool while RNG interrupt is enabled (wait for interrupt handler if pool is empty),
+*								otherwise RNG is polled. Seed errors are recovered in both cases.
+*
 *@param 	None
 *@return 	32-bits random value
 */
 uint32_t RNG_get(void);
 
 /**
-*@brief 		Enable/disable RNG 's interrupt 
+*@brief 		Read random bytes from pool without waiting
+*
+*								Pool is filled by RNG_intrpt_handler while RNG interrupt is enabled (RNG_intrpt_ctr), interrupt is
+*								disabled by handler once pool is full and enabled again when words are read. Pool is a single producer,
+*								single consumer ring: RNG_read and RNG_get are not to be called from thread and interrupt context at same time.
+*								Unused bytes of last word are dropped, a random byte is never returned twice.
+*
+*@param 	Pointer to buffer
+*@param 	Number of bytes requested
+*@return 	Number of bytes read, lower than requested if pool ran out
+*/
+uint32_t RNG_read(uint8_t *bufferPtr, uint32_t len);
+
+/**
+*@brief 		Get number of random bytes in pool
+*@param 	None
+*@return 	Number of bytes RNG_read can return immediately
+*/
+uint32_t RNG_get_available(void);
+
+/**
+*@brief 		Get and clear errors detected since last call
+*@param 	None
+*@return 	Error bits (refer to @RNG_ERROR), 0 if no error
+*/
+uint8_t RNG_get_error(void);
+
+/**
+*@brief 		Enable/disable RNG 's interrupt, interrupt fill pool
 *@param	Enable or disable
 *@return 	None
 */	
@@ -0,0 +1,132 @@
+/**
+*@file stm32f407xx_soft_timer.h
+*@brief provide software timer service multiplexed on one 32 bits hardware timer.
+*
+*This header file provide APIs for one-shot and periodic software timers on stm32f407xx MCUs.
+*All software timers share one free running 32 bits timer (TIM5 by default, TIM2 can be selected), channel 1 compare match is
+*reprogrammed to the nearest expiry so that no periodic tick interrupt is needed while timers are idle.
+*Timers are kept in a hierarchical timing wheel (SWTIM_LEVEL_NUM levels of 32 slots), insert and cancel are O(1),
+*next expiry is found by scanning slot bitmap of each level with CLZ.
+*
+*@note Timer callbacks are called from timer interrupt, they may start or cancel any software timer.
+*SWTIM_start and SWTIM_cancel may be called from thread mode and from any interrupt: wheel is modified with interrupts masked
+*(callbacks run with interrupts unmasked).
+*Each running timer hold a stop lock (stm32f407xx_pwr), a periodic timer keep core out of stop mode until it is cancelled.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_SOFT_TIMER_H
+#define STM32F407XX_SOFT_TIMER_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_rcc.h"
+#include "stm32f407xx_timer.h"
+#include "stm32f407xx_pwr.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@SWTIM_HW_TIMER
+*Hardware timer used by service, must be a 32 bits timer (TIM2 or TIM5)
+*/
+#define SWTIM_TIMx TIM5
+#define SWTIM_IRQ_NUMBER IRQ_TIM5
+#define SWTIM_IRQHandler TIM5_IRQHandler
+#define SWTIM_IRQ_PRIORITY 6
+
+/*
+*@SWTIM_TIMING
+*Timing unit of service
+*/
+#define SWTIM_COUNT_FREQ 1000000	/*counter frequency (in Hz), one tick is 1 microsecond*/
+#define SWTIM_MAX_DELAY 0x3FFFFFFF	/*longest delay or period (in tick), about 17 minutes*/
+#define SWTIM_MS_TO_TICKS(ms) ((ms)*(SWTIM_COUNT_FREQ/1000))
+
+/*
+*@SWTIM_WHEEL
+*Timing wheel geometry: each level hold 32 slots, level n slot width is 32^n ticks, 7 levels cover 32 bits
+*/
+#define SWTIM_SLOT_BITS 5
+#define SWTIM_SLOT_NUM 32
+#define SWTIM_LEVEL_NUM 7
+
+/***********************************************************************
+Software timer structure definition
+***********************************************************************/
+
+typedef void (*SWTIM_Callback_t)(void *argPtr);
+
+typedef struct SWTIM_Timer{
+	struct SWTIM_Timer *nextPtr;	/*internal: next timer in wheel slot*/
+	struct SWTIM_Timer **pprevPtr;	/*internal: link pointing to this timer, NULL while timer is not running*/
+	uint32_t expiry;	/*internal: counter value at which timer expire*/
+	uint32_t period;	/*internal: reload period (in tick), 0 for one-shot timer*/
+	uint8_t slot;	/*internal: level*SWTIM_SLOT_NUM + slot of wheel holding timer*/
+	SWTIM_Callback_t callback;	/*function called when timer expire*/
+	void *argPtr;	/*argument passed to callback*/
+}SWTIM_Timer_t;
+
+/***********************************************************************
+Software timer APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize software timer service
+*
+*This start hardware timer as free running counter at SWTIM_COUNT_FREQ and enable its channel 1 compare interrupt.
+*
+*@param none
+*@return none
+*/
+void SWTIM_init (void);
+
+/**
+*@brief Initialize a software timer
+*@param Pointer to software timer struct
+*@param Callback called when timer expire
+*@param Argument passed to callback
+*@return none
+*/
+void SWTIM_timer_init (SWTIM_Timer_t *timerPtr, SWTIM_Callback_t callback, void *argPtr);
+
+/**
+*@brief Start (or restart) a software timer
+*
+*A running timer is first cancelled, so this can be used to kick a timeout.
+*
+*@param Pointer to software timer struct
+*@param Delay before first expiry (in tick, up to SWTIM_MAX_DELAY)
+*@param Period of following expiries (in tick, up to SWTIM_MAX_DELAY), 0 for one-shot timer
+*@return none
+*/
+void SWTIM_start (SWTIM_Timer_t *timerPtr, uint32_t delay, uint32_t period);
+
+/**
+*@brief Cancel a software timer, do nothing if timer is not running
+*@param Pointer to software timer struct
+*@return none
+*/
+void SWTIM_cancel (SWTIM_Timer_t *timerPtr);
+
+/**
+*@brief Check whether a software timer is running
+*@param Pointer to software timer struct
+*@return 1 if timer is running, 0 otherwise
+*/
+uint8_t SWTIM_is_active (SWTIM_Timer_t *timerPtr);
+
+/**
+*@brief Get current counter value of service
+*@param none
+*@return Current time (in tick), wrap around every 2^32 ticks
+*/
+uint32_t SWTIM_get_tick (void);
+
+#endif
@@ -24,12 +24,31 @@
 *Add SPI_send_16_bits function
 */
 
+/**
+*@Version 1.2
+*19/10/2026
+*Pins packs are applied as GPIO pin tables, SPI_general_init return NULL if pins are claimed by another pins pack
+*/
+
+/**
+*@Version 1.3
+*19/10/2026
+*SPI_intrpt_handler is tagged RAM_FUNC, run from SRAM if linker script place section ".RamFunc" there
+*/
+
+/**
+*@Version 1.4
+*19/10/2026
+*interrupt transfers hold a stop lock (stm32f407xx_pwr) until they complete
+*/
+
 #ifndef STM32F407XX_SPI_H
 #define STM32F407XX_SPI_H
 
 #include "stm32f407xx.h"                  // Device header
 #include "stm32f407xx_common_macro.h"
 #include "stm32f407xx_gpio.h"
+#include "stm32f407xx_pwr.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -212,7 +231,7 @@ void SPI_init(SPI_Handle_t *SPIxHandlePtr);
 *@param 	Clock polarity
 *@param 	Software slave manager
 *@param 	Clock speed
-*@return 	Pointer to SPI handle struct
+*@return 	Pointer to SPI handle struct, NULL if pins of pins pack are used by another pins pack
 */
 SPI_Handle_t* SPI_general_init(SPI_TypeDef *SPIxPtr, SPI_pins_pack_t pinsPack, uint32_t deviceMode, uint8_t busConfig, uint8_t dataFrame, uint8_t clkPhase, uint8_t clkPol, uint8_t swSlaveManage, uint8_t clkSpeed);
 
@@ -0,0 +1,123 @@
+/**
+*@file stm32f407xx_time.h
+*@brief provide monotonic time base and precise delays on stm32f407xx MCUs.
+*
+*This header file provide a free running 64 bits microsecond timestamp and busy-wait delays which do not depend on CPU speed.
+*Time is counted by DWT cycle counter (CYCCNT, one count per HCLK cycle), which is extended to 64 bits in software.
+*SysTick interrupt fold CYCCNT into 64 bits timestamp TIME_SYNC_FREQ times per second, so that CYCCNT never wrap between two reads.
+*
+*CYCCNT stop while core sleep (WFI), sleep time is measured with SysTick and added to timestamp by TIME_sleep_exit.
+*
+*@note TIME_init register TIME_clock_update as RCC clock hook, so cycles are converted with new HCLK after a clock change made through RCC driver.
+*Time does not advance during stop mode (SysTick is stopped).
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#ifndef STM32F407XX_TIME_H
+#define STM32F407XX_TIME_H
+
+#include "stm32f407xx.h"                  // Device header
+#include "stm32f407xx_common_macro.h"
+#include "stm32f407xx_rcc.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@TIME_SYNC
+*SysTick interrupt folding cycle counter into 64 bits timestamp
+*/
+#define TIME_SYNC_FREQ 10	/*in Hz, CYCCNT wrap every 25 s at 168 MHz*/
+#define TIME_SYSTICK_PRIORITY 15	/*lowest priority, folding is short and never urgent*/
+
+/***********************************************************************
+Time base APIs prototype
+***********************************************************************/
+
+/**
+*@brief Initialize time base
+*
+*This enable DWT cycle counter and start SysTick interrupt at TIME_SYNC_FREQ. Calling it again has no effect.
+*
+*@param none
+*@return none
+*/
+void TIME_init (void);
+
+/**
+*@brief Re-read HCLK after system clock change
+*
+*Timestamp is first brought up to date, so it stay continuous across clock change (error is bounded by time since clock was changed).
+*
+*@param none
+*@return none
+*/
+void TIME_clock_update (void);
+
+/**
+*@brief Get time since TIME_init
+*@param none
+*@return Time (in microsecond)
+*/
+uint64_t TIME_get_us (void);
+
+/**
+*@brief Get time since TIME_init
+*@param none
+*@return Time (in milisecond)
+*/
+uint64_t TIME_get_ms (void);
+
+/**
+*@brief Get time elapsed since given timestamp
+*@param Earlier timestamp (in microsecond) returned by TIME_get_us
+*@return Elapsed time (in microsecond)
+*/
+uint64_t TIME_elapsed_us (uint64_t sinceUs);
+
+/**
+*@brief Check whether given timeout has elapsed since given timestamp
+*@param Timestamp (in microsecond) returned by TIME_get_us when wait started
+*@param Timeout (in microsecond)
+*@return 1 if timeout elapsed, 0 otherwise
+*/
+uint8_t TIME_is_timeout (uint64_t startUs, uint64_t timeoutUs);
+
+/**
+*@brief Busy-wait for given time
+*
+*Delay is counted in CPU cycles, it is accurate to a few cycles and independent of compiler optimization.
+*Time base is initialized (TIME_init) by first delay if it was not yet.
+*
+*@param Delay (in microsecond)
+*@return none
+*/
+void TIME_delay_us (uint32_t delayUs);
+
+/**
+*@brief Busy-wait for given time, time base is initialized by first delay if it was not yet
+*@param Delay (in milisecond)
+*@return none
+*/
+void TIME_delay_ms (uint32_t delayMs);
+
+/**
+*@brief Record SysTick before core enter sleep mode, to be called with interrupts masked (used by stm32f407xx_pwr)
+*@param none
+*@return none
+*/
+void TIME_sleep_enter (void);
+
+/**
+*@brief Add time spent in sleep mode to timestamp, to be called after wake up with interrupts still masked
+*@param none
+*@return none
+*/
+void TIME_sleep_exit (void);
+
+#endif
@@ -1,14 +1,59 @@
 /**
-*@file stm32f407xx_dac.h
-*@brief provide APIs for interfacing with basic timer on stm32f407xx MCUs.
+*@file stm32f407xx_timer.h
+*@brief provide APIs for interfacing with timers on stm32f407xx MCUs.
 *
-*This header file provide APIs for interfacing with basic timer (timer 6 and timer 7)on stm32f407xx MCUs.
-*@note: only use this driver for timer 6 and timer 7.
+*This header file provide APIs for interfacing with basic timers (timer 6 and timer 7), general purpose timers (timer 2 to timer 5, timer 9 to timer 14)
+*and advanced timers (timer 1 and timer 8) on stm32f407xx MCUs.
+*@note: TIM2 and TIM5 have 32 bits counter, other timers have 16 bits counter.
+*Channel 3 and 4 exist on TIM1-TIM5 and TIM8, channel 2 exist on TIM1-TIM5, TIM8, TIM9 and TIM12, complementary outputs exist on TIM1 and TIM8 only.
 *
 *@author Tran Thanh Nhan
 *@date 20/08/2019
 */
 
+/**
+*@Version 1.1
+*extend driver to timer 1 to timer 14
+*add 32 bits reload value (TIM2 and TIM5)
+*add following functions:
+*TIM_OC_init
+*TIM_IC_init
+*TIM_set_compare_val
+*TIM_get_capture_val
+*TIM_get_counter
+*TIM_dead_time_config
+*TIM_main_output_ctr
+*TIM_one_pulse_ctr
+*TIM_channel_interrupt_ctr
+*TIM_application_event_callback
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*add following functions:
+*TIM_get_CLK_value
+*TIM_slave_mode_config
+*TIM_DMA_request_ctr
+*TIM_DMA_burst_config
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*add following functions:
+*TIM_encoder_init
+*TIM_master_mode_config
+*19/10/2026
+*/
+
+/**
+*@Version 1.4
+*counter frequency set by TIM_init or TIM_set_prescaler is kept across system clock changes:
+*prescaler of each initialized timer is re-derived by a RCC clock hook
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_TIMER_H
 #define STM32F407XX_TIMER_H
 
@@ -17,12 +62,146 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+/***********************************************************************
+Macro definition
+***********************************************************************/
+
+/*
+*@TIM_CHANNEL
+*Timer capture/compare channel
+*/
+#define TIM_CHANNEL_1 1
+#define TIM_CHANNEL_2 2
+#define TIM_CHANNEL_3 3
+#define TIM_CHANNEL_4 4
+
+/*
+*@TIM_OC_MODE
+*Output compare mode
+*/
+#define TIM_OC_MODE_FROZEN 0	/*compare match has no effect on output*/
+#define TIM_OC_MODE_ACTIVE 1	/*output set active on match*/
+#define TIM_OC_MODE_INACTIVE 2	/*output set inactive on match*/
+#define TIM_OC_MODE_TOGGLE 3	/*output toggle on match*/
+#define TIM_OC_MODE_FORCE_INACTIVE 4
+#define TIM_OC_MODE_FORCE_ACTIVE 5
+#define TIM_OC_MODE_PWM1 6	/*output active while counter < compare value*/
+#define TIM_OC_MODE_PWM2 7	/*output inactive while counter < compare value*/
+
+/*
+*@TIM_OC_POLARITY
+*Output compare active level
+*/
+#define TIM_OC_POLARITY_HIGH 0
+#define TIM_OC_POLARITY_LOW 1
+
+/*
+*@TIM_IC_SELECTION
+*Input capture source of channel
+*/
+#define TIM_IC_DIRECT_TI 1	/*ICx is mapped on TIx*/
+#define TIM_IC_INDIRECT_TI 2	/*IC1 on TI2, IC2 on TI1, IC3 on TI4, IC4 on TI3*/
+#define TIM_IC_TRC 3	/*ICx is mapped on internal trigger*/
+
+/*
+*@TIM_IC_POLARITY
+*Input capture active edge
+*/
+#define TIM_IC_POLARITY_RISING 0
+#define TIM_IC_POLARITY_FALLING 1
+#define TIM_IC_POLARITY_BOTH 5	/*CCxNP:CCxP = 11*/
+
+/*
+*@TIM_IC_PRESCALER
+*Number of events for one capture
+*/
+#define TIM_IC_PRESCALER_DIV1 0
+#define TIM_IC_PRESCALER_DIV2 1
+#define TIM_IC_PRESCALER_DIV4 2
+#define TIM_IC_PRESCALER_DIV8 3
+
+/*
+*@TIM_EVENT
+*Timer interrupt event
+*/
+#define TIM_EV_UPDATE 0
+#define TIM_EV_CC1 1
+#define TIM_EV_CC2 2
+#define TIM_EV_CC3 3
+#define TIM_EV_CC4 4
+#define TIM_EV_CC1_OVERCAPTURE 5
+#define TIM_EV_CC2_OVERCAPTURE 6
+#define TIM_EV_CC3_OVERCAPTURE 7
+#define TIM_EV_CC4_OVERCAPTURE 8
+
+/*
+*@TIM_SLAVE_MODE
+*Slave mode controller function (SMS bits)
+*/
+#define TIM_SLAVE_MODE_DISABLE 0	/*counter clocked by internal clock*/
+#define TIM_SLAVE_MODE_ENCODER_1 1	/*count on TI2FP2 edges depending on TI1FP1 level*/
+#define TIM_SLAVE_MODE_ENCODER_2 2	/*count on TI1FP1 edges depending on TI2FP2 level*/
+#define TIM_SLAVE_MODE_ENCODER_3 3	/*count on both TI1FP1 and TI2FP2 edges*/
+#define TIM_SLAVE_MODE_RESET 4	/*trigger rising edge reset counter*/
+#define TIM_SLAVE_MODE_GATED 5	/*counter run while trigger is high*/
+#define TIM_SLAVE_MODE_TRIGGER 6	/*trigger rising edge start counter*/
+#define TIM_SLAVE_MODE_EXT_CLK 7	/*trigger rising edges clock counter*/
+
+/*
+*@TIM_TRIGGER
+*Slave mode trigger input (TS bits)
+*/
+#define TIM_TRIGGER_ITR0 0
+#define TIM_TRIGGER_ITR1 1
+#define TIM_TRIGGER_ITR2 2
+#define TIM_TRIGGER_ITR3 3
+#define TIM_TRIGGER_TI1F_ED 4	/*both edges of TI1*/
+#define TIM_TRIGGER_TI1FP1 5	/*filtered TI1, with channel 1 polarity*/
+#define TIM_TRIGGER_TI2FP2 6	/*filtered TI2, with channel 2 polarity*/
+#define TIM_TRIGGER_ETRF 7
+
+/*
+*@TIM_MASTER_MODE
+*Trigger output (TRGO) source (MMS bits)
+*/
+#define TIM_MASTER_MODE_RESET 0	/*UG bit or slave mode reset*/
+#define TIM_MASTER_MODE_ENABLE 1	/*counter enable*/
+#define TIM_MASTER_MODE_UPDATE 2	/*update event*/
+#define TIM_MASTER_MODE_COMPARE_PULSE 3	/*pulse on each capture or compare match of channel 1*/
+#define TIM_MASTER_MODE_OC1REF 4
+#define TIM_MASTER_MODE_OC2REF 5
+#define TIM_MASTER_MODE_OC3REF 6
+#define TIM_MASTER_MODE_OC4REF 7
+
+/*
+*@TIM_DMA_REQUEST
+*Timer event requesting DMA transfer (DMA request enable bit is bit (8 + request) of DIER)
+*/
+#define TIM_DMA_REQ_UPDATE 0
+#define TIM_DMA_REQ_CC1 1
+#define TIM_DMA_REQ_CC2 2
+#define TIM_DMA_REQ_CC3 3
+#define TIM_DMA_REQ_CC4 4
+#define TIM_DMA_REQ_COM 5
+#define TIM_DMA_REQ_TRIGGER 6
+
+/*
+*@TIM_DMA_BASE
+*First register accessed through DMAR in DMA burst (word offset from CR1)
+*/
+#define TIM_DMA_BASE_ARR 11
+#define TIM_DMA_BASE_RCR 12
+#define TIM_DMA_BASE_CCR1 13
+#define TIM_DMA_BASE_CCR2 14
+#define TIM_DMA_BASE_CCR3 15
+#define TIM_DMA_BASE_CCR4 16
+
 /***********************************************************************
 Timer structure definition
 ***********************************************************************/
 
 typedef struct{
-	uint16_t reloadVal;	 
+	uint32_t reloadVal;	/*16 bits, 32 bits on TIM2 and TIM5*/
 	uint16_t prescaler;	
 }TIM_Config_t;
 
@@ -31,6 +210,30 @@ typedef struct{
 	TIM_Config_t *TIMxConfigPtr;
 }TIM_Handle_t;
 
+typedef struct{
+	uint8_t channel;	/*refer to @TIM_CHANNEL for possible value*/
+	uint8_t mode;	/*refer to @TIM_OC_MODE for possible value*/
+	uint32_t compareVal;	/*compare value (PWM duty cycle = compareVal/(reloadVal + 1))*/
+	uint8_t polarity;	/*refer to @TIM_OC_POLARITY for possible value*/
+	uint8_t complementary;	/*ENABLE to drive complementary output CHxN (TIM1 and TIM8 only), with same polarity as CHx*/
+}TIM_OC_Config_t;
+
+typedef struct{
+	uint8_t channel;	/*refer to @TIM_CHANNEL for possible value*/
+	uint8_t selection;	/*refer to @TIM_IC_SELECTION for possible value*/
+	uint8_t polarity;	/*refer to @TIM_IC_POLARITY for possible value*/
+	uint8_t prescaler;	/*refer to @TIM_IC_PRESCALER for possible value*/
+	uint8_t filter;	/*0 (no filter) to 15, refer to ICxF bits in reference manual*/
+}TIM_IC_Config_t;
+
+typedef struct{
+	uint8_t mode;	/*TIM_SLAVE_MODE_ENCODER_1, TIM_SLAVE_MODE_ENCODER_2 or TIM_SLAVE_MODE_ENCODER_3 (refer to @TIM_SLAVE_MODE)*/
+	uint8_t polarityA;	/*TIM_IC_POLARITY_RISING (non-inverted) or TIM_IC_POLARITY_FALLING (inverted) for TI1*/
+	uint8_t polarityB;	/*TIM_IC_POLARITY_RISING (non-inverted) or TIM_IC_POLARITY_FALLING (inverted) for TI2*/
+	uint8_t filter;	/*0 (no filter) to 15, applied to both inputs*/
+	uint32_t reloadVal;	/*counter wrap around after reloadVal (counts per revolution - 1, or full counter range)*/
+}TIM_Encoder_Config_t;
+
 /***********************************************************************
 Timer driver APIs prototype
 ***********************************************************************/
@@ -56,6 +259,9 @@ void TIM_ctr(TIM_TypeDef *TIMxPtr, uint8_t startOrStop);
 
 /**
 *@brief Initialize timer
+*
+*Counter frequency (timer clock/(prescaler + 1)) is kept across clock changes made through RCC driver.
+*
 *@param Pointer to timer handle struct
 *@return none
 */
@@ -83,7 +289,7 @@ void TIM_deinit(TIM_TypeDef *TIMxPtr);
 *@param Reload value
 *@return none
 */
-void TIM_set_reload_val(TIM_TypeDef *TIMxPtr, uint16_t reloadVal);
+void TIM_set_reload_val(TIM_TypeDef *TIMxPtr, uint32_t reloadVal);
 
 /**
 *@brief Set timer 's prescaler
@@ -91,7 +297,7 @@ void TIM_set_reload_val(TIM_TypeDef *TIMxPtr, uint16_t reloadVal);
 *@param Prescaler
 *@return none
 */
-void TIM_ser_prescaler(TIM_TypeDef *TIMxPtr, uint16_t prescaler);
+void TIM_set_prescaler(TIM_TypeDef *TIMxPtr, uint16_t prescaler);
 
 /**
 *@brief Enable or disable interrupt for update event of timer
@@ -119,6 +325,9 @@ void TIM_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority);
 
 /**
 *@brief Timer interrupt handler
+*
+*Clear pending update and capture/compare flag whose interrupt is enabled, and call TIM_application_event_callback for each of them.
+*
 *@param Pointer to base address of timer
 *@return none
 */
@@ -130,4 +339,158 @@ void TIM_intrpt_handler (TIM_TypeDef *TIMxPtr);
 *@return none
 */
 void TIM_update_event_TRGO (TIM_TypeDef *TIMxPtr);
+
+/**
+*@brief Initialize timer channel as output compare or PWM output
+*
+*Preload of compare value is enabled so that new value take effect at next update event. 
+*Main output of advanced timers (TIM1, TIM8) is enabled.
+*
+*@param Pointer to base address of timer
+*@param Pointer to output compare configuration struct
+*@return none
+*/
+void TIM_OC_init(TIM_TypeDef *TIMxPtr, TIM_OC_Config_t *OCConfigPtr);
+
+/**
+*@brief Initialize timer channel as input capture
+*@param Pointer to base address of timer
+*@param Pointer to input capture configuration struct
+*@return none
+*/
+void TIM_IC_init(TIM_TypeDef *TIMxPtr, TIM_IC_Config_t *ICConfigPtr);
+
+/**
+*@brief Set compare value of timer channel (PWM duty cycle)
+*@param Pointer to base address of timer
+*@param Channel (refer to @TIM_CHANNEL)
+*@param Compare value
+*@return none
+*/
+void TIM_set_compare_val(TIM_TypeDef *TIMxPtr, uint8_t channel, uint32_t compareVal);
+
+/**
+*@brief Get last captured counter value of timer channel
+*@param Pointer to base address of timer
+*@param Channel (refer to @TIM_CHANNEL)
+*@return Captured value
+*/
+uint32_t TIM_get_capture_val(TIM_TypeDef *TIMxPtr, uint8_t channel);
+
+/**
+*@brief Get current counter value
+*@param Pointer to base address of timer
+*@return Counter value
+*/
+uint32_t TIM_get_counter(TIM_TypeDef *TIMxPtr);
+
+/**
+*@brief Config dead-time inserted between complementary outputs (TIM1 and TIM8 only)
+*
+*Dead-time is rounded down to nearest value that can be generated from timer clock (clock division 1), 
+*and clamped to maximum (1008 timer clock cycles).
+*
+*@param Pointer to base address of timer
+*@param Dead-time (in nanosecond)
+*@return none
+*/
+void TIM_dead_time_config(TIM_TypeDef *TIMxPtr, uint32_t deadTimeNs);
+
+/**
+*@brief Enable or disable main output of advanced timers (TIM1 and TIM8)
+*@param Pointer to base address of timer
+*@param Enable or disable action
+*@return none
+*/
+void TIM_main_output_ctr(TIM_TypeDef *TIMxPtr, uint8_t enOrDis);
+
+/**
+*@brief Enable or disable one pulse mode
+*
+*In one pulse mode, counter stop at next update event. Combined with PWM2 mode, a single pulse of 
+*(reloadVal - compareVal) cycles is generated after a delay of compareVal cycles each time timer is started.
+*
+*@param Pointer to base address of timer
+*@param Enable or disable action
+*@return none
+*/
+void TIM_one_pulse_ctr(TIM_TypeDef *TIMxPtr, uint8_t enOrDis);
+
+/**
+*@brief Enable or disable capture/compare interrupt of timer channel
+*@param Pointer to base address of timer
+*@param Channel (refer to @TIM_CHANNEL)
+*@param Enable or disable action
+*@return none
+*/
+void TIM_channel_interrupt_ctr(TIM_TypeDef *TIMxPtr, uint8_t channel, uint8_t enOrDis);
+
+/**
+*@brief Inform application of timer event
+*@param Pointer to base address of timer
+*@param Event macro (refer to @TIM_EVENT)
+*@return none
+*/
+void TIM_application_event_callback (TIM_TypeDef *TIMxPtr, uint8_t event);
+
+/**
+*@brief Get clock frequency of timer counter before prescaler
+*@param Pointer to base address of timer
+*@return Timer clock (in Hz), -1 if error
+*/
+int32_t TIM_get_CLK_value(TIM_TypeDef *TIMxPtr);
+
+/**
+*@brief Config slave mode controller
+*
+*Slave mode exist on TIM1-TIM5, TIM8, TIM9 and TIM12.
+*
+*@param Pointer to base address of timer
+*@param Slave mode (refer to @TIM_SLAVE_MODE)
+*@param Trigger input (refer to @TIM_TRIGGER), ignored in encoder modes
+*@return none
+*/
+void TIM_slave_mode_config(TIM_TypeDef *TIMxPtr, uint8_t slaveMode, uint8_t trigger);
+
+/**
+*@brief Enable or disable DMA request on timer event
+*@param Pointer to base address of timer
+*@param Request (refer to @TIM_DMA_REQUEST)
+*@param Enable or disable action
+*@return none
+*/
+void TIM_DMA_request_ctr(TIM_TypeDef *TIMxPtr, uint8_t request, uint8_t enOrDis);
+
+/**
+*@brief Config DMA burst through DMAR register
+*
+*Each DMA request then access transferNum consecutive timer registers from baseReg through DMAR, 
+*DMA stream must point to DMAR and transfer words.
+*
+*@param Pointer to base address of timer
+*@param First register of burst (refer to @TIM_DMA_BASE)
+*@param Number of registers accessed per request (1 - 18)
+*@return none
+*/
+void TIM_DMA_burst_config(TIM_TypeDef *TIMxPtr, uint8_t baseReg, uint8_t transferNum);
+
+/**
+*@brief Initialize timer as quadrature encoder interface
+*
+*Counter is clocked by edges of channel 1 (A) and channel 2 (B) inputs and count up or down depending on phase between them.
+*Encoder mode exist on TIM1-TIM5 and TIM8. Counter start from 0, timer is to be started with TIM_ctr.
+*
+*@param Pointer to base address of timer
+*@param Pointer to encoder configuration struct
+*@return none
+*/
+void TIM_encoder_init(TIM_TypeDef *TIMxPtr, TIM_Encoder_Config_t *encoderConfigPtr);
+
+/**
+*@brief Select timer trigger output (TRGO) source
+*@param Pointer to base address of timer
+*@param Master mode (refer to @TIM_MASTER_MODE)
+*@return none
+*/
+void TIM_master_mode_config(TIM_TypeDef *TIMxPtr, uint8_t masterMode);
 #endif
\ No newline at end of file
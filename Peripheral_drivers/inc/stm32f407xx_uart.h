@@ -8,6 +8,24 @@
 *@date 15/08/2019
 */
 
+/**
+*@Version 1.1
+*baud rate set by UART_init is kept across system clock changes: BRR of each initialized UART is re-derived by a RCC clock hook
+*19/10/2026
+*/
+
+/**
+*@Version 1.2
+*UART_intrpt_handler is tagged RAM_FUNC, run from SRAM if linker script place section ".RamFunc" there
+*19/10/2026
+*/
+
+/**
+*@Version 1.3
+*interrupt transfers hold a stop lock (stm32f407xx_pwr) until they are closed
+*19/10/2026
+*/
+
 #ifndef STM32F407XX_UART_H
 #define STM32F407XX_UART_H
 
@@ -15,6 +33,7 @@
 #include "stm32f407xx_common_macro.h"
 #include "stm32f407xx_rcc.h"
 #include "stm32f407xx_gpio.h"
+#include "stm32f407xx_pwr.h"
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -188,7 +207,7 @@ void UART_init(UART_Handle_t *UARTxHandlePtr);
 *@param UART mode (transceiver, receiver, transceiver & receiver)
 *@param Parity control
 *@param Flow control
-*@return none
+*@return Pointer to UART handle struct, NULL if pins of pins pack are used by another pins pack
 */
 UART_Handle_t* UART_general_init(USART_TypeDef *UARTxPtr, UART_Pins_pack_t pinsPack, uint32_t baudRate, uint8_t stopBit, uint8_t wordLength, uint8_t mode, uint8_t parityCtrl, uint8_t flowCtrl);
 
@@ -15,7 +15,16 @@
 
 #include "../inc/stm32f407xx_rng.h"
 
-uint32_t RNG_random_value = 0; 
+#define RNG_POOL_MASK (RNG_POOL_SIZE - 1)
+
+static void RNG_recover(void);
+
+/*pool indices run freely, word n is stored in pool[n & RNG_POOL_MASK]*/
+static volatile uint32_t pool[RNG_POOL_SIZE];
+static volatile uint32_t poolWriteIdx = 0;	/*only written by interrupt handler*/
+static volatile uint32_t poolReadIdx = 0;	/*only written by RNG_read*/
+static volatile uint8_t poolEnabled = 0;
+static volatile uint8_t RNGError = 0;
 
 /***********************************************************************
 RNG clock enable/disable
@@ -57,6 +66,10 @@ void RNG_deinit(void)
 {
 	RCC->AHB2RSTR |= RCC_AHB2RSTR_RNGRST;
 	RCC->AHB2RSTR &= ~RCC_AHB2RSTR_RNGRST;
+	
+	poolEnabled = 0;
+	poolReadIdx = poolWriteIdx;
+	RNGError = 0;
 };
 
 /***********************************************************************
@@ -64,8 +77,64 @@ Read 32-bits random value generated by RNG
 ***********************************************************************/		
 uint32_t RNG_get(void)
 {
-	while(!(RNG->SR & RNG_SR_DRDY));
-	return RNG->DR;
+	uint32_t value;
+	
+	if(poolEnabled){
+		while(RNG_read((uint8_t*)&value,sizeof(value)) == 0);
+		return value;
+	}
+	
+	while(1){
+		RNG_recover();
+		uint32_t SR = RNG->SR;
+		if((SR & RNG_SR_DRDY) && !(SR & RNG_SR_SECS)){
+			return RNG->DR;
+		}
+	}
+}
+
+/***********************************************************************
+Read random bytes from pool
+***********************************************************************/
+uint32_t RNG_read(uint8_t *bufferPtr, uint32_t len)
+{
+	uint32_t readNum = 0;
+	
+	while(readNum < len && poolReadIdx != poolWriteIdx){
+		uint32_t word = pool[poolReadIdx & RNG_POOL_MASK];
+		poolReadIdx++;
+		uint32_t byteNum = (len - readNum < sizeof(word)) ? len - readNum : sizeof(word);
+		memcpy(&bufferPtr[readNum],&word,byteNum);
+		readNum += byteNum;
+	}
+	
+	/*pool has room again, handler may have stopped interrupt when it was full*/
+	if(poolEnabled && readNum){
+		RNG->CR |= RNG_CR_IE;
+	}
+	return readNum;
+}
+
+/***********************************************************************
+Get number of random bytes in pool
+***********************************************************************/
+uint32_t RNG_get_available(void)
+{
+	return (poolWriteIdx - poolReadIdx)*sizeof(uint32_t);
+}
+
+/***********************************************************************
+Get and clear errors
+***********************************************************************/
+uint8_t RNG_get_error(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint8_t error = RNGError;
+	RNGError = 0;
+	__set_PRIMASK(primask);
+	
+	return error;
 }
 
 /***********************************************************************
@@ -74,8 +143,10 @@ Enable/disable RNG 's interrupt
 void RNG_intrpt_ctr(uint8_t enOrDis)
 {
 	if(enOrDis == ENABLE){
+		poolEnabled = 1;
 		RNG->CR |= RNG_CR_IE;
-	}else if (enOrDis == ENABLE){
+	}else if (enOrDis == DISABLE){
+		poolEnabled = 0;
 		RNG->CR &= ~RNG_CR_IE;	
 	}
 }
@@ -125,19 +196,40 @@ RNG 's interrupt handler
 ***********************************************************************/
 void RNG_intrpt_handler (void)
 {
-	uint8_t check1 = (RNG->CR & RNG_CR_IE) >> RNG_CR_IE_Pos;
-	uint8_t check2 = (RNG->SR & RNG_SR_DRDY) >> RNG_SR_DRDY_Pos;
+	RNG_recover();
 	
-	/*case interrupt triggered due to data is ready*/
-	if(check1 & check2){
-		RNG_random_value = RNG->DR;
+	uint32_t SR = RNG->SR;
+	if((SR & RNG_SR_DRDY) && !(SR & RNG_SR_SECS)){
+		if(poolWriteIdx - poolReadIdx < RNG_POOL_SIZE){
+			pool[poolWriteIdx & RNG_POOL_MASK] = RNG->DR;
+			poolWriteIdx++;
+		}
+		/*pool full: no more interrupt until RNG_read make room*/
+		if(poolWriteIdx - poolReadIdx >= RNG_POOL_SIZE){
+			RNG->CR &= ~RNG_CR_IE;
+		}
 	}
+}
+
+/***********************************************************************
+Private function: recover from seed error, clear clock error
+@note interrupt flags are cleared by writing 0, other SR bits are read only
+***********************************************************************/
+static void RNG_recover(void)
+{
+	uint32_t SR = RNG->SR;
 	
-	check1 = (RNG->CR & RNG_CR_IE) >> RNG_CR_IE_Pos;
-	check2 = (RNG->SR & RNG_SR_CEIS) >> RNG_SR_CEIS_Pos;
+	/*seed error: word in data register is not to be used, RNG is restarted to reseed*/
+	if(SR & RNG_SR_SEIS){
+		RNG->SR = ~RNG_SR_SEIS;
+		RNG->CR &= ~RNG_CR_RNGEN;
+		RNG->CR |= RNG_CR_RNGEN;
+		RNGError |= RNG_ERR_SEED;
+	}
 	
-	/*case interrupt triggered due to clock is not correctly detected*/
-	if(check1 & check2){
-		RNG->SR &= ~RNG_SR_CEIS;
+	/*clock error: previously generated words stay valid, generation resume once CECS is cleared by hardware*/
+	if(SR & RNG_SR_CEIS){
+		RNG->SR = ~RNG_SR_CEIS;
+		RNGError |= RNG_ERR_CLOCK;
 	}
 }
@@ -78,6 +78,9 @@ void ADC_init(ADC_Handle_t *ADCxHandlePtr)
 	/*enable clock for ADCx peripheral*/
 	ADC_CLK_ctr(ADCxHandlePtr->ADCxPtr,ENABLE);
 	
+	/*time base is used for conversion timeout*/
+	TIME_init();
+	
 	/*turn off ADCx peripheral for initilization*/
 	ADC_ctr(ADCxHandlePtr->ADCxPtr,DISABLE);
 	
@@ -159,18 +162,16 @@ Write digital value to ADC
 ***********************************************************************/
 uint16_t ADC_read(ADC_TypeDef *ADCxPtr, uint8_t channel)
 {
-	uint16_t timeOut = 0xFFF;
-	
 	ADC_configure_channel(ADCxPtr,channel);
 	
 	/*execute software start*/
 	ADCxPtr->CR2 |= ADC_CR2_SWSTART;
+	uint64_t startTime = TIME_get_us();
 	
 	/*wait until conversion end*/
 	while(!(ADCxPtr->SR & ADC_SR_EOC))
 	{
-		timeOut--;
-		if(!timeOut){
+		if(TIME_is_timeout(startTime,ADC_TIMEOUT_US)){
 			return 0;
 		}
 	}
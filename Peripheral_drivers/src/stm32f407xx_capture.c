@@ -0,0 +1,340 @@
+/**
+*@file stm32f407xx_capture.c
+*@brief provide frequency and duty cycle measurement of external signals on stm32f407xx MCUs.
+*
+*This source file provide APIs for measuring period and active time of a signal with a timer in PWM input mode.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_capture.h"
+
+typedef struct{
+	TIM_TypeDef *TIMxPtr;
+	uint8_t inputChannel;
+	DMA_TypeDef *DMAxPtr;
+	uint8_t streamNo;
+	uint8_t DMAChannel;
+}CAPTURE_DMA_Map_t;
+
+/*DMA stream and channel serving capture request of channel 1 and channel 2, refer to DMA request mapping in reference manual*/
+static const CAPTURE_DMA_Map_t DMAMap[] = {
+	{TIM1,TIM_CHANNEL_1,DMA2,1,6},{TIM1,TIM_CHANNEL_2,DMA2,2,6},
+	{TIM2,TIM_CHANNEL_1,DMA1,5,3},{TIM2,TIM_CHANNEL_2,DMA1,6,3},
+	{TIM3,TIM_CHANNEL_1,DMA1,4,5},{TIM3,TIM_CHANNEL_2,DMA1,5,5},
+	{TIM4,TIM_CHANNEL_1,DMA1,0,2},{TIM4,TIM_CHANNEL_2,DMA1,3,2},
+	{TIM5,TIM_CHANNEL_1,DMA1,2,6},{TIM5,TIM_CHANNEL_2,DMA1,4,6},
+	{TIM8,TIM_CHANNEL_1,DMA2,2,7},{TIM8,TIM_CHANNEL_2,DMA2,3,7},
+};
+
+static uint8_t CAPTURE_has_slave_mode(TIM_TypeDef *TIMxPtr);
+static void CAPTURE_DMA_init(CAPTURE_Handle_t *CAPTUREHandlePtr, const CAPTURE_DMA_Map_t *mapPtr);
+static uint16_t CAPTURE_get_write_idx(CAPTURE_Handle_t *CAPTUREHandlePtr);
+static uint32_t CAPTURE_tick_to_ns(CAPTURE_Handle_t *CAPTUREHandlePtr, uint64_t ticks);
+
+/***********************************************************************
+Initialize timer in PWM input mode and ring buffer
+***********************************************************************/
+int32_t CAPTURE_init(CAPTURE_Handle_t *CAPTUREHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = CAPTUREHandlePtr->TIMxPtr;
+	CAPTURE_Config_t *configPtr = CAPTUREHandlePtr->CAPTUREConfigPtr;
+	const CAPTURE_DMA_Map_t *mapPtr = NULL;
+
+	if(!CAPTURE_has_slave_mode(TIMxPtr) || configPtr->sampleNum < 2 || configPtr->sampleNum > 0x7FFF){
+		return -1;
+	}
+	if(configPtr->mode == CAPTURE_MODE_DMA){
+		for(uint8_t i = 0; i < sizeof(DMAMap)/sizeof(DMAMap[0]); i++){
+			if(DMAMap[i].TIMxPtr == TIMxPtr && DMAMap[i].inputChannel == configPtr->inputChannel){
+				mapPtr = &DMAMap[i];
+			}
+		}
+		if(mapPtr == NULL || DMA_stream_reserve(DMA_get_stream(mapPtr->DMAxPtr,mapPtr->streamNo),CAPTUREHandlePtr) < 0){
+			return -1;
+		}
+	}
+
+	/*counter run over its whole range, prescaler is rounded to nearest available counter frequency*/
+	int32_t TIMCLK = TIM_get_CLK_value(TIMxPtr);
+	uint32_t prescaler = (TIMCLK + configPtr->countFreq/2)/configPtr->countFreq;
+	if(prescaler == 0){
+		prescaler = 1;
+	}else if(prescaler > 0x10000){
+		prescaler = 0x10000;
+	}
+	TIM_Config_t TIMConfig = {.reloadVal = 0xFFFFFFFF,.prescaler = prescaler - 1};
+	TIM_Handle_t TIMHandle = {TIMxPtr,&TIMConfig};
+	TIM_init(&TIMHandle);
+	CAPTUREHandlePtr->countFreq = TIMCLK/prescaler;
+
+	/*input channel capture period on active edge, paired channel capture active time on opposite edge of same input*/
+	uint8_t periodChannel = configPtr->inputChannel;
+	uint8_t activeChannel = (periodChannel == TIM_CHANNEL_1) ? TIM_CHANNEL_2 : TIM_CHANNEL_1;
+	TIM_IC_Config_t ICConfig = {.channel = periodChannel,.selection = TIM_IC_DIRECT_TI,.polarity = configPtr->activeEdge,
+															.prescaler = TIM_IC_PRESCALER_DIV1,.filter = configPtr->filter};
+	TIM_IC_init(TIMxPtr,&ICConfig);
+
+	ICConfig.channel = activeChannel;
+	ICConfig.selection = TIM_IC_INDIRECT_TI;
+	ICConfig.polarity = (configPtr->activeEdge == TIM_IC_POLARITY_RISING) ? TIM_IC_POLARITY_FALLING : TIM_IC_POLARITY_RISING;
+	TIM_IC_init(TIMxPtr,&ICConfig);
+
+	/*active edge reset counter*/
+	TIM_slave_mode_config(TIMxPtr,TIM_SLAVE_MODE_RESET,(periodChannel == TIM_CHANNEL_1) ? TIM_TRIGGER_TI1FP1 : TIM_TRIGGER_TI2FP2);
+
+	if(mapPtr != NULL){
+		/*each capture request read CCR1 and CCR2 into ring buffer*/
+		TIM_DMA_burst_config(TIMxPtr,TIM_DMA_BASE_CCR1,2);
+		CAPTURE_DMA_init(CAPTUREHandlePtr,mapPtr);
+	}else{
+		CAPTUREHandlePtr->DMAStreamPtr = NULL;
+		TIM_channel_interrupt_ctr(TIMxPtr,periodChannel,ENABLE);
+	}
+	CAPTUREHandlePtr->busy = 0;
+
+	return CAPTUREHandlePtr->countFreq;
+}
+
+/***********************************************************************
+Start measurement
+***********************************************************************/
+void CAPTURE_start(CAPTURE_Handle_t *CAPTUREHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = CAPTUREHandlePtr->TIMxPtr;
+	DMA_Stream_TypeDef *streamPtr = CAPTUREHandlePtr->DMAStreamPtr;
+
+	CAPTUREHandlePtr->writeIdx = 0;
+	CAPTUREHandlePtr->readIdx = 0;
+	CAPTUREHandlePtr->discard = 1;
+	CAPTUREHandlePtr->error = 0;
+
+	TIMxPtr->CNT = 0;
+	TIMxPtr->SR = 0;
+
+	if(streamPtr != NULL){
+		/*restart DMA from beginning of ring buffer*/
+		streamPtr->CR &= ~DMA_SxCR_EN;
+		while(streamPtr->CR & DMA_SxCR_EN);
+		streamPtr->NDTR = CAPTURE_BUFFER_SIZE(CAPTUREHandlePtr->CAPTUREConfigPtr->sampleNum);
+		streamPtr->CR |= DMA_SxCR_EN;
+		TIM_DMA_request_ctr(TIMxPtr,CAPTUREHandlePtr->CAPTUREConfigPtr->inputChannel,ENABLE);
+	}
+
+	TIM_ctr(TIMxPtr,START);
+
+	/*restart without stop keep the lock already held*/
+	if(!CAPTUREHandlePtr->busy){
+		CAPTUREHandlePtr->busy = 1;
+		PWR_stop_lock(PWR_LOCK_CAPTURE);
+	}
+}
+
+/***********************************************************************
+Stop measurement
+***********************************************************************/
+void CAPTURE_stop(CAPTURE_Handle_t *CAPTUREHandlePtr)
+{
+	TIM_ctr(CAPTUREHandlePtr->TIMxPtr,STOP);
+
+	if(CAPTUREHandlePtr->DMAStreamPtr != NULL){
+		TIM_DMA_request_ctr(CAPTUREHandlePtr->TIMxPtr,CAPTUREHandlePtr->CAPTUREConfigPtr->inputChannel,DISABLE);
+		CAPTUREHandlePtr->DMAStreamPtr->CR &= ~DMA_SxCR_EN;
+	}
+
+	if(CAPTUREHandlePtr->busy){
+		CAPTUREHandlePtr->busy = 0;
+		PWR_stop_unlock(PWR_LOCK_CAPTURE);
+	}
+}
+
+/***********************************************************************
+Read oldest sample from ring buffer
+***********************************************************************/
+uint8_t CAPTURE_read(CAPTURE_Handle_t *CAPTUREHandlePtr, uint32_t *periodPtr, uint32_t *activePtr)
+{
+	CAPTURE_Config_t *configPtr = CAPTUREHandlePtr->CAPTUREConfigPtr;
+	uint16_t writeIdx = CAPTURE_get_write_idx(CAPTUREHandlePtr);
+
+	while(CAPTUREHandlePtr->readIdx != writeIdx){
+		/*sample hold CCR1 then CCR2, period is in CCR of input channel*/
+		uint32_t *samplePtr = &configPtr->bufferPtr[2*CAPTUREHandlePtr->readIdx];
+		uint32_t period = samplePtr[configPtr->inputChannel - 1];
+		uint32_t active = samplePtr[2 - configPtr->inputChannel];
+
+		CAPTUREHandlePtr->readIdx = (CAPTUREHandlePtr->readIdx + 1) % configPtr->sampleNum;
+		if(CAPTUREHandlePtr->discard){
+			CAPTUREHandlePtr->discard = 0;
+			continue;
+		}
+
+		/*counter restart from 0 one tick after active edge, so both captured values are one tick short*/
+		*periodPtr = period + 1;
+		*activePtr = active + 1;
+		return 1;
+	}
+	return 0;
+}
+
+/***********************************************************************
+Compute statistics over window of samples captured since previous call
+***********************************************************************/
+void CAPTURE_get_stats(CAPTURE_Handle_t *CAPTUREHandlePtr, CAPTURE_Stats_t *statsPtr)
+{
+	TIM_TypeDef *TIMxPtr = CAPTUREHandlePtr->TIMxPtr;
+	uint64_t periodSum = 0;
+	uint64_t activeSum = 0;
+	uint32_t periodMin = 0xFFFFFFFF;
+	uint32_t periodMax = 0;
+	uint16_t dutyMin = 10000;
+	uint16_t dutyMax = 0;
+	uint16_t count = 0;
+	uint32_t period, active;
+
+	while(CAPTURE_read(CAPTUREHandlePtr,&period,&active)){
+		/*at 0 % or 100 % duty cycle there is no opposite edge, paired channel keep an old value*/
+		if(active > period){
+			active = period;
+		}
+		uint16_t duty = ((uint64_t)active*10000)/period;
+
+		periodSum += period;
+		activeSum += active;
+		periodMin = (period < periodMin) ? period : periodMin;
+		periodMax = (period > periodMax) ? period : periodMax;
+		dutyMin = (duty < dutyMin) ? duty : dutyMin;
+		dutyMax = (duty > dutyMax) ? duty : dutyMax;
+		count++;
+	}
+
+	if(CAPTUREHandlePtr->DMAStreamPtr != NULL){
+		/*in DMA mode counter overflow is only seen here, window may hold a sample spanning overflow*/
+		if(TIMxPtr->SR & TIM_SR_UIF){
+			TIMxPtr->SR = ~TIM_SR_UIF;
+			CAPTUREHandlePtr->error |= CAPTURE_ERR_OVERFLOW;
+		}
+		statsPtr->error = CAPTUREHandlePtr->error;
+		CAPTUREHandlePtr->error = 0;
+	}else{
+		TIM_channel_interrupt_ctr(TIMxPtr,CAPTUREHandlePtr->CAPTUREConfigPtr->inputChannel,DISABLE);
+		statsPtr->error = CAPTUREHandlePtr->error;
+		CAPTUREHandlePtr->error = 0;
+		TIM_channel_interrupt_ctr(TIMxPtr,CAPTUREHandlePtr->CAPTUREConfigPtr->inputChannel,ENABLE);
+	}
+
+	statsPtr->sampleCount = count;
+	if(!count){
+		statsPtr->frequency = 0;
+		statsPtr->periodAvg = 0;
+		statsPtr->periodMin = 0;
+		statsPtr->periodMax = 0;
+		statsPtr->dutyAvg = 0;
+		statsPtr->dutyMin = 0;
+		statsPtr->dutyMax = 0;
+		return;
+	}
+
+	statsPtr->frequency = ((uint64_t)count*CAPTUREHandlePtr->countFreq + periodSum/2)/periodSum;
+	statsPtr->periodAvg = CAPTURE_tick_to_ns(CAPTUREHandlePtr,periodSum/count);
+	statsPtr->periodMin = CAPTURE_tick_to_ns(CAPTUREHandlePtr,periodMin);
+	statsPtr->periodMax = CAPTURE_tick_to_ns(CAPTUREHandlePtr,periodMax);
+	statsPtr->dutyAvg = (activeSum*10000)/periodSum;
+	statsPtr->dutyMin = dutyMin;
+	statsPtr->dutyMax = dutyMax;
+}
+
+/***********************************************************************
+Capture interrupt handler
+***********************************************************************/
+void CAPTURE_intrpt_handler(CAPTURE_Handle_t *CAPTUREHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = CAPTUREHandlePtr->TIMxPtr;
+	CAPTURE_Config_t *configPtr = CAPTUREHandlePtr->CAPTUREConfigPtr;
+	uint32_t status = TIMxPtr->SR;
+
+	/*capture flag of channel x is bit x of SR*/
+	if(!(status & (1 << configPtr->inputChannel))){
+		return;
+	}
+
+	/*reading capture registers clear capture flags*/
+	uint32_t CCR1Val = TIMxPtr->CCR1;
+	uint32_t CCR2Val = TIMxPtr->CCR2;
+
+	/*counter overflowed since previous active edge: period does not fit counter, sample is dropped*/
+	if(status & TIM_SR_UIF){
+		TIMxPtr->SR = ~TIM_SR_UIF;
+		CAPTUREHandlePtr->error |= CAPTURE_ERR_OVERFLOW;
+		return;
+	}
+
+	uint16_t nextIdx = (CAPTUREHandlePtr->writeIdx + 1) % configPtr->sampleNum;
+	if(nextIdx == CAPTUREHandlePtr->readIdx){
+		CAPTUREHandlePtr->error |= CAPTURE_ERR_OVERRUN;
+		return;
+	}
+	configPtr->bufferPtr[2*CAPTUREHandlePtr->writeIdx] = CCR1Val;
+	configPtr->bufferPtr[2*CAPTUREHandlePtr->writeIdx + 1] = CCR2Val;
+	CAPTUREHandlePtr->writeIdx = nextIdx;
+}
+
+/***********************************************************************
+Private function: check whether timer has slave mode controller and 2 input channels
+***********************************************************************/
+static uint8_t CAPTURE_has_slave_mode(TIM_TypeDef *TIMxPtr)
+{
+	return (TIMxPtr == TIM1 || TIMxPtr == TIM2 || TIMxPtr == TIM3 || TIMxPtr == TIM4
+					|| TIMxPtr == TIM5 || TIMxPtr == TIM8 || TIMxPtr == TIM9 || TIMxPtr == TIM12);
+}
+
+/***********************************************************************
+Private function: config circular DMA from timer DMAR register to ring buffer
+***********************************************************************/
+static void CAPTURE_DMA_init(CAPTURE_Handle_t *CAPTUREHandlePtr, const CAPTURE_DMA_Map_t *mapPtr)
+{
+	DMA_Stream_TypeDef *streamPtr = DMA_get_stream(mapPtr->DMAxPtr,mapPtr->streamNo);
+	/*each stream has 6 bits of flags, at bit 0, 6, 16, 22 of LIFCR (stream 0-3) and HIFCR (stream 4-7)*/
+	static const uint8_t flagShift[4] = {0,6,16,22};
+	volatile uint32_t *IFCRPtr = (mapPtr->streamNo < 4) ? &mapPtr->DMAxPtr->LIFCR : &mapPtr->DMAxPtr->HIFCR;
+
+	/*enable clock for DMA and disable stream for configuration*/
+	RCC->AHB1ENR |= (mapPtr->DMAxPtr == DMA1) ? RCC_AHB1ENR_DMA1EN : RCC_AHB1ENR_DMA2EN;
+	streamPtr->CR &= ~DMA_SxCR_EN;
+	while(streamPtr->CR & DMA_SxCR_EN);
+	*IFCRPtr = 0x3D << flagShift[mapPtr->streamNo % 4];
+
+	streamPtr->PAR = (uint32_t)&CAPTUREHandlePtr->TIMxPtr->DMAR;
+	streamPtr->M0AR = (uint32_t)CAPTUREHandlePtr->CAPTUREConfigPtr->bufferPtr;
+	streamPtr->NDTR = CAPTURE_BUFFER_SIZE(CAPTUREHandlePtr->CAPTUREConfigPtr->sampleNum);
+	streamPtr->FCR = 0;
+
+	/*peripheral to memory, word transfers, circular, high priority since a late transfer lose a capture*/
+	streamPtr->CR = (mapPtr->DMAChannel << DMA_SxCR_CHSEL_Pos) | (0x02 << DMA_SxCR_MSIZE_Pos) | (0x02 << DMA_SxCR_PSIZE_Pos)
+									| DMA_SxCR_MINC | DMA_SxCR_CIRC | (0x02 << DMA_SxCR_PL_Pos);
+
+	CAPTUREHandlePtr->DMAStreamPtr = streamPtr;
+}
+
+/***********************************************************************
+Private function: get index of next sample to be written
+***********************************************************************/
+static uint16_t CAPTURE_get_write_idx(CAPTURE_Handle_t *CAPTUREHandlePtr)
+{
+	if(CAPTUREHandlePtr->DMAStreamPtr != NULL){
+		/*NDTR count remaining words of current lap, only complete samples are counted*/
+		uint16_t bufferSize = CAPTURE_BUFFER_SIZE(CAPTUREHandlePtr->CAPTUREConfigPtr->sampleNum);
+		return ((bufferSize - CAPTUREHandlePtr->DMAStreamPtr->NDTR)/2) % CAPTUREHandlePtr->CAPTUREConfigPtr->sampleNum;
+	}
+	return CAPTUREHandlePtr->writeIdx;
+}
+
+/***********************************************************************
+Private function: convert counter ticks to nanosecond, clamp to 32 bits
+***********************************************************************/
+static uint32_t CAPTURE_tick_to_ns(CAPTURE_Handle_t *CAPTUREHandlePtr, uint64_t ticks)
+{
+	uint64_t ns = (ticks*1000000000)/CAPTUREHandlePtr->countFreq;
+
+	return (ns > 0xFFFFFFFF) ? 0xFFFFFFFF : ns;
+}
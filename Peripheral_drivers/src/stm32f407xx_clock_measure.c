@@ -0,0 +1,261 @@
+/**
+*@file stm32f407xx_clock_measure.c
+*@brief provide measurement of internal clocks on stm32f407xx MCUs.
+*
+*This source file provide APIs for measuring LSI, LSE and HSE frequencies with timer input capture, and for correcting
+*HSE frequency used by clock computation.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_clock_measure.h"
+
+/*internal routing of timer inputs, refer to TIMx_OR in reference manual*/
+#define CLOCK_TIM5_TI4_MASK (3 << 6)
+#define CLOCK_TIM5_TI4_LSI (1 << 6)
+#define CLOCK_TIM5_TI4_LSE (2 << 6)
+#define CLOCK_TIM11_TI1_MASK 3
+#define CLOCK_TIM11_TI1_HSE_RTC 2
+
+#define CLOCK_IC_DIV 8	/*input periods per capture*/
+#define CLOCK_EDGE_TIMEOUT_DIV 10	/*no capture during 1/10 s of counter clock is a timeout*/
+#define CLOCK_LSI_STARTUP_LOOP 100000
+
+static int8_t CLOCK_capture(TIM_TypeDef *TIMxPtr, uint8_t channel, uint32_t mask, uint32_t counterFreq, uint32_t durationMs,
+															uint64_t *ticksPtr, uint32_t *captureNumPtr);
+static int8_t CLOCK_measure_TIM5(uint32_t route, uint32_t durationMs, uint64_t *ticksPtr, uint32_t *captureNumPtr, uint32_t *counterFreqPtr);
+static int8_t CLOCK_measure_TIM11(uint32_t durationMs, uint64_t *ticksPtr, uint32_t *captureNumPtr, uint32_t *counterFreqPtr);
+static int8_t CLOCK_measure_mHz(uint8_t source, uint32_t durationMs, CLOCK_Measure_t *measurePtr, uint64_t *freqmHzPtr);
+static uint8_t CLOCK_SYSCLK_from_HSE(void);
+
+/***********************************************************************
+Measure an internal clock
+***********************************************************************/
+int8_t CLOCK_measure(uint8_t source, uint32_t durationMs, CLOCK_Measure_t *measurePtr)
+{
+	uint64_t freqmHz;
+
+	return CLOCK_measure_mHz(source,durationMs,measurePtr,&freqmHz);
+}
+
+/***********************************************************************
+Measure HSE against LSE and correct HSE frequency
+***********************************************************************/
+int8_t CLOCK_calibrate_HSE(uint32_t durationMs, int32_t *errorPpmPtr)
+{
+	CLOCK_Measure_t LSEMeasure;
+	uint64_t LSEmHz;
+
+	if(!CLOCK_SYSCLK_from_HSE()){
+		return -1;
+	}
+	if(CLOCK_measure_mHz(CLOCK_SRC_LSE,durationMs,&LSEMeasure,&LSEmHz) == -1){
+		return -1;
+	}
+
+	/*timers count HSE periods believed to last 1/HSEFreq: LSE look slower by the factor HSE is faster*/
+	uint32_t HSEFreq = ((uint64_t)RCC_get_HSE_freq()*CLOCK_LSE_FREQ*1000 + LSEmHz/2)/LSEmHz;
+	int32_t errorPpm = ((int64_t)HSEFreq - RCC_HSE_FREQ)*1000000/RCC_HSE_FREQ;
+
+	if(errorPpmPtr != NULL){
+		*errorPpmPtr = errorPpm;
+	}
+	if(errorPpm > CLOCK_CAL_MAX_PPM || errorPpm < -CLOCK_CAL_MAX_PPM){
+		return -1;
+	}
+
+	RCC_set_HSE_freq(HSEFreq);
+	return 0;
+}
+
+/***********************************************************************
+Private function: measure an internal clock, frequency is also given in mHz
+***********************************************************************/
+static int8_t CLOCK_measure_mHz(uint8_t source, uint32_t durationMs, CLOCK_Measure_t *measurePtr, uint64_t *freqmHzPtr)
+{
+	uint64_t ticks;
+	uint32_t captureNum;
+	uint32_t counterFreq;
+	uint32_t scale = 1;	/*division of measured clock before capture input*/
+	int8_t status = -1;
+
+	if(durationMs > CLOCK_DURATION_MAX_MS){
+		durationMs = CLOCK_DURATION_MAX_MS;
+	}
+
+	if(source == CLOCK_SRC_LSI){
+		uint8_t LSIWasOn = (RCC->CSR & RCC_CSR_LSION) ? 1 : 0;
+		RCC->CSR |= RCC_CSR_LSION;
+		for(uint32_t i = 0; !(RCC->CSR & RCC_CSR_LSIRDY) && i < CLOCK_LSI_STARTUP_LOOP; i++);
+		if(RCC->CSR & RCC_CSR_LSIRDY){
+			status = CLOCK_measure_TIM5(CLOCK_TIM5_TI4_LSI,durationMs,&ticks,&captureNum,&counterFreq);
+		}
+		if(!LSIWasOn){
+			RCC->CSR &= ~RCC_CSR_LSION;
+		}
+		measurePtr->nominalFreq = CLOCK_LSI_FREQ;
+	}else if(source == CLOCK_SRC_LSE){
+		if(RCC->BDCR & RCC_BDCR_LSERDY){
+			status = CLOCK_measure_TIM5(CLOCK_TIM5_TI4_LSE,durationMs,&ticks,&captureNum,&counterFreq);
+		}
+		measurePtr->nominalFreq = CLOCK_LSE_FREQ;
+	}else if(source == CLOCK_SRC_HSE){
+		/*RTC clocked by HSE would be disturbed by RTC prescaler change*/
+		uint8_t RTCOnHSE = ((RCC->BDCR & RCC_BDCR_RTCSEL) == RCC_BDCR_RTCSEL) && (RCC->BDCR & RCC_BDCR_RTCEN);
+		if((RCC->CR & RCC_CR_HSERDY) && !RTCOnHSE && !CLOCK_SYSCLK_from_HSE()){
+			uint32_t RTCPRE = RCC->CFGR & RCC_CFGR_RTCPRE;
+			RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_RTCPRE) | (CLOCK_HSE_RTC_DIV << RCC_CFGR_RTCPRE_Pos);
+			status = CLOCK_measure_TIM11(durationMs,&ticks,&captureNum,&counterFreq);
+			RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_RTCPRE) | RTCPRE;
+		}
+		measurePtr->nominalFreq = RCC_HSE_FREQ;
+		scale = CLOCK_HSE_RTC_DIV;
+	}
+
+	if(status == -1){
+		return -1;
+	}
+
+	/*computed in mHz to keep resolution of low speed clocks*/
+	uint64_t freqmHz = (uint64_t)captureNum*CLOCK_IC_DIV*scale*counterFreq*1000/ticks;
+	measurePtr->frequency = (freqmHz + 500)/1000;
+	measurePtr->errorPpm = ((int64_t)freqmHz - (int64_t)measurePtr->nominalFreq*1000)*1000/measurePtr->nominalFreq;
+	measurePtr->captureNum = captureNum;
+	*freqmHzPtr = freqmHz;
+
+	return 0;
+}
+
+/***********************************************************************
+Private function: accumulate capture periods during given duration
+@note reading capture register clear capture flag, overcapture flag set before reading mean a period is lost
+***********************************************************************/
+static int8_t CLOCK_capture(TIM_TypeDef *TIMxPtr, uint8_t channel, uint32_t mask, uint32_t counterFreq, uint32_t durationMs,
+															uint64_t *ticksPtr, uint32_t *captureNumPtr)
+{
+	uint32_t flagCC = 1 << channel;	/*CCxIF*/
+	uint32_t flagOF = 1 << (channel + 8);	/*CCxOF*/
+	uint64_t durationTicks = (uint64_t)counterFreq*durationMs/1000;
+	uint32_t timeoutTicks = counterFreq/CLOCK_EDGE_TIMEOUT_DIV;
+	uint64_t ticks = 0;
+	uint32_t captureNum = 0;
+	uint32_t idleTicks = 0;
+	uint32_t lastCount = TIMxPtr->CNT;
+	uint32_t lastCapture = 0;
+	uint8_t firstCapture = 1;
+
+	TIMxPtr->SR = ~(flagCC | flagOF);
+
+	while(ticks < durationTicks || !captureNum){
+		uint32_t count = TIMxPtr->CNT;
+		idleTicks += (count - lastCount) & mask;
+		lastCount = count;
+
+		if(TIMxPtr->SR & flagCC){
+			uint32_t capture = TIM_get_capture_val(TIMxPtr,channel);
+			if(TIMxPtr->SR & flagOF){
+				return -1;
+			}
+			if(!firstCapture){
+				ticks += (capture - lastCapture) & mask;
+				captureNum++;
+			}
+			firstCapture = 0;
+			lastCapture = capture;
+			idleTicks = 0;
+		}else if(idleTicks > timeoutTicks){
+			return -1;
+		}
+	}
+
+	*ticksPtr = ticks;
+	*captureNumPtr = captureNum;
+	return 0;
+}
+
+/***********************************************************************
+Private function: measure clock routed to TIM5 channel 4
+***********************************************************************/
+static int8_t CLOCK_measure_TIM5(uint32_t route, uint32_t durationMs, uint64_t *ticksPtr, uint32_t *captureNumPtr, uint32_t *counterFreqPtr)
+{
+	TIM_IC_Config_t ICConfig = {.channel = TIM_CHANNEL_4,.selection = TIM_IC_DIRECT_TI,.polarity = TIM_IC_POLARITY_RISING,
+															.prescaler = TIM_IC_PRESCALER_DIV8,.filter = 0};
+	uint8_t shared = (RCC->APB1ENR & RCC_APB1ENR_TIM5EN) && (TIM5->CR1 & TIM_CR1_CEN);
+	int8_t status;
+
+	if(shared){
+		/*counter of software timer is used as it is, it must wrap at 32 bits*/
+		if(TIM5->ARR != 0xFFFFFFFF){
+			return -1;
+		}
+		*counterFreqPtr = TIM_get_CLK_value(TIM5)/(TIM5->PSC + 1);
+	}else{
+		TIM_Config_t TIMConfig = {.reloadVal = 0xFFFFFFFF,.prescaler = 0};
+		TIM_Handle_t TIMHandle = {TIM5,&TIMConfig};
+		TIM_init(&TIMHandle);
+		TIM_ctr(TIM5,START);
+		*counterFreqPtr = TIM_get_CLK_value(TIM5);
+	}
+
+	uint32_t OR = TIM5->OR;
+	TIM5->OR = (OR & ~CLOCK_TIM5_TI4_MASK) | route;
+	TIM_IC_init(TIM5,&ICConfig);
+
+	status = CLOCK_capture(TIM5,TIM_CHANNEL_4,0xFFFFFFFF,*counterFreqPtr,durationMs,ticksPtr,captureNumPtr);
+
+	/*give channel 4 back*/
+	TIM5->CCER &= ~(0x0F << TIM_CCER_CC4E_Pos);
+	TIM5->CCMR2 &= ~(0xFF << 8);
+	TIM5->OR = OR;
+	TIM5->SR = ~(TIM_SR_CC4IF | TIM_SR_CC4OF);
+
+	if(!shared){
+		TIM_ctr(TIM5,STOP);
+		TIM_deinit(TIM5);
+		TIM_CLK_ctr(TIM5,DISABLE);
+	}
+	return status;
+}
+
+/***********************************************************************
+Private function: measure HSE_RTC routed to TIM11 channel 1
+***********************************************************************/
+static int8_t CLOCK_measure_TIM11(uint32_t durationMs, uint64_t *ticksPtr, uint32_t *captureNumPtr, uint32_t *counterFreqPtr)
+{
+	TIM_IC_Config_t ICConfig = {.channel = TIM_CHANNEL_1,.selection = TIM_IC_DIRECT_TI,.polarity = TIM_IC_POLARITY_RISING,
+															.prescaler = TIM_IC_PRESCALER_DIV8,.filter = 0};
+	TIM_Config_t TIMConfig = {.reloadVal = 0xFFFF,.prescaler = 0};
+	TIM_Handle_t TIMHandle = {TIM11,&TIMConfig};
+	int8_t status;
+
+	if((RCC->APB2ENR & RCC_APB2ENR_TIM11EN) && (TIM11->CR1 & TIM_CR1_CEN)){
+		return -1;
+	}
+
+	TIM_init(&TIMHandle);
+	TIM11->OR = (TIM11->OR & ~CLOCK_TIM11_TI1_MASK) | CLOCK_TIM11_TI1_HSE_RTC;
+	TIM_IC_init(TIM11,&ICConfig);
+	TIM_ctr(TIM11,START);
+	*counterFreqPtr = TIM_get_CLK_value(TIM11);
+
+	status = CLOCK_capture(TIM11,TIM_CHANNEL_1,0xFFFF,*counterFreqPtr,durationMs,ticksPtr,captureNumPtr);
+
+	TIM_ctr(TIM11,STOP);
+	TIM_deinit(TIM11);
+	TIM_CLK_ctr(TIM11,DISABLE);
+	return status;
+}
+
+/***********************************************************************
+Private function: check if system clock derive from HSE
+***********************************************************************/
+static uint8_t CLOCK_SYSCLK_from_HSE(void)
+{
+	uint32_t SWS = RCC->CFGR & RCC_CFGR_SWS;
+
+	if(SWS == RCC_CFGR_SWS_HSE){
+		return 1;
+	}
+	return (SWS == RCC_CFGR_SWS_PLL) && (RCC->PLLCFGR & RCC_PLLCFGR_PLLSRC);
+}
@@ -10,6 +10,11 @@
 
 #include "../inc/stm32f407xx_dac.h"
 
+static DMA_Stream_TypeDef* DAC_DMA_get_stream(uint8_t channel);
+static volatile uint32_t* DAC_get_DHR_address(DAC_Handle_t *DACxHandlePtr);
+static int8_t DAC_DMA_start(DAC_Handle_t *DACxHandlePtr, const void *bufferPtr, uint16_t Length, uint8_t dataSize);
+static TIM_TypeDef* DAC_get_trigger_timer(uint8_t triggerEV);
+
 /***********************************************************************
 DAC clock enable/disable
 ***********************************************************************/
@@ -32,12 +37,16 @@ void DAC_periph_ctr(DAC_Handle_t *DACxHandlePtr, uint8_t enOrDis)
 			DACxHandlePtr->DACxPtr->CR |= DAC_CR_EN1;
 		}else if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_2){
 			DACxHandlePtr->DACxPtr->CR |= DAC_CR_EN2;
+		}else if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_DUAL){
+			DACxHandlePtr->DACxPtr->CR |= DAC_CR_EN1 | DAC_CR_EN2;
 		}
 	}else{
 		if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_1){
 			DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_EN1;
 		}else if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_2){
 			DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_EN2;
+		}else if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_DUAL){
+			DACxHandlePtr->DACxPtr->CR &= ~(DAC_CR_EN1 | DAC_CR_EN2);
 		}
 	}
 }
@@ -53,33 +62,55 @@ void DAC_init(DAC_Handle_t *DACxHandlePtr)
 	/*disable DAC peripheral for initilization*/
 	DAC_periph_ctr(DACxHandlePtr,DISABLE);
 	
-	/*DAC channel trigger configuration*/
 	uint8_t option = DACxHandlePtr->DACxConfigPtr->triggerEV;
 	uint8_t channel =	DACxHandlePtr->DACxConfigPtr->channel;
 	
+	/*DAC channel trigger and wave generation configuration, in dual mode both channels are configured identically*/
+	uint8_t waveGen = DACxHandlePtr->DACxConfigPtr->waveGen;
+	uint8_t waveAmplitude = DACxHandlePtr->DACxConfigPtr->waveAmplitude;
+	
 	if(option != DAC_NO_TRIGGER_EV){
-		if(channel == DAC_CHANNEL_1){
+		if(channel == DAC_CHANNEL_1 || channel == DAC_CHANNEL_DUAL){
 			DACxHandlePtr->DACxPtr->CR |= DAC_CR_TEN1;
 			DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_TSEL1;
 			DACxHandlePtr->DACxPtr->CR |= option << DAC_CR_TSEL1_Pos;
-		}else if(channel == DAC_CHANNEL_2){
+			DACxHandlePtr->DACxPtr->CR &= ~(DAC_CR_WAVE1 | DAC_CR_MAMP1);
+			DACxHandlePtr->DACxPtr->CR |= (waveGen << DAC_CR_WAVE1_Pos) | (waveAmplitude << DAC_CR_MAMP1_Pos);
+		}
+		if(channel == DAC_CHANNEL_2 || channel == DAC_CHANNEL_DUAL){
 			DACxHandlePtr->DACxPtr->CR |= DAC_CR_TEN2;
 			DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_TSEL2;
 			DACxHandlePtr->DACxPtr->CR |= option << DAC_CR_TSEL2_Pos;
+			DACxHandlePtr->DACxPtr->CR &= ~(DAC_CR_WAVE2 | DAC_CR_MAMP2);
+			DACxHandlePtr->DACxPtr->CR |= (waveGen << DAC_CR_WAVE2_Pos) | (waveAmplitude << DAC_CR_MAMP2_Pos);
 		}
 	}
 	
 	/*DAC output buffer enable/disable*/
 	option = DACxHandlePtr->DACxConfigPtr->outputBuffer;
 	
-	if(channel == DAC_CHANNEL_1){
+	if(channel == DAC_CHANNEL_1 || channel == DAC_CHANNEL_DUAL){
 		DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_BOFF1;
 		DACxHandlePtr->DACxPtr->CR |= option<<DAC_CR_BOFF1_Pos;
-	}else if(channel == DAC_CHANNEL_2){
+	}
+	if(channel == DAC_CHANNEL_2 || channel == DAC_CHANNEL_DUAL){
 		DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_BOFF2;
 		DACxHandlePtr->DACxPtr->CR |= option<<DAC_CR_BOFF2_Pos;
 	}
 	
+	/*precompute write target so that writing a sample is a single store*/
+	uint8_t resolution = DACxHandlePtr->DACxConfigPtr->resolution;
+	
+	DACxHandlePtr->DHRxPtr = DAC_get_DHR_address(DACxHandlePtr);
+	DACxHandlePtr->dataMask = (resolution == DAC_RES_8_bits) ? 0xFF : 0xFFF;
+	DACxHandlePtr->dataShift = (resolution == DAC_RES_12_bits && DACxHandlePtr->DACxConfigPtr->alignment == DAC_ALIGNMENT_LEFT) ? 4 : 0;
+	if(channel == DAC_CHANNEL_DUAL){
+		DACxHandlePtr->dualShift = (resolution == DAC_RES_8_bits) ? 8 : 16;
+	}else{
+		DACxHandlePtr->dualShift = 0;
+	}
+	DACxHandlePtr->PCMBusy = 0;
+	
 	/*enable DAC peripheral*/
 	DAC_periph_ctr(DACxHandlePtr,ENABLE);
 }
@@ -98,35 +129,315 @@ Write digital value to DAC
 ***********************************************************************/
 void DAC_write(DAC_Handle_t *DACxHandlePtr, uint16_t digiVal)
 {
-	uint8_t resolution = DACxHandlePtr->DACxConfigPtr->resolution;
+	uint32_t sample = (uint32_t)(digiVal & DACxHandlePtr->dataMask) << DACxHandlePtr->dataShift;
+	
+	/*in single channel mode dualShift is 0 and sample is written as is*/
+	*DACxHandlePtr->DHRxPtr = sample | (sample << DACxHandlePtr->dualShift);
+}
+
+/***********************************************************************
+Write digital values to both DAC channels
+***********************************************************************/
+void DAC_write_dual(DAC_Handle_t *DACxHandlePtr, uint16_t ch1Val, uint16_t ch2Val)
+{
+	uint32_t ch1Sample = (uint32_t)(ch1Val & DACxHandlePtr->dataMask) << DACxHandlePtr->dataShift;
+	uint32_t ch2Sample = (uint32_t)(ch2Val & DACxHandlePtr->dataMask) << DACxHandlePtr->dataShift;
+	
+	*DACxHandlePtr->DHRxPtr = ch1Sample | (ch2Sample << DACxHandlePtr->dualShift);
+}
+
+/***********************************************************************
+Generate software trigger event
+***********************************************************************/
+void DAC_software_trigger(DAC_Handle_t *DACxHandlePtr)
+{
 	uint8_t channel = DACxHandlePtr->DACxConfigPtr->channel;
 	
 	if(channel == DAC_CHANNEL_1){
-		/*case 8 bits DAC resolution*/
-		if(resolution == DAC_RES_8_bits){
-			DACxHandlePtr->DACxPtr->DHR8R1 = (uint8_t)(digiVal & 0xFF);
-		/*case 12 bits DAC resolution*/
-		}else{
-			uint8_t alignment = DACxHandlePtr->DACxConfigPtr->alignment;
-			if(alignment == DAC_ALIGNMENT_LEFT){
-				DACxHandlePtr->DACxPtr->DHR12L1 = (digiVal & 0xFFF)<<DAC_DHR12L1_DACC1DHR_Pos;
-			}else{
-				DACxHandlePtr->DACxPtr->DHR12R1 = digiVal & 0xFFF;
-			}
-		} 
+		DACxHandlePtr->DACxPtr->SWTRIGR = DAC_SWTRIGR_SWTRIG1;
 	}else if(channel == DAC_CHANNEL_2){
-		/*case 8 bits DAC resolution*/
+		DACxHandlePtr->DACxPtr->SWTRIGR = DAC_SWTRIGR_SWTRIG2;
+	}else{
+		DACxHandlePtr->DACxPtr->SWTRIGR = DAC_SWTRIGR_SWTRIG1 | DAC_SWTRIGR_SWTRIG2;
+	}
+}
+
+/***********************************************************************
+Start circular DMA transfer from memory buffer to DAC
+***********************************************************************/
+int8_t DAC_DMA_start_circular(DAC_Handle_t *DACxHandlePtr, uint16_t *bufferPtr, uint16_t Length)
+{
+	return DAC_DMA_start(DACxHandlePtr,bufferPtr,Length,0x01);
+}
+
+/***********************************************************************
+Stop DMA transfer to DAC
+***********************************************************************/
+void DAC_DMA_stop(DAC_Handle_t *DACxHandlePtr)
+{
+	uint8_t channel = DACxHandlePtr->DACxConfigPtr->channel;
+	
+	if(channel == DAC_CHANNEL_2){
+		DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_DMAEN2;
+	}else{
+		DACxHandlePtr->DACxPtr->CR &= ~DAC_CR_DMAEN1;
+	}
+	DAC_DMA_get_stream(channel)->CR &= ~DMA_SxCR_EN;
+	DMA_stream_release(DAC_DMA_get_stream(channel),DACxHandlePtr);
+}
+
+/***********************************************************************
+Enable or disable DAC DMA stream 's interrupt vector in NVIC 
+***********************************************************************/
+void DAC_intrpt_vector_ctr (uint8_t IRQnumber, uint8_t enOrDis)
+{
+	/*ISER/ICER are write-1 registers, writing back read value would affect other enabled vectors*/
+	if(enOrDis == ENABLE){
+		if(IRQnumber <= 31){
+			NVIC->ISER[0] = (1<<IRQnumber);
+		}
+		else if(IRQnumber > 31 && IRQnumber <= 63){
+			NVIC->ISER[1] = (1<<(IRQnumber%32));
+		}
+		else if(IRQnumber > 63 && IRQnumber <= 95){
+			NVIC->ISER[2] = (1<<(IRQnumber%64));
+		}
+	}else{
+		if(IRQnumber <= 31){
+			NVIC->ICER[0] = (1<<IRQnumber);
+		}
+		else if(IRQnumber > 31 && IRQnumber <= 63){
+			NVIC->ICER[1] = (1<<(IRQnumber%32));
+		}
+		else if(IRQnumber > 63 && IRQnumber <= 95){
+			NVIC->ICER[2] = (1<<(IRQnumber%64));
+		}
+	}
+}
+
+/***********************************************************************
+Config priority for DAC DMA stream 's interrupt 
+***********************************************************************/
+void DAC_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority)
+{
+	/*IP is a byte array indexed by IRQ number, priority is held in upper bits of each byte*/
+	NVIC->IP[IRQnumber] = (uint8_t)(priority << NUM_OF_IPR_BIT_IMPLEMENTED);
+}
+
+/***********************************************************************
+DAC DMA stream interrupt handler
+***********************************************************************/
+void DAC_DMA_intrpt_handler (DAC_Handle_t *DACxHandlePtr)
+{
+	uint32_t status = DMA1->HISR;
+	
+	/*dual channel is served by channel 1 DMA stream*/
+	if(DACxHandlePtr->DACxConfigPtr->channel != DAC_CHANNEL_2){
+		/*case first half of buffer was transferred*/
+		if(status & DMA_HISR_HTIF5){
+			DMA1->HIFCR = DMA_HIFCR_CHTIF5;
+			DAC_application_event_callback(DACxHandlePtr,DAC_EV_DMA_HALF_CMPLT);
+		}
+		/*case second half of buffer was transferred*/
+		if(status & DMA_HISR_TCIF5){
+			DMA1->HIFCR = DMA_HIFCR_CTCIF5;
+			DAC_application_event_callback(DACxHandlePtr,DAC_EV_DMA_CMPLT);
+		}
+	}else{
+		if(status & DMA_HISR_HTIF6){
+			DMA1->HIFCR = DMA_HIFCR_CHTIF6;
+			DAC_application_event_callback(DACxHandlePtr,DAC_EV_DMA_HALF_CMPLT);
+		}
+		if(status & DMA_HISR_TCIF6){
+			DMA1->HIFCR = DMA_HIFCR_CTCIF6;
+			DAC_application_event_callback(DACxHandlePtr,DAC_EV_DMA_CMPLT);
+		}
+	}
+}
+
+/***********************************************************************
+Config trigger timer at given sample rate
+***********************************************************************/
+int32_t DAC_sample_rate_config(DAC_Handle_t *DACxHandlePtr, uint32_t sampleRate)
+{
+	TIM_TypeDef *TIMxPtr = DAC_get_trigger_timer(DACxHandlePtr->DACxConfigPtr->triggerEV);
+	int32_t TIMclk = RCC_get_TIMCLK_value(APB1);
+	
+	if(TIMxPtr == NULL || TIMclk < 0 || sampleRate == 0 || sampleRate > (uint32_t)TIMclk/2){
+		return -1;
+	}
+	
+	/*split timer clock division into prescaler and reload value, both limited to 16 bits*/
+	uint32_t division = ((uint32_t)TIMclk + sampleRate/2)/sampleRate;
+	uint32_t prescaler = (division - 1)/65536;
+	uint32_t reloadVal = division/(prescaler + 1) - 1;
+	
+	TIM_Config_t TIMConfig = {.reloadVal = reloadVal,.prescaler = prescaler};
+	TIM_Handle_t TIMHandle = {TIMxPtr,&TIMConfig};
+	TIM_init(&TIMHandle);
+	TIM_update_event_TRGO(TIMxPtr);
+	
+	return TIMclk/((prescaler + 1)*(reloadVal + 1));
+}
+
+/***********************************************************************
+Start streaming PCM samples to DAC
+***********************************************************************/
+int32_t DAC_PCM_start(DAC_Handle_t *DACxHandlePtr, const void *bufferPtr, uint16_t sampleCount, uint32_t sampleRate)
+{
+	uint8_t resolution = DACxHandlePtr->DACxConfigPtr->resolution;
+	uint8_t channel = DACxHandlePtr->DACxConfigPtr->channel;
+	uint8_t dataSize;
+	
+	int32_t actualRate = DAC_sample_rate_config(DACxHandlePtr,sampleRate);
+	if(actualRate < 0){
+		return -1;
+	}
+	
+	/*transfer size is one sample: byte, half-word or word (refer to @DAC_PCM_FORMAT)*/
+	if(channel == DAC_CHANNEL_DUAL){
+		dataSize = (resolution == DAC_RES_8_bits) ? 0x01 : 0x02;
+	}else{
+		dataSize = (resolution == DAC_RES_8_bits) ? 0x00 : 0x01;
+	}
+	if(DAC_DMA_start(DACxHandlePtr,bufferPtr,sampleCount,dataSize) < 0){
+		return -1;
+	}
+	
+	TIM_ctr(DAC_get_trigger_timer(DACxHandlePtr->DACxConfigPtr->triggerEV),START);
+	
+	/*restart without stop keep the lock already held*/
+	if(!DACxHandlePtr->PCMBusy){
+		DACxHandlePtr->PCMBusy = 1;
+		PWR_stop_lock(PWR_LOCK_DAC);
+	}
+	return actualRate;
+}
+
+/***********************************************************************
+Stop streaming PCM samples to DAC
+***********************************************************************/
+void DAC_PCM_stop(DAC_Handle_t *DACxHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = DAC_get_trigger_timer(DACxHandlePtr->DACxConfigPtr->triggerEV);
+	
+	if(TIMxPtr != NULL){
+		TIM_ctr(TIMxPtr,STOP);
+	}
+	DAC_DMA_stop(DACxHandlePtr);
+	
+	if(DACxHandlePtr->PCMBusy){
+		DACxHandlePtr->PCMBusy = 0;
+		PWR_stop_unlock(PWR_LOCK_DAC);
+	}
+}
+
+/***********************************************************************
+Inform application of DAC event
+@Note: this is to be define in user application
+***********************************************************************/
+__attribute__((weak)) void DAC_application_event_callback (DAC_Handle_t *DACxHandlePtr,uint8_t event) 
+{
+}
+
+/***********************************************************************
+Private function: get DMA stream serving given DAC channel
+***********************************************************************/
+static DMA_Stream_TypeDef* DAC_DMA_get_stream(uint8_t channel)
+{
+	if(channel == DAC_CHANNEL_2){
+		return DAC_CH2_DMA_STREAM;
+	}
+	return DAC_CH1_DMA_STREAM;
+}
+
+/***********************************************************************
+Private function: get address of data holding register matching channel, resolution and alignment
+***********************************************************************/
+static volatile uint32_t* DAC_get_DHR_address(DAC_Handle_t *DACxHandlePtr)
+{
+	uint8_t resolution = DACxHandlePtr->DACxConfigPtr->resolution;
+	uint8_t alignment = DACxHandlePtr->DACxConfigPtr->alignment;
+	
+	if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_1){
 		if(resolution == DAC_RES_8_bits){
-			DACxHandlePtr->DACxPtr->DHR8R2 = (uint8_t)(digiVal & 0xFF);
-		/*case 12 bits DAC resolution*/
-		}else{
-			uint8_t alignment = DACxHandlePtr->DACxConfigPtr->alignment;
-			if(alignment == DAC_ALIGNMENT_LEFT){
-				DACxHandlePtr->DACxPtr->DHR12L2 = (digiVal & 0xFFF)<<DAC_DHR12L2_DACC2DHR_Pos;
-			}else{
-				DACxHandlePtr->DACxPtr->DHR12R2 = digiVal & 0xFFF;
-			}
-		} 
+			return &DACxHandlePtr->DACxPtr->DHR8R1;
+		}else if(alignment == DAC_ALIGNMENT_LEFT){
+			return &DACxHandlePtr->DACxPtr->DHR12L1;
+		}
+		return &DACxHandlePtr->DACxPtr->DHR12R1;
+	}else if(DACxHandlePtr->DACxConfigPtr->channel == DAC_CHANNEL_DUAL){
+		if(resolution == DAC_RES_8_bits){
+			return &DACxHandlePtr->DACxPtr->DHR8RD;
+		}else if(alignment == DAC_ALIGNMENT_LEFT){
+			return &DACxHandlePtr->DACxPtr->DHR12LD;
+		}
+		return &DACxHandlePtr->DACxPtr->DHR12RD;
+	}else{
+		if(resolution == DAC_RES_8_bits){
+			return &DACxHandlePtr->DACxPtr->DHR8R2;
+		}else if(alignment == DAC_ALIGNMENT_LEFT){
+			return &DACxHandlePtr->DACxPtr->DHR12L2;
+		}
+		return &DACxHandlePtr->DACxPtr->DHR12R2;
 	}
 }
+
+/***********************************************************************
+Private function: start circular DMA transfer to DAC data holding register
+@note dataSize: 0 byte, 1 half-word, 2 word (same size for memory and peripheral in direct mode)
+@return 0: success, -1: stream is allocated to a DMA handle or reserved by an other driver
+***********************************************************************/
+static int8_t DAC_DMA_start(DAC_Handle_t *DACxHandlePtr, const void *bufferPtr, uint16_t Length, uint8_t dataSize)
+{
+	uint8_t channel = DACxHandlePtr->DACxConfigPtr->channel;
+	DMA_Stream_TypeDef *streamPtr = DAC_DMA_get_stream(channel);
+	
+	if(DMA_stream_reserve(streamPtr,DACxHandlePtr) < 0){
+		return -1;
+	}
+	
+	/*enable clock for DMA1 and disable stream for configuration*/
+	RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+	streamPtr->CR &= ~DMA_SxCR_EN;
+	while(streamPtr->CR & DMA_SxCR_EN);
+	
+	/*clear all pending flags of the stream*/
+	if(channel == DAC_CHANNEL_2){
+		DMA1->HIFCR = DMA_HIFCR_CTCIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CFEIF6;
+	}else{
+		DMA1->HIFCR = DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+	}
+	
+	/*program addresses and number of samples*/
+	streamPtr->PAR = (uint32_t)DACxHandlePtr->DHRxPtr;
+	streamPtr->M0AR = (uint32_t)bufferPtr;
+	streamPtr->NDTR = Length;
+	
+	/*channel 7, memory and peripheral data size, memory increment, circular, memory to peripheral, half and full transfer interrupt*/
+	streamPtr->CR = (DAC_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | (dataSize << DMA_SxCR_MSIZE_Pos) | (dataSize << DMA_SxCR_PSIZE_Pos) 
+									| DMA_SxCR_MINC | DMA_SxCR_CIRC | (0x01 << DMA_SxCR_DIR_Pos) | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
 	
+	/*enable stream and let DAC issue DMA request on every trigger event, in dual mode only channel 1 request DMA*/
+	streamPtr->CR |= DMA_SxCR_EN;
+	if(channel == DAC_CHANNEL_2){
+		DACxHandlePtr->DACxPtr->CR |= DAC_CR_DMAEN2;
+	}else{
+		DACxHandlePtr->DACxPtr->CR |= DAC_CR_DMAEN1;
+	}
+	return 0;
+}
+
+/***********************************************************************
+Private function: get timer selected as DAC trigger event
+@note only basic timers are handled by timer driver
+***********************************************************************/
+static TIM_TypeDef* DAC_get_trigger_timer(uint8_t triggerEV)
+{
+	if(triggerEV == DAC_TRIGGER_EV_TIM6){
+		return TIM6;
+	}else if(triggerEV == DAC_TRIGGER_EV_TIM7){
+		return TIM7;
+	}
+	return NULL;
+}
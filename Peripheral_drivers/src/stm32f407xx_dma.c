@@ -0,0 +1,491 @@
+/**
+*@file stm32f407xx_dma.c
+*@brief provide APIs for DMA controllers (DMA1, DMA2) of stm32f407xx MCUs.
+*
+*This source file provide APIs for allocating a DMA stream to a peripheral request and running transfers on it.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_dma.h"
+
+typedef struct{
+	uint8_t request;
+	uint8_t streamIdx;	/*0 - 7: DMA1 stream 0 - 7, 8 - 15: DMA2 stream 0 - 7*/
+	uint8_t channel;
+}DMA_Map_t;
+
+/*stream and channel serving each request, refer to DMA1 and DMA2 request mapping in reference manual.
+Streams of a request are listed in order of preference: first one is tried first*/
+static const DMA_Map_t requestMap[] = {
+	/*DMA1*/
+	{DMA_REQ_SPI3_RX,0,0},{DMA_REQ_SPI3_RX,2,0},{DMA_REQ_SPI2_RX,3,0},{DMA_REQ_SPI2_TX,4,0},
+	{DMA_REQ_SPI3_TX,5,0},{DMA_REQ_SPI3_TX,7,0},
+	{DMA_REQ_I2C1_RX,0,1},{DMA_REQ_I2C1_RX,5,1},{DMA_REQ_TIM7_UP,2,1},{DMA_REQ_TIM7_UP,4,1},
+	{DMA_REQ_I2C1_TX,6,1},{DMA_REQ_I2C1_TX,7,1},
+	{DMA_REQ_TIM4_CH1,0,2},{DMA_REQ_TIM4_CH2,3,2},{DMA_REQ_TIM4_UP,6,2},{DMA_REQ_TIM4_CH3,7,2},
+	{DMA_REQ_TIM2_UP,1,3},{DMA_REQ_TIM2_UP,7,3},{DMA_REQ_TIM2_CH3,1,3},{DMA_REQ_I2C3_RX,2,3},{DMA_REQ_I2C3_TX,4,3},
+	{DMA_REQ_TIM2_CH1,5,3},{DMA_REQ_TIM2_CH2,6,3},{DMA_REQ_TIM2_CH4,6,3},{DMA_REQ_TIM2_CH4,7,3},
+	{DMA_REQ_UART5_RX,0,4},{DMA_REQ_USART3_RX,1,4},{DMA_REQ_UART4_RX,2,4},{DMA_REQ_USART3_TX,3,4},{DMA_REQ_USART3_TX,4,7},
+	{DMA_REQ_UART4_TX,4,4},{DMA_REQ_USART2_RX,5,4},{DMA_REQ_USART2_TX,6,4},{DMA_REQ_UART5_TX,7,4},
+	{DMA_REQ_TIM3_CH4,2,5},{DMA_REQ_TIM3_UP,2,5},{DMA_REQ_TIM3_CH1,4,5},{DMA_REQ_TIM3_CH2,5,5},{DMA_REQ_TIM3_CH3,7,5},
+	{DMA_REQ_TIM5_CH3,0,6},{DMA_REQ_TIM5_UP,0,6},{DMA_REQ_TIM5_UP,6,6},{DMA_REQ_TIM5_CH4,1,6},{DMA_REQ_TIM5_CH4,3,6},
+	{DMA_REQ_TIM5_CH1,2,6},{DMA_REQ_TIM5_CH2,4,6},
+	{DMA_REQ_TIM6_UP,1,7},{DMA_REQ_I2C2_RX,2,7},{DMA_REQ_I2C2_RX,3,7},{DMA_REQ_DAC1,5,7},{DMA_REQ_DAC2,6,7},
+	{DMA_REQ_I2C2_TX,7,7},
+	/*DMA2*/
+	{DMA_REQ_ADC1,8,0},{DMA_REQ_ADC1,12,0},{DMA_REQ_TIM8_CH1,10,0},{DMA_REQ_TIM8_CH2,10,0},{DMA_REQ_TIM8_CH3,10,0},
+	{DMA_REQ_TIM1_CH1,14,0},{DMA_REQ_TIM1_CH2,14,0},{DMA_REQ_TIM1_CH3,14,0},
+	{DMA_REQ_DCMI,9,1},{DMA_REQ_DCMI,15,1},{DMA_REQ_ADC2,10,1},{DMA_REQ_ADC2,11,1},
+	{DMA_REQ_ADC3,8,2},{DMA_REQ_ADC3,9,2},
+	{DMA_REQ_SPI1_RX,8,3},{DMA_REQ_SPI1_RX,10,3},{DMA_REQ_SPI1_TX,11,3},{DMA_REQ_SPI1_TX,13,3},
+	{DMA_REQ_USART1_RX,10,4},{DMA_REQ_USART1_RX,13,4},{DMA_REQ_SDIO,11,4},{DMA_REQ_SDIO,14,4},{DMA_REQ_USART1_TX,15,4},
+	{DMA_REQ_USART6_RX,9,5},{DMA_REQ_USART6_RX,10,5},{DMA_REQ_USART6_TX,14,5},{DMA_REQ_USART6_TX,15,5},
+	{DMA_REQ_TIM1_CH1,9,6},{DMA_REQ_TIM1_CH1,11,6},{DMA_REQ_TIM1_CH2,10,6},{DMA_REQ_TIM1_CH4,12,6},{DMA_REQ_TIM1_UP,13,6},
+	{DMA_REQ_TIM1_CH3,14,6},
+	{DMA_REQ_TIM8_UP,9,7},{DMA_REQ_TIM8_CH1,10,7},{DMA_REQ_TIM8_CH2,11,7},{DMA_REQ_TIM8_CH3,12,7},{DMA_REQ_TIM8_CH4,15,7},
+};
+
+static const uint8_t streamIRQ[DMA_STREAM_NUM] = {
+	IRQ_DMA1_STREAM0,IRQ_DMA1_STREAM1,IRQ_DMA1_STREAM2,IRQ_DMA1_STREAM3,
+	IRQ_DMA1_STREAM4,IRQ_DMA1_STREAM5,IRQ_DMA1_STREAM6,IRQ_DMA1_STREAM7,
+	IRQ_DMA2_STREAM0,IRQ_DMA2_STREAM1,IRQ_DMA2_STREAM2,IRQ_DMA2_STREAM3,
+	IRQ_DMA2_STREAM4,IRQ_DMA2_STREAM5,IRQ_DMA2_STREAM6,IRQ_DMA2_STREAM7,
+};
+
+/*each stream has 6 bits of flags, at bit 0, 6, 16, 22 of LISR/LIFCR (stream 0-3) and HISR/HIFCR (stream 4-7)*/
+static const uint8_t flagShift[4] = {0,6,16,22};
+#define DMA_FLAG_FE 0x01
+#define DMA_FLAG_DME 0x04
+#define DMA_FLAG_TE 0x08
+#define DMA_FLAG_HT 0x10
+#define DMA_FLAG_TC 0x20
+#define DMA_FLAG_ALL 0x3D
+
+static DMA_Handle_t *streamOwner[DMA_STREAM_NUM];
+static const void *streamReserver[DMA_STREAM_NUM];	/*driver (its handle) driving stream directly, NULL if none*/
+
+static int8_t DMA_check_config(DMA_Config_t *configPtr);
+static int8_t DMA_allocate(DMA_Handle_t *DMAHandlePtr);
+static void DMA_configure(DMA_Handle_t *DMAHandlePtr);
+static int8_t DMA_get_stream_idx(DMA_Stream_TypeDef *streamPtr);
+static DMA_TypeDef* DMA_get_controller(uint8_t streamIdx);
+static void DMA_disable_stream(DMA_Handle_t *DMAHandlePtr);
+
+/***********************************************************************
+Allocate a stream serving configured request and configure it
+***********************************************************************/
+int8_t DMA_init(DMA_Handle_t *DMAHandlePtr)
+{
+	if(DMA_check_config(DMAHandlePtr->DMAConfigPtr) < 0 || DMA_allocate(DMAHandlePtr) < 0){
+		DMAHandlePtr->streamPtr = NULL;
+		return -1;
+	}
+
+	RCC->AHB1ENR |= (DMAHandlePtr->DMAxPtr == DMA1) ? RCC_AHB1ENR_DMA1EN : RCC_AHB1ENR_DMA2EN;
+	DMA_configure(DMAHandlePtr);
+	if(DMAHandlePtr->DMAConfigPtr->callback != NULL){
+		DMA_intrpt_priority_config(streamIRQ[DMAHandlePtr->streamIdx],DMA_IRQ_PRIORITY);
+		DMA_intrpt_vector_ctr(streamIRQ[DMAHandlePtr->streamIdx],ENABLE);
+	}
+
+	return DMAHandlePtr->streamIdx;
+}
+
+/***********************************************************************
+Apply changed configuration to allocated stream
+***********************************************************************/
+int8_t DMA_reconfig(DMA_Handle_t *DMAHandlePtr)
+{
+	if(DMAHandlePtr->streamPtr == NULL || DMA_check_config(DMAHandlePtr->DMAConfigPtr) < 0){
+		return -1;
+	}
+	DMA_configure(DMAHandlePtr);
+	return 0;
+}
+
+/***********************************************************************
+Stop transfer and release stream
+***********************************************************************/
+void DMA_deinit(DMA_Handle_t *DMAHandlePtr)
+{
+	if(DMAHandlePtr->streamPtr == NULL){
+		return;
+	}
+	DMA_disable_stream(DMAHandlePtr);
+	DMAHandlePtr->streamPtr->CR = 0;
+	if(DMAHandlePtr->DMAConfigPtr->callback != NULL){
+		DMA_intrpt_vector_ctr(streamIRQ[DMAHandlePtr->streamIdx],DISABLE);
+	}
+	streamOwner[DMAHandlePtr->streamIdx] = NULL;
+	DMAHandlePtr->streamPtr = NULL;
+}
+
+/***********************************************************************
+Start a transfer
+***********************************************************************/
+void DMA_start(DMA_Handle_t *DMAHandlePtr, volatile void *periphPtr, void *mem0Ptr, void *mem1Ptr, uint16_t length)
+{
+	DMA_Stream_TypeDef *streamPtr = DMAHandlePtr->streamPtr;
+
+	/*addresses and length can only be written while stream is disabled*/
+	DMA_disable_stream(DMAHandlePtr);
+	streamPtr->PAR = (uint32_t)periphPtr;
+	streamPtr->M0AR = (uint32_t)mem0Ptr;
+	streamPtr->M1AR = (uint32_t)mem1Ptr;
+	streamPtr->NDTR = length;
+	streamPtr->CR = DMAHandlePtr->CRVal;
+	streamPtr->CR |= DMA_SxCR_EN;
+}
+
+/***********************************************************************
+Stop transfer
+***********************************************************************/
+void DMA_stop(DMA_Handle_t *DMAHandlePtr)
+{
+	DMA_disable_stream(DMAHandlePtr);
+}
+
+/***********************************************************************
+Check whether a transfer is running
+***********************************************************************/
+uint8_t DMA_is_busy(DMA_Handle_t *DMAHandlePtr)
+{
+	return (DMAHandlePtr->streamPtr->CR & DMA_SxCR_EN) ? 1 : 0;
+}
+
+/***********************************************************************
+Get number of data items left to transfer
+***********************************************************************/
+uint16_t DMA_get_remaining(DMA_Handle_t *DMAHandlePtr)
+{
+	return DMAHandlePtr->streamPtr->NDTR;
+}
+
+/***********************************************************************
+Get memory being accessed by stream in double buffer mode
+***********************************************************************/
+uint8_t DMA_get_current_memory(DMA_Handle_t *DMAHandlePtr)
+{
+	return (DMAHandlePtr->streamPtr->CR & DMA_SxCR_CT) ? 1 : 0;
+}
+
+/***********************************************************************
+Change address of idle memory in double buffer mode
+***********************************************************************/
+int8_t DMA_set_memory(DMA_Handle_t *DMAHandlePtr, uint8_t memNo, void *memPtr)
+{
+	DMA_Stream_TypeDef *streamPtr = DMAHandlePtr->streamPtr;
+
+	/*hardware ignore write to address register of memory in use while stream is enabled*/
+	if((streamPtr->CR & DMA_SxCR_EN) && DMA_get_current_memory(DMAHandlePtr) == memNo){
+		return -1;
+	}
+	if(memNo == 0){
+		streamPtr->M0AR = (uint32_t)memPtr;
+	}else{
+		streamPtr->M1AR = (uint32_t)memPtr;
+	}
+	return 0;
+}
+
+/***********************************************************************
+Get IRQ number of allocated stream
+***********************************************************************/
+uint8_t DMA_get_IRQ_number(DMA_Handle_t *DMAHandlePtr)
+{
+	return streamIRQ[DMAHandlePtr->streamIdx];
+}
+
+/***********************************************************************
+Get stream of a controller
+***********************************************************************/
+DMA_Stream_TypeDef* DMA_get_stream(DMA_TypeDef *DMAxPtr, uint8_t streamNo)
+{
+	/*stream registers follow interrupt status registers, 0x18 bytes per stream*/
+	return (DMA_Stream_TypeDef*)((uint32_t)DMAxPtr + 0x10 + 0x18*streamNo);
+}
+
+/***********************************************************************
+Reserve a stream driven directly by a driver
+***********************************************************************/
+int8_t DMA_stream_reserve(DMA_Stream_TypeDef *streamPtr, const void *ownerPtr)
+{
+	int8_t streamIdx = DMA_get_stream_idx(streamPtr);
+	int8_t ret = -1;
+
+	if(streamIdx < 0 || ownerPtr == NULL){
+		return -1;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(streamOwner[streamIdx] == NULL && (streamReserver[streamIdx] == NULL || streamReserver[streamIdx] == ownerPtr)){
+		streamReserver[streamIdx] = ownerPtr;
+		ret = 0;
+	}
+	__set_PRIMASK(primask);
+	return ret;
+}
+
+/***********************************************************************
+Release a reserved stream
+***********************************************************************/
+void DMA_stream_release(DMA_Stream_TypeDef *streamPtr, const void *ownerPtr)
+{
+	int8_t streamIdx = DMA_get_stream_idx(streamPtr);
+
+	if(streamIdx < 0){
+		return;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(streamReserver[streamIdx] == ownerPtr){
+		streamReserver[streamIdx] = NULL;
+	}
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Enable or disable DMA stream 's interrupt vector in NVIC
+***********************************************************************/
+void DMA_intrpt_vector_ctr(uint8_t IRQnumber, uint8_t enOrDis)
+{
+	/*ISER/ICER are write-1 registers, writing back read value would affect other enabled vectors*/
+	if(enOrDis == ENABLE){
+		if(IRQnumber <= 31){
+			NVIC->ISER[0] = (1<<IRQnumber);
+		}
+		else if(IRQnumber > 31 && IRQnumber <= 63){
+			NVIC->ISER[1] = (1<<(IRQnumber%32));
+		}
+		else if(IRQnumber > 63 && IRQnumber <= 95){
+			NVIC->ISER[2] = (1<<(IRQnumber%64));
+		}
+	}else{
+		if(IRQnumber <= 31){
+			NVIC->ICER[0] = (1<<IRQnumber);
+		}
+		else if(IRQnumber > 31 && IRQnumber <= 63){
+			NVIC->ICER[1] = (1<<(IRQnumber%32));
+		}
+		else if(IRQnumber > 63 && IRQnumber <= 95){
+			NVIC->ICER[2] = (1<<(IRQnumber%64));
+		}
+	}
+}
+
+/***********************************************************************
+Config priority for DMA stream 's interrupt
+***********************************************************************/
+void DMA_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority)
+{
+	/*IP is a byte array indexed by IRQ number, priority is held in upper bits of each byte*/
+	NVIC->IP[IRQnumber] = (uint8_t)(priority << NUM_OF_IPR_BIT_IMPLEMENTED);
+}
+
+/***********************************************************************
+DMA stream interrupt handler
+***********************************************************************/
+void DMA_intrpt_handler(uint8_t IRQNumber)
+{
+	uint8_t streamIdx;
+
+	for(streamIdx = 0; streamIdx < DMA_STREAM_NUM; streamIdx++){
+		if(streamIRQ[streamIdx] == IRQNumber){
+			break;
+		}
+	}
+	if(streamIdx == DMA_STREAM_NUM){
+		return;
+	}
+	/*flags of a reserved stream belong to driver driving it*/
+	DMA_Handle_t *DMAHandlePtr = streamOwner[streamIdx];
+	if(DMAHandlePtr == NULL){
+		return;
+	}
+
+	DMA_TypeDef *DMAxPtr = DMA_get_controller(streamIdx);
+	uint8_t streamNo = streamIdx % 8;
+	volatile uint32_t *ISRPtr = (streamNo < 4) ? &DMAxPtr->LISR : &DMAxPtr->HISR;
+	volatile uint32_t *IFCRPtr = (streamNo < 4) ? &DMAxPtr->LIFCR : &DMAxPtr->HIFCR;
+	uint8_t flags = (*ISRPtr >> flagShift[streamNo % 4]) & DMA_FLAG_ALL;
+	*IFCRPtr = flags << flagShift[streamNo % 4];
+
+	if(DMAHandlePtr->DMAConfigPtr->callback == NULL){
+		return;
+	}
+	DMA_Callback_t callback = DMAHandlePtr->DMAConfigPtr->callback;
+	void *argPtr = DMAHandlePtr->DMAConfigPtr->argPtr;
+
+	if(flags & (DMA_FLAG_TE | DMA_FLAG_DME)){
+		callback(DMA_EV_ERROR,argPtr);
+	}
+	/*stream is disabled by transfer error, other flags of same interrupt are not reported*/
+	if(flags & DMA_FLAG_TE){
+		return;
+	}
+	if(flags & DMA_FLAG_HT){
+		callback(DMA_EV_HALF_CMPLT,argPtr);
+	}
+	if(flags & DMA_FLAG_TC){
+		callback(DMA_EV_CMPLT,argPtr);
+	}
+}
+
+/***********************************************************************
+Private function: check transfer configuration against hardware restrictions
+***********************************************************************/
+static int8_t DMA_check_config(DMA_Config_t *configPtr)
+{
+	if(configPtr->direction > DMA_DIR_M2M || configPtr->periphSize > DMA_SIZE_WORD || configPtr->memSize > DMA_SIZE_WORD
+		|| configPtr->mode > DMA_MODE_DOUBLE_BUFFER || configPtr->priority > DMA_PRIORITY_VERY_HIGH
+		|| configPtr->FIFOThreshold > DMA_FIFO_FULL || configPtr->periphBurst > DMA_BURST_INC16 || configPtr->memBurst > DMA_BURST_INC16){
+		return -1;
+	}
+	if((configPtr->request == DMA_REQ_MEM2MEM) != (configPtr->direction == DMA_DIR_M2M)){
+		return -1;
+	}
+	/*memory to memory can not be circular*/
+	if(configPtr->direction == DMA_DIR_M2M && configPtr->mode != DMA_MODE_NORMAL){
+		return -1;
+	}
+
+	uint8_t threshold = configPtr->FIFOThreshold;
+	if(configPtr->direction == DMA_DIR_M2M && threshold == DMA_FIFO_DIRECT){
+		threshold = DMA_FIFO_FULL;
+	}
+	if(threshold == DMA_FIFO_DIRECT){
+		/*direct mode: no burst, memory data size is peripheral data size*/
+		return (configPtr->periphBurst == DMA_BURST_SINGLE && configPtr->memBurst == DMA_BURST_SINGLE
+						&& configPtr->memSize == configPtr->periphSize) ? 0 : -1;
+	}
+
+	/*a burst (4, 8 or 16 beats) must fill or empty FIFO up to threshold in whole bursts*/
+	uint8_t thresholdBytes = 4*threshold;
+	if(configPtr->memBurst != DMA_BURST_SINGLE && (thresholdBytes % ((4 << (configPtr->memBurst - 1)) << configPtr->memSize))){
+		return -1;
+	}
+	if(configPtr->periphBurst != DMA_BURST_SINGLE && (thresholdBytes % ((4 << (configPtr->periphBurst - 1)) << configPtr->periphSize))){
+		return -1;
+	}
+	return 0;
+}
+
+/***********************************************************************
+Private function: take first free stream serving request
+@note memory to memory is served by any DMA2 stream, from stream 7 down since low streams serve most peripherals
+***********************************************************************/
+static int8_t DMA_allocate(DMA_Handle_t *DMAHandlePtr)
+{
+	uint8_t request = DMAHandlePtr->DMAConfigPtr->request;
+	int8_t streamIdx = -1;
+	uint8_t channel = 0;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(request == DMA_REQ_MEM2MEM){
+		for(int8_t i = DMA_STREAM_NUM - 1; i >= 8; i--){
+			if(streamOwner[i] == NULL && streamReserver[i] == NULL){
+				streamIdx = i;
+				break;
+			}
+		}
+	}else{
+		for(uint8_t i = 0; i < sizeof(requestMap)/sizeof(requestMap[0]); i++){
+			uint8_t idx = requestMap[i].streamIdx;
+			if(requestMap[i].request == request && streamOwner[idx] == NULL && streamReserver[idx] == NULL){
+				streamIdx = idx;
+				channel = requestMap[i].channel;
+				break;
+			}
+		}
+	}
+	if(streamIdx >= 0){
+		streamOwner[streamIdx] = DMAHandlePtr;
+	}
+	__set_PRIMASK(primask);
+
+	if(streamIdx < 0){
+		return -1;
+	}
+	DMAHandlePtr->streamIdx = streamIdx;
+	DMAHandlePtr->channel = channel;
+	DMAHandlePtr->DMAxPtr = DMA_get_controller(streamIdx);
+	DMAHandlePtr->streamPtr = DMA_get_stream(DMAHandlePtr->DMAxPtr,streamIdx % 8);
+	return 0;
+}
+
+/***********************************************************************
+Private function: write configuration of handle to its stream
+***********************************************************************/
+static void DMA_configure(DMA_Handle_t *DMAHandlePtr)
+{
+	DMA_Config_t *configPtr = DMAHandlePtr->DMAConfigPtr;
+	DMA_Stream_TypeDef *streamPtr = DMAHandlePtr->streamPtr;
+
+	DMA_disable_stream(DMAHandlePtr);
+
+	/*memory to memory need FIFO, direct mode transfer each peripheral request straight through*/
+	uint8_t threshold = configPtr->FIFOThreshold;
+	if(configPtr->direction == DMA_DIR_M2M && threshold == DMA_FIFO_DIRECT){
+		threshold = DMA_FIFO_FULL;
+	}
+	streamPtr->FCR = (threshold == DMA_FIFO_DIRECT) ? 0 : (DMA_SxFCR_DMDIS | ((threshold - 1) << DMA_SxFCR_FTH_Pos));
+
+	uint32_t CRVal = (DMAHandlePtr->channel << DMA_SxCR_CHSEL_Pos) | (configPtr->memBurst << DMA_SxCR_MBURST_Pos)
+									| (configPtr->periphBurst << DMA_SxCR_PBURST_Pos) | (configPtr->priority << DMA_SxCR_PL_Pos)
+									| (configPtr->memSize << DMA_SxCR_MSIZE_Pos) | (configPtr->periphSize << DMA_SxCR_PSIZE_Pos)
+									| (configPtr->direction << DMA_SxCR_DIR_Pos);
+	if(configPtr->memInc == ENABLE){
+		CRVal |= DMA_SxCR_MINC;
+	}
+	if(configPtr->periphInc == ENABLE){
+		CRVal |= DMA_SxCR_PINC;
+	}
+	if(configPtr->mode == DMA_MODE_CIRCULAR){
+		CRVal |= DMA_SxCR_CIRC;
+	}else if(configPtr->mode == DMA_MODE_DOUBLE_BUFFER){
+		CRVal |= DMA_SxCR_DBM | DMA_SxCR_CIRC;
+	}
+	if(configPtr->callback != NULL){
+		/*FIFO error only delay transfers (request is served again), it is not reported*/
+		CRVal |= DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE;
+	}
+	DMAHandlePtr->CRVal = CRVal;
+	streamPtr->CR = CRVal;
+}
+
+/***********************************************************************
+Private function: get stream index of a stream
+***********************************************************************/
+static int8_t DMA_get_stream_idx(DMA_Stream_TypeDef *streamPtr)
+{
+	for(uint8_t i = 0; i < DMA_STREAM_NUM; i++){
+		if(DMA_get_stream(DMA_get_controller(i),i % 8) == streamPtr){
+			return i;
+		}
+	}
+	return -1;
+}
+
+/***********************************************************************
+Private function: get controller of a stream index
+***********************************************************************/
+static DMA_TypeDef* DMA_get_controller(uint8_t streamIdx)
+{
+	return (streamIdx < 8) ? DMA1 : DMA2;
+}
+
+/***********************************************************************
+Private function: disable stream, wait for end of current transfer and clear its flags
+***********************************************************************/
+static void DMA_disable_stream(DMA_Handle_t *DMAHandlePtr)
+{
+	uint8_t streamNo = DMAHandlePtr->streamIdx % 8;
+	volatile uint32_t *IFCRPtr = (streamNo < 4) ? &DMAHandlePtr->DMAxPtr->LIFCR : &DMAHandlePtr->DMAxPtr->HIFCR;
+
+	DMAHandlePtr->streamPtr->CR &= ~DMA_SxCR_EN;
+	while(DMAHandlePtr->streamPtr->CR & DMA_SxCR_EN);
+	*IFCRPtr = DMA_FLAG_ALL << flagShift[streamNo % 4];
+}
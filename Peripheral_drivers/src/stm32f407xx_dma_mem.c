@@ -0,0 +1,226 @@
+/**
+*@file stm32f407xx_dma_mem.c
+*@brief provide asynchronous memory copy and fill on a DMA2 memory to memory stream of stm32f407xx MCUs.
+*
+*This source file provide APIs for copying and filling memory in background.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_dma_mem.h"
+
+#define DMAMEM_CCM_START 0x10000000
+#define DMAMEM_CCM_END 0x10010000
+
+static void DMAMEM_DMA_callback(uint8_t event, void *argPtr);
+static int8_t DMAMEM_submit(DMAMEM_Request_t *reqPtr);
+static void DMAMEM_start_next(void);
+static uint8_t DMAMEM_in_CCM(const void *ptr, uint32_t len);
+
+/*memory copies have low priority, so that they do not delay peripheral streams of DMA2*/
+static DMA_Config_t DMAConfig = {.request = DMA_REQ_MEM2MEM,.direction = DMA_DIR_M2M,.periphSize = DMA_SIZE_WORD,.memSize = DMA_SIZE_WORD,
+																.periphInc = ENABLE,.memInc = ENABLE,.mode = DMA_MODE_NORMAL,.priority = DMA_PRIORITY_LOW,
+																.FIFOThreshold = DMA_FIFO_FULL,.periphBurst = DMA_BURST_SINGLE,.memBurst = DMA_BURST_SINGLE,
+																.callback = DMAMEM_DMA_callback,.argPtr = NULL};
+static DMA_Handle_t DMAHandle = {.DMAConfigPtr = &DMAConfig};
+static uint8_t initialized = 0;
+static DMAMEM_Request_t *queueHead;
+static DMAMEM_Request_t *queueTail;
+static uint32_t chunkLen;	/*bytes of current transfer*/
+
+/***********************************************************************
+Allocate a DMA2 stream for memory copies
+***********************************************************************/
+int8_t DMAMEM_init(void)
+{
+	if(initialized){
+		return DMAHandle.streamIdx;
+	}
+	int8_t streamIdx = DMA_init(&DMAHandle);
+	if(streamIdx >= 0){
+		initialized = 1;
+	}
+	return streamIdx;
+}
+
+/***********************************************************************
+Copy memory in background
+***********************************************************************/
+int8_t DMAMEM_memcpy(DMAMEM_Request_t *reqPtr, void *dstPtr, const void *srcPtr, uint32_t len, DMAMEM_Callback_t callback, void *argPtr)
+{
+	if(reqPtr->state == DMAMEM_STATE_PENDING){
+		return -1;
+	}
+	reqPtr->callback = callback;
+	reqPtr->argPtr = argPtr;
+
+	if(!initialized || len < DMAMEM_CPU_THRESHOLD || DMAMEM_in_CCM(dstPtr,len) || DMAMEM_in_CCM(srcPtr,len)){
+		memcpy(dstPtr,srcPtr,len);
+		reqPtr->state = DMAMEM_STATE_DONE;
+		if(callback != NULL){
+			callback(argPtr);
+		}
+		return 1;
+	}
+
+	reqPtr->dstPtr = dstPtr;
+	reqPtr->srcPtr = srcPtr;
+	reqPtr->remaining = len;
+	return DMAMEM_submit(reqPtr);
+}
+
+/***********************************************************************
+Fill memory with a 32-bits value in background
+***********************************************************************/
+int8_t DMAMEM_memset32(DMAMEM_Request_t *reqPtr, uint32_t *dstPtr, uint32_t value, uint32_t wordNum, DMAMEM_Callback_t callback, void *argPtr)
+{
+	if(reqPtr->state == DMAMEM_STATE_PENDING){
+		return -1;
+	}
+	reqPtr->callback = callback;
+	reqPtr->argPtr = argPtr;
+
+	if(!initialized || 4*wordNum < DMAMEM_CPU_THRESHOLD || DMAMEM_in_CCM(dstPtr,4*wordNum)){
+		for(uint32_t i = 0; i < wordNum; i++){
+			dstPtr[i] = value;
+		}
+		reqPtr->state = DMAMEM_STATE_DONE;
+		if(callback != NULL){
+			callback(argPtr);
+		}
+		return 1;
+	}
+
+	reqPtr->dstPtr = (uint8_t*)dstPtr;
+	reqPtr->srcPtr = NULL;
+	reqPtr->value = value;
+	reqPtr->remaining = 4*wordNum;
+	return DMAMEM_submit(reqPtr);
+}
+
+/***********************************************************************
+Get state of a request
+***********************************************************************/
+uint8_t DMAMEM_get_state(DMAMEM_Request_t *reqPtr)
+{
+	return reqPtr->state;
+}
+
+/***********************************************************************
+Wait until a request is done
+***********************************************************************/
+int8_t DMAMEM_wait(DMAMEM_Request_t *reqPtr)
+{
+	while(reqPtr->state == DMAMEM_STATE_PENDING);
+	return (reqPtr->state == DMAMEM_STATE_ERROR) ? -1 : 0;
+}
+
+/***********************************************************************
+Private function: end of DMA transfer, go on with current request or next one
+***********************************************************************/
+static void DMAMEM_DMA_callback(uint8_t event, void *argPtr)
+{
+	DMAMEM_Request_t *reqPtr = queueHead;
+
+	if(reqPtr == NULL || event == DMA_EV_HALF_CMPLT){
+		return;
+	}
+	if(event == DMA_EV_CMPLT){
+		reqPtr->dstPtr += chunkLen;
+		if(reqPtr->srcPtr != NULL){
+			reqPtr->srcPtr += chunkLen;
+		}
+		reqPtr->remaining -= chunkLen;
+		if(reqPtr->remaining){
+			DMAMEM_start_next();
+			return;
+		}
+		reqPtr->state = DMAMEM_STATE_DONE;
+	}else{
+		DMA_stop(&DMAHandle);
+		reqPtr->state = DMAMEM_STATE_ERROR;
+	}
+
+	/*next request is started before callback run, so that stream does not wait for callback*/
+	queueHead = reqPtr->nextPtr;
+	DMAMEM_start_next();
+	if(reqPtr->callback != NULL){
+		reqPtr->callback(reqPtr->argPtr);
+	}
+}
+
+/***********************************************************************
+Private function: append request to queue, start it if stream is idle
+***********************************************************************/
+static int8_t DMAMEM_submit(DMAMEM_Request_t *reqPtr)
+{
+	reqPtr->nextPtr = NULL;
+	reqPtr->state = DMAMEM_STATE_PENDING;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(queueHead == NULL){
+		queueHead = reqPtr;
+		queueTail = reqPtr;
+		PWR_stop_lock(PWR_LOCK_DMA);
+		DMAMEM_start_next();
+	}else{
+		queueTail->nextPtr = reqPtr;
+		queueTail = reqPtr;
+	}
+	__set_PRIMASK(primask);
+	return 0;
+}
+
+/***********************************************************************
+Private function: start next transfer of request at head of queue, release stop lock if queue is empty
+@note called with interrupts masked or from stream interrupt
+***********************************************************************/
+static void DMAMEM_start_next(void)
+{
+	DMAMEM_Request_t *reqPtr = queueHead;
+
+	if(reqPtr == NULL){
+		PWR_stop_unlock(PWR_LOCK_DMA);
+		return;
+	}
+
+	/*largest data size allowed by alignment of addresses and length, bursts (16 bytes, one FIFO) need 16 bytes alignment
+	so that a burst never cross a 1 kB boundary*/
+	uint32_t alignment = (uint32_t)reqPtr->dstPtr | reqPtr->remaining;
+	if(reqPtr->srcPtr != NULL){
+		alignment |= (uint32_t)reqPtr->srcPtr;
+	}
+	uint8_t size = !(alignment & 0x03) ? DMA_SIZE_WORD : (!(alignment & 0x01) ? DMA_SIZE_HALFWORD : DMA_SIZE_BYTE);
+	uint8_t burst = !(alignment & 0x0F) ? (DMA_BURST_INC16 - size) : DMA_BURST_SINGLE;
+
+	/*fill read a fixed word: source is always word sized, single*/
+	DMAConfig.memSize = size;
+	DMAConfig.memBurst = burst;
+	if(reqPtr->srcPtr != NULL){
+		DMAConfig.periphSize = size;
+		DMAConfig.periphBurst = burst;
+		DMAConfig.periphInc = ENABLE;
+	}else{
+		DMAConfig.periphSize = DMA_SIZE_WORD;
+		DMAConfig.periphBurst = DMA_BURST_SINGLE;
+		DMAConfig.periphInc = DISABLE;
+	}
+	DMA_reconfig(&DMAHandle);
+
+	/*number of data items is counted in source data size, 65535 at most, whole bursts*/
+	uint32_t maxLen = (0xFFFFUL << DMAConfig.periphSize) & ~0x0FUL;
+	chunkLen = (reqPtr->remaining > maxLen) ? maxLen : reqPtr->remaining;
+	const void *srcPtr = (reqPtr->srcPtr != NULL) ? (const void*)reqPtr->srcPtr : (const void*)&reqPtr->value;
+	DMA_start(&DMAHandle,(volatile void*)srcPtr,reqPtr->dstPtr,NULL,chunkLen >> DMAConfig.periphSize);
+}
+
+/***********************************************************************
+Private function: check whether a buffer overlap CCM RAM
+***********************************************************************/
+static uint8_t DMAMEM_in_CCM(const void *ptr, uint32_t len)
+{
+	uint32_t start = (uint32_t)ptr;
+	return (start < DMAMEM_CCM_END && start + len > DMAMEM_CCM_START);
+}
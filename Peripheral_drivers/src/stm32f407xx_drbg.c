@@ -0,0 +1,321 @@
+/**
+*@file stm32f407xx_drbg.c
+*@brief provide fast software random generators seeded from hardware RNG.
+*
+*This source file provide APIs for a ChaCha20 based deterministic random bit generator (DRBG) and a xoshiro128** generator.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_drbg.h"
+
+#define DRBG_BLOCK_SIZE 64
+#define DRBG_KEY_WORDS 8
+#define DRBG_XOSHIRO_WORDS 4
+#define DRBG_REKEY_BLOCKS 16	/*key is replaced at least every 1 kB of ChaCha20 output*/
+
+#define DRBG_ROTL(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define DRBG_QUARTER_ROUND(a,b,c,d) \
+	a += b; d = DRBG_ROTL(d ^ a,16); \
+	c += d; b = DRBG_ROTL(b ^ c,12); \
+	a += b; d = DRBG_ROTL(d ^ a,8); \
+	c += d; b = DRBG_ROTL(b ^ c,7)
+
+static void DRBG_chacha_block(const uint32_t *statePtr, uint32_t *outPtr);
+static void DRBG_chacha_next(DRBG_Handle_t *DRBGHandlePtr, uint32_t *outPtr);
+static void DRBG_chacha_rekey(DRBG_Handle_t *DRBGHandlePtr, uint8_t dropBlock);
+static void DRBG_chacha_output(DRBG_Handle_t *DRBGHandlePtr, uint8_t *bytePtr, uint32_t len);
+static uint32_t DRBG_xoshiro_next(uint32_t *statePtr);
+static void DRBG_xoshiro_fix(uint32_t *statePtr);
+static void DRBG_check_reseed(DRBG_Handle_t *DRBGHandlePtr, uint32_t len);
+
+/***********************************************************************
+Initialize generator and seed it from entropy callback
+***********************************************************************/
+int8_t DRBG_init(DRBG_Handle_t *DRBGHandlePtr)
+{
+	DRBG_Config_t *configPtr = DRBGHandlePtr->DRBGConfigPtr;
+
+	if(configPtr->type > DRBG_TYPE_XOSHIRO || configPtr->entropy == NULL){
+		return -1;
+	}
+
+	DRBG_seed(DRBGHandlePtr,NULL,0);
+	return DRBG_reseed(DRBGHandlePtr);
+}
+
+/***********************************************************************
+Seed generator with given words
+***********************************************************************/
+void DRBG_seed(DRBG_Handle_t *DRBGHandlePtr, const uint32_t *seedPtr, uint8_t wordNum)
+{
+	if(wordNum > DRBG_SEED_WORDS_MAX){
+		wordNum = DRBG_SEED_WORDS_MAX;
+	}
+
+	memset(DRBGHandlePtr->state,0,sizeof(DRBGHandlePtr->state));
+	memset(DRBGHandlePtr->block,0,sizeof(DRBGHandlePtr->block));
+	if(wordNum){
+		memcpy(DRBGHandlePtr->state,seedPtr,wordNum*sizeof(uint32_t));
+	}
+	DRBGHandlePtr->blockIdx = DRBG_BLOCK_SIZE;
+	DRBGHandlePtr->blockNum = 0;
+	DRBGHandlePtr->outputNum = 0;
+
+	if(DRBGHandlePtr->DRBGConfigPtr->type == DRBG_TYPE_XOSHIRO){
+		memset(&DRBGHandlePtr->state[DRBG_XOSHIRO_WORDS],0,sizeof(DRBGHandlePtr->state) - DRBG_XOSHIRO_WORDS*sizeof(uint32_t));
+		DRBG_xoshiro_fix(DRBGHandlePtr->state);
+	}
+}
+
+/***********************************************************************
+Mix fresh entropy into generator state
+***********************************************************************/
+int8_t DRBG_reseed(DRBG_Handle_t *DRBGHandlePtr)
+{
+	DRBG_Entropy_t entropy = DRBGHandlePtr->DRBGConfigPtr->entropy;
+
+	if(entropy == NULL){
+		return -1;
+	}
+
+	if(DRBGHandlePtr->DRBGConfigPtr->type == DRBG_TYPE_XOSHIRO){
+		for(uint8_t i = 0; i < DRBG_XOSHIRO_WORDS; i++){
+			DRBGHandlePtr->state[i] ^= entropy();
+		}
+		DRBG_xoshiro_fix(DRBGHandlePtr->state);
+	}else{
+		/*entropy is added to key, then key is passed through ChaCha20 so that weak entropy word can not cancel state*/
+		for(uint8_t i = 0; i < DRBG_KEY_WORDS; i++){
+			DRBGHandlePtr->state[i] ^= entropy();
+		}
+		DRBG_chacha_rekey(DRBGHandlePtr,1);
+	}
+	DRBGHandlePtr->outputNum = 0;
+	return 0;
+}
+
+/***********************************************************************
+Fill a buffer with random bytes
+***********************************************************************/
+void DRBG_fill(DRBG_Handle_t *DRBGHandlePtr, void *bufferPtr, uint32_t len)
+{
+	uint8_t *bytePtr = (uint8_t*)bufferPtr;
+
+	DRBG_check_reseed(DRBGHandlePtr,len);
+
+	if(DRBGHandlePtr->DRBGConfigPtr->type == DRBG_TYPE_XOSHIRO){
+		uint32_t word;
+		if(!((uintptr_t)bytePtr & 3)){
+			uint32_t *wordPtr = (uint32_t*)bytePtr;
+			for(; len >= sizeof(word); len -= sizeof(word)){
+				*wordPtr++ = DRBG_xoshiro_next(DRBGHandlePtr->state);
+			}
+			bytePtr = (uint8_t*)wordPtr;
+		}
+		for(; len >= sizeof(word); len -= sizeof(word)){
+			word = DRBG_xoshiro_next(DRBGHandlePtr->state);
+			memcpy(bytePtr,&word,sizeof(word));
+			bytePtr += sizeof(word);
+		}
+		if(len){
+			word = DRBG_xoshiro_next(DRBGHandlePtr->state);
+			memcpy(bytePtr,&word,len);
+		}
+		return;
+	}
+
+	DRBG_chacha_output(DRBGHandlePtr,bytePtr,len);
+	DRBG_chacha_rekey(DRBGHandlePtr,1);
+}
+
+/***********************************************************************
+Get a 32-bits random value
+***********************************************************************/
+uint32_t DRBG_get(DRBG_Handle_t *DRBGHandlePtr)
+{
+	uint32_t value;
+
+	DRBG_check_reseed(DRBGHandlePtr,sizeof(value));
+
+	if(DRBGHandlePtr->DRBGConfigPtr->type == DRBG_TYPE_XOSHIRO){
+		return DRBG_xoshiro_next(DRBGHandlePtr->state);
+	}
+
+	/*no key replacement after each word, block buffer is consumed by successive calls*/
+	DRBG_chacha_output(DRBGHandlePtr,(uint8_t*)&value,sizeof(value));
+	return value;
+}
+
+/***********************************************************************
+Get a random value in [0, range)
+***********************************************************************/
+uint32_t DRBG_get_range(DRBG_Handle_t *DRBGHandlePtr, uint32_t range)
+{
+	/*multiply and shift, values falling in biased low part are drawn again*/
+	uint64_t product = (uint64_t)DRBG_get(DRBGHandlePtr)*range;
+
+	if((uint32_t)product < range){
+		uint32_t threshold = (0 - range) % range;
+		while((uint32_t)product < threshold){
+			product = (uint64_t)DRBG_get(DRBGHandlePtr)*range;
+		}
+	}
+	return product >> 32;
+}
+
+/***********************************************************************
+Private function: ChaCha20 block of key and 64 bits block counter, nonce is 0
+***********************************************************************/
+static void DRBG_chacha_block(const uint32_t *statePtr, uint32_t *outPtr)
+{
+	uint32_t input[16] = {0x61707865,0x3320646e,0x79622d32,0x6b206574,
+												statePtr[0],statePtr[1],statePtr[2],statePtr[3],statePtr[4],statePtr[5],statePtr[6],statePtr[7],
+												statePtr[8],statePtr[9],0,0};
+	uint32_t x0 = input[0], x1 = input[1], x2 = input[2], x3 = input[3];
+	uint32_t x4 = input[4], x5 = input[5], x6 = input[6], x7 = input[7];
+	uint32_t x8 = input[8], x9 = input[9], x10 = input[10], x11 = input[11];
+	uint32_t x12 = input[12], x13 = input[13], x14 = input[14], x15 = input[15];
+
+	/*10 double rounds: column round then diagonal round*/
+	for(uint8_t i = 0; i < 10; i++){
+		DRBG_QUARTER_ROUND(x0,x4,x8,x12);
+		DRBG_QUARTER_ROUND(x1,x5,x9,x13);
+		DRBG_QUARTER_ROUND(x2,x6,x10,x14);
+		DRBG_QUARTER_ROUND(x3,x7,x11,x15);
+		DRBG_QUARTER_ROUND(x0,x5,x10,x15);
+		DRBG_QUARTER_ROUND(x1,x6,x11,x12);
+		DRBG_QUARTER_ROUND(x2,x7,x8,x13);
+		DRBG_QUARTER_ROUND(x3,x4,x9,x14);
+	}
+
+	/*words are little endian, same as byte order of keystream*/
+	outPtr[0] = x0 + input[0];
+	outPtr[1] = x1 + input[1];
+	outPtr[2] = x2 + input[2];
+	outPtr[3] = x3 + input[3];
+	outPtr[4] = x4 + input[4];
+	outPtr[5] = x5 + input[5];
+	outPtr[6] = x6 + input[6];
+	outPtr[7] = x7 + input[7];
+	outPtr[8] = x8 + input[8];
+	outPtr[9] = x9 + input[9];
+	outPtr[10] = x10 + input[10];
+	outPtr[11] = x11 + input[11];
+	outPtr[12] = x12 + input[12];
+	outPtr[13] = x13 + input[13];
+	outPtr[14] = x14 + input[14];
+	outPtr[15] = x15 + input[15];
+}
+
+/***********************************************************************
+Private function: generate next ChaCha20 block and advance block counter
+***********************************************************************/
+static void DRBG_chacha_next(DRBG_Handle_t *DRBGHandlePtr, uint32_t *outPtr)
+{
+	uint32_t *statePtr = DRBGHandlePtr->state;
+
+	DRBG_chacha_block(statePtr,outPtr);
+	if(!++statePtr[DRBG_KEY_WORDS]){
+		statePtr[DRBG_KEY_WORDS + 1]++;
+	}
+	if(++DRBGHandlePtr->blockNum >= DRBG_REKEY_BLOCKS){
+		DRBG_chacha_rekey(DRBGHandlePtr,0);
+	}
+}
+
+/***********************************************************************
+Private function: replace key by first half of next block, unused bytes of block buffer are dropped if requested
+***********************************************************************/
+static void DRBG_chacha_rekey(DRBG_Handle_t *DRBGHandlePtr, uint8_t dropBlock)
+{
+	uint32_t *statePtr = DRBGHandlePtr->state;
+	uint32_t block[16];
+
+	DRBG_chacha_block(statePtr,block);
+	memcpy(statePtr,block,DRBG_KEY_WORDS*sizeof(uint32_t));
+	statePtr[DRBG_KEY_WORDS] = 0;
+	statePtr[DRBG_KEY_WORDS + 1] = 0;
+	memset(block,0,sizeof(block));
+	DRBGHandlePtr->blockNum = 0;
+
+	if(dropBlock){
+		memset(DRBGHandlePtr->block,0,sizeof(DRBGHandlePtr->block));
+		DRBGHandlePtr->blockIdx = DRBG_BLOCK_SIZE;
+	}
+}
+
+/***********************************************************************
+Private function: copy ChaCha20 keystream into buffer
+@note whole blocks are generated in place when buffer is word aligned, served bytes of block buffer are erased
+***********************************************************************/
+static void DRBG_chacha_output(DRBG_Handle_t *DRBGHandlePtr, uint8_t *bytePtr, uint32_t len)
+{
+	uint8_t *blockPtr = (uint8_t*)DRBGHandlePtr->block;
+
+	while(len){
+		if(DRBGHandlePtr->blockIdx == DRBG_BLOCK_SIZE){
+			if(len >= DRBG_BLOCK_SIZE && !((uintptr_t)bytePtr & 3)){
+				DRBG_chacha_next(DRBGHandlePtr,(uint32_t*)bytePtr);
+				bytePtr += DRBG_BLOCK_SIZE;
+				len -= DRBG_BLOCK_SIZE;
+				continue;
+			}
+			DRBG_chacha_next(DRBGHandlePtr,DRBGHandlePtr->block);
+			DRBGHandlePtr->blockIdx = 0;
+		}
+
+		uint32_t byteNum = DRBG_BLOCK_SIZE - DRBGHandlePtr->blockIdx;
+		if(byteNum > len){
+			byteNum = len;
+		}
+		memcpy(bytePtr,&blockPtr[DRBGHandlePtr->blockIdx],byteNum);
+		memset(&blockPtr[DRBGHandlePtr->blockIdx],0,byteNum);
+		DRBGHandlePtr->blockIdx += byteNum;
+		bytePtr += byteNum;
+		len -= byteNum;
+	}
+}
+
+/***********************************************************************
+Private function: xoshiro128** next value
+***********************************************************************/
+static uint32_t DRBG_xoshiro_next(uint32_t *statePtr)
+{
+	uint32_t result = DRBG_ROTL(statePtr[1]*5,7)*9;
+	uint32_t temp = statePtr[1] << 9;
+
+	statePtr[2] ^= statePtr[0];
+	statePtr[3] ^= statePtr[1];
+	statePtr[1] ^= statePtr[2];
+	statePtr[0] ^= statePtr[3];
+	statePtr[2] ^= temp;
+	statePtr[3] = DRBG_ROTL(statePtr[3],11);
+
+	return result;
+}
+
+/***********************************************************************
+Private function: xoshiro128** state must not be all zero
+***********************************************************************/
+static void DRBG_xoshiro_fix(uint32_t *statePtr)
+{
+	if(!(statePtr[0] | statePtr[1] | statePtr[2] | statePtr[3])){
+		statePtr[0] = 0x9E3779B9;
+	}
+}
+
+/***********************************************************************
+Private function: reseed once interval is reached, count output
+***********************************************************************/
+static void DRBG_check_reseed(DRBG_Handle_t *DRBGHandlePtr, uint32_t len)
+{
+	DRBG_Config_t *configPtr = DRBGHandlePtr->DRBGConfigPtr;
+
+	if(configPtr->reseedInterval != DRBG_RESEED_NEVER && configPtr->entropy != NULL
+			&& DRBGHandlePtr->outputNum >= configPtr->reseedInterval){
+		DRBG_reseed(DRBGHandlePtr);
+	}
+	DRBGHandlePtr->outputNum += len;
+}
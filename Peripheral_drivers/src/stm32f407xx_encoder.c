@@ -0,0 +1,263 @@
+/**
+*@file stm32f407xx_encoder.c
+*@brief provide quadrature encoder position and velocity measurement on stm32f407xx MCUs.
+*
+*This source file provide APIs for reading a quadrature encoder with a timer in encoder interface mode and estimating its velocity.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_encoder.h"
+
+typedef struct{
+	TIM_TypeDef *slaveTIMxPtr;
+	TIM_TypeDef *masterTIMxPtr;
+	uint8_t trigger;
+}ENCODER_ITR_Map_t;
+
+/*internal trigger connection between timers, refer to TIMx internal trigger connection tables in reference manual*/
+static const ENCODER_ITR_Map_t ITRMap[] = {
+	{TIM1,TIM5,TIM_TRIGGER_ITR0},{TIM1,TIM2,TIM_TRIGGER_ITR1},{TIM1,TIM3,TIM_TRIGGER_ITR2},{TIM1,TIM4,TIM_TRIGGER_ITR3},
+	{TIM2,TIM1,TIM_TRIGGER_ITR0},{TIM2,TIM8,TIM_TRIGGER_ITR1},{TIM2,TIM3,TIM_TRIGGER_ITR2},{TIM2,TIM4,TIM_TRIGGER_ITR3},
+	{TIM3,TIM1,TIM_TRIGGER_ITR0},{TIM3,TIM2,TIM_TRIGGER_ITR1},{TIM3,TIM5,TIM_TRIGGER_ITR2},{TIM3,TIM4,TIM_TRIGGER_ITR3},
+	{TIM4,TIM1,TIM_TRIGGER_ITR0},{TIM4,TIM2,TIM_TRIGGER_ITR1},{TIM4,TIM3,TIM_TRIGGER_ITR2},{TIM4,TIM8,TIM_TRIGGER_ITR3},
+	{TIM5,TIM2,TIM_TRIGGER_ITR0},{TIM5,TIM3,TIM_TRIGGER_ITR1},{TIM5,TIM4,TIM_TRIGGER_ITR2},{TIM5,TIM8,TIM_TRIGGER_ITR3},
+	{TIM8,TIM1,TIM_TRIGGER_ITR0},{TIM8,TIM2,TIM_TRIGGER_ITR1},{TIM8,TIM4,TIM_TRIGGER_ITR2},{TIM8,TIM5,TIM_TRIGGER_ITR3},
+};
+
+static uint8_t ENCODER_get_trigger(TIM_TypeDef *slaveTIMxPtr, TIM_TypeDef *masterTIMxPtr, uint8_t *triggerPtr);
+static uint32_t ENCODER_get_mask(TIM_TypeDef *TIMxPtr);
+static int32_t ENCODER_signed_diff(uint32_t a, uint32_t b, uint32_t mask);
+
+/***********************************************************************
+Initialize encoder timer and timestamp timer
+***********************************************************************/
+int8_t ENCODER_init(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = ENCODERHandlePtr->TIMxPtr;
+	ENCODER_Config_t *configPtr = ENCODERHandlePtr->ENCODERConfigPtr;
+	TIM_TypeDef *timestampTIMxPtr = configPtr->timestampTIMxPtr;
+	uint8_t trigger;
+
+	/*every timer with encoder mode appear as slave in internal trigger map*/
+	if(!ENCODER_get_trigger(TIMxPtr,NULL,&trigger)){
+		return -1;
+	}
+	if(timestampTIMxPtr != NULL && !ENCODER_get_trigger(timestampTIMxPtr,TIMxPtr,&trigger)){
+		return -1;
+	}
+
+	/*counter use its whole range, position is extended in software*/
+	TIM_Encoder_Config_t encoderConfig = {.mode = configPtr->mode,.polarityA = configPtr->polarityA,.polarityB = configPtr->polarityB,
+																				.filter = configPtr->filter,.reloadVal = 0xFFFFFFFF};
+	TIM_encoder_init(TIMxPtr,&encoderConfig);
+	ENCODERHandlePtr->countMask = ENCODER_get_mask(TIMxPtr);
+	ENCODERHandlePtr->lastCount = 0;
+	ENCODERHandlePtr->position = 0;
+	ENCODERHandlePtr->velocity = 0;
+
+	if(timestampTIMxPtr != NULL){
+		/*encoder timer capture position on each A edge (IC1 is already mapped on TI1) and pulse TRGO*/
+		TIM_IC_Config_t ICConfig = {.channel = TIM_CHANNEL_1,.selection = TIM_IC_DIRECT_TI,.polarity = configPtr->polarityA,
+																.prescaler = TIM_IC_PRESCALER_DIV1,.filter = configPtr->filter};
+		TIM_IC_init(TIMxPtr,&ICConfig);
+		TIM_master_mode_config(TIMxPtr,TIM_MASTER_MODE_COMPARE_PULSE);
+
+		/*timestamp timer run free and capture its counter on trigger pulse (TRC) of encoder timer*/
+		int32_t TIMCLK = TIM_get_CLK_value(timestampTIMxPtr);
+		uint32_t prescaler = (TIMCLK + configPtr->timestampFreq/2)/configPtr->timestampFreq;
+		if(prescaler == 0){
+			prescaler = 1;
+		}else if(prescaler > 0x10000){
+			prescaler = 0x10000;
+		}
+		TIM_Config_t TIMConfig = {.reloadVal = 0xFFFFFFFF,.prescaler = prescaler - 1};
+		TIM_Handle_t TIMHandle = {timestampTIMxPtr,&TIMConfig};
+		TIM_init(&TIMHandle);
+		ENCODERHandlePtr->timestampFreq = TIMCLK/prescaler;
+		ENCODERHandlePtr->timestampMask = ENCODER_get_mask(timestampTIMxPtr);
+
+		ICConfig.channel = configPtr->timestampChannel;
+		ICConfig.selection = TIM_IC_TRC;
+		ICConfig.polarity = TIM_IC_POLARITY_RISING;
+		ICConfig.filter = 0;
+		TIM_IC_init(timestampTIMxPtr,&ICConfig);
+		TIM_slave_mode_config(timestampTIMxPtr,TIM_SLAVE_MODE_DISABLE,trigger);
+		TIM_ctr(timestampTIMxPtr,START);
+
+		ENCODERHandlePtr->lastUpdateTime = TIM_get_counter(timestampTIMxPtr) & ENCODERHandlePtr->timestampMask;
+		ENCODERHandlePtr->lastEdgeTime = TIM_get_capture_val(timestampTIMxPtr,configPtr->timestampChannel) & ENCODERHandlePtr->timestampMask;
+		ENCODERHandlePtr->lastEdgePos = 0;
+		ENCODERHandlePtr->lastEdgeDelta = 0;
+		ENCODERHandlePtr->idleTicks = 0;
+		ENCODERHandlePtr->edgeValid = 0;
+	}
+
+	TIM_ctr(TIMxPtr,START);
+	ENCODERHandlePtr->busy = 1;
+	PWR_stop_lock(PWR_LOCK_ENCODER);
+	return 0;
+}
+
+/***********************************************************************
+Stop encoder timer and timestamp timer
+***********************************************************************/
+void ENCODER_stop(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	TIM_TypeDef *timestampTIMxPtr = ENCODERHandlePtr->ENCODERConfigPtr->timestampTIMxPtr;
+
+	TIM_ctr(ENCODERHandlePtr->TIMxPtr,STOP);
+	if(timestampTIMxPtr != NULL){
+		TIM_ctr(timestampTIMxPtr,STOP);
+	}
+
+	if(ENCODERHandlePtr->busy){
+		ENCODERHandlePtr->busy = 0;
+		PWR_stop_unlock(PWR_LOCK_ENCODER);
+	}
+}
+
+/***********************************************************************
+Update position and velocity
+***********************************************************************/
+void ENCODER_update(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = ENCODERHandlePtr->TIMxPtr;
+	ENCODER_Config_t *configPtr = ENCODERHandlePtr->ENCODERConfigPtr;
+	TIM_TypeDef *timestampTIMxPtr = configPtr->timestampTIMxPtr;
+
+	uint32_t count = TIMxPtr->CNT & ENCODERHandlePtr->countMask;
+	int32_t delta = ENCODER_signed_diff(count,ENCODERHandlePtr->lastCount,ENCODERHandlePtr->countMask);
+	ENCODERHandlePtr->position += delta;
+	ENCODERHandlePtr->lastCount = count;
+
+	if(timestampTIMxPtr == NULL){
+		/*counts per fixed interval*/
+		ENCODERHandlePtr->velocity = (int64_t)delta*configPtr->updateFreq*100;
+		return;
+	}
+
+	/*position and time of last A edge, read again if a new edge was captured meanwhile*/
+	uint32_t edgeCount, edgeTime;
+	do{
+		edgeCount = TIM_get_capture_val(TIMxPtr,TIM_CHANNEL_1);
+		edgeTime = TIM_get_capture_val(timestampTIMxPtr,configPtr->timestampChannel);
+	}while(edgeCount != TIM_get_capture_val(TIMxPtr,TIM_CHANNEL_1));
+	uint32_t now = TIM_get_counter(timestampTIMxPtr) & ENCODERHandlePtr->timestampMask;
+	uint32_t mask = ENCODERHandlePtr->timestampMask;
+
+	edgeTime &= mask;
+	int32_t edgePos = ENCODERHandlePtr->position - ENCODER_signed_diff(count,edgeCount & ENCODERHandlePtr->countMask,ENCODERHandlePtr->countMask);
+	uint32_t sinceUpdate = (now - ENCODERHandlePtr->lastUpdateTime) & mask;
+	uint32_t stopTicks = ((uint64_t)ENCODERHandlePtr->timestampFreq*ENCODER_STOP_TIMEOUT_MS)/1000;
+
+	if(edgeTime != ENCODERHandlePtr->lastEdgeTime){
+		/*time between edges: idle time up to last update, plus time from last update to new edge*/
+		uint32_t edgeTicks = ENCODERHandlePtr->idleTicks + ((edgeTime - ENCODERHandlePtr->lastUpdateTime) & mask);
+		if(edgeTicks < ENCODERHandlePtr->idleTicks){
+			ENCODERHandlePtr->edgeValid = 0;
+		}
+		if(ENCODERHandlePtr->edgeValid && edgeTicks){
+			int32_t edgeDelta = edgePos - ENCODERHandlePtr->lastEdgePos;
+			ENCODERHandlePtr->velocity = ((int64_t)edgeDelta*ENCODERHandlePtr->timestampFreq*100)/edgeTicks;
+			ENCODERHandlePtr->lastEdgeDelta = edgeDelta;
+		}
+		ENCODERHandlePtr->lastEdgePos = edgePos;
+		ENCODERHandlePtr->lastEdgeTime = edgeTime;
+		ENCODERHandlePtr->idleTicks = (now - edgeTime) & mask;
+		ENCODERHandlePtr->edgeValid = 1;
+	}else{
+		/*no edge: idle time saturate, measurement across saturated idle time is not valid*/
+		if(ENCODERHandlePtr->idleTicks + sinceUpdate < ENCODERHandlePtr->idleTicks){
+			ENCODERHandlePtr->idleTicks = 0xFFFFFFFF;
+			ENCODERHandlePtr->edgeValid = 0;
+		}else{
+			ENCODERHandlePtr->idleTicks += sinceUpdate;
+		}
+
+		if(ENCODERHandlePtr->idleTicks >= stopTicks){
+			ENCODERHandlePtr->velocity = 0;
+		}else{
+			/*next edge is at least idle time away, so speed can not be higher than last edge counts over idle time*/
+			int32_t edgeDelta = abs(ENCODERHandlePtr->lastEdgeDelta);
+			edgeDelta = edgeDelta ? edgeDelta : 1;
+			int64_t bound = ((int64_t)edgeDelta*ENCODERHandlePtr->timestampFreq*100)/(ENCODERHandlePtr->idleTicks ? ENCODERHandlePtr->idleTicks : 1);
+			if(ENCODERHandlePtr->velocity > bound){
+				ENCODERHandlePtr->velocity = bound;
+			}else if(ENCODERHandlePtr->velocity < -bound){
+				ENCODERHandlePtr->velocity = -bound;
+			}
+		}
+	}
+	ENCODERHandlePtr->lastUpdateTime = now;
+}
+
+/***********************************************************************
+Get position at last update
+***********************************************************************/
+int32_t ENCODER_get_position(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	return ENCODERHandlePtr->position;
+}
+
+/***********************************************************************
+Set position
+***********************************************************************/
+void ENCODER_set_position(ENCODER_Handle_t *ENCODERHandlePtr, int32_t position)
+{
+	/*edge position is moved by same offset so that next velocity is not disturbed*/
+	ENCODERHandlePtr->lastEdgePos += position - ENCODERHandlePtr->position;
+	ENCODERHandlePtr->position = position;
+}
+
+/***********************************************************************
+Get velocity at last update
+***********************************************************************/
+int32_t ENCODER_get_velocity(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	return ENCODERHandlePtr->velocity;
+}
+
+/***********************************************************************
+Get shaft speed at last update
+***********************************************************************/
+int32_t ENCODER_get_rpm(ENCODER_Handle_t *ENCODERHandlePtr)
+{
+	return ((int64_t)ENCODERHandlePtr->velocity*60)/(int32_t)ENCODERHandlePtr->ENCODERConfigPtr->countsPerRev;
+}
+
+/***********************************************************************
+Private function: find internal trigger of slave timer connected to master timer (any master if NULL)
+***********************************************************************/
+static uint8_t ENCODER_get_trigger(TIM_TypeDef *slaveTIMxPtr, TIM_TypeDef *masterTIMxPtr, uint8_t *triggerPtr)
+{
+	for(uint8_t i = 0; i < sizeof(ITRMap)/sizeof(ITRMap[0]); i++){
+		if(ITRMap[i].slaveTIMxPtr == slaveTIMxPtr && (masterTIMxPtr == NULL || ITRMap[i].masterTIMxPtr == masterTIMxPtr)){
+			*triggerPtr = ITRMap[i].trigger;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/***********************************************************************
+Private function: get counter range of timer
+***********************************************************************/
+static uint32_t ENCODER_get_mask(TIM_TypeDef *TIMxPtr)
+{
+	return (TIMxPtr == TIM2 || TIMxPtr == TIM5) ? 0xFFFFFFFF : 0xFFFF;
+}
+
+/***********************************************************************
+Private function: signed difference of two counter values within counter range
+***********************************************************************/
+static int32_t ENCODER_signed_diff(uint32_t a, uint32_t b, uint32_t mask)
+{
+	uint32_t diff = (a - b) & mask;
+
+	if(mask == 0xFFFF){
+		return (int16_t)diff;
+	}
+	return (int32_t)diff;
+}
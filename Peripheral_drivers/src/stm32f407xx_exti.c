@@ -0,0 +1,227 @@
+/**
+*@file stm32f407xx_exti.c
+*@brief provide per-pin external interrupt dispatch on stm32f407xx MCUs.
+*
+*This source file provide APIs for registering a callback on each of the 16 EXTI lines.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_exti.h"
+
+static void EXTI_line_ctr (uint16_t lineBit, uint8_t enOrDis);
+static void EXTI_process_edge (uint8_t line, uint64_t timestampUs);
+static void EXTI_dispatch (uint8_t line, uint8_t level, uint64_t timestampUs);
+static void EXTI_debounce_expiry (void *argPtr);
+static uint8_t EXTI_get_IRQ_number (uint8_t line);
+
+static const EXTI_Config_t *lineConfig[EXTI_LINE_NUM];
+static SWTIM_Timer_t debounceTimer[EXTI_LINE_NUM];
+static uint64_t edgeTime[EXTI_LINE_NUM];	/*time of first edge of debounced line*/
+static volatile uint8_t lineArmed[EXTI_LINE_NUM];
+static uint8_t stableLevel[EXTI_LINE_NUM];	/*last reported level of debounced line*/
+
+/***********************************************************************
+Register callback of a line
+***********************************************************************/
+int8_t EXTI_register(uint8_t line, const EXTI_Config_t *EXTIConfigPtr)
+{
+	if(line >= EXTI_LINE_NUM || EXTIConfigPtr == NULL){
+		return -1;
+	}
+
+	EXTI_disarm(line);
+	TIME_init();
+	lineConfig[line] = EXTIConfigPtr;
+	SWTIM_timer_init(&debounceTimer[line],EXTI_debounce_expiry,(void*)(uint32_t)line);
+	/*debounced line track pin level, so both edges are needed, selected edge is filtered after sampling*/
+	GPIO_EXTI_line_config(EXTIConfigPtr->GPIOxPtr,line,EXTIConfigPtr->debounceUs ? GPIO_MODE_INTRPT_RFE : EXTIConfigPtr->edge);
+
+	uint8_t IRQNumber = EXTI_get_IRQ_number(line);
+	GPIO_Intrpt_priority_config(IRQNumber,EXTI_IRQ_PRIORITY);
+	GPIO_Intrpt_ctrl(IRQNumber,ENABLE);
+	EXTI_arm(line);
+	return 0;
+}
+
+/***********************************************************************
+Remove callback of a line
+***********************************************************************/
+void EXTI_unregister(uint8_t line)
+{
+	if(line >= EXTI_LINE_NUM){
+		return;
+	}
+	EXTI_disarm(line);
+	lineConfig[line] = NULL;
+}
+
+/***********************************************************************
+Arm a registered line
+***********************************************************************/
+void EXTI_arm(uint8_t line)
+{
+	if(line >= EXTI_LINE_NUM || lineConfig[line] == NULL){
+		return;
+	}
+	uint16_t lineBit = 1<<line;
+
+	/*current level is the reference for debouncing, edge which occurred while line was disarmed is dropped*/
+	stableLevel[line] = GPIO_read_pin(lineConfig[line]->GPIOxPtr,line);
+	EXTI->PR = lineBit;
+	lineArmed[line] = 1;
+	EXTI_line_ctr(lineBit,ENABLE);
+}
+
+/***********************************************************************
+Disarm a line
+***********************************************************************/
+void EXTI_disarm(uint8_t line)
+{
+	if(line >= EXTI_LINE_NUM){
+		return;
+	}
+	uint16_t lineBit = 1<<line;
+
+	lineArmed[line] = 0;
+	EXTI_line_ctr(lineBit,DISABLE);
+	if(lineConfig[line] != NULL){
+		SWTIM_cancel(&debounceTimer[line]);
+	}
+}
+
+/***********************************************************************
+Check whether a line is armed
+***********************************************************************/
+uint8_t EXTI_is_armed(uint8_t line)
+{
+	return (line < EXTI_LINE_NUM) ? lineArmed[line] : 0;
+}
+
+/***********************************************************************
+EXTI interrupt handler
+***********************************************************************/
+void EXTI_intrpt_handler(uint8_t IRQNumber)
+{
+	uint32_t vectorLines;
+
+	if(IRQNumber == IRQ_EXTI9_5){
+		vectorLines = 0x03E0;
+	}else if(IRQNumber == IRQ_EXTI15_10){
+		vectorLines = 0xFC00;
+	}else{
+		vectorLines = 1<<(IRQNumber - IRQ_EXTI0);
+	}
+
+	uint32_t pending = EXTI->PR & EXTI->IMR & vectorLines;
+	if(!pending){
+		return;
+	}
+	/*one timestamp for all lines found pending together, taken before any callback run*/
+	uint64_t timestampUs = TIME_get_us();
+
+	while(pending){
+		uint8_t line = 31 - __CLZ(pending);
+		pending &= ~(1UL<<line);
+		EXTI->PR = 1UL<<line;
+		EXTI_process_edge(line,timestampUs);
+	}
+}
+
+/***********************************************************************
+Private function: unmask or mask lines, IMR is also written from interrupts of other priorities
+***********************************************************************/
+static void EXTI_line_ctr (uint16_t lineBit, uint8_t enOrDis)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(enOrDis == ENABLE){
+		EXTI->IMR |= lineBit;
+	}else{
+		EXTI->IMR &= ~lineBit;
+	}
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Private function: handle an edge on a line
+***********************************************************************/
+static void EXTI_process_edge (uint8_t line, uint64_t timestampUs)
+{
+	const EXTI_Config_t *configPtr = lineConfig[line];
+
+	if(configPtr == NULL){
+		/*line unmasked without callback*/
+		EXTI_line_ctr(1<<line,DISABLE);
+		return;
+	}
+
+	if(configPtr->debounceUs){
+		/*ignore bounces until level is sampled*/
+		EXTI_line_ctr(1<<line,DISABLE);
+		edgeTime[line] = timestampUs;
+		SWTIM_start(&debounceTimer[line],(uint64_t)configPtr->debounceUs*SWTIM_COUNT_FREQ/1000000,0);
+	}else{
+		EXTI_dispatch(line,GPIO_read_pin(configPtr->GPIOxPtr,line),timestampUs);
+	}
+}
+
+/***********************************************************************
+Private function: call callback of a line, disarm oneshot line before so that callback may re-arm it
+***********************************************************************/
+static void EXTI_dispatch (uint8_t line, uint8_t level, uint64_t timestampUs)
+{
+	const EXTI_Config_t *configPtr = lineConfig[line];
+
+	if(configPtr->oneshot == ENABLE){
+		EXTI_disarm(line);
+	}
+	if(configPtr->callback != NULL){
+		configPtr->callback(line,level,timestampUs,configPtr->argPtr);
+	}
+}
+
+/***********************************************************************
+Private function: sample debounced line at end of debounce time
+***********************************************************************/
+static void EXTI_debounce_expiry (void *argPtr)
+{
+	uint8_t line = (uint32_t)argPtr;
+	uint16_t lineBit = 1<<line;
+	const EXTI_Config_t *configPtr = lineConfig[line];
+
+	if(!lineArmed[line] || configPtr == NULL){
+		return;
+	}
+
+	/*pending bit is cleared before pin is read, so an edge after reading is not lost*/
+	EXTI->PR = lineBit;
+	uint8_t level = GPIO_read_pin(configPtr->GPIOxPtr,line);
+	EXTI_line_ctr(lineBit,ENABLE);
+
+	/*a pulse shorter than debounce time leave level unchanged and is ignored*/
+	if(level == stableLevel[line]){
+		return;
+	}
+	stableLevel[line] = level;
+
+	if(configPtr->edge == GPIO_MODE_INTRPT_RFE || (configPtr->edge == GPIO_MODE_INTRPT_RE && level)
+		|| (configPtr->edge == GPIO_MODE_INTRPT_FE && !level)){
+		EXTI_dispatch(line,level,edgeTime[line]);
+	}
+}
+
+/***********************************************************************
+Private function: get IRQ number of vector serving a line
+***********************************************************************/
+static uint8_t EXTI_get_IRQ_number (uint8_t line)
+{
+	if(line <= 4){
+		return IRQ_EXTI0 + line;
+	}else if(line <= 9){
+		return IRQ_EXTI9_5;
+	}else{
+		return IRQ_EXTI15_10;
+	}
+}
@@ -10,6 +10,13 @@
 
 #include "../inc/stm32f407xx_gpio.h"  
 
+static uint32_t GPIO_spread_2_bits (uint16_t mask);
+static uint32_t GPIO_spread_4_bits (uint8_t mask);
+static int8_t GPIO_table_find (const GPIO_Port_table_t *tablePtr);
+
+static uint16_t claimedPins[GPIO_PORT_NUM];
+static const GPIO_Port_table_t *appliedTables[GPIO_TABLE_MAX_APPLIED];
+
 void GPIO_CLK_ctr (GPIO_TypeDef *GPIOxPtr, uint8_t enOrDis)
 {
 	if(enOrDis == ENABLE){
@@ -67,44 +74,7 @@ void GPIO_init (GPIO_Handle_t *GPIOxHandlePtr)
 	if(valueSet <= GPIO_MODE_ANL){		
 		GPIOxHandlePtr->GPIOxPtr->MODER |= valueSet<<(2*bitPos);
 	}else{
-		if (valueSet == GPIO_MODE_INTRPT_FE){
-				EXTI->FTSR |= (1<<bitPos);
-				EXTI->RTSR &= ~(1<<bitPos);
-		}else if (valueSet == GPIO_MODE_INTRPT_RE){
-				EXTI->RTSR |= (1<<bitPos);
-				EXTI->FTSR &= ~(1<<bitPos);
-		}else if (valueSet == GPIO_MODE_INTRPT_RFE){
-				EXTI->RTSR |= 1<<bitPos;
-				EXTI->FTSR |= 1<<bitPos;
-		}
-	
-		/*GPIO port selection in EXTICR*/
-		uint8_t registerNo = GPIOxHandlePtr->GPIO_Pin_config.pinNumber/4;
-		bitPos = GPIOxHandlePtr->GPIO_Pin_config.pinNumber%4;
-		if(GPIOxHandlePtr->GPIOxPtr == GPIOA){
-			valueSet = 0x00;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOB){
-			valueSet = 0x01;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOC){
-			valueSet = 0x02;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOD){
-			valueSet = 0x03;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOE){
-			valueSet = 0x04;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOF){
-			valueSet = 0x05;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOG){
-			valueSet = 0x06;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOH){
-			valueSet = 0x07;
-		}else if(GPIOxHandlePtr->GPIOxPtr == GPIOI){
-			valueSet = 0x08;
-		}
-		RCC->APB2ENR |= (1<<14);
-		SYSCFG->EXTICR[registerNo] &= ~(0x0F<<4*bitPos);
-		SYSCFG->EXTICR[registerNo] |= (valueSet<<4*bitPos);
-	
-		bitPos = GPIOxHandlePtr->GPIO_Pin_config.pinNumber;
+		GPIO_EXTI_line_config(GPIOxHandlePtr->GPIOxPtr,bitPos,valueSet);
 		EXTI->IMR |= 1<<bitPos;
 	}
 	
@@ -195,10 +165,11 @@ uint16_t GPIO_read_port (GPIO_TypeDef *GPIOxPtr)
 
 void GPIO_write_pin (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t setOrClear)
 {
+	/*BSRR write is atomic, no read-modify-write of ODR which an interrupt could corrupt*/
 	if(setOrClear == SET){
-		GPIOxPtr->ODR |= 1<<pinNumber;
+		GPIOxPtr->BSRR = 1UL<<pinNumber;
 	}else{
-		GPIOxPtr->ODR &= ~(1<<pinNumber);
+		GPIOxPtr->BSRR = 1UL<<(pinNumber + 16);
 	}
 }
 
@@ -209,16 +180,129 @@ void GPIO_write_port (GPIO_TypeDef *GPIOxPtr,uint16_t value)
 
 void GPIO_toggle_pin (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber)
 {
-		GPIOxPtr->ODR ^= 1<<pinNumber;
+	GPIO_toggle_pins(GPIOxPtr,1U<<pinNumber);
+}
+
+void GPIO_write_pins (GPIO_TypeDef *GPIOxPtr, uint16_t setMask, uint16_t clearMask)
+{
+	GPIOxPtr->BSRR = ((uint32_t)clearMask<<16) | setMask;
+}
+
+void GPIO_write_masked (GPIO_TypeDef *GPIOxPtr, uint16_t mask, uint16_t value)
+{
+	GPIOxPtr->BSRR = ((uint32_t)(mask & ~value)<<16) | (mask & value);
+}
+
+void GPIO_toggle_pins (GPIO_TypeDef *GPIOxPtr, uint16_t mask)
+{
+	/*only masked pins are written, so an interrupt changing other pins between read and write is not overridden*/
+	uint32_t outputVal = GPIOxPtr->ODR;
+	GPIOxPtr->BSRR = ((outputVal & mask)<<16) | (~outputVal & mask);
+}
+
+void GPIO_EXTI_line_config (GPIO_TypeDef *GPIOxPtr, uint8_t pinNumber, uint8_t edge)
+{
+	if (edge == GPIO_MODE_INTRPT_FE){
+			EXTI->FTSR |= (1<<pinNumber);
+			EXTI->RTSR &= ~(1<<pinNumber);
+	}else if (edge == GPIO_MODE_INTRPT_RE){
+			EXTI->RTSR |= (1<<pinNumber);
+			EXTI->FTSR &= ~(1<<pinNumber);
+	}else if (edge == GPIO_MODE_INTRPT_RFE){
+			EXTI->RTSR |= 1<<pinNumber;
+			EXTI->FTSR |= 1<<pinNumber;
+	}
+
+	/*GPIO port selection in EXTICR, ports are 0x400 bytes apart from GPIOA*/
+	uint8_t registerNo = pinNumber/4;
+	uint8_t bitPos = pinNumber%4;
+	uint8_t portCode = ((uint32_t)GPIOxPtr - (uint32_t)GPIOA)/0x400;
+	RCC->APB2ENR |= (1<<14);
+	SYSCFG->EXTICR[registerNo] &= ~(0x0F<<4*bitPos);
+	SYSCFG->EXTICR[registerNo] |= (portCode<<4*bitPos);
+}
+
+int8_t GPIO_table_apply (const GPIO_Port_table_t *tablePtr, uint8_t portNum, uint16_t *conflictPtr)
+{
+	int8_t index = GPIO_table_find(tablePtr);
+	int8_t freeSlot = -1;
+	uint8_t conflict = 0;
+
+	if(conflictPtr != NULL){
+		for(uint8_t i = 0; i < GPIO_PORT_NUM; i++){
+			conflictPtr[i] = 0;
+		}
+	}
+
+	/*check all ports before writing any, pins of an applied table are claimed by itself*/
+	for(uint8_t i = 0; i < portNum; i++){
+		const GPIO_Port_table_t *portPtr = &tablePtr[i];
+		uint16_t conflictPins = (portPtr->pinSum != portPtr->pinMask) ? portPtr->pinMask : 0;
+		if(index < 0){
+			conflictPins |= claimedPins[portPtr->port] & portPtr->pinMask;
+		}
+		if(conflictPins){
+			conflict = 1;
+			if(conflictPtr != NULL){
+				conflictPtr[portPtr->port] |= conflictPins;
+			}
+		}
+	}
+	if(conflict){
+		return -1;
+	}
+
+	/*a new table need a free slot, otherwise its pins could never be released*/
+	if(index < 0){
+		freeSlot = GPIO_table_find(NULL);
+		if(freeSlot < 0){
+			return -1;
+		}
+	}
+
+	for(uint8_t i = 0; i < portNum; i++){
+		const GPIO_Port_table_t *portPtr = &tablePtr[i];
+		GPIO_TypeDef *GPIOxPtr = (GPIO_TypeDef*)((uint32_t)GPIOA + 0x400*portPtr->port);
+		uint32_t mask2Bits = GPIO_spread_2_bits(portPtr->pinMask);
+
+		RCC->AHB1ENR |= (1<<portPtr->port);
+		/*mode is written last so that pin switch to its function with output and alternate function already set*/
+		GPIOxPtr->OTYPER = (GPIOxPtr->OTYPER & ~portPtr->pinMask) | portPtr->OTYPERVal;
+		GPIOxPtr->OSPEEDR = (GPIOxPtr->OSPEEDR & ~mask2Bits) | portPtr->OSPEEDRVal;
+		GPIOxPtr->PUPDR = (GPIOxPtr->PUPDR & ~mask2Bits) | portPtr->PUPDRVal;
+		if(portPtr->pinMask & 0x00FF){
+			GPIOxPtr->AFR[0] = (GPIOxPtr->AFR[0] & ~GPIO_spread_4_bits(portPtr->pinMask)) | portPtr->AFRVal[0];
+		}
+		if(portPtr->pinMask & 0xFF00){
+			GPIOxPtr->AFR[1] = (GPIOxPtr->AFR[1] & ~GPIO_spread_4_bits(portPtr->pinMask>>8)) | portPtr->AFRVal[1];
+		}
+		GPIOxPtr->MODER = (GPIOxPtr->MODER & ~mask2Bits) | portPtr->MODERVal;
+		claimedPins[portPtr->port] |= portPtr->pinMask;
+	}
+
+	if(index < 0){
+		appliedTables[freeSlot] = tablePtr;
+	}
+	return 0;
+}
+
+void GPIO_table_release (const GPIO_Port_table_t *tablePtr, uint8_t portNum)
+{
+	int8_t index = GPIO_table_find(tablePtr);
+
+	if(index < 0){
+		return;
+	}
+	appliedTables[index] = NULL;
+	for(uint8_t i = 0; i < portNum; i++){
+		claimedPins[tablePtr[i].port] &= ~tablePtr[i].pinMask;
+	}
 }
 
 void GPIO_Intrpt_priority_config (uint8_t IRQnumber, uint8_t IRQpriority)
 {
-	uint8_t registerNo = IRQnumber/4;
-	uint8_t section = IRQnumber%4;
-	
-	*(NVIC_IPR_BASE_ADDR + 4*registerNo) &= ~(0xFF << (8*section));
-	*(NVIC_IPR_BASE_ADDR + 4*registerNo) |= (IRQpriority << (8*section + NUM_OF_IPR_BIT_IMPLEMENTED));
+	/*IP is a byte array indexed by IRQ number, priority is held in upper bits of each byte*/
+	NVIC->IP[IRQnumber] = (uint8_t)(IRQpriority << NUM_OF_IPR_BIT_IMPLEMENTED);
 }
 
 void GPIO_Intrpt_ctrl (uint8_t IRQnumber, uint8_t enOrDis)
@@ -248,8 +332,47 @@ void GPIO_Intrpt_ctrl (uint8_t IRQnumber, uint8_t enOrDis)
 
 void GPIO_Intrpt_handler (uint8_t pinNumber)
 {
+	/*pending bits are cleared by writing 1, other lines must be written 0 so they are not cleared*/
 	if(EXTI->PR & (1<<pinNumber)){
-		EXTI->PR |= (1<<pinNumber);
+		EXTI->PR = (1<<pinNumber);
+	}
+}
+ 
+
+/***********************************************************************
+Private function: spread each bit of mask over 2 bits (MODER, OSPEEDR, PUPDR field mask)
+***********************************************************************/
+static uint32_t GPIO_spread_2_bits (uint16_t mask)
+{
+	uint32_t spread = mask;
+	spread = (spread | (spread<<8)) & 0x00FF00FF;
+	spread = (spread | (spread<<4)) & 0x0F0F0F0F;
+	spread = (spread | (spread<<2)) & 0x33333333;
+	spread = (spread | (spread<<1)) & 0x55555555;
+	return spread*0x03;
+}
+
+/***********************************************************************
+Private function: spread each bit of mask over 4 bits (AFR field mask)
+***********************************************************************/
+static uint32_t GPIO_spread_4_bits (uint8_t mask)
+{
+	uint32_t spread = mask;
+	spread = (spread | (spread<<12)) & 0x000F000F;
+	spread = (spread | (spread<<6)) & 0x03030303;
+	spread = (spread | (spread<<3)) & 0x11111111;
+	return spread*0x0F;
+}
+
+/***********************************************************************
+Private function: find table among applied tables (free slot if NULL)
+***********************************************************************/
+static int8_t GPIO_table_find (const GPIO_Port_table_t *tablePtr)
+{
+	for(uint8_t i = 0; i < GPIO_TABLE_MAX_APPLIED; i++){
+		if(appliedTables[i] == tablePtr){
+			return i;
+		}
 	}
+	return -1;
 }
- 
\ No newline at end of file
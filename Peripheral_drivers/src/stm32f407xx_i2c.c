@@ -10,8 +10,11 @@
 
 #include "../inc/stm32f407xx_i2c.h"
 
-extern uint32_t RCC_get_PCLK_value(uint8_t APBx);
-extern uint32_t RCC_get_PLL_output (void);
+/*SCL settings of each I2C set by I2C_init (speed 0 if not initialized), timing is re-derived from them after clock change*/
+static I2C_TypeDef * const I2CTable[] = {I2C1,I2C2,I2C3};
+static uint32_t I2CSCLspeed[sizeof(I2CTable)/sizeof(I2CTable[0])];
+static uint8_t I2CFMdutyCycle[sizeof(I2CTable)/sizeof(I2CTable[0])];
+static RCC_Clock_hook_t I2CClockHook;
 
 /***********************************************************************
 Private function: generate start/ stop condition 
@@ -87,6 +90,9 @@ static void I2C_close_receive_data(I2C_Handle_t *I2CxHandlePtr)
 {
 	I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CR2_ITBUFEN);
 	I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CR2_ITEVTEN);
+	if(I2CxHandlePtr->State != I2C_READY){
+		PWR_stop_unlock(PWR_LOCK_I2C);
+	}
 	I2CxHandlePtr->rxBufferPtr = NULL;
 	I2CxHandlePtr->rxLength = 0;
 	I2CxHandlePtr->State = I2C_READY;
@@ -101,6 +107,9 @@ static void I2C_close_send_data(I2C_Handle_t *I2CxHandlePtr)
 {
 	I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CR2_ITBUFEN);
 	I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CR2_ITEVTEN);
+	if(I2CxHandlePtr->State != I2C_READY){
+		PWR_stop_unlock(PWR_LOCK_I2C);
+	}
 	I2CxHandlePtr->txBufferPtr = NULL;
 	I2CxHandlePtr->txLength = 0;
 	I2CxHandlePtr->State = I2C_READY;
@@ -108,6 +117,54 @@ static void I2C_close_send_data(I2C_Handle_t *I2CxHandlePtr)
 	I2CxHandlePtr->repeatedStart = DISABLE;
 }
 
+/***********************************************************************
+Private function: program input frequency, SCL clock control and rise time from APB1 clock
+***********************************************************************/
+static void I2C_timing_config(I2C_TypeDef *I2CxPtr, uint32_t SCLspeed, uint8_t FMdutyCycle)
+{
+	uint32_t fPCLK1 = RCC_get_PCLK_value(APB1);
+	uint32_t CCRval = 0;
+	uint16_t tRiseMax = 0;
+	
+	/*set I2C peripheral input frequency*/
+	I2CxPtr->CR2 &= ~(I2C_CR2_FREQ);
+	I2CxPtr->CR2 |=	(fPCLK1/1000000) << I2C_CR2_FREQ_Pos;
+	
+	/*config I2C SCL line speed (standard mode or fast mode). if fast mode, config duty cycle*/
+	if(SCLspeed <= I2C_FSCL_SM){
+		/*slow mode*/
+		CCRval = fPCLK1/(2*I2C_FSCL_SM);
+		tRiseMax = 1000;
+	}else if(FMdutyCycle == I2C_FMduty_2){
+		/*fast mode, t_low:t_high 2:1*/
+		CCRval = I2C_CCR_FS | fPCLK1/(3*I2C_FSCL_FM);
+		tRiseMax = 300;
+	}else{
+		/*fast mode, t_low:t_high 16:9*/
+		CCRval = I2C_CCR_FS | I2C_CCR_DUTY | fPCLK1/(25*I2C_FSCL_FM);
+		tRiseMax = 300;
+	}
+	I2CxPtr->CCR = CCRval;
+	
+	/*config t_rise value*/
+	I2CxPtr->TRISE = (((uint64_t)tRiseMax*fPCLK1)/1000000000 + 1) & 0x3F;
+}
+
+/***********************************************************************
+Private function: re-derive timing of initialized I2Cs after clock change, CCR is only writable while peripheral is disabled
+***********************************************************************/
+static void I2C_clock_change(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr)
+{
+	for(uint8_t i = 0; i < sizeof(I2CTable)/sizeof(I2CTable[0]); i++){
+		if(I2CSCLspeed[i]){
+			uint32_t enabled = I2CTable[i]->CR1 & I2C_CR1_PE;
+			I2CTable[i]->CR1 &= ~I2C_CR1_PE;
+			I2C_timing_config(I2CTable[i],I2CSCLspeed[i],I2CFMdutyCycle[i]);
+			I2CTable[i]->CR1 |= enabled;
+		}
+	}
+}
+
 /***********************************************************************
 Private function: write data to DR register
 ***********************************************************************/
@@ -195,52 +252,19 @@ void I2C_init(I2C_Handle_t *I2CxHandlePtr)
 	/*disable I2Cx peripheral for initilization*/
 	I2C_periph_ctr(I2CxHandlePtr->I2CxPtr,DISABLE);
 	
-	/*set I2C peripheral input frequency*/
-	uint32_t fPCLK1 = RCC_get_PCLK_value(APB1);
-	I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CR2_FREQ);
-	I2CxHandlePtr->I2CxPtr->CR2 |=	(fPCLK1/1000000) << I2C_CR2_FREQ_Pos;
-	
-	/*config I2C SCL line speed (standard mode or fast mode). if fast mode, config duty cycle*/
-	I2CxHandlePtr->I2CxPtr->CCR &= ~(I2C_CCR_FS);
-	I2CxHandlePtr->I2CxPtr->CCR |= I2CxHandlePtr->I2CxConfigPtr->SCLspeed << I2C_CCR_FS_Pos;
-	
-	uint16_t CCRval = 0;
-	
-	if(I2CxHandlePtr->I2CxConfigPtr->SCLspeed <= I2C_FSCL_SM){
-		/*slow mode*/
-		CCRval = fPCLK1/(2*I2C_FSCL_SM);
-	}else if(I2CxHandlePtr->I2CxConfigPtr->SCLspeed > I2C_FSCL_SM && I2CxHandlePtr->I2CxConfigPtr->SCLspeed <= I2C_FSCL_FM){
-		/*fast mode*/		
-		if(I2CxHandlePtr->I2CxConfigPtr->FMdutyCycle == I2C_FMduty_2){
-			/*t_low:t_high 2:1*/
-			I2CxHandlePtr->I2CxPtr->CR2 &= ~(I2C_CCR_DUTY);
-			CCRval = fPCLK1/(3*I2C_FSCL_FM);
-		}else{
-			/*t_low:t_high 2:1 16:9*/
-			I2CxHandlePtr->I2CxPtr->CR2 |= I2C_CCR_DUTY;
-			CCRval = fPCLK1/(25*I2C_FSCL_FM);
+	/*config SCL timing, it is kept across clock changes*/
+	I2C_timing_config(I2CxHandlePtr->I2CxPtr,I2CxHandlePtr->I2CxConfigPtr->SCLspeed,I2CxHandlePtr->I2CxConfigPtr->FMdutyCycle);
+	for(uint8_t i = 0; i < sizeof(I2CTable)/sizeof(I2CTable[0]); i++){
+		if(I2CTable[i] == I2CxHandlePtr->I2CxPtr){
+			I2CSCLspeed[i] = I2CxHandlePtr->I2CxConfigPtr->SCLspeed;
+			I2CFMdutyCycle[i] = I2CxHandlePtr->I2CxConfigPtr->FMdutyCycle;
 		}
 	}
-	 
-	I2CxHandlePtr->I2CxPtr->CCR &= ~(I2C_CCR_CCR);
-	I2CxHandlePtr->I2CxPtr->CCR |= CCRval << I2C_CCR_CCR_Pos;
+	RCC_clock_hook_register(&I2CClockHook,I2C_clock_change,NULL);
 	
 	/*program device own address*/ 
 	I2CxHandlePtr->I2CxPtr->OAR1	&= ~(I2C_OAR1_ADD1_7);
 	I2CxHandlePtr->I2CxPtr->OAR1	|= I2CxHandlePtr->I2CxConfigPtr->deviceAddress <<	I2C_OAR1_ADD1_Pos;
-	
-	/*config t_rise value*/
-	uint8_t regVal = 0;
-	uint16_t tRiseMax = 0;
-	
-	if(I2CxHandlePtr->I2CxConfigPtr->SCLspeed <= I2C_FSCL_SM){
-		tRiseMax = 1000;
-	}else if(I2CxHandlePtr->I2CxConfigPtr->SCLspeed > I2C_FSCL_SM && I2CxHandlePtr->I2CxConfigPtr->SCLspeed <= I2C_FSCL_FM){
-		tRiseMax = 300;
-	}
-	
-	regVal = ((double)tRiseMax/1000000000)*fPCLK1+1;
-	I2CxHandlePtr->I2CxPtr->TRISE = (regVal&0x3F);
 }
 
 /***********************************************************************
@@ -258,6 +282,13 @@ void I2C_deinit(I2C_TypeDef *I2CxPtr)
 		RCC->APB1RSTR |= RCC_APB1RSTR_I2C3RST;
 		RCC->AHB1RSTR &= ~(RCC_APB1RSTR_I2C3RST);
 	}
+	
+	/*reset I2C is no longer re-timed after clock change*/
+	for(uint8_t i = 0; i < sizeof(I2CTable)/sizeof(I2CTable[0]); i++){
+		if(I2CTable[i] == I2CxPtr){
+			I2CSCLspeed[i] = 0;
+		}
+	}
 }
 
 /***********************************************************************
@@ -345,6 +376,7 @@ uint8_t I2C_master_receive_intrpt (I2C_Handle_t *I2CxHandlePtr, uint8_t *rxBuffe
 		I2CxHandlePtr->rxBufferPtr = rxBufferPtr;
 		I2CxHandlePtr->rxLength = Length;
 		I2CxHandlePtr->State = I2C_BUSY_IN_RX;
+		PWR_stop_lock(PWR_LOCK_I2C);
 		I2CxHandlePtr->slaveAddr = slaveAddr;
 		I2CxHandlePtr->repeatedStart = repeatedStart;
 		/*Enable interrupt when ever RXNE flag is set*/
@@ -369,6 +401,7 @@ uint8_t I2C_master_send_intrpt (I2C_Handle_t *I2CxHandlePtr, uint8_t *txBufferPt
 		I2CxHandlePtr->txBufferPtr = txBufferPtr;
 		I2CxHandlePtr->txLength = Length;
 		I2CxHandlePtr->State = I2C_BUSY_IN_TX;
+		PWR_stop_lock(PWR_LOCK_I2C);
 		I2CxHandlePtr->slaveAddr = slaveAddr;
 		I2CxHandlePtr->repeatedStart = repeatedStart;	
 		/*Enable interrupt when TXE flag is set or when error occur*/
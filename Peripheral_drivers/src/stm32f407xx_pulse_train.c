@@ -0,0 +1,254 @@
+/**
+*@file stm32f407xx_pulse_train.c
+*@brief provide DMA driven pulse trains on timer outputs of stm32f407xx MCUs.
+*
+*This source file provide APIs for streaming timer register values from memory into a timer through DMA burst.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_pulse_train.h"
+
+typedef struct{
+	TIM_TypeDef *TIMxPtr;
+	DMA_TypeDef *DMAxPtr;
+	uint8_t streamNo;
+	uint8_t DMAChannel;
+	uint8_t DMAIRQNumber;
+	uint8_t TIMIRQNumber;
+}PULSE_Map_t;
+
+/*DMA stream and channel serving update request of each timer, refer to DMA request mapping in reference manual*/
+static const PULSE_Map_t pulseMap[] = {
+	{TIM1,DMA2,5,6,IRQ_DMA2_STREAM5,IRQ_TIM1_UP_TIM10},
+	{TIM2,DMA1,1,3,IRQ_DMA1_STREAM1,IRQ_TIM2},
+	{TIM3,DMA1,2,5,IRQ_DMA1_STREAM2,IRQ_TIM3},
+	{TIM4,DMA1,6,2,IRQ_DMA1_STREAM6,IRQ_TIM4},
+	{TIM5,DMA1,0,6,IRQ_DMA1_STREAM0,IRQ_TIM5},
+	{TIM8,DMA2,1,7,IRQ_DMA2_STREAM1,IRQ_TIM8_UP_TIM13},
+};
+
+/*each stream has 6 bits of flags, at bit 0, 6, 16, 22 of LISR/LIFCR (stream 0-3) and HISR/HIFCR (stream 4-7)*/
+static const uint8_t flagShift[4] = {0,6,16,22};
+#define PULSE_DMA_FLAG_HT 0x10
+#define PULSE_DMA_FLAG_TC 0x20
+#define PULSE_DMA_FLAG_ALL 0x3D
+
+static void PULSE_load_period(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t period);
+static void PULSE_DMA_start(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t transferNum);
+
+/***********************************************************************
+Initialize DMA burst engine of timer
+***********************************************************************/
+int8_t PULSE_init(PULSE_Handle_t *PULSEHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = PULSEHandlePtr->TIMxPtr;
+	const PULSE_Map_t *mapPtr = NULL;
+
+	for(uint8_t i = 0; i < sizeof(pulseMap)/sizeof(pulseMap[0]); i++){
+		if(pulseMap[i].TIMxPtr == TIMxPtr){
+			mapPtr = &pulseMap[i];
+		}
+	}
+	if(mapPtr == NULL){
+		return -1;
+	}
+	DMA_Stream_TypeDef *streamPtr = DMA_get_stream(mapPtr->DMAxPtr,mapPtr->streamNo);
+	if(DMA_stream_reserve(streamPtr,PULSEHandlePtr) < 0){
+		return -1;
+	}
+	PULSEHandlePtr->DMAxPtr = mapPtr->DMAxPtr;
+	PULSEHandlePtr->streamNo = mapPtr->streamNo;
+	PULSEHandlePtr->DMAChannel = mapPtr->DMAChannel;
+	PULSEHandlePtr->DMAStreamPtr = streamPtr;
+	PULSEHandlePtr->busy = 0;
+
+	RCC->AHB1ENR |= (mapPtr->DMAxPtr == DMA1) ? RCC_AHB1ENR_DMA1EN : RCC_AHB1ENR_DMA2EN;
+
+	/*each update request write regNum registers, reload value is preloaded like compare values*/
+	TIM_DMA_burst_config(TIMxPtr,PULSEHandlePtr->PULSEConfigPtr->baseReg,PULSEHandlePtr->PULSEConfigPtr->regNum);
+	TIMxPtr->CR1 |= TIM_CR1_ARPE;
+
+	DMA_intrpt_priority_config(mapPtr->DMAIRQNumber,PULSE_IRQ_PRIORITY);
+	DMA_intrpt_vector_ctr(mapPtr->DMAIRQNumber,ENABLE);
+	TIM_intrpt_priority_config(mapPtr->TIMIRQNumber,PULSE_IRQ_PRIORITY);
+	TIM_intrpt_vector_ctr(mapPtr->TIMIRQNumber,ENABLE);
+	return 0;
+}
+
+/***********************************************************************
+Start a pulse train
+***********************************************************************/
+int8_t PULSE_start(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t periodNum, uint8_t mode)
+{
+	TIM_TypeDef *TIMxPtr = PULSEHandlePtr->TIMxPtr;
+	uint8_t regNum = PULSEHandlePtr->PULSEConfigPtr->regNum;
+
+	if(PULSEHandlePtr->busy || periodNum == 0 || (uint32_t)periodNum*regNum > 0xFFFF){
+		return -1;
+	}
+
+	TIM_ctr(TIMxPtr,STOP);
+	TIM_DMA_request_ctr(TIMxPtr,TIM_DMA_REQ_UPDATE,DISABLE);
+	TIM_interrupt_ctr(TIMxPtr,DISABLE);
+	PULSEHandlePtr->mode = mode;
+	PULSEHandlePtr->busy = 1;
+	PWR_stop_lock(PWR_LOCK_PULSE);
+
+	if(mode == PULSE_MODE_CIRCULAR){
+		/*whole buffer loop, registers keep current values until DMA preload reach them*/
+		PULSE_DMA_start(PULSEHandlePtr,bufferPtr,periodNum*regNum);
+	}else{
+		/*first period go to active registers by update generation (which request neither DMA nor interrupt since URS is set),
+		second period wait in preload registers, DMA write following periods one update event ahead*/
+		PULSE_load_period(PULSEHandlePtr,bufferPtr,0);
+		TIMxPtr->EGR = TIM_EGR_UG;
+		if(periodNum == 1){
+			PULSEHandlePtr->remainingUpdates = 1;
+		}else{
+			PULSE_load_period(PULSEHandlePtr,bufferPtr,1);
+			PULSEHandlePtr->remainingUpdates = 2;
+		}
+
+		if(periodNum > 2){
+			uint8_t dataBytes = (PULSEHandlePtr->PULSEConfigPtr->dataSize == PULSE_DATA_32_BITS) ? 4 : 2;
+			PULSE_DMA_start(PULSEHandlePtr,(const uint8_t*)bufferPtr + 2*regNum*dataBytes,(periodNum - 2)*regNum);
+		}else{
+			/*no DMA needed, count update events right away*/
+			TIMxPtr->SR = ~TIM_SR_UIF;
+			TIM_interrupt_ctr(TIMxPtr,ENABLE);
+		}
+	}
+
+	TIM_ctr(TIMxPtr,START);
+	return 0;
+}
+
+/***********************************************************************
+Stop pulse train immediately
+***********************************************************************/
+void PULSE_stop(PULSE_Handle_t *PULSEHandlePtr)
+{
+	TIM_ctr(PULSEHandlePtr->TIMxPtr,STOP);
+	TIM_DMA_request_ctr(PULSEHandlePtr->TIMxPtr,TIM_DMA_REQ_UPDATE,DISABLE);
+	TIM_interrupt_ctr(PULSEHandlePtr->TIMxPtr,DISABLE);
+	PULSEHandlePtr->DMAStreamPtr->CR &= ~DMA_SxCR_EN;
+	if(PULSEHandlePtr->busy){
+		PWR_stop_unlock(PWR_LOCK_PULSE);
+	}
+	PULSEHandlePtr->busy = 0;
+}
+
+/***********************************************************************
+Check whether a pulse train is playing
+***********************************************************************/
+uint8_t PULSE_is_busy(PULSE_Handle_t *PULSEHandlePtr)
+{
+	return PULSEHandlePtr->busy;
+}
+
+/***********************************************************************
+DMA stream interrupt handler
+***********************************************************************/
+void PULSE_DMA_intrpt_handler(PULSE_Handle_t *PULSEHandlePtr)
+{
+	uint8_t streamNo = PULSEHandlePtr->streamNo;
+	volatile uint32_t *ISRPtr = (streamNo < 4) ? &PULSEHandlePtr->DMAxPtr->LISR : &PULSEHandlePtr->DMAxPtr->HISR;
+	volatile uint32_t *IFCRPtr = (streamNo < 4) ? &PULSEHandlePtr->DMAxPtr->LIFCR : &PULSEHandlePtr->DMAxPtr->HIFCR;
+	uint32_t status = *ISRPtr >> flagShift[streamNo % 4];
+
+	if(status & PULSE_DMA_FLAG_HT){
+		*IFCRPtr = PULSE_DMA_FLAG_HT << flagShift[streamNo % 4];
+		PULSE_application_event_callback(PULSEHandlePtr,PULSE_EV_HALF_CMPLT);
+	}
+	if(status & PULSE_DMA_FLAG_TC){
+		*IFCRPtr = PULSE_DMA_FLAG_TC << flagShift[streamNo % 4];
+		if(PULSEHandlePtr->mode == PULSE_MODE_CIRCULAR){
+			PULSE_application_event_callback(PULSEHandlePtr,PULSE_EV_CMPLT);
+		}else{
+			/*last period is in preload registers: it become active at next update event and end at the one after*/
+			TIM_DMA_request_ctr(PULSEHandlePtr->TIMxPtr,TIM_DMA_REQ_UPDATE,DISABLE);
+			PULSEHandlePtr->TIMxPtr->SR = ~TIM_SR_UIF;
+			TIM_interrupt_ctr(PULSEHandlePtr->TIMxPtr,ENABLE);
+		}
+	}
+}
+
+/***********************************************************************
+Timer update interrupt handler
+***********************************************************************/
+void PULSE_TIM_intrpt_handler(PULSE_Handle_t *PULSEHandlePtr)
+{
+	TIM_TypeDef *TIMxPtr = PULSEHandlePtr->TIMxPtr;
+
+	if((TIMxPtr->DIER & TIM_DIER_UIE) && (TIMxPtr->SR & TIM_SR_UIF)){
+		TIMxPtr->SR = ~TIM_SR_UIF;
+		PULSEHandlePtr->remainingUpdates--;
+		if(!PULSEHandlePtr->remainingUpdates){
+			TIM_ctr(TIMxPtr,STOP);
+			TIM_interrupt_ctr(TIMxPtr,DISABLE);
+			PULSEHandlePtr->busy = 0;
+			PWR_stop_unlock(PWR_LOCK_PULSE);
+			PULSE_application_event_callback(PULSEHandlePtr,PULSE_EV_DONE);
+		}
+	}
+}
+
+/***********************************************************************
+Inform application of pulse train event
+@Note: this is to be define in user application
+***********************************************************************/
+__attribute__((weak)) void PULSE_application_event_callback(PULSE_Handle_t *PULSEHandlePtr, uint8_t event)
+{
+}
+
+/***********************************************************************
+Private function: write values of one period into timer registers
+***********************************************************************/
+static void PULSE_load_period(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t period)
+{
+	PULSE_Config_t *configPtr = PULSEHandlePtr->PULSEConfigPtr;
+	/*timer registers are 32 bits wide, baseReg is word offset from CR1 as in DCR*/
+	volatile uint32_t *regPtr = &PULSEHandlePtr->TIMxPtr->CR1 + configPtr->baseReg;
+	uint32_t index = (uint32_t)period*configPtr->regNum;
+
+	for(uint8_t i = 0; i < configPtr->regNum; i++){
+		if(configPtr->dataSize == PULSE_DATA_32_BITS){
+			regPtr[i] = ((const uint32_t*)bufferPtr)[index + i];
+		}else{
+			regPtr[i] = ((const uint16_t*)bufferPtr)[index + i];
+		}
+	}
+}
+
+/***********************************************************************
+Private function: start DMA from memory to timer DMAR on update request
+***********************************************************************/
+static void PULSE_DMA_start(PULSE_Handle_t *PULSEHandlePtr, const void *bufferPtr, uint16_t transferNum)
+{
+	DMA_Stream_TypeDef *streamPtr = PULSEHandlePtr->DMAStreamPtr;
+	uint8_t streamNo = PULSEHandlePtr->streamNo;
+	volatile uint32_t *IFCRPtr = (streamNo < 4) ? &PULSEHandlePtr->DMAxPtr->LIFCR : &PULSEHandlePtr->DMAxPtr->HIFCR;
+	uint8_t dataSize = PULSEHandlePtr->PULSEConfigPtr->dataSize;
+
+	streamPtr->CR &= ~DMA_SxCR_EN;
+	while(streamPtr->CR & DMA_SxCR_EN);
+	*IFCRPtr = PULSE_DMA_FLAG_ALL << flagShift[streamNo % 4];
+
+	streamPtr->PAR = (uint32_t)&PULSEHandlePtr->TIMxPtr->DMAR;
+	streamPtr->M0AR = (uint32_t)bufferPtr;
+	streamPtr->NDTR = transferNum;
+	streamPtr->FCR = 0;
+
+	/*memory to peripheral, direct mode (same size on both sides), very high priority since a late transfer corrupt a period*/
+	uint32_t CRVal = (PULSEHandlePtr->DMAChannel << DMA_SxCR_CHSEL_Pos) | (dataSize << DMA_SxCR_MSIZE_Pos) | (dataSize << DMA_SxCR_PSIZE_Pos)
+									| DMA_SxCR_MINC | (0x01 << DMA_SxCR_DIR_Pos) | (0x03 << DMA_SxCR_PL_Pos) | DMA_SxCR_TCIE;
+	if(PULSEHandlePtr->mode == PULSE_MODE_CIRCULAR){
+		CRVal |= DMA_SxCR_CIRC | DMA_SxCR_HTIE;
+	}
+	streamPtr->CR = CRVal;
+
+	streamPtr->CR |= DMA_SxCR_EN;
+	TIM_DMA_request_ctr(PULSEHandlePtr->TIMxPtr,TIM_DMA_REQ_UPDATE,ENABLE);
+}
@@ -0,0 +1,149 @@
+/**
+*@file stm32f407xx_pwr.c
+*@brief provide low power idle management on stm32f407xx MCUs.
+*
+*This source file provide APIs for putting the core to sleep between interrupts and into stop mode when the system is quiescent.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_pwr.h"
+
+static void PWR_enter_sleep (void);
+static void PWR_enter_stop (void);
+
+static PWR_Config_t PWRConfig = {.stopMode = DISABLE,.lowPowerRegulator = DISABLE,.flashPowerDown = DISABLE};
+static volatile uint16_t lockCount[PWR_LOCK_NUM];
+static volatile uint16_t lockMask = 0;	/*bit n set while lockCount[n] is not 0*/
+
+/***********************************************************************
+Configure power manager
+***********************************************************************/
+void PWR_init(const PWR_Config_t *PWRConfigPtr)
+{
+	PWRConfig = *PWRConfigPtr;
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+}
+
+/***********************************************************************
+Take a stop lock
+***********************************************************************/
+void PWR_stop_lock(uint8_t source)
+{
+	if(source >= PWR_LOCK_NUM){
+		return;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	lockCount[source]++;
+	lockMask |= 1<<source;
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Release a stop lock
+***********************************************************************/
+void PWR_stop_unlock(uint8_t source)
+{
+	if(source >= PWR_LOCK_NUM){
+		return;
+	}
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if(lockCount[source] && !--lockCount[source]){
+		lockMask &= ~(1<<source);
+	}
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Get sources holding a stop lock
+***********************************************************************/
+uint16_t PWR_get_stop_locks(void)
+{
+	return lockMask;
+}
+
+/***********************************************************************
+Sleep until next interrupt
+***********************************************************************/
+void PWR_sleep(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	PWR_enter_sleep();
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Enter lowest allowed low power mode
+***********************************************************************/
+uint8_t PWR_idle(void)
+{
+	uint8_t mode;
+	uint32_t primask = __get_PRIMASK();
+
+	/*locks are checked with interrupts masked, a pending interrupt still end WFI and is handled once PRIMASK is restored*/
+	__disable_irq();
+	if(PWRConfig.stopMode == ENABLE && !lockMask){
+		PWR_enter_stop();
+		mode = PWR_MODE_STOP;
+	}else{
+		PWR_enter_sleep();
+		mode = PWR_MODE_SLEEP;
+	}
+	__set_PRIMASK(primask);
+
+	return mode;
+}
+
+/***********************************************************************
+Inform application of power manager event
+@Note: this is to be define in user application
+***********************************************************************/
+__attribute__((weak)) void PWR_application_event_callback(uint8_t event)
+{
+}
+
+/***********************************************************************
+Private function: sleep mode, to be called with interrupts masked
+***********************************************************************/
+static void PWR_enter_sleep (void)
+{
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+	TIME_sleep_enter();
+	__DSB();
+	__WFI();
+	TIME_sleep_exit();
+}
+
+/***********************************************************************
+Private function: stop mode, to be called with interrupts masked
+@note core wake up running from HSI, system clock is restored before interrupts are unmasked
+***********************************************************************/
+static void PWR_enter_stop (void)
+{
+	PWR_application_event_callback(PWR_EV_STOP_ENTER);
+
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+	PWR->CR &= ~(PWR_CR_PDDS | PWR_CR_LPDS | PWR_CR_FPDS);
+	if(PWRConfig.lowPowerRegulator == ENABLE){
+		PWR->CR |= PWR_CR_LPDS;
+	}
+	if(PWRConfig.flashPowerDown == ENABLE){
+		PWR->CR |= PWR_CR_FPDS;
+	}
+
+	SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+	__DSB();
+	__WFI();
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+	/*clock not set by configurator can not be restored, drivers are then re-timed to HSI*/
+	if(RCC_clock_restore() == -1){
+		RCC_clock_update();
+	}
+
+	PWR_application_event_callback(PWR_EV_STOP_EXIT);
+}
@@ -9,15 +9,47 @@
 */
 
 #include "../inc/stm32f407xx_rcc.h"
+#include "../inc/stm32f407xx_time.h"
 
 void	RCC_HSI_clock_ctrl (uint8_t enOrDis);
 void	RCC_HSE_clock_ctrl (uint8_t enOrDis);
 void	RCC_PLL_clock_ctrl (uint8_t enOrDis);
-void PWR_set_scale_mode (void);
-void FLASH_set_latency (void);
-void RCC_set_PLL_84_MHz (void);
+void PWR_set_scale_mode (uint8_t scale1);
+void FLASH_set_latency (uint8_t latency);
+void FLASH_accelerator_update (uint8_t forceReset);
 int32_t RCC_get_PLL_output (void);
-void RCC_delay( volatile uint32_t delay);
+void RCC_delay( uint32_t delayUs);
+static void RCC_switch_SYSCLK (uint8_t source);
+static void RCC_read_clock_freq (RCC_Clock_freq_t *clockFreqPtr);
+static uint8_t RCC_bus_prescaler (uint32_t inputFreq, uint32_t maxFreq, const uint16_t *divArray, uint8_t divNum);
+
+/*division factors selectable by CFGR HPRE (field value 8 + index) and PPREx (field value 4 + index), index 0 is no division*/
+static const uint16_t AHBDivTable[] = {1,2,4,8,16,64,128,256,512};
+static const uint16_t APBDivTable[] = {1,2,4,8,16};
+
+static RCC_Clock_freq_t clockFreq;	/*clock tree snapshot, valid once read*/
+static uint8_t clockFreqValid = 0;
+static RCC_Clock_hook_t *clockHookListPtr = NULL;
+
+/*high and medium levels share PLL configuration, so switching between them only change prescalers*/
+static const RCC_Clock_config_t perfLevelDefault[RCC_PERF_LEVEL_NUM] = {
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 168000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 168000000,.HCLKFreq = 84000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSI,.SYSCLKFreq = 16000000,.PLL48Clock = DISABLE},
+};
+static RCC_Clock_setting_t perfLevelSetting[RCC_PERF_LEVEL_NUM];
+static uint8_t perfLevelSolved = 0;	/*bit n set once setting of level n is solved*/
+static uint8_t perfLevel = RCC_PERF_LEVEL_NONE;
+static RCC_Clock_setting_t appliedSetting;	/*last setting applied, restored after stop mode*/
+static uint8_t appliedSettingValid = 0;
+static uint32_t HSEFreq = RCC_HSE_FREQ;	/*actual HSE frequency, nominal until corrected*/
+
+static FLASH_Config_t flashConfig = {.VDDRange = FLASH_VDD_2V7_3V6,.prefetch = ENABLE,.instructionCache = ENABLE,.dataCache = ENABLE};
+/*HCLK range of each flash wait state, indexed by @FLASH_VDD_RANGE*/
+static const uint32_t flashWSFreq[] = {30000000,24000000,22000000,20000000};
+
+#define FLASH_ACR_ACCELERATOR (FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN)
+#define RCC_PLLCFGR_FIELDS (RCC_PLLCFGR_PLLSRC | RCC_PLLCFGR_PLLM | RCC_PLLCFGR_PLLN | RCC_PLLCFGR_PLLP | RCC_PLLCFGR_PLLQ)
 
 /***********************************************************************
 Configure MCO2 for clock measurement
@@ -69,6 +101,11 @@ void RCC_set_SYSCLK_HSE (void)
 	
 	/*turn of HSI*/
 	RCC_HSI_clock_ctrl (DISABLE);
+	
+	FLASH_accelerator_update(0);
+	appliedSettingValid = 0;
+	perfLevel = RCC_PERF_LEVEL_NONE;
+	RCC_clock_update();
 }
 
 /***********************************************************************
@@ -76,31 +113,316 @@ Set system clock as PLL 84 MHz
 ***********************************************************************/
 void RCC_set_SYSCLK_PLL_84_MHz (void)
 {	
-	/*set voltage scale mode to mode 1*/
-	PWR_set_scale_mode ();
-	
-	/*set flash latency to 2 wait state*/
-	FLASH_set_latency();
-	
-	/*set AHB division factor as 1, APB2 division factor as 1, APB1 division factor as 2 so that AHB clock is 84Mhz, APB1 clock is 42Mhz, APB2  clock is 84 Mhz*/
-	RCC->CFGR &= ~(RCC_CFGR_HPRE);
-	
-	RCC->CFGR &= ~(RCC_CFGR_PPRE2);
-	
-	RCC->CFGR &= ~(RCC_CFGR_PPRE1);
-	RCC->CFGR |= RCC_APB_DIV2 << RCC_CFGR_PPRE1_Pos;
-	
-	/*set PLL as 84 Mhz*/
-	RCC_set_PLL_84_MHz();
-		
-	/*select PLL as system clock*/
-	RCC->CFGR &= ~(RCC_CFGR_SW);
-	RCC->CFGR |= RCC_SYSCLK_PLL << RCC_CFGR_SW_Pos;
-	
-	while (((RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos) != RCC_SYSCLK_PLL);
-	
-	/*turn of HSI*/
-	RCC_HSI_clock_ctrl (DISABLE);
+	/*AHB clock is 84Mhz, APB1 clock is 42Mhz, APB2  clock is 84 Mhz, 48 MHz for RNG*/
+	RCC_Clock_config_t clockConfig = {.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 84000000,.PLL48Clock = ENABLE};
+	RCC_clock_config(&clockConfig);
+}
+
+/***********************************************************************
+Set system clock as PLL 168 MHz
+***********************************************************************/
+void RCC_set_SYSCLK_PLL_168_MHz (void)
+{
+	RCC_Clock_config_t clockConfig = {.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 168000000,.PLL48Clock = ENABLE};
+	RCC_clock_config(&clockConfig);
+}
+
+/***********************************************************************
+Search PLL factors and bus prescalers for a clock tree requirement
+***********************************************************************/
+int8_t RCC_clock_solve (const RCC_Clock_config_t *clockConfigPtr, RCC_Clock_setting_t *settingPtr)
+{
+	uint32_t oscFreq = (clockConfigPtr->oscillator == RCC_OSC_HSE) ? RCC_HSE_FREQ : RCC_HSI_FREQ;
+	uint32_t target = clockConfigPtr->SYSCLKFreq;
+	uint32_t bestError = 0xFFFFFFFF;
+	int8_t exact = 0;
+
+	if(target == 0 || target > RCC_SYSCLK_MAX){
+		return -1;
+	}
+	settingPtr->oscillator = clockConfigPtr->oscillator;
+	settingPtr->PLLM = 0;
+	settingPtr->PLLN = 0;
+	settingPtr->PLLP = 0;
+	settingPtr->PLLQ = 0;
+	settingPtr->PLL48Freq = 0;
+
+	if(target == oscFreq && clockConfigPtr->PLL48Clock != ENABLE){
+		/*oscillator drive system clock directly*/
+		settingPtr->SYSCLKSource = (clockConfigPtr->oscillator == RCC_OSC_HSE) ? RCC_SYSCLK_HSE : RCC_SYSCLK_HSI;
+		settingPtr->SYSCLKFreq = oscFreq;
+		exact = 1;
+	}else{
+		settingPtr->SYSCLKSource = RCC_SYSCLK_PLL;
+		settingPtr->SYSCLKFreq = 0;
+		/*lowest PLLM first: highest VCO input (lowest jitter) is kept among equally good solutions*/
+		for(uint8_t M = 2; M <= 63; M++){
+			if(oscFreq/M > RCC_VCO_INPUT_MAX){
+				continue;
+			}
+			if(oscFreq/M < RCC_VCO_INPUT_MIN){
+				break;
+			}
+			for(uint8_t P = 2; P <= 8; P += 2){
+				/*nearest PLLN for this PLLM, PLLP*/
+				uint32_t N = ((uint64_t)target*M*P + oscFreq/2)/oscFreq;
+				if(N < 50 || N > 432){
+					continue;
+				}
+				uint64_t VCOFreq = (uint64_t)oscFreq*N/M;
+				if(VCOFreq < RCC_VCO_OUTPUT_MIN || VCOFreq > RCC_VCO_OUTPUT_MAX){
+					continue;
+				}
+				uint32_t SYSCLKFreq = VCOFreq/P;
+				if(SYSCLKFreq > RCC_SYSCLK_MAX){
+					continue;
+				}
+
+				/*PLL48CLK must not exceed 48 MHz, it must be exact when required*/
+				uint8_t Q = (VCOFreq + RCC_PLL48_FREQ - 1)/RCC_PLL48_FREQ;
+				if(Q < 2){
+					Q = 2;
+				}
+				if(Q > 15){
+					continue;
+				}
+				if(clockConfigPtr->PLL48Clock == ENABLE && (uint64_t)oscFreq*N != (uint64_t)RCC_PLL48_FREQ*Q*M){
+					continue;
+				}
+
+				uint32_t error = (SYSCLKFreq > target) ? SYSCLKFreq - target : target - SYSCLKFreq;
+				if(error < bestError){
+					bestError = error;
+					settingPtr->PLLM = M;
+					settingPtr->PLLN = N;
+					settingPtr->PLLP = P;
+					settingPtr->PLLQ = Q;
+					settingPtr->SYSCLKFreq = SYSCLKFreq;
+					settingPtr->PLL48Freq = VCOFreq/Q;
+				}
+			}
+		}
+		if(settingPtr->SYSCLKFreq == 0){
+			return -1;
+		}
+		exact = (bestError == 0);
+	}
+
+	/*smallest prescaler keeping each bus below its limit*/
+	uint32_t HCLKMax = clockConfigPtr->HCLKFreq ? clockConfigPtr->HCLKFreq : settingPtr->SYSCLKFreq;
+	uint32_t PCLK1Max = (clockConfigPtr->PCLK1Freq && clockConfigPtr->PCLK1Freq < RCC_PCLK1_MAX) ? clockConfigPtr->PCLK1Freq : RCC_PCLK1_MAX;
+	uint32_t PCLK2Max = (clockConfigPtr->PCLK2Freq && clockConfigPtr->PCLK2Freq < RCC_PCLK2_MAX) ? clockConfigPtr->PCLK2Freq : RCC_PCLK2_MAX;
+	uint8_t index;
+
+	index = RCC_bus_prescaler(settingPtr->SYSCLKFreq,HCLKMax,AHBDivTable,sizeof(AHBDivTable)/sizeof(AHBDivTable[0]));
+	settingPtr->HPRE = index ? 7 + index : 0;
+	settingPtr->HCLKFreq = settingPtr->SYSCLKFreq/AHBDivTable[index];
+
+	index = RCC_bus_prescaler(settingPtr->HCLKFreq,PCLK1Max,APBDivTable,sizeof(APBDivTable)/sizeof(APBDivTable[0]));
+	settingPtr->PPRE1 = index ? 3 + index : 0;
+	settingPtr->PCLK1Freq = settingPtr->HCLKFreq/APBDivTable[index];
+
+	index = RCC_bus_prescaler(settingPtr->HCLKFreq,PCLK2Max,APBDivTable,sizeof(APBDivTable)/sizeof(APBDivTable[0]));
+	settingPtr->PPRE2 = index ? 3 + index : 0;
+	settingPtr->PCLK2Freq = settingPtr->HCLKFreq/APBDivTable[index];
+
+	/*flash is read at HCLK, wait states depend on supply voltage range*/
+	int8_t latency = FLASH_get_latency(settingPtr->HCLKFreq);
+	settingPtr->flashLatency = (latency == -1) ? FLASH_LATENCY_MAX : latency;
+	settingPtr->scale1 = (settingPtr->HCLKFreq > RCC_SCALE2_HCLK_MAX) ? 1 : 0;
+
+	return (exact && latency != -1) ? 0 : -1;
+}
+
+/***********************************************************************
+Apply a clock setting
+***********************************************************************/
+void RCC_clock_apply (const RCC_Clock_setting_t *settingPtr)
+{
+	uint8_t currentLatency = (FLASH->ACR & FLASH_ACR_LATENCY) >> FLASH_ACR_LATENCY_Pos;
+	uint8_t currentSource = (RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos;
+	uint32_t PLLCFGRVal = ((settingPtr->oscillator == RCC_OSC_HSE) ? RCC_PLLCFGR_PLLSRC : 0) | (settingPtr->PLLM << RCC_PLLCFGR_PLLM_Pos)
+												| (settingPtr->PLLN << RCC_PLLCFGR_PLLN_Pos) | (((settingPtr->PLLP >> 1) - 1) << RCC_PLLCFGR_PLLP_Pos)
+												| (settingPtr->PLLQ << RCC_PLLCFGR_PLLQ_Pos);
+
+	/*system clock source (and PLL factors) unchanged: only prescalers change and PLL keep running,
+	regulator is never lowered to scale 2 on this path, so it is only taken if scale 1 is not newly needed*/
+	uint8_t prescalerOnly = (currentSource == settingPtr->SYSCLKSource)
+													&& (currentSource != RCC_SYSCLK_PLL || (RCC->PLLCFGR & RCC_PLLCFGR_FIELDS) == PLLCFGRVal)
+													&& (!settingPtr->scale1 || (PWR->CR & PWR_CR_VOS));
+
+	/*enough wait states for both old and new clock*/
+	if(settingPtr->flashLatency > currentLatency){
+		FLASH_set_latency(settingPtr->flashLatency);
+	}
+
+	if(prescalerOnly){
+		/*all prescalers change in one write, so bus limits hold before and after it*/
+		RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)) | (settingPtr->HPRE << RCC_CFGR_HPRE_Pos)
+								| (settingPtr->PPRE1 << RCC_CFGR_PPRE1_Pos) | (settingPtr->PPRE2 << RCC_CFGR_PPRE2_Pos);
+	}else{
+		/*run from HSI (16 MHz, safe for any prescaler and wait states) while clock tree is reprogrammed*/
+		RCC_HSI_clock_ctrl(ENABLE);
+		RCC_switch_SYSCLK(RCC_SYSCLK_HSI);
+		RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2)) | (settingPtr->HPRE << RCC_CFGR_HPRE_Pos)
+								| (settingPtr->PPRE1 << RCC_CFGR_PPRE1_Pos) | (settingPtr->PPRE2 << RCC_CFGR_PPRE2_Pos);
+
+		RCC_PLL_clock_ctrl(DISABLE);
+		while(RCC->CR & RCC_CR_PLLRDY);
+		if(settingPtr->oscillator == RCC_OSC_HSE){
+			RCC_HSE_clock_ctrl(ENABLE);
+		}
+		PWR_set_scale_mode(settingPtr->scale1);
+
+		if(settingPtr->SYSCLKSource == RCC_SYSCLK_PLL){
+			/*reserved bits keep their reset value*/
+			RCC->PLLCFGR = (RCC->PLLCFGR & ~RCC_PLLCFGR_FIELDS) | PLLCFGRVal;
+			RCC_PLL_clock_ctrl(ENABLE);
+			/*regulator output is ready once PLL is locked*/
+			if(settingPtr->scale1){
+				while(!(PWR->CSR & PWR_CSR_VOSRDY));
+			}
+		}
+		RCC_switch_SYSCLK(settingPtr->SYSCLKSource);
+	}
+
+	if(settingPtr->flashLatency < currentLatency){
+		FLASH_set_latency(settingPtr->flashLatency);
+	}
+
+	/*turn off unused oscillators*/
+	if(settingPtr->SYSCLKSource != RCC_SYSCLK_PLL){
+		RCC_PLL_clock_ctrl(DISABLE);
+	}
+	if(settingPtr->oscillator != RCC_OSC_HSE){
+		RCC_HSE_clock_ctrl(DISABLE);
+	}
+	if(settingPtr->SYSCLKSource != RCC_SYSCLK_HSI && settingPtr->oscillator != RCC_OSC_HSI){
+		RCC_HSI_clock_ctrl(DISABLE);
+	}
+
+	FLASH_accelerator_update(0);
+	appliedSetting = *settingPtr;
+	appliedSettingValid = 1;
+	perfLevel = RCC_PERF_LEVEL_NONE;
+	RCC_clock_update();
+}
+
+/***********************************************************************
+Solve and apply a clock tree requirement
+***********************************************************************/
+int8_t RCC_clock_config (const RCC_Clock_config_t *clockConfigPtr)
+{
+	RCC_Clock_setting_t setting;
+
+	if(RCC_clock_solve(clockConfigPtr,&setting) == -1){
+		return -1;
+	}
+	RCC_clock_apply(&setting);
+	return 0;
+}
+
+/***********************************************************************
+Set clock requirement of a performance level
+***********************************************************************/
+int8_t RCC_perf_level_config (uint8_t level, const RCC_Clock_config_t *clockConfigPtr)
+{
+	RCC_Clock_setting_t setting;
+
+	if(level >= RCC_PERF_LEVEL_NUM || RCC_clock_solve(clockConfigPtr,&setting) == -1){
+		return -1;
+	}
+	perfLevelSetting[level] = setting;
+	perfLevelSolved |= 1<<level;
+	return 0;
+}
+
+/***********************************************************************
+Switch to a performance level
+***********************************************************************/
+int8_t RCC_set_perf_level (uint8_t level)
+{
+	if(level >= RCC_PERF_LEVEL_NUM){
+		return -1;
+	}
+	if(level == perfLevel){
+		return 0;
+	}
+	/*default requirement is solved once, on first use of level*/
+	if(!(perfLevelSolved & (1<<level)) && RCC_perf_level_config(level,&perfLevelDefault[level]) == -1){
+		return -1;
+	}
+
+	RCC_clock_apply(&perfLevelSetting[level]);
+	perfLevel = level;
+	return 0;
+}
+
+/***********************************************************************
+Get current performance level
+***********************************************************************/
+uint8_t RCC_get_perf_level (void)
+{
+	return perfLevel;
+}
+
+/***********************************************************************
+Re-apply last clock setting
+***********************************************************************/
+int8_t RCC_clock_restore (void)
+{
+	uint8_t level = perfLevel;
+
+	if(!appliedSettingValid){
+		return -1;
+	}
+	RCC_clock_apply(&appliedSetting);
+	perfLevel = level;
+	return 0;
+}
+
+/***********************************************************************
+Set actual HSE frequency
+***********************************************************************/
+void RCC_set_HSE_freq (uint32_t freq)
+{
+	HSEFreq = freq;
+	RCC_clock_update();
+}
+
+/***********************************************************************
+Get HSE frequency used for clock computation
+***********************************************************************/
+uint32_t RCC_get_HSE_freq (void)
+{
+	return HSEFreq;
+}
+
+/***********************************************************************
+Configure flash interface
+***********************************************************************/
+void FLASH_config (const FLASH_Config_t *FLASHConfigPtr)
+{
+	flashConfig = *FLASHConfigPtr;
+	FLASH_accelerator_update(0);
+}
+
+/***********************************************************************
+Get flash wait states needed at an AHB clock
+***********************************************************************/
+int8_t FLASH_get_latency (uint32_t HCLKFreq)
+{
+	uint32_t latency = (HCLKFreq - 1)/flashWSFreq[flashConfig.VDDRange];
+
+	return (latency > FLASH_LATENCY_MAX) ? -1 : (int8_t)latency;
+}
+
+/***********************************************************************
+Reset ART accelerator caches
+***********************************************************************/
+void FLASH_cache_reset (void)
+{
+	FLASH_accelerator_update(1);
 }
 
 /***********************************************************************
@@ -108,18 +430,15 @@ Get system clock value
 ***********************************************************************/
 int32_t RCC_get_SYSCLK_value (void)
 {
-	int32_t sysClockVal = 0;
-	uint8_t sysClockStatus =	(RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos;
-	
-	if(sysClockStatus == 0){
-		sysClockVal = 16000000;
-	}else if(sysClockStatus == 1){
-		sysClockVal = 8000000;
-	}else if(sysClockStatus == 2){
-		sysClockVal = RCC_get_PLL_output();
-	}	
-	
-	return sysClockVal;
+	return RCC_get_clock_freq()->SYSCLK;
+}
+
+/***********************************************************************
+Get AHB bus clock value  
+***********************************************************************/
+int32_t RCC_get_HCLK_value (void)
+{
+	return RCC_get_clock_freq()->HCLK;
 }
 
 /***********************************************************************
@@ -127,41 +446,112 @@ Get APB bus clock value
 ***********************************************************************/
 int32_t RCC_get_PCLK_value(uint8_t APBx)
 {
-	int32_t sysClock = 0, PCLK = 0;
-	uint8_t AHBdiv = 0, APBdiv = 0;
-	uint16_t AHBdivArray[] = {2,4,8,16,64,128,256,512};
-	uint8_t APBdivArray[]	=	{2,4,8,16};
-	uint8_t AHBdivStatus = (RCC->CFGR >> RCC_CFGR_HPRE_Pos)	& 0x0F;
-	uint8_t APBdivStatus;
-	if(APBx == APB1){
-		APBdivStatus = (RCC->CFGR >> RCC_CFGR_PPRE1_Pos)	& 0x07;
-	}else{
-		APBdivStatus = (RCC->CFGR >> RCC_CFGR_PPRE2_Pos)	& 0x07;
+	return (APBx == APB1) ? RCC_get_clock_freq()->PCLK1 : RCC_get_clock_freq()->PCLK2;
+}
+
+/***********************************************************************
+Get clock value of timers connected to APB bus
+***********************************************************************/
+int32_t RCC_get_TIMCLK_value(uint8_t APBx)
+{
+	return (APBx == APB1) ? RCC_get_clock_freq()->TIMCLK1 : RCC_get_clock_freq()->TIMCLK2;
+}
+
+/***********************************************************************
+Get clock tree snapshot
+***********************************************************************/
+const RCC_Clock_freq_t* RCC_get_clock_freq (void)
+{
+	if(!clockFreqValid){
+		RCC_read_clock_freq(&clockFreq);
+		clockFreqValid = 1;
 	}
-		
-	sysClock = RCC_get_SYSCLK_value();
-	
-	if(sysClock == -1){
-		return -1;
+	return &clockFreq;
+}
+
+/***********************************************************************
+Refresh clock tree snapshot and notify registered hooks
+***********************************************************************/
+void RCC_clock_update (void)
+{
+	RCC_read_clock_freq(&clockFreq);
+	clockFreqValid = 1;
+
+	for(RCC_Clock_hook_t *hookPtr = clockHookListPtr; hookPtr != NULL; hookPtr = hookPtr->nextPtr){
+		hookPtr->callback(&clockFreq,hookPtr->argPtr);
 	}
+}
+
+/***********************************************************************
+Register a clock change hook
+***********************************************************************/
+void RCC_clock_hook_register (RCC_Clock_hook_t *hookPtr, RCC_Clock_callback_t callback, void *argPtr)
+{
+	RCC_Clock_hook_t **linkPtr = &clockHookListPtr;
+
+	/*hooks are called in registration order, a hook already in list is not added twice*/
+	while(*linkPtr != NULL){
+		if(*linkPtr == hookPtr){
+			return;
+		}
+		linkPtr = &(*linkPtr)->nextPtr;
+	}
+	hookPtr->callback = callback;
+	hookPtr->argPtr = argPtr;
+	hookPtr->nextPtr = NULL;
+	*linkPtr = hookPtr;
+}
+
+/***********************************************************************
+Unregister a clock change hook
+***********************************************************************/
+void RCC_clock_hook_unregister (RCC_Clock_hook_t *hookPtr)
+{
+	for(RCC_Clock_hook_t **linkPtr = &clockHookListPtr; *linkPtr != NULL; linkPtr = &(*linkPtr)->nextPtr){
+		if(*linkPtr == hookPtr){
+			*linkPtr = hookPtr->nextPtr;
+			return;
+		}
+	}
+}
+
+/***********************************************************************
+Private function:derive clock values from RCC registers
+***********************************************************************/
+static void RCC_read_clock_freq (RCC_Clock_freq_t *clockFreqPtr)
+{
+	int32_t sysClock = -1;
+	uint8_t sysClockStatus =	(RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos;
+	uint8_t AHBdivStatus = (RCC->CFGR >> RCC_CFGR_HPRE_Pos)	& 0x0F;
+	uint8_t APB1divStatus = (RCC->CFGR >> RCC_CFGR_PPRE1_Pos)	& 0x07;
+	uint8_t APB2divStatus = (RCC->CFGR >> RCC_CFGR_PPRE2_Pos)	& 0x07;
 	
-	/*get AHB prescaler*/
-	if(AHBdivStatus <= 7){
-		AHBdiv = 1;
-	}else{
-		AHBdiv = AHBdivArray[AHBdivStatus-8];
+	if(sysClockStatus == RCC_SYSCLK_HSI){
+		sysClock = RCC_HSI_FREQ;
+	}else if(sysClockStatus == RCC_SYSCLK_HSE){
+		sysClock = HSEFreq;
+	}else if(sysClockStatus == RCC_SYSCLK_PLL){
+		sysClock = RCC_get_PLL_output();
 	}
 	
-	/*get APB1 prescaler*/
-	if(APBdivStatus <= 3){
-		APBdiv = 1;
-	}else{
-		APBdiv = APBdivArray[APBdivStatus-4];
+	clockFreqPtr->SYSCLK = sysClock;
+	if(sysClock == -1){
+		clockFreqPtr->HCLK = -1;
+		clockFreqPtr->PCLK1 = -1;
+		clockFreqPtr->PCLK2 = -1;
+		clockFreqPtr->TIMCLK1 = -1;
+		clockFreqPtr->TIMCLK2 = -1;
+		return;
 	}
 	
-	/*derive PCLK*/ 
-	PCLK = (sysClock/AHBdiv)/APBdiv;
-	return PCLK;
+	/*field value below 8 (AHB) or 4 (APB) mean no division*/
+	clockFreqPtr->HCLK = sysClock/AHBDivTable[(AHBdivStatus <= 7) ? 0 : AHBdivStatus - 7];
+	clockFreqPtr->PCLK1 = clockFreqPtr->HCLK/APBDivTable[(APB1divStatus <= 3) ? 0 : APB1divStatus - 3];
+	clockFreqPtr->PCLK2 = clockFreqPtr->HCLK/APBDivTable[(APB2divStatus <= 3) ? 0 : APB2divStatus - 3];
+	
+	/*timer clock is doubled when APB prescaler is not 1*/
+	clockFreqPtr->TIMCLK1 = (APB1divStatus > 3) ? clockFreqPtr->PCLK1*2 : clockFreqPtr->PCLK1;
+	clockFreqPtr->TIMCLK2 = (APB2divStatus > 3) ? clockFreqPtr->PCLK2*2 : clockFreqPtr->PCLK2;
 }
 
 /***********************************************************************
@@ -204,49 +594,53 @@ void RCC_PLL_clock_ctrl (uint8_t enOrDis)
 }
 
 /***********************************************************************
-Private function:set voltage scale mode to mode 1
+Private function:set voltage scale mode (scale 1 for HCLK above 144 MHz, scale 2 otherwise)
 ***********************************************************************/
-void PWR_set_scale_mode (void)
+void PWR_set_scale_mode (uint8_t scale1)
 {
-	PWR->CR |= PWR_CR_VOS;
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+	if(scale1){
+		PWR->CR |= PWR_CR_VOS;
+	}else{
+		PWR->CR &= ~PWR_CR_VOS;
+	}
 }
 
 
 /***********************************************************************
-Private function:set Flash latency (in case of increasing system clock)
+Private function:set Flash latency, new value is read back before clock is changed
 ***********************************************************************/
-void FLASH_set_latency (void)
+void FLASH_set_latency (uint8_t latency)
 {
-	FLASH->ACR &= ~(0x07 << FLASH_ACR_LATENCY_Pos);
-	FLASH->ACR |= FLASH_ACR_LATENCY_5WS;
+	FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | (latency << FLASH_ACR_LATENCY_Pos);
+	while(((FLASH->ACR & FLASH_ACR_LATENCY) >> FLASH_ACR_LATENCY_Pos) != latency);
 }
 
 /***********************************************************************
-Private function:configure PLL as 168 MHz and turn PLL on
+Private function:set prefetch and caches from flash config, caches are reset before being enabled
+(reset only works while cache is disabled)
 ***********************************************************************/
-void RCC_set_PLL_84_MHz (void)
+void FLASH_accelerator_update (uint8_t forceReset)
 {
-		/*turn on HSE*/
-	RCC_HSE_clock_ctrl (ENABLE);
-	
-	/*select HSE as PLL input, turn off PLL, and program PLL 's division factors to achieve 84Mhz*/
-	RCC->PLLCFGR |= RCC_PLLCFGR_PLLSRC;
-	RCC->CR &= ~RCC_CR_PLLON;
-	
-	RCC->PLLCFGR &= ~(RCC_PLLCFGR_PLLM);
-	RCC->PLLCFGR |= RCC_PLL_84_VCO_INPUT_DIV << RCC_PLLCFGR_PLLM_Pos;
+	uint32_t ACRBits = 0;
 
-	RCC->PLLCFGR &= ~(RCC_PLLCFGR_PLLN);
-	RCC->PLLCFGR |= RCC_PLL_84_VCO_OUTPUT_MUL << RCC_PLLCFGR_PLLN_Pos;
+	if(flashConfig.prefetch == ENABLE && flashConfig.VDDRange != FLASH_VDD_1V8_2V1){
+		ACRBits |= FLASH_ACR_PRFTEN;
+	}
+	if(flashConfig.instructionCache == ENABLE){
+		ACRBits |= FLASH_ACR_ICEN;
+	}
+	if(flashConfig.dataCache == ENABLE){
+		ACRBits |= FLASH_ACR_DCEN;
+	}
+	if(!forceReset && (FLASH->ACR & FLASH_ACR_ACCELERATOR) == ACRBits){
+		return;
+	}
 
-	RCC->PLLCFGR &= ~(RCC_PLLCFGR_PLLP);
-	RCC->PLLCFGR |= RCC_PLL_84_PLL_OUTPUT_DIV << RCC_PLLCFGR_PLLP_Pos;	
-	
-	RCC->PLLCFGR &= ~(RCC_PLLCFGR_PLLQ);
-	RCC->PLLCFGR |= RCC_PLL_84_MAIN_PLL_DIV << RCC_PLLCFGR_PLLQ_Pos;	
-	
-	/*turn on PLL*/
-	RCC_PLL_clock_ctrl (ENABLE);
+	FLASH->ACR &= ~FLASH_ACR_ACCELERATOR;
+	FLASH->ACR |= FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+	FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+	FLASH->ACR |= ACRBits;
 }
 
 /***********************************************************************
@@ -264,9 +658,9 @@ int32_t RCC_get_PLL_output (void)
 	/*determine PLL input source*/
 	uint8_t check = (RCC->PLLCFGR & RCC_PLLCFGR_PLLSRC) >> RCC_PLLCFGR_PLLSRC_Pos;
 	if (check){
-		VCOinput = 8000000;
+		VCOinput = HSEFreq;
 	}else{
-		VCOinput = 16000000;
+		VCOinput = RCC_HSI_FREQ;
 	}
 	
 	/*determine VCO input division factor*/
@@ -295,16 +689,35 @@ int32_t RCC_get_PLL_output (void)
 		PLLoutputDiv = 8;
 	}	
 	
-	PLLoutput = (((double)(VCOinput / VCOinputDiv))*VCOoutputMul)/PLLoutputDiv; 
+	PLLoutput = ((uint64_t)VCOinput*VCOoutputMul)/((uint32_t)VCOinputDiv*PLLoutputDiv);
 	return PLLoutput;
 }
 
 /***********************************************************************
-Private function:generate delay
+Private function:generate delay (in microsecond), counted on time base so that it does not depend on clock speed
+***********************************************************************/
+void RCC_delay( uint32_t delayUs)
+{
+	TIME_delay_us(delayUs);
+}
+
+/***********************************************************************
+Private function:switch system clock and wait until switch is done
 ***********************************************************************/
-void RCC_delay( volatile uint32_t delay)
+static void RCC_switch_SYSCLK (uint8_t source)
 {
-	while(!delay){
-		delay--;
-	};
+	RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | (source << RCC_CFGR_SW_Pos);
+	while (((RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos) != source);
+}
+
+/***********************************************************************
+Private function:get index of smallest division factor keeping bus clock below a limit
+***********************************************************************/
+static uint8_t RCC_bus_prescaler (uint32_t inputFreq, uint32_t maxFreq, const uint16_t *divArray, uint8_t divNum)
+{
+	uint8_t index = 0;
+	while(index < divNum - 1 && inputFreq/divArray[index] > maxFreq){
+		index++;
+	}
+	return index;
 }
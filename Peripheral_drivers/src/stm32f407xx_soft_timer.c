@@ -0,0 +1,292 @@
+/**
+*@file stm32f407xx_soft_timer.c
+*@brief provide software timer service multiplexed on one 32 bits hardware timer.
+*
+*This source file provide APIs for one-shot and periodic software timers on stm32f407xx MCUs.
+*
+*A timer is placed at the level of the highest 5 bits group in which its expiry differ from wheel time, in the slot given by expiry bits of that group.
+*When wheel time enter a slot of level 0 its timers expire, when wheel time enter a slot of upper level its timers are moved down (cascaded).
+*Wheel time only advance to slot boundaries, so hardware compare is programmed once per expiry or cascade.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_soft_timer.h"
+
+#define SWTIM_EXPIRING_SLOT 0xFF	/*timer is in expiring list, not in wheel*/
+#define SWTIM_HEARTBEAT 0x40000000	/*longest time between two compare interrupts, keep wheel time close to counter*/
+
+static uint32_t SWTIM_lock (void);
+static void SWTIM_unlock (uint32_t lockState);
+static void SWTIM_insert (SWTIM_Timer_t *timerPtr);
+static void SWTIM_unlink (SWTIM_Timer_t *timerPtr);
+static uint8_t SWTIM_next_event (uint8_t *levelPtr, uint8_t *slotPtr, uint32_t *eventTimePtr);
+static void SWTIM_process (void);
+
+static SWTIM_Timer_t *wheelList[SWTIM_LEVEL_NUM][SWTIM_SLOT_NUM];
+static uint32_t wheelBitmap[SWTIM_LEVEL_NUM];	/*bit n set: slot n of level is not empty*/
+static SWTIM_Timer_t *expiringList = NULL;	/*timers which expire at current wheel time*/
+static uint32_t wheelTime = 0;
+static uint32_t armedTime = 0;	/*value programmed in compare register*/
+static uint8_t processing = 0;
+
+/***********************************************************************
+Initialize software timer service
+***********************************************************************/
+void SWTIM_init (void)
+{
+	TIM_Config_t TIMConfig = {.reloadVal = 0xFFFFFFFF,.prescaler = RCC_get_TIMCLK_value(APB1)/SWTIM_COUNT_FREQ - 1};
+	TIM_Handle_t TIMHandle = {SWTIM_TIMx,&TIMConfig};
+	TIM_init(&TIMHandle);
+
+	/*channel 1 stay in frozen output compare mode without preload: compare value take effect immediately and only set CC1IF*/
+	wheelTime = SWTIM_TIMx->CNT;
+	armedTime = wheelTime + SWTIM_HEARTBEAT;
+	SWTIM_TIMx->CCR1 = armedTime;
+
+	/*wheel run below time critical interrupts, priority is set before compare interrupt and vector are enabled*/
+	TIM_intrpt_priority_config(SWTIM_IRQ_NUMBER,SWTIM_IRQ_PRIORITY);
+	TIM_channel_interrupt_ctr(SWTIM_TIMx,TIM_CHANNEL_1,ENABLE);
+	TIM_intrpt_vector_ctr(SWTIM_IRQ_NUMBER,ENABLE);
+	TIM_ctr(SWTIM_TIMx,START);
+}
+
+/***********************************************************************
+Initialize a software timer
+***********************************************************************/
+void SWTIM_timer_init (SWTIM_Timer_t *timerPtr, SWTIM_Callback_t callback, void *argPtr)
+{
+	timerPtr->nextPtr = NULL;
+	timerPtr->pprevPtr = NULL;
+	timerPtr->period = 0;
+	timerPtr->callback = callback;
+	timerPtr->argPtr = argPtr;
+}
+
+/***********************************************************************
+Start a software timer
+***********************************************************************/
+void SWTIM_start (SWTIM_Timer_t *timerPtr, uint32_t delay, uint32_t period)
+{
+	if(delay > SWTIM_MAX_DELAY){
+		delay = SWTIM_MAX_DELAY;
+	}
+	if(period > SWTIM_MAX_DELAY){
+		period = SWTIM_MAX_DELAY;
+	}
+
+	uint32_t lockState = SWTIM_lock();
+
+	/*each armed timer hold a stop lock, hardware counter must run until it expire*/
+	if(timerPtr->pprevPtr != NULL){
+		SWTIM_unlink(timerPtr);
+	}else{
+		PWR_stop_lock(PWR_LOCK_SWTIM);
+	}
+	timerPtr->expiry = SWTIM_TIMx->CNT + delay;
+	timerPtr->period = period;
+	SWTIM_insert(timerPtr);
+
+	/*new timer expire before programmed compare: generate compare event so that interrupt reschedule*/
+	if(!processing && (int32_t)(timerPtr->expiry - armedTime) < 0){
+		SWTIM_TIMx->EGR = TIM_EGR_CC1G;
+	}
+
+	SWTIM_unlock(lockState);
+}
+
+/***********************************************************************
+Cancel a software timer
+***********************************************************************/
+void SWTIM_cancel (SWTIM_Timer_t *timerPtr)
+{
+	uint32_t lockState = SWTIM_lock();
+
+	if(timerPtr->pprevPtr != NULL){
+		SWTIM_unlink(timerPtr);
+		PWR_stop_unlock(PWR_LOCK_SWTIM);
+	}
+
+	SWTIM_unlock(lockState);
+}
+
+/***********************************************************************
+Check whether a software timer is running
+***********************************************************************/
+uint8_t SWTIM_is_active (SWTIM_Timer_t *timerPtr)
+{
+	return (timerPtr->pprevPtr != NULL);
+}
+
+/***********************************************************************
+Get current counter value
+***********************************************************************/
+uint32_t SWTIM_get_tick (void)
+{
+	return SWTIM_TIMx->CNT;
+}
+
+/***********************************************************************
+Hardware timer interrupt: expire or cascade timers up to current time
+***********************************************************************/
+void SWTIM_IRQHandler (void)
+{
+	if((SWTIM_TIMx->DIER & TIM_DIER_CC1IE) && (SWTIM_TIMx->SR & TIM_SR_CC1IF)){
+		SWTIM_TIMx->SR = ~TIM_SR_CC1IF;
+		SWTIM_process();
+	}
+}
+
+/***********************************************************************
+Private function: mask interrupts, return previous PRIMASK
+@note timers may be started or cancelled from any interrupt, which may preempt thread mode as well as SWTIM_process,
+so wheel is only modified with all interrupts masked
+***********************************************************************/
+static uint32_t SWTIM_lock (void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+static void SWTIM_unlock (uint32_t lockState)
+{
+	__set_PRIMASK(lockState);
+}
+
+/***********************************************************************
+Private function: put timer into wheel slot (or expiring list) matching its expiry
+***********************************************************************/
+static void SWTIM_insert (SWTIM_Timer_t *timerPtr)
+{
+	SWTIM_Timer_t **headPtr;
+	uint32_t diff = timerPtr->expiry ^ wheelTime;
+
+	if((int32_t)(timerPtr->expiry - wheelTime) <= 0){
+		headPtr = &expiringList;
+		timerPtr->slot = SWTIM_EXPIRING_SLOT;
+	}else{
+		uint8_t level = (31 - __CLZ(diff))/SWTIM_SLOT_BITS;
+		uint8_t slot = (timerPtr->expiry >> (level*SWTIM_SLOT_BITS)) & (SWTIM_SLOT_NUM - 1);
+
+		headPtr = &wheelList[level][slot];
+		wheelBitmap[level] |= 1U << slot;
+		timerPtr->slot = level*SWTIM_SLOT_NUM + slot;
+	}
+
+	timerPtr->nextPtr = *headPtr;
+	if(*headPtr != NULL){
+		(*headPtr)->pprevPtr = &timerPtr->nextPtr;
+	}
+	*headPtr = timerPtr;
+	timerPtr->pprevPtr = headPtr;
+}
+
+/***********************************************************************
+Private function: remove timer from its list, clear slot bit once slot is empty
+***********************************************************************/
+static void SWTIM_unlink (SWTIM_Timer_t *timerPtr)
+{
+	*timerPtr->pprevPtr = timerPtr->nextPtr;
+	if(timerPtr->nextPtr != NULL){
+		timerPtr->nextPtr->pprevPtr = timerPtr->pprevPtr;
+	}
+	timerPtr->pprevPtr = NULL;
+
+	if(timerPtr->slot != SWTIM_EXPIRING_SLOT){
+		uint8_t level = timerPtr->slot/SWTIM_SLOT_NUM;
+		uint8_t slot = timerPtr->slot%SWTIM_SLOT_NUM;
+		if(wheelList[level][slot] == NULL){
+			wheelBitmap[level] &= ~(1U << slot);
+		}
+	}
+}
+
+/***********************************************************************
+Private function: find next slot to be entered by wheel time
+@note lowest non empty level always hold the earliest event, occupied slots are after current slot
+(only top level may wrap around because counter is 32 bits)
+***********************************************************************/
+static uint8_t SWTIM_next_event (uint8_t *levelPtr, uint8_t *slotPtr, uint32_t *eventTimePtr)
+{
+	for(uint8_t level = 0; level < SWTIM_LEVEL_NUM; level++){
+		uint32_t bitmap = wheelBitmap[level];
+		if(!bitmap){
+			continue;
+		}
+
+		uint8_t shift = level*SWTIM_SLOT_BITS;
+		uint8_t current = (wheelTime >> shift) & (SWTIM_SLOT_NUM - 1);
+		uint32_t after = bitmap & ~((2U << current) - 1);
+
+		/*lowest set bit: count leading zero of bit reversed bitmap*/
+		uint8_t slot = __CLZ(__RBIT(after ? after : bitmap));
+
+		uint32_t upperMask = (shift + SWTIM_SLOT_BITS >= 32) ? 0 : ~((1U << (shift + SWTIM_SLOT_BITS)) - 1);
+		*eventTimePtr = (wheelTime & upperMask) | ((uint32_t)slot << shift);
+		*levelPtr = level;
+		*slotPtr = slot;
+		return 1;
+	}
+	return 0;
+}
+
+/***********************************************************************
+Private function: expire and cascade timers, then program compare to next event
+***********************************************************************/
+static void SWTIM_process (void)
+{
+	uint8_t level, slot;
+	uint32_t eventTime;
+	uint32_t lockState = SWTIM_lock();
+
+	processing = 1;
+	while(1){
+		/*fire timers which are due, periodic timers are rearmed before callback so that callback may cancel them*/
+		while(expiringList != NULL){
+			SWTIM_Timer_t *timerPtr = expiringList;
+			SWTIM_unlink(timerPtr);
+			if(timerPtr->period){
+				timerPtr->expiry += timerPtr->period;
+				SWTIM_insert(timerPtr);
+			}else{
+				PWR_stop_unlock(PWR_LOCK_SWTIM);
+			}
+			/*callback run with interrupts unmasked, timers it start are found by next scan*/
+			SWTIM_unlock(lockState);
+			timerPtr->callback(timerPtr->argPtr);
+			lockState = SWTIM_lock();
+		}
+
+		uint32_t now = SWTIM_TIMx->CNT;
+		uint8_t found = SWTIM_next_event(&level,&slot,&eventTime);
+
+		if(!found || (int32_t)(eventTime - now) > 0){
+			/*no occupied slot is entered before next event, wheel time can catch up with counter*/
+			wheelTime = now;
+			if(!found || (eventTime - now) > SWTIM_HEARTBEAT){
+				eventTime = now + SWTIM_HEARTBEAT;
+			}
+			armedTime = eventTime;
+			SWTIM_TIMx->CCR1 = eventTime;
+
+			/*counter may have passed compare value while it was programmed*/
+			if((int32_t)(eventTime - SWTIM_TIMx->CNT) > 0){
+				break;
+			}
+			continue;
+		}
+
+		/*enter slot: level 0 timers expire, upper level timers move down*/
+		wheelTime = eventTime;
+		while(wheelList[level][slot] != NULL){
+			SWTIM_Timer_t *timerPtr = wheelList[level][slot];
+			SWTIM_unlink(timerPtr);
+			SWTIM_insert(timerPtr);
+		}
+	}
+	processing = 0;
+	SWTIM_unlock(lockState);
+}
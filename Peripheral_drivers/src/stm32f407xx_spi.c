@@ -13,9 +13,7 @@
 
 #include "../inc/stm32f407xx_spi.h"
 
-static void SPI_pins_pack_1_GPIO_init(SPI_TypeDef *SPIxPtr);
-static void SPI_pins_pack_2_GPIO_init(SPI_TypeDef *SPIxPtr);
-static void SPI_pins_pack_3_GPIO_init(SPI_TypeDef *SPIxPtr);
+static int8_t SPI_pins_pack_GPIO_init(SPI_TypeDef *SPIxPtr, SPI_pins_pack_t pinsPack);
 static void SPI_data_frame_config(SPI_TypeDef *SPIxPtr, uint8_t dataFrame);
 static void SPI_close_transmission(SPI_Handle_t *SPIxHandlePtr);
 static void SPI_close_reception(SPI_Handle_t *SPIxHandlePtr);
@@ -148,12 +146,9 @@ Initialize SPI peripheral and initialize corresponding GPIO pins as SPI function
 ***********************************************************************/
 SPI_Handle_t* SPI_general_init(SPI_TypeDef *SPIxPtr, SPI_pins_pack_t pinsPack, uint32_t deviceMode, uint8_t busConfig, uint8_t dataFrame, uint8_t clkPhase, uint8_t clkPol, uint8_t swSlaveManage, uint8_t clkSpeed)
 {
-	if (pinsPack == SPI_pins_pack_1){
-		SPI_pins_pack_1_GPIO_init(SPIxPtr);
-	}else if (pinsPack == SPI_pins_pack_2){
-		SPI_pins_pack_2_GPIO_init(SPIxPtr);
-	}else if (pinsPack == SPI_pins_pack_3){
-		SPI_pins_pack_3_GPIO_init(SPIxPtr);		
+	/*pins already used by another pins pack are not touched*/
+	if(SPI_pins_pack_GPIO_init(SPIxPtr,pinsPack) < 0){
+		return NULL;
 	}
 	
 	static SPI_Handle_t SPIxHandle;
@@ -272,6 +267,7 @@ uint8_t SPI_receive_data_intrpt (SPI_Handle_t *SPIxHandlePtr, uint8_t *rxBufferP
 		SPIxHandlePtr->rxBufferPtr = rxBufferPtr;
 		SPIxHandlePtr->rxLength = Length;
 		SPIxHandlePtr->rxState = SPI_STATE_RX_BUSY;
+		PWR_stop_lock(PWR_LOCK_SPI);
 		SPIxHandlePtr->SPIxPtr->CR2 |= SPI_CR2_ERRIE;
 		/*Enable RXNEIE bit to get interrupt when ever RXNE flag is set*/
 		SPIxHandlePtr->SPIxPtr->CR2 |= SPI_CR2_RXNEIE;
@@ -289,6 +285,7 @@ uint8_t SPI_send_data_intrpt (SPI_Handle_t *SPIxHandlePtr, uint8_t *txBufferPtr,
 		SPIxHandlePtr->txBufferPtr = txBufferPtr;
 		SPIxHandlePtr->txLength = Length;
 		SPIxHandlePtr->txState = SPI_STATE_TX_BUSY;
+		PWR_stop_lock(PWR_LOCK_SPI);
 		SPIxHandlePtr->SPIxPtr->CR2 |= SPI_CR2_ERRIE;
 		/*Enable TXEIE bit to get interrupt when ever TXE flag is set*/
 		SPIxHandlePtr->SPIxPtr->CR2 |= SPI_CR2_TXEIE;
@@ -341,7 +338,7 @@ void SPI_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority)
 /***********************************************************************
 General Interrupt handler for SPI peripheral
 ***********************************************************************/
-void SPI_intrpt_handler (SPI_Handle_t *SPIxHandlePtr)
+RAM_FUNC void SPI_intrpt_handler (SPI_Handle_t *SPIxHandlePtr)
 {
 	/*case interrupt triggered due to data received in rx buffer*/
 	uint8_t check1 = (SPIxHandlePtr->SPIxPtr->CR2 & SPI_CR2_RXNEIE) >> SPI_CR2_RXNEIE_Pos;
@@ -358,6 +355,7 @@ void SPI_intrpt_handler (SPI_Handle_t *SPIxHandlePtr)
 			SPIxHandlePtr->rxBufferPtr+=2;
 		}
 		if(!(SPIxHandlePtr->rxLength)){
+			PWR_stop_unlock(PWR_LOCK_SPI);
 			SPIxHandlePtr->rxState = SPI_STATE_READY;
 			SPIxHandlePtr->SPIxPtr->CR2 &= ~(SPI_CR2_RXNEIE);
 		}
@@ -411,56 +409,79 @@ __attribute__((weak)) void SPI_application_event_callback (SPI_Handle_t *SPIxHan
 {
 }
 
-/***********************************************************************
-Private function: Initialize GPIO pin as SPI function (for pins pack 1) 
-***********************************************************************/
-void SPI_pins_pack_1_GPIO_init(SPI_TypeDef *SPIxPtr)
-{
-	if(SPIxPtr == SPI1){
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-	}else if(SPIxPtr == SPI2){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);			
-	}else if(SPIxPtr == SPI3){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_4,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-	}		
-}
+/*pins pack tables: SCK, MISO, MOSI in alternate function mode*/
+#define SPI1_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5)
+#define SPI2_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5)
+#define SPI3_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_4,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6)
+#define SPI1_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_4,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5)
+#define SPI2_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_13,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_14,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_15,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5)
+#define SPI3_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6)
+#define SPI2_PACK_3_PINS(X,port) \
+	X(port,GPIO_PORT_I,GPIO_PIN_NO_1,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_I,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5) \
+	X(port,GPIO_PORT_I,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5)
+
+static const GPIO_Port_table_t SPI1Pack1Table[] = {GPIO_PORT_TABLE(SPI1_PACK_1_PINS,GPIO_PORT_A)};
+static const GPIO_Port_table_t SPI2Pack1Table[] = {GPIO_PORT_TABLE(SPI2_PACK_1_PINS,GPIO_PORT_B),GPIO_PORT_TABLE(SPI2_PACK_1_PINS,GPIO_PORT_C)};
+static const GPIO_Port_table_t SPI3Pack1Table[] = {GPIO_PORT_TABLE(SPI3_PACK_1_PINS,GPIO_PORT_B)};
+static const GPIO_Port_table_t SPI1Pack2Table[] = {GPIO_PORT_TABLE(SPI1_PACK_2_PINS,GPIO_PORT_B)};
+static const GPIO_Port_table_t SPI2Pack2Table[] = {GPIO_PORT_TABLE(SPI2_PACK_2_PINS,GPIO_PORT_B)};
+static const GPIO_Port_table_t SPI3Pack2Table[] = {GPIO_PORT_TABLE(SPI3_PACK_2_PINS,GPIO_PORT_C)};
+static const GPIO_Port_table_t SPI2Pack3Table[] = {GPIO_PORT_TABLE(SPI2_PACK_3_PINS,GPIO_PORT_I)};
 
 /***********************************************************************
-Private function: Initialize GPIO pin as SPI function (for pins pack 2) 
+Private function: Initialize GPIO pins of pins pack as SPI function
 ***********************************************************************/
-void SPI_pins_pack_2_GPIO_init(SPI_TypeDef *SPIxPtr)
+static int8_t SPI_pins_pack_GPIO_init(SPI_TypeDef *SPIxPtr, SPI_pins_pack_t pinsPack)
 {
-	if(SPIxPtr == SPI1){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_4,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);		
-	}else if(SPIxPtr == SPI2){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_13,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_14,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_15,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-	}else if(SPIxPtr == SPI3){
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,6);
-	}			
-}
+	const GPIO_Port_table_t *tablePtr = NULL;
+	uint8_t portNum = 1;
 
-/***********************************************************************
-Private function: Initialize GPIO pin as SPI function (for pins pack 3) 
-***********************************************************************/
-void SPI_pins_pack_3_GPIO_init(SPI_TypeDef *SPIxPtr)
-{
-	if(SPIxPtr == SPI2){
-		GPIO_init_direct(GPIOI,GPIO_PIN_NO_1,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOI,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);
-		GPIO_init_direct(GPIOI,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,5);				
+	if(pinsPack == SPI_pins_pack_1){
+		if(SPIxPtr == SPI1){
+			tablePtr = SPI1Pack1Table;
+		}else if(SPIxPtr == SPI2){
+			tablePtr = SPI2Pack1Table;
+			portNum = 2;
+		}else if(SPIxPtr == SPI3){
+			tablePtr = SPI3Pack1Table;
+		}
+	}else if(pinsPack == SPI_pins_pack_2){
+		if(SPIxPtr == SPI1){
+			tablePtr = SPI1Pack2Table;
+		}else if(SPIxPtr == SPI2){
+			tablePtr = SPI2Pack2Table;
+		}else if(SPIxPtr == SPI3){
+			tablePtr = SPI3Pack2Table;
+		}
+	}else if(pinsPack == SPI_pins_pack_3){
+		if(SPIxPtr == SPI2){
+			tablePtr = SPI2Pack3Table;
+		}
+	}
+
+	if(tablePtr == NULL){
+		return 0;
 	}
+	return GPIO_table_apply(tablePtr,portNum,NULL);
 }
 
 /***********************************************************************
@@ -484,6 +505,9 @@ Private function: Close SPI transmission (after transmission complete)
 ***********************************************************************/
 void SPI_close_transmission(SPI_Handle_t *SPIxHandlePtr)
 {
+	if(SPIxHandlePtr->txState != SPI_STATE_READY){
+		PWR_stop_unlock(PWR_LOCK_SPI);
+	}
 	SPIxHandlePtr->txBufferPtr = NULL;
 	SPIxHandlePtr->txLength = 0;
 	SPIxHandlePtr->txState = SPI_STATE_READY;
@@ -494,6 +518,9 @@ Private function: Close SPI reception (after reception complete)
 ***********************************************************************/
 void SPI_close_reception(SPI_Handle_t *SPIxHandlePtr)
 {
+	if(SPIxHandlePtr->rxState != SPI_STATE_READY){
+		PWR_stop_unlock(PWR_LOCK_SPI);
+	}
 	SPIxHandlePtr->rxBufferPtr = NULL;
 	SPIxHandlePtr->rxLength = 0;
 	SPIxHandlePtr->rxState = SPI_STATE_READY;
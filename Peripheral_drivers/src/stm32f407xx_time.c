@@ -0,0 +1,219 @@
+/**
+*@file stm32f407xx_time.c
+*@brief provide monotonic time base and precise delays on stm32f407xx MCUs.
+*
+*This source file provide a free running 64 bits microsecond timestamp and busy-wait delays which do not depend on CPU speed.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+#include "../inc/stm32f407xx_time.h"
+
+static void TIME_SysTick_config (void);
+static uint32_t TIME_get_cycles_per_us (void);
+static void TIME_clock_change (const RCC_Clock_freq_t *clockFreqPtr, void *argPtr);
+
+static uint64_t timeBaseUs = 0;	/*timestamp at timeBaseCycles*/
+static uint32_t timeBaseCycles = 0;	/*CYCCNT value matching timeBaseUs*/
+static uint32_t cyclesPerUs = 16;	/*HCLK in MHz, HSI after reset*/
+static uint8_t timeInitialized = 0;
+static uint32_t sleepSysTickVal;	/*SysTick value when core went to sleep*/
+static uint32_t sleepCycles;	/*CYCCNT value when core went to sleep*/
+static RCC_Clock_hook_t timeClockHook;
+
+/***********************************************************************
+Initialize time base
+***********************************************************************/
+void TIME_init (void)
+{
+	if(timeInitialized){
+		return;
+	}
+
+	/*enable trace block, then DWT cycle counter*/
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	timeBaseUs = 0;
+	timeBaseCycles = 0;
+	cyclesPerUs = TIME_get_cycles_per_us();
+	TIME_SysTick_config();
+	RCC_clock_hook_register(&timeClockHook,TIME_clock_change,NULL);
+
+	timeInitialized = 1;
+}
+
+/***********************************************************************
+Re-read HCLK after system clock change
+***********************************************************************/
+void TIME_clock_update (void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	TIME_get_us();
+	cyclesPerUs = TIME_get_cycles_per_us();
+	TIME_SysTick_config();
+
+	__set_PRIMASK(primask);
+}
+
+/***********************************************************************
+Get time in microsecond
+***********************************************************************/
+uint64_t TIME_get_us (void)
+{
+	uint64_t nowUs;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	/*move base forward by whole microseconds only, so that remaining cycles are not lost*/
+	uint32_t elapsedUs = (DWT->CYCCNT - timeBaseCycles)/cyclesPerUs;
+	timeBaseUs += elapsedUs;
+	timeBaseCycles += elapsedUs*cyclesPerUs;
+	nowUs = timeBaseUs;
+
+	__set_PRIMASK(primask);
+	return nowUs;
+}
+
+/***********************************************************************
+Get time in milisecond
+***********************************************************************/
+uint64_t TIME_get_ms (void)
+{
+	return TIME_get_us()/1000;
+}
+
+/***********************************************************************
+Get time elapsed since given timestamp
+***********************************************************************/
+uint64_t TIME_elapsed_us (uint64_t sinceUs)
+{
+	return TIME_get_us() - sinceUs;
+}
+
+/***********************************************************************
+Check whether timeout has elapsed
+***********************************************************************/
+uint8_t TIME_is_timeout (uint64_t startUs, uint64_t timeoutUs)
+{
+	return (TIME_get_us() - startUs) >= timeoutUs;
+}
+
+/***********************************************************************
+Busy-wait in microsecond
+***********************************************************************/
+void TIME_delay_us (uint32_t delayUs)
+{
+	/*CYCCNT does not run before TIME_init, a delay would never end*/
+	if(!timeInitialized){
+		TIME_init();
+	}
+	uint32_t start = DWT->CYCCNT;
+	uint64_t cycles = (uint64_t)delayUs*cyclesPerUs;
+
+	/*wait in chunks shorter than half of CYCCNT range so that wrap around is handled by unsigned difference*/
+	while(cycles > 0x7FFFFFFF){
+		while((DWT->CYCCNT - start) < 0x7FFFFFFF);
+		start += 0x7FFFFFFF;
+		cycles -= 0x7FFFFFFF;
+	}
+	while((DWT->CYCCNT - start) < (uint32_t)cycles);
+}
+
+/***********************************************************************
+Busy-wait in milisecond
+***********************************************************************/
+void TIME_delay_ms (uint32_t delayMs)
+{
+	while(delayMs){
+		TIME_delay_us(1000);
+		delayMs--;
+	}
+}
+
+/***********************************************************************
+Mark entry in sleep mode
+***********************************************************************/
+void TIME_sleep_enter (void)
+{
+	if(!timeInitialized){
+		return;
+	}
+	/*reading CTRL clear COUNTFLAG*/
+	(void)SysTick->CTRL;
+	sleepSysTickVal = SysTick->VAL;
+	sleepCycles = DWT->CYCCNT;
+}
+
+/***********************************************************************
+Add time spent in sleep mode
+***********************************************************************/
+void TIME_sleep_exit (void)
+{
+	if(!timeInitialized){
+		return;
+	}
+	uint32_t val = SysTick->VAL;
+	uint32_t countedCycles = DWT->CYCCNT - sleepCycles;
+	uint32_t sysTickCount;
+
+	/*SysTick interrupt wake core, so counter wrapped at most once*/
+	if(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk){
+		sysTickCount = sleepSysTickVal + (SysTick->LOAD + 1) - val;
+	}else{
+		sysTickCount = sleepSysTickVal - val;
+	}
+
+	/*SysTick count HCLK/8 during sleep, CYCCNT only count if core clock was kept running (debugger)*/
+	uint32_t sleptCycles = sysTickCount*8;
+	if(sleptCycles > countedCycles){
+		timeBaseCycles -= sleptCycles - countedCycles;
+	}
+}
+
+/***********************************************************************
+SysTick interrupt: fold cycle counter into 64 bits timestamp
+***********************************************************************/
+void SysTick_Handler (void)
+{
+	TIME_get_us();
+}
+
+/***********************************************************************
+Private function: start SysTick at TIME_SYNC_FREQ, clocked by HCLK/8
+***********************************************************************/
+static void TIME_SysTick_config (void)
+{
+	SysTick->CTRL = 0;
+	SysTick->LOAD = (cyclesPerUs*1000000/8)/TIME_SYNC_FREQ - 1;
+	SysTick->VAL = 0;
+
+	/*SysTick is system handler 15, its priority is in SHP[11]*/
+	SCB->SHP[11] = TIME_SYSTICK_PRIORITY << NUM_OF_IPR_BIT_IMPLEMENTED;
+	SysTick->CTRL = SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/***********************************************************************
+Private function: get number of HCLK cycles in one microsecond (at least 1)
+***********************************************************************/
+static uint32_t TIME_get_cycles_per_us (void)
+{
+	int32_t HCLK = RCC_get_HCLK_value();
+
+	if(HCLK < 1000000){
+		return 1;
+	}
+	return HCLK/1000000;
+}
+
+/***********************************************************************
+Private function: RCC clock hook
+***********************************************************************/
+static void TIME_clock_change (const RCC_Clock_freq_t *clockFreqPtr, void *argPtr)
+{
+	TIME_clock_update();
+}
@@ -1,32 +1,45 @@
 /**
-*@file stm32f407xx_dac.c
-*@brief provide APIs for interfacing with basic timer on stm32f407xx MCUs.
+*@file stm32f407xx_timer.c
+*@brief provide APIs for interfacing with timers on stm32f407xx MCUs.
 *
-*This source file provide APIs for interfacing with basic timer (timer 6 and timer 7)on stm32f407xx MCUs.
-*@note: only use this driver for timer 6 and timer 7.
+*This source file provide APIs for interfacing with basic, general purpose and advanced timers (timer 1 to timer 14) on stm32f407xx MCUs.
 *
 *@author Tran Thanh Nhan
 *@date 20/08/2019
 */
 
 #include "../inc/stm32f407xx_timer.h"
+#include "../inc/stm32f407xx_rcc.h"
+
+static uint8_t TIM_get_RCC_bit(TIM_TypeDef *TIMxPtr, uint32_t *bitPtr);
+static volatile uint32_t* TIM_get_CCR_address(TIM_TypeDef *TIMxPtr, uint8_t channel);
+static void TIM_record_count_freq(TIM_TypeDef *TIMxPtr, uint16_t prescaler);
+static void TIM_clock_change(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr);
+
+/*counter frequency of each timer set by TIM_init or TIM_set_prescaler (0 if not set), prescaler is re-derived from it after clock change*/
+static TIM_TypeDef * const TIMTable[] = {TIM1,TIM2,TIM3,TIM4,TIM5,TIM6,TIM7,TIM8,TIM9,TIM10,TIM11,TIM12,TIM13,TIM14};
+static uint32_t TIMCountFreq[sizeof(TIMTable)/sizeof(TIMTable[0])];
+static RCC_Clock_hook_t TIMClockHook;
 
 /***********************************************************************
 Timer clock enable/disable
 ***********************************************************************/
 void TIM_CLK_ctr(TIM_TypeDef *TIMxPtr, uint8_t enOrDis)
 {
+	uint32_t bit;
+	uint8_t APBx = TIM_get_RCC_bit(TIMxPtr,&bit);
+	
 	if(enOrDis == ENABLE){
-		if(TIMxPtr ==  TIM6){
-			RCC->APB1ENR |= RCC_APB1ENR_TIM6EN;
-		}else if (TIMxPtr ==  TIM7){
-			RCC->APB1ENR |= RCC_APB1ENR_TIM7EN;
+		if(APBx == APB1){
+			RCC->APB1ENR |= bit;
+		}else{
+			RCC->APB2ENR |= bit;
 		}
 	}else{
-		if(TIMxPtr ==  TIM6){
-			RCC->APB1ENR &= ~RCC_APB1ENR_TIM6EN;
-		}else if (TIMxPtr ==  TIM7){
-			RCC->APB1ENR &= ~RCC_APB1ENR_TIM7EN;
+		if(APBx == APB1){
+			RCC->APB1ENR &= ~bit;
+		}else{
+			RCC->APB2ENR &= ~bit;
 		}
 	}	
 }
@@ -58,7 +71,7 @@ void TIM_init(TIM_Handle_t *TIMxHandlePtr)
 	TIMxHandlePtr->TIMxPtr->CR1 |= TIM_CR1_URS;
 	
 	/*config reload value*/
-	uint16_t reloadVal = TIMxHandlePtr->TIMxConfigPtr->reloadVal;
+	uint32_t reloadVal = TIMxHandlePtr->TIMxConfigPtr->reloadVal;
 	TIMxHandlePtr->TIMxPtr->ARR = reloadVal;
 	
 	/*config prescaler*/
@@ -67,6 +80,8 @@ void TIM_init(TIM_Handle_t *TIMxHandlePtr)
 	
 	/*update reload value and prescaler immediately*/
 	TIMxHandlePtr->TIMxPtr->EGR |= TIM_EGR_UG;
+	
+	TIM_record_count_freq(TIMxHandlePtr->TIMxPtr,prescaler);
 }
 
 /***********************************************************************
@@ -91,19 +106,29 @@ Deinitialize timer
 ***********************************************************************/
 void TIM_deinit(TIM_TypeDef *TIMxPtr)
 {
-	if(TIMxPtr == TIM6){
-		RCC->APB1RSTR |= RCC_APB1RSTR_TIM6RST;
-		RCC->AHB1RSTR &= ~(RCC_APB1RSTR_TIM6RST);
-	}else if(TIMxPtr == TIM7){
-		RCC->APB1RSTR |= RCC_APB1RSTR_TIM7RST;
-		RCC->AHB1RSTR &= ~(RCC_APB1RSTR_TIM7RST);
+	uint32_t bit;
+	
+	/*reset bit has same position as clock enable bit*/
+	if(TIM_get_RCC_bit(TIMxPtr,&bit) == APB1){
+		RCC->APB1RSTR |= bit;
+		RCC->APB1RSTR &= ~bit;
+	}else{
+		RCC->APB2RSTR |= bit;
+		RCC->APB2RSTR &= ~bit;
+	}
+	
+	/*reset timer is no longer re-timed after clock change*/
+	for(uint8_t i = 0; i < sizeof(TIMTable)/sizeof(TIMTable[0]); i++){
+		if(TIMTable[i] == TIMxPtr){
+			TIMCountFreq[i] = 0;
+		}
 	}
 }
 
 /***********************************************************************
 Set timer 's reload value
 ***********************************************************************/
-void TIM_set_reload_val(TIM_TypeDef *TIMxPtr, uint16_t reloadVal)
+void TIM_set_reload_val(TIM_TypeDef *TIMxPtr, uint32_t reloadVal)
 {
 	/*update reload value immediately*/
 	TIMxPtr->ARR = reloadVal;
@@ -118,6 +143,8 @@ void TIM_set_prescaler(TIM_TypeDef *TIMxPtr, uint16_t prescaler)
 	/*update prescaler immediately*/
 	TIMxPtr->PSC = prescaler;
 	TIMxPtr->EGR |= TIM_EGR_UG;
+	
+	TIM_record_count_freq(TIMxPtr,prescaler);
 }
 
 /***********************************************************************
@@ -137,25 +164,26 @@ Enable or disable timer 's interrupt vector in NVIC
 ***********************************************************************/
 void TIM_intrpt_vector_ctr (uint8_t IRQnumber, uint8_t enOrDis)
 {
+	/*ISER/ICER are write-1 registers, writing back read value would affect other enabled vectors*/
 	if(enOrDis == ENABLE){
 		if(IRQnumber <= 31){
-			NVIC->ISER[0] |= (1<<IRQnumber);
+			NVIC->ISER[0] = (1<<IRQnumber);
 		}
 		else if(IRQnumber > 31 && IRQnumber <= 63){
-			NVIC->ISER[1] |= (1<<(IRQnumber%32));
+			NVIC->ISER[1] = (1<<(IRQnumber%32));
 		}
 		else if(IRQnumber > 63 && IRQnumber <= 95){
-			NVIC->ISER[2] |= (1<<(IRQnumber%64));
+			NVIC->ISER[2] = (1<<(IRQnumber%64));
 		}
 	}else{
 		if(IRQnumber <= 31){
-			NVIC->ICER[0] |= (1<<IRQnumber);
+			NVIC->ICER[0] = (1<<IRQnumber);
 		}
 		else if(IRQnumber > 31 && IRQnumber <= 63){
-			NVIC->ICER[1] |= (1<<(IRQnumber%32));
+			NVIC->ICER[1] = (1<<(IRQnumber%32));
 		}
 		else if(IRQnumber > 63 && IRQnumber <= 95){
-			NVIC->ICER[2] |= (1<<(IRQnumber%64));
+			NVIC->ICER[2] = (1<<(IRQnumber%64));
 		}
 	}
 }
@@ -165,11 +193,8 @@ Config priority for timer 's interrupt
 ***********************************************************************/
 void TIM_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority)
 {
-	uint8_t registerNo = IRQnumber/4;
-	uint8_t section = IRQnumber%4;
-	
-	NVIC->IP[registerNo] &= ~(0xFF << (8*section));
-	NVIC->IP[registerNo] |= (priority << (8*section + NUM_OF_IPR_BIT_IMPLEMENTED));
+	/*IP is a byte array indexed by IRQ number, priority is held in upper bits of each byte*/
+	NVIC->IP[IRQnumber] = (uint8_t)(priority << NUM_OF_IPR_BIT_IMPLEMENTED);
 }
 
 /***********************************************************************
@@ -177,11 +202,25 @@ Timer interrupt handler
 ***********************************************************************/
 void TIM_intrpt_handler (TIM_TypeDef *TIMxPtr)
 {
-	uint8_t check1 = TIMxPtr->DIER & TIM_DIER_UIE;
-	uint8_t check2 = TIMxPtr->SR & TIM_SR_UIF;
+	uint32_t check1 = TIMxPtr->DIER;
+	uint32_t check2 = TIMxPtr->SR;
 	
-	if(check1 & check2){
-		TIMxPtr->SR &= ~TIM_SR_UIF;
+	/*status flags are cleared by writing 0, other flags are left untouched by writing 1*/
+	if((check1 & TIM_DIER_UIE) && (check2 & TIM_SR_UIF)){
+		TIMxPtr->SR = ~TIM_SR_UIF;
+		TIM_application_event_callback(TIMxPtr,TIM_EV_UPDATE);
+	}
+	
+	/*capture/compare flag of channel x is bit x of SR and DIER, overcapture flag of channel x is bit x + 8 of SR*/
+	for(uint8_t channel = TIM_CHANNEL_1; channel <= TIM_CHANNEL_4; channel++){
+		if((check1 & (1 << channel)) && (check2 & (1 << channel))){
+			TIMxPtr->SR = ~(1 << channel);
+			TIM_application_event_callback(TIMxPtr,TIM_EV_CC1 + channel - 1);
+			if(check2 & (1 << (channel + 8))){
+				TIMxPtr->SR = ~(1 << (channel + 8));
+				TIM_application_event_callback(TIMxPtr,TIM_EV_CC1_OVERCAPTURE + channel - 1);
+			}
+		}
 	}
 }
 
@@ -192,3 +231,350 @@ void TIM_update_event_TRGO (TIM_TypeDef *TIMxPtr)
 {
 	TIMxPtr->CR2 |= 0x02 << TIM_CR2_MMS_Pos;
 }
+
+/***********************************************************************
+Initialize timer channel as output compare or PWM output
+***********************************************************************/
+void TIM_OC_init(TIM_TypeDef *TIMxPtr, TIM_OC_Config_t *OCConfigPtr)
+{
+	uint8_t channel = OCConfigPtr->channel;
+	/*CCMR1 hold channel 1 and 2, CCMR2 hold channel 3 and 4, each channel use 8 bits*/
+	volatile uint32_t *CCMRxPtr = (channel <= TIM_CHANNEL_2) ? &TIMxPtr->CCMR1 : &TIMxPtr->CCMR2;
+	uint8_t CCMRshift = ((channel - 1) % 2)*8;
+	/*CCER use 4 bits for each channel: CCxE, CCxP, CCxNE, CCxNP*/
+	uint8_t CCERshift = (channel - 1)*4;
+	
+	/*disable channel for configuration*/
+	TIMxPtr->CCER &= ~(0x0F << CCERshift);
+	
+	/*output mode (CCxS = 00), compare mode, compare preload*/
+	*CCMRxPtr &= ~(0xFF << CCMRshift);
+	*CCMRxPtr |= ((OCConfigPtr->mode << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE) << CCMRshift;
+	
+	*TIM_get_CCR_address(TIMxPtr,channel) = OCConfigPtr->compareVal;
+	
+	/*auto-reload preload, so that period and duty cycle change together at update event*/
+	TIMxPtr->CR1 |= TIM_CR1_ARPE;
+	
+	/*polarity and output enable of channel and its complementary output*/
+	uint32_t CCERval = TIM_CCER_CC1E;
+	if(OCConfigPtr->polarity == TIM_OC_POLARITY_LOW){
+		CCERval |= TIM_CCER_CC1P;
+	}
+	if(OCConfigPtr->complementary == ENABLE){
+		CCERval |= TIM_CCER_CC1NE;
+		if(OCConfigPtr->polarity == TIM_OC_POLARITY_LOW){
+			CCERval |= TIM_CCER_CC1NP;
+		}
+	}
+	TIMxPtr->CCER |= CCERval << CCERshift;
+	
+	/*outputs of advanced timers stay disabled until main output is enabled*/
+	if(TIMxPtr == TIM1 || TIMxPtr == TIM8){
+		TIM_main_output_ctr(TIMxPtr,ENABLE);
+	}
+}
+
+/***********************************************************************
+Initialize timer channel as input capture
+***********************************************************************/
+void TIM_IC_init(TIM_TypeDef *TIMxPtr, TIM_IC_Config_t *ICConfigPtr)
+{
+	uint8_t channel = ICConfigPtr->channel;
+	volatile uint32_t *CCMRxPtr = (channel <= TIM_CHANNEL_2) ? &TIMxPtr->CCMR1 : &TIMxPtr->CCMR2;
+	uint8_t CCMRshift = ((channel - 1) % 2)*8;
+	uint8_t CCERshift = (channel - 1)*4;
+	
+	/*disable channel for configuration*/
+	TIMxPtr->CCER &= ~(0x0F << CCERshift);
+	
+	/*input selection, prescaler and filter*/
+	*CCMRxPtr &= ~(0xFF << CCMRshift);
+	*CCMRxPtr |= ((ICConfigPtr->selection << TIM_CCMR1_CC1S_Pos) | (ICConfigPtr->prescaler << TIM_CCMR1_IC1PSC_Pos) 
+								| ((ICConfigPtr->filter & 0x0F) << TIM_CCMR1_IC1F_Pos)) << CCMRshift;
+	
+	/*active edge (CCxP, CCxNP) and capture enable*/
+	TIMxPtr->CCER |= ((ICConfigPtr->polarity << TIM_CCER_CC1P_Pos) | TIM_CCER_CC1E) << CCERshift;
+}
+
+/***********************************************************************
+Set compare value of timer channel
+***********************************************************************/
+void TIM_set_compare_val(TIM_TypeDef *TIMxPtr, uint8_t channel, uint32_t compareVal)
+{
+	*TIM_get_CCR_address(TIMxPtr,channel) = compareVal;
+}
+
+/***********************************************************************
+Get captured value of timer channel
+***********************************************************************/
+uint32_t TIM_get_capture_val(TIM_TypeDef *TIMxPtr, uint8_t channel)
+{
+	return *TIM_get_CCR_address(TIMxPtr,channel);
+}
+
+/***********************************************************************
+Get current counter value
+***********************************************************************/
+uint32_t TIM_get_counter(TIM_TypeDef *TIMxPtr)
+{
+	return TIMxPtr->CNT;
+}
+
+/***********************************************************************
+Config dead-time between complementary outputs
+***********************************************************************/
+void TIM_dead_time_config(TIM_TypeDef *TIMxPtr, uint32_t deadTimeNs)
+{
+	uint32_t ticks = ((uint64_t)RCC_get_TIMCLK_value(APB2)*deadTimeNs)/1000000000;
+	uint8_t DTG;
+	
+	/*DTG encoding: 0xxxxxxx step 1, 10xxxxxx step 2 from 128, 110xxxxx step 8 from 256, 111xxxxx step 16 from 512*/
+	if(ticks < 128){
+		DTG = ticks;
+	}else if(ticks < 256){
+		DTG = 0x80 | ((ticks/2 - 64) & 0x3F);
+	}else if(ticks < 512){
+		DTG = 0xC0 | ((ticks/8 - 32) & 0x1F);
+	}else if(ticks < 1024){
+		DTG = 0xE0 | ((ticks/16 - 32) & 0x1F);
+	}else{
+		DTG = 0xFF;
+	}
+	
+	TIMxPtr->BDTR &= ~TIM_BDTR_DTG;
+	TIMxPtr->BDTR |= DTG << TIM_BDTR_DTG_Pos;
+}
+
+/***********************************************************************
+Enable or disable main output of advanced timers
+***********************************************************************/
+void TIM_main_output_ctr(TIM_TypeDef *TIMxPtr, uint8_t enOrDis)
+{
+	if(enOrDis == ENABLE){
+		TIMxPtr->BDTR |= TIM_BDTR_MOE;
+	}else{
+		TIMxPtr->BDTR &= ~TIM_BDTR_MOE;
+	}
+}
+
+/***********************************************************************
+Enable or disable one pulse mode
+***********************************************************************/
+void TIM_one_pulse_ctr(TIM_TypeDef *TIMxPtr, uint8_t enOrDis)
+{
+	if(enOrDis == ENABLE){
+		TIMxPtr->CR1 |= TIM_CR1_OPM;
+	}else{
+		TIMxPtr->CR1 &= ~TIM_CR1_OPM;
+	}
+}
+
+/***********************************************************************
+Enable or disable capture/compare interrupt of timer channel
+***********************************************************************/
+void TIM_channel_interrupt_ctr(TIM_TypeDef *TIMxPtr, uint8_t channel, uint8_t enOrDis)
+{
+	/*CCxIE is bit x of DIER*/
+	if(enOrDis == ENABLE){
+		TIMxPtr->DIER |= 1 << channel;
+	}else{
+		TIMxPtr->DIER &= ~(1 << channel);
+	}
+}
+
+/***********************************************************************
+Inform application of timer event
+@Note: this is to be define in user application
+***********************************************************************/
+__attribute__((weak)) void TIM_application_event_callback (TIM_TypeDef *TIMxPtr, uint8_t event)
+{
+}
+
+/***********************************************************************
+Get clock frequency of timer counter before prescaler
+***********************************************************************/
+int32_t TIM_get_CLK_value(TIM_TypeDef *TIMxPtr)
+{
+	uint32_t bit;
+	
+	return RCC_get_TIMCLK_value(TIM_get_RCC_bit(TIMxPtr,&bit));
+}
+
+/***********************************************************************
+Config slave mode controller
+***********************************************************************/
+void TIM_slave_mode_config(TIM_TypeDef *TIMxPtr, uint8_t slaveMode, uint8_t trigger)
+{
+	/*trigger must be selected while slave mode is disabled*/
+	TIMxPtr->SMCR &= ~(TIM_SMCR_SMS | TIM_SMCR_TS);
+	TIMxPtr->SMCR |= (trigger & 0x07) << TIM_SMCR_TS_Pos;
+	TIMxPtr->SMCR |= (slaveMode & 0x07) << TIM_SMCR_SMS_Pos;
+}
+
+/***********************************************************************
+Enable or disable DMA request on timer event
+***********************************************************************/
+void TIM_DMA_request_ctr(TIM_TypeDef *TIMxPtr, uint8_t request, uint8_t enOrDis)
+{
+	/*UDE is bit 8 of DIER, CCxDE is bit 8 + x, COMDE bit 13, TDE bit 14*/
+	if(enOrDis == ENABLE){
+		TIMxPtr->DIER |= 1 << (8 + request);
+	}else{
+		TIMxPtr->DIER &= ~(1 << (8 + request));
+	}
+}
+
+/***********************************************************************
+Config DMA burst through DMAR register
+***********************************************************************/
+void TIM_DMA_burst_config(TIM_TypeDef *TIMxPtr, uint8_t baseReg, uint8_t transferNum)
+{
+	TIMxPtr->DCR = ((transferNum - 1) << TIM_DCR_DBL_Pos) | (baseReg << TIM_DCR_DBA_Pos);
+}
+
+/***********************************************************************
+Initialize timer as quadrature encoder interface
+***********************************************************************/
+void TIM_encoder_init(TIM_TypeDef *TIMxPtr, TIM_Encoder_Config_t *encoderConfigPtr)
+{
+	TIM_Config_t TIMConfig = {.reloadVal = encoderConfigPtr->reloadVal,.prescaler = 0};
+	TIM_Handle_t TIMHandle = {TIMxPtr,&TIMConfig};
+	TIM_init(&TIMHandle);
+	
+	/*IC1 mapped on TI1, IC2 mapped on TI2, same filter on both inputs*/
+	uint8_t filter = encoderConfigPtr->filter & 0x0F;
+	TIMxPtr->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP | TIM_CCER_CC2E | TIM_CCER_CC2P | TIM_CCER_CC2NP);
+	TIMxPtr->CCMR1 = (0x01 << TIM_CCMR1_CC1S_Pos) | (filter << TIM_CCMR1_IC1F_Pos) | (0x01 << TIM_CCMR1_CC2S_Pos) | (filter << TIM_CCMR1_IC2F_Pos);
+	
+	/*CCxP invert input, CCxNP must stay 0 in encoder mode*/
+	if(encoderConfigPtr->polarityA == TIM_IC_POLARITY_FALLING){
+		TIMxPtr->CCER |= TIM_CCER_CC1P;
+	}
+	if(encoderConfigPtr->polarityB == TIM_IC_POLARITY_FALLING){
+		TIMxPtr->CCER |= TIM_CCER_CC2P;
+	}
+	
+	TIM_slave_mode_config(TIMxPtr,encoderConfigPtr->mode,0);
+	TIMxPtr->CNT = 0;
+}
+
+/***********************************************************************
+Select timer trigger output (TRGO) source
+***********************************************************************/
+void TIM_master_mode_config(TIM_TypeDef *TIMxPtr, uint8_t masterMode)
+{
+	TIMxPtr->CR2 &= ~TIM_CR2_MMS;
+	TIMxPtr->CR2 |= (masterMode & 0x07) << TIM_CR2_MMS_Pos;
+}
+
+/***********************************************************************
+Private function: get APB bus of timer and position of its clock enable/reset bit
+***********************************************************************/
+static uint8_t TIM_get_RCC_bit(TIM_TypeDef *TIMxPtr, uint32_t *bitPtr)
+{
+	if(TIMxPtr == TIM1){
+		*bitPtr = RCC_APB2ENR_TIM1EN;
+	}else if(TIMxPtr == TIM8){
+		*bitPtr = RCC_APB2ENR_TIM8EN;
+	}else if(TIMxPtr == TIM9){
+		*bitPtr = RCC_APB2ENR_TIM9EN;
+	}else if(TIMxPtr == TIM10){
+		*bitPtr = RCC_APB2ENR_TIM10EN;
+	}else if(TIMxPtr == TIM11){
+		*bitPtr = RCC_APB2ENR_TIM11EN;
+	}else{
+		if(TIMxPtr == TIM2){
+			*bitPtr = RCC_APB1ENR_TIM2EN;
+		}else if(TIMxPtr == TIM3){
+			*bitPtr = RCC_APB1ENR_TIM3EN;
+		}else if(TIMxPtr == TIM4){
+			*bitPtr = RCC_APB1ENR_TIM4EN;
+		}else if(TIMxPtr == TIM5){
+			*bitPtr = RCC_APB1ENR_TIM5EN;
+		}else if(TIMxPtr == TIM6){
+			*bitPtr = RCC_APB1ENR_TIM6EN;
+		}else if(TIMxPtr == TIM7){
+			*bitPtr = RCC_APB1ENR_TIM7EN;
+		}else if(TIMxPtr == TIM12){
+			*bitPtr = RCC_APB1ENR_TIM12EN;
+		}else if(TIMxPtr == TIM13){
+			*bitPtr = RCC_APB1ENR_TIM13EN;
+		}else if(TIMxPtr == TIM14){
+			*bitPtr = RCC_APB1ENR_TIM14EN;
+		}else{
+			*bitPtr = 0;
+		}
+		return APB1;
+	}
+	return APB2;
+}
+
+/***********************************************************************
+Private function: get address of capture/compare register of channel
+***********************************************************************/
+static volatile uint32_t* TIM_get_CCR_address(TIM_TypeDef *TIMxPtr, uint8_t channel)
+{
+	if(channel == TIM_CHANNEL_1){
+		return &TIMxPtr->CCR1;
+	}else if(channel == TIM_CHANNEL_2){
+		return &TIMxPtr->CCR2;
+	}else if(channel == TIM_CHANNEL_3){
+		return &TIMxPtr->CCR3;
+	}
+	return &TIMxPtr->CCR4;
+}
+
+/***********************************************************************
+Private function: record counter frequency of timer, so that its prescaler follow clock changes
+***********************************************************************/
+static void TIM_record_count_freq(TIM_TypeDef *TIMxPtr, uint16_t prescaler)
+{
+	int32_t TIMCLK = TIM_get_CLK_value(TIMxPtr);
+	
+	for(uint8_t i = 0; i < sizeof(TIMTable)/sizeof(TIMTable[0]); i++){
+		if(TIMTable[i] == TIMxPtr){
+			TIMCountFreq[i] = (TIMCLK > 0) ? (uint32_t)TIMCLK/(prescaler + 1) : 0;
+		}
+	}
+	RCC_clock_hook_register(&TIMClockHook,TIM_clock_change,NULL);
+}
+
+/***********************************************************************
+Private function: re-derive prescaler of initialized timers after clock change
+***********************************************************************/
+static void TIM_clock_change(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr)
+{
+	for(uint8_t i = 0; i < sizeof(TIMTable)/sizeof(TIMTable[0]); i++){
+		TIM_TypeDef *TIMxPtr = TIMTable[i];
+		uint32_t bit;
+		int32_t TIMCLK = (TIM_get_RCC_bit(TIMxPtr,&bit) == APB1) ? clockFreqPtr->TIMCLK1 : clockFreqPtr->TIMCLK2;
+		
+		if(!TIMCountFreq[i] || TIMCLK <= 0){
+			continue;
+		}
+		
+		/*counter frequency is kept exactly when new timer clock is a multiple of it, otherwise nearest one is used*/
+		uint32_t division = ((uint32_t)TIMCLK + TIMCountFreq[i]/2)/TIMCountFreq[i];
+		uint32_t prescaler = division ? division - 1 : 0;
+		if(prescaler > 0xFFFF){
+			prescaler = 0xFFFF;
+		}
+		if(prescaler == TIMxPtr->PSC){
+			continue;
+		}
+		
+		/*update generation load prescaler at once (without interrupt nor DMA request since URS is set) but clear counter,
+		so counter is put back and period in progress go on*/
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		uint32_t CR1Val = TIMxPtr->CR1;
+		uint32_t counter = TIMxPtr->CNT;
+		TIMxPtr->CR1 = CR1Val | TIM_CR1_URS;
+		TIMxPtr->PSC = prescaler;
+		TIMxPtr->EGR = TIM_EGR_UG;
+		TIMxPtr->CNT = counter;
+		TIMxPtr->CR1 = CR1Val;
+		__set_PRIMASK(primask);
+	}
+}
@@ -10,14 +10,17 @@
 
 #include "../inc/stm32f407xx_uart.h"
 
-extern uint32_t RCC_get_PCLK_value(uint8_t APBx);
-extern uint32_t RCC_get_PLL_output (void);
 
 static uint8_t USARTDIV_fractional_part_calc (uint32_t periphCLK, uint32_t baudRate);
 static uint16_t USARTDIV_integer_part_calc (uint32_t periphCLK, uint32_t baudRate);
-static void UART_pins_pack_1_gpio_init(USART_TypeDef *UARTxPtr);
-static void UART_pins_pack_2_gpio_init(USART_TypeDef *UARTxPtr);
-static void UART_pins_pack_3_gpio_init(USART_TypeDef *UARTxPtr);
+static int8_t UART_pins_pack_gpio_init(USART_TypeDef *UARTxPtr, UART_Pins_pack_t pinsPack);
+static void UART_set_baud_rate(USART_TypeDef *UARTxPtr, uint32_t baudRate);
+static void UART_clock_change(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr);
+
+/*baud rate set by UART_init on each UART (0 if not initialized), BRR is re-derived from it after clock change*/
+static USART_TypeDef * const UARTTable[] = {USART1,USART2,USART3,UART4,UART5,USART6};
+static uint32_t UARTBaudRate[sizeof(UARTTable)/sizeof(UARTTable[0])];
+static RCC_Clock_hook_t UARTClockHook;
 
 /***********************************************************************
 UART clock enable/disable
@@ -131,17 +134,15 @@ void UART_init(UART_Handle_t *UARTxHandlePtr)
 	UARTxHandlePtr->UARTxPtr->CR2 &= ~(USART_CR2_STOP);
 	UARTxHandlePtr->UARTxPtr->CR2 |= option<<USART_CR2_STOP_Pos;
 	
-	/*config baudrate*/
+	/*config baudrate, it is kept across clock changes*/
 	uint32_t baudRate = UARTxHandlePtr->UARTxConfigPtr->baudRate;
-	uint32_t periphCLK = 0;
-	if(UARTxHandlePtr->UARTxPtr == USART1 || UARTxHandlePtr->UARTxPtr == USART6){
-		periphCLK = RCC_get_PCLK_value(APB2);
-	}else if(UARTxHandlePtr->UARTxPtr == USART2 ||UARTxHandlePtr->UARTxPtr == USART3 || UARTxHandlePtr->UARTxPtr == UART4 || UARTxHandlePtr->UARTxPtr == UART5){
-		periphCLK = RCC_get_PCLK_value(APB1);
+	UART_set_baud_rate(UARTxHandlePtr->UARTxPtr,baudRate);
+	for(uint8_t i = 0; i < sizeof(UARTTable)/sizeof(UARTTable[0]); i++){
+		if(UARTTable[i] == UARTxHandlePtr->UARTxPtr){
+			UARTBaudRate[i] = baudRate;
+		}
 	}
-	UARTxHandlePtr->UARTxPtr->BRR = 0;
-	UARTxHandlePtr->UARTxPtr->BRR |= USARTDIV_integer_part_calc(periphCLK,baudRate)<<USART_BRR_DIV_Mantissa_Pos;
-	UARTxHandlePtr->UARTxPtr->BRR |= USARTDIV_fractional_part_calc(periphCLK,baudRate)<<USART_BRR_DIV_Fraction_Pos;
+	RCC_clock_hook_register(&UARTClockHook,UART_clock_change,NULL);
 	
 	/*enable UART peripheral*/
 	UART_periph_ctr(UARTxHandlePtr->UARTxPtr,ENABLE);
@@ -152,12 +153,9 @@ Initialize UART peripheral and initialize corresponding GPIO pins as UART functi
 ***********************************************************************/
 UART_Handle_t* UART_general_init(USART_TypeDef *UARTxPtr, UART_Pins_pack_t pinsPack, uint32_t baudRate, uint8_t stopBit, uint8_t wordLength, uint8_t mode, uint8_t parityCtrl, uint8_t flowCtrl)
 {
-	if(pinsPack == UART_pins_pack_1){
-		UART_pins_pack_1_gpio_init(UARTxPtr);
-	}else if(pinsPack == UART_pins_pack_2){
-		UART_pins_pack_2_gpio_init(UARTxPtr);
-	}else if(pinsPack == UART_pins_pack_3){
-		UART_pins_pack_3_gpio_init(UARTxPtr);
+	/*pins already used by another pins pack are not touched*/
+	if(UART_pins_pack_gpio_init(UARTxPtr,pinsPack) < 0){
+		return NULL;
 	}
 	
 	static UART_Handle_t UARTxHandle;
@@ -202,6 +200,13 @@ void UART_deinit(USART_TypeDef *UARTxPtr)
 		RCC->APB2RSTR |= RCC_APB2RSTR_USART6RST;
 		RCC->AHB2RSTR &= ~(RCC_APB2RSTR_USART6RST);	
 	}
+	
+	/*reset UART is no longer re-timed after clock change*/
+	for(uint8_t i = 0; i < sizeof(UARTTable)/sizeof(UARTTable[0]); i++){
+		if(UARTTable[i] == UARTxPtr){
+			UARTBaudRate[i] = 0;
+		}
+	}
 }
 
 /***********************************************************************
@@ -279,6 +284,7 @@ uint8_t UART_send_intrpt (UART_Handle_t *UARTxHandlePtr, uint8_t *txBufferPtr,ui
 		UARTxHandlePtr->txBufferPtr = txBufferPtr;
 		UARTxHandlePtr->txLength = Length;
 		UARTxHandlePtr->txState = UART_STATE_TX_BUSY;
+		PWR_stop_lock(PWR_LOCK_UART);
 		UARTxHandlePtr->UARTxPtr->SR &= ~USART_SR_TC;
 		UARTxHandlePtr->UARTxPtr->CR1 |= USART_CR1_TXEIE;
 		UARTxHandlePtr->UARTxPtr->CR1 |= USART_CR1_TCIE;
@@ -298,6 +304,7 @@ uint8_t UART_receive_intrpt (UART_Handle_t *UARTxHandlePtr, uint8_t *rxBufferPtr
 		UARTxHandlePtr->rxBufferPtr = rxBufferPtr;
 		UARTxHandlePtr->rxLength = Length;
 		UARTxHandlePtr->rxState = UART_STATE_RX_BUSY;
+		PWR_stop_lock(PWR_LOCK_UART);
 		UARTxHandlePtr->UARTxPtr->CR1 |= USART_CR1_RXNEIE;
 		UARTxHandlePtr->UARTxPtr->CR3 |= USART_CR3_CTSIE;
 		UARTxHandlePtr->UARTxPtr->CR1 |= USART_CR1_PEIE;
@@ -348,7 +355,7 @@ void UART_intrpt_priority_config(uint8_t IRQnumber, uint8_t priority)
 /***********************************************************************
 UART interrupt handler 
 ***********************************************************************/
-void UART_intrpt_handler (UART_Handle_t *UARTxHandlePtr)
+RAM_FUNC void UART_intrpt_handler (UART_Handle_t *UARTxHandlePtr)
 {
 	uint8_t check1 = UARTxHandlePtr->UARTxPtr->SR & USART_SR_TXE;
 	uint8_t check2 = UARTxHandlePtr->UARTxPtr->CR1 & USART_CR1_TXEIE;
@@ -432,6 +439,9 @@ void UART_intrpt_handler (UART_Handle_t *UARTxHandlePtr)
 close transmission
 ***********************************************************************/
 void UART_close_send_data(UART_Handle_t *UARTxHandlePtr){
+		if(UARTxHandlePtr->txState != UART_STATE_READY){
+			PWR_stop_unlock(PWR_LOCK_UART);
+		}
 		UARTxHandlePtr->txBufferPtr = NULL;
 		UARTxHandlePtr->txLength = 0;
 		UARTxHandlePtr->txState = UART_STATE_READY;
@@ -443,6 +453,9 @@ void UART_close_send_data(UART_Handle_t *UARTxHandlePtr){
 close reception
 ***********************************************************************/
 void UART_close_receive_data(UART_Handle_t *UARTxHandlePtr){
+		if(UARTxHandlePtr->rxState != UART_STATE_READY){
+			PWR_stop_unlock(PWR_LOCK_UART);
+		}
 		UARTxHandlePtr->rxBufferPtr = NULL;
 		UARTxHandlePtr->rxLength = 0;
 		UARTxHandlePtr->rxState = UART_STATE_READY;
@@ -477,62 +490,127 @@ static uint8_t USARTDIV_fractional_part_calc (uint32_t periphCLK, uint32_t baudR
 	return fractionalVal;
 }
 
+/*pins pack tables: TX, RX in open drain alternate function mode with pull up*/
+#define USART1_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART2_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART3_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define UART4_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_0,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_1,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define UART5_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART6_PACK_1_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART1_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_B,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART2_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART3_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define UART4_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART6_PACK_2_PINS(X,port) \
+	X(port,GPIO_PORT_G,GPIO_PIN_NO_14,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_G,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+#define USART3_PACK_3_PINS(X,port) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_8,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7)
+
+static const GPIO_Port_table_t USART1Pack1Table[] = {GPIO_PORT_TABLE(USART1_PACK_1_PINS,GPIO_PORT_A)};
+static const GPIO_Port_table_t USART2Pack1Table[] = {GPIO_PORT_TABLE(USART2_PACK_1_PINS,GPIO_PORT_A)};
+static const GPIO_Port_table_t USART3Pack1Table[] = {GPIO_PORT_TABLE(USART3_PACK_1_PINS,GPIO_PORT_B)};
+static const GPIO_Port_table_t UART4Pack1Table[] = {GPIO_PORT_TABLE(UART4_PACK_1_PINS,GPIO_PORT_A)};
+static const GPIO_Port_table_t UART5Pack1Table[] = {GPIO_PORT_TABLE(UART5_PACK_1_PINS,GPIO_PORT_C), GPIO_PORT_TABLE(UART5_PACK_1_PINS,GPIO_PORT_D)};
+static const GPIO_Port_table_t USART6Pack1Table[] = {GPIO_PORT_TABLE(USART6_PACK_1_PINS,GPIO_PORT_C)};
+static const GPIO_Port_table_t USART1Pack2Table[] = {GPIO_PORT_TABLE(USART1_PACK_2_PINS,GPIO_PORT_B)};
+static const GPIO_Port_table_t USART2Pack2Table[] = {GPIO_PORT_TABLE(USART2_PACK_2_PINS,GPIO_PORT_D)};
+static const GPIO_Port_table_t USART3Pack2Table[] = {GPIO_PORT_TABLE(USART3_PACK_2_PINS,GPIO_PORT_C)};
+static const GPIO_Port_table_t UART4Pack2Table[] = {GPIO_PORT_TABLE(UART4_PACK_2_PINS,GPIO_PORT_C)};
+static const GPIO_Port_table_t USART6Pack2Table[] = {GPIO_PORT_TABLE(USART6_PACK_2_PINS,GPIO_PORT_G)};
+static const GPIO_Port_table_t USART3Pack3Table[] = {GPIO_PORT_TABLE(USART3_PACK_3_PINS,GPIO_PORT_D)};
+
 /***********************************************************************
-Private function: Initialize GPIO pin as UART function (for pins pack 1) 
+Private function: Initialize GPIO pins of pins pack as UART function
 ***********************************************************************/
-static void UART_pins_pack_1_gpio_init(USART_TypeDef *UARTxPtr)
+static int8_t UART_pins_pack_gpio_init(USART_TypeDef *UARTxPtr, UART_Pins_pack_t pinsPack)
 {
-	if(UARTxPtr == USART1){
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-	}else if (UARTxPtr == USART2){
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_3,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);	
-	}else if (UARTxPtr == USART3){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}else if (UARTxPtr == UART4){
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_0,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOA,GPIO_PIN_NO_1,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}else if (UARTxPtr == UART5){
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOD,GPIO_PIN_NO_2,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}else if (UARTxPtr == USART6){
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}	
+	const GPIO_Port_table_t *tablePtr = NULL;
+	uint8_t portNum = 1;
+
+	if(pinsPack == UART_pins_pack_1){
+		if(UARTxPtr == USART1){
+			tablePtr = USART1Pack1Table;
+		}else if(UARTxPtr == USART2){
+			tablePtr = USART2Pack1Table;
+		}else if(UARTxPtr == USART3){
+			tablePtr = USART3Pack1Table;
+		}else if(UARTxPtr == UART4){
+			tablePtr = UART4Pack1Table;
+		}else if(UARTxPtr == UART5){
+			tablePtr = UART5Pack1Table;
+			portNum = 2;
+		}else if(UARTxPtr == USART6){
+			tablePtr = USART6Pack1Table;
+		}
+	}else if(pinsPack == UART_pins_pack_2){
+		if(UARTxPtr == USART1){
+			tablePtr = USART1Pack2Table;
+		}else if(UARTxPtr == USART2){
+			tablePtr = USART2Pack2Table;
+		}else if(UARTxPtr == USART3){
+			tablePtr = USART3Pack2Table;
+		}else if(UARTxPtr == UART4){
+			tablePtr = UART4Pack2Table;
+		}else if(UARTxPtr == USART6){
+			tablePtr = USART6Pack2Table;
+		}
+	}else if(pinsPack == UART_pins_pack_3){
+		if(UARTxPtr == USART3){
+			tablePtr = USART3Pack3Table;
+		}
+	}
+
+	if(tablePtr == NULL){
+		return 0;
+	}
+	return GPIO_table_apply(tablePtr,portNum,NULL);
 }
 
 /***********************************************************************
-Private function: Initialize GPIO pin as UART function (for pins pack 2) 
+Private function: program BRR from current APB clock
 ***********************************************************************/
-static void UART_pins_pack_2_gpio_init(USART_TypeDef *UARTxPtr)
+static void UART_set_baud_rate(USART_TypeDef *UARTxPtr, uint32_t baudRate)
 {
-	if(UARTxPtr == USART1){
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOB,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-	}else if (UARTxPtr == USART2){
-		GPIO_init_direct(GPIOD,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOD,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);	
-	}else if (UARTxPtr == USART3){
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}else if (UARTxPtr == UART4){
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_10,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOC,GPIO_PIN_NO_11,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);			
-	}else if (UARTxPtr == USART6){
-		GPIO_init_direct(GPIOG,GPIO_PIN_NO_14,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOG,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);		
-	}	
+	uint32_t periphCLK = 0;
+	if(UARTxPtr == USART1 || UARTxPtr == USART6){
+		periphCLK = RCC_get_PCLK_value(APB2);
+	}else if(UARTxPtr == USART2 ||UARTxPtr == USART3 || UARTxPtr == UART4 || UARTxPtr == UART5){
+		periphCLK = RCC_get_PCLK_value(APB1);
+	}
+	UARTxPtr->BRR = (USARTDIV_integer_part_calc(periphCLK,baudRate)<<USART_BRR_DIV_Mantissa_Pos)
+									| (USARTDIV_fractional_part_calc(periphCLK,baudRate)<<USART_BRR_DIV_Fraction_Pos);
 }
 
 /***********************************************************************
-Private function: Initialize GPIO pin as UART function (for pins pack 3) 
+Private function: re-derive BRR of initialized UARTs after clock change
 ***********************************************************************/
-static void UART_pins_pack_3_gpio_init(USART_TypeDef *UARTxPtr)
+static void UART_clock_change(const RCC_Clock_freq_t *clockFreqPtr, void *argPtr)
 {
-	if(UARTxPtr == USART3){
-		GPIO_init_direct(GPIOD,GPIO_PIN_NO_8,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
-		GPIO_init_direct(GPIOD,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_OD,GPIO_PU,7);
+	for(uint8_t i = 0; i < sizeof(UARTTable)/sizeof(UARTTable[0]); i++){
+		if(UARTBaudRate[i]){
+			UART_set_baud_rate(UARTTable[i],UARTBaudRate[i]);
+		}
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,69 @@
+/**
+*@brief test debouncing button service
+*
+*User button (PA0, active high) generate repeat events while held: each press or repeat step a counter shown in binary on green, orange and red leds.
+*An external button on PD5 (active low) toggle blue led on release and clear counter on long-press.
+*Purpose is to test button service APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*User_button PA0
+*External_button PD5 (to ground)
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+#define USER_BUTTON 0
+#define EXTERNAL_BUTTON 1
+#define COUNTER_MASK ((1<<GPIO_PIN_NO_12) | (1<<GPIO_PIN_NO_13) | (1<<GPIO_PIN_NO_14))
+
+const Button_Config_t buttons[] = {
+	{GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR,SET,BUTTON_HOLD_REPEAT},
+	{GPIOD,GPIO_PIN_NO_5,GPIO_PU,CLEAR,BUTTON_HOLD_LONG_PRESS},
+};
+
+int main (void)
+{
+	uint8_t counter = 0;
+	uint8_t skipRelease = 0;
+	Button_Event_t event;
+
+	for(uint8_t pin = GPIO_PIN_NO_12; pin <= GPIO_PIN_NO_15; pin++){
+		led_init(GPIOD,pin);
+	}
+	SWTIM_init();
+	button_service_init(buttons,sizeof(buttons)/sizeof(buttons[0]));
+
+	while(1){
+		while(button_get_event(&event)){
+			if(event.button == USER_BUTTON){
+				if(event.event == BUTTON_EV_PRESS || event.event == BUTTON_EV_REPEAT){
+					counter++;
+				}
+			}else if(event.event == BUTTON_EV_LONG_PRESS){
+				counter = 0;
+				skipRelease = 1;
+			}else if(event.event == BUTTON_EV_RELEASE){
+				/*release which end a long-press does not toggle*/
+				if(!skipRelease){
+					led_toggle(GPIOD,GPIO_PIN_NO_15);
+				}
+				skipRelease = 0;
+			}
+			GPIO_write_masked(GPIOD,COUNTER_MASK,(counter & 0x07)<<GPIO_PIN_NO_12);
+		}
+	}
+}
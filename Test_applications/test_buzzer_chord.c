@@ -0,0 +1,58 @@
+/**
+*@file test_buzzer_chord.c
+*@brief test DDS engine of buzzer driver by playing chords and frequency sweeps
+*
+*This program play a C major chord (3 voices mixed together), then sweep a siren tone up and down, using developed driver for buzzer (see buzzer.h for details).
+*Purpose is to test multi-voice mixing and frequency sweep of buzzer driver.
+*Oscilloscope is used to monitor DAC channel 2 output.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*DAC_channel_2 PA5
+*Green_led PD12
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+#include "../Device_drivers/inc/buzzer.h"
+
+int main (void)
+{
+	/*initilize led on PD12*/
+	led_init(GPIOD,GPIO_PIN_NO_12);
+
+	/*initilize user button on PA0*/
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	buzzer_init(DAC_CHANNEL_2);
+
+	while(1){
+		if(button_read(GPIOA,GPIO_PIN_NO_0)){
+			led_on(GPIOD,GPIO_PIN_NO_12);
+
+			/*C major chord: C5, E5, G5*/
+			buzzer_voice_set(0,523,BUZZER_VOLUME_MAX);
+			buzzer_voice_set(1,659,BUZZER_VOLUME_MAX);
+			buzzer_voice_set(2,784,BUZZER_VOLUME_MAX);
+			buzzer_wait(1000);
+			buzzer_stop_sound();
+
+			/*siren: sweep 600 Hz to 1200 Hz and back*/
+			buzzer_voice_sweep(0,600,1200,500,BUZZER_VOLUME_MAX);
+			buzzer_wait(500);
+			buzzer_voice_sweep(0,1200,600,500,BUZZER_VOLUME_MAX);
+			buzzer_wait(500);
+			buzzer_stop_sound();
+		}else{
+			led_off(GPIOD,GPIO_PIN_NO_12);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+/**
+*@file test_buzzer_melody.c
+*@brief test melody sequencer of buzzer driver
+*
+*This program queue an alarm melody on buzzer sequencer and keep blinking a led while melody is played in background, using developed driver for buzzer (see buzzer.h for details).
+*Purpose is to test that melody is played without blocking CPU, note envelope and sequence completion callback.
+*Oscilloscope is used to monitor DAC channel 2 output.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*DAC_channel_2 PA5
+*Green_led PD12
+*Orange_led PD13
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+#include "../Device_drivers/inc/buzzer.h"
+
+/*alarm melody: {freq, duration, rest, volume, attack, release}*/
+static const Buzzer_Note_t alarmMelody[] = {
+	{880,150,50,BUZZER_VOLUME_MAX,5,20},
+	{1175,150,50,BUZZER_VOLUME_MAX,5,20},
+	{880,150,50,BUZZER_VOLUME_MAX,5,20},
+	{1175,300,300,BUZZER_VOLUME_MAX,5,100},
+};
+
+static volatile uint8_t passCount = 0;
+
+void delay (void);
+
+int main (void)
+{
+	/*initilize leds on PD12 and PD13*/
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	led_init(GPIOD,GPIO_PIN_NO_13);
+
+	/*initilize user button on PA0*/
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	buzzer_init(DAC_CHANNEL_2);
+
+	while(1){
+		/*start alarm once button is pressed, alarm is stopped after 3 passes*/
+		if(button_read(GPIOA,GPIO_PIN_NO_0) && !buzzer_sequence_busy()){
+			passCount = 0;
+			buzzer_sequence_play(alarmMelody,sizeof(alarmMelody)/sizeof(alarmMelody[0]),ENABLE);
+		}
+		if(passCount >= 3){
+			buzzer_sequence_stop();
+			passCount = 0;
+		}
+
+		/*CPU is free while melody is played*/
+		led_toggle(GPIOD,GPIO_PIN_NO_12);
+		delay();
+	}
+}
+
+void buzzer_application_event_callback (const Buzzer_Note_t *notesPtr, uint8_t event)
+{
+	if(event == BUZZER_EV_SEQUENCE_CMPLT){
+		passCount++;
+		led_toggle(GPIOD,GPIO_PIN_NO_13);
+	}
+}
+
+void delay (void)
+{
+	for(uint32_t i = 0; i < 500000; i++);
+}
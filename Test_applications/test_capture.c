@@ -0,0 +1,107 @@
+/**
+*@brief test frequency and duty cycle measurement
+*
+*This generate 25 kHz PWM with 30% duty cycle on TIM4 channel 1 (PD12), which is wired to TIM3 channel 1 (PA6) and TIM9 channel 1 (PE5).
+*TIM3 measure signal in DMA mode, TIM9 measure signal in interrupt mode, statistics of both are computed every 100ms
+*and watched in debugger (expected: frequency 25000 Hz, period 40000 ns, duty cycle 3000).
+*Orange led (PD13) is on while TIM3 result is correct, red led (PD14) is on while TIM9 result is correct.
+*Purpose is to test capture APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*TIM4_CH1 PD12
+*TIM3_CH1 PA6 (connect to PD12)
+*TIM9_CH1 PE5 (connect to PD12)
+*Orange_led PD13
+*Red_led PD14
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_capture.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Device_drivers/inc/led.h"
+
+#define SIGNAL_FREQ 25000
+#define SIGNAL_DUTY 30	/*in %*/
+#define SAMPLE_NUM 4096	/*more than one 100ms window at 25 kHz*/
+
+uint32_t TIM3Buffer[CAPTURE_BUFFER_SIZE(SAMPLE_NUM)];
+uint32_t TIM9Buffer[CAPTURE_BUFFER_SIZE(SAMPLE_NUM)];
+
+CAPTURE_Config_t TIM3CaptureConfig = {.inputChannel = TIM_CHANNEL_1,.activeEdge = TIM_IC_POLARITY_RISING,.filter = 0,
+																			.countFreq = 16000000,.mode = CAPTURE_MODE_DMA,.bufferPtr = TIM3Buffer,.sampleNum = SAMPLE_NUM};
+CAPTURE_Config_t TIM9CaptureConfig = {.inputChannel = TIM_CHANNEL_1,.activeEdge = TIM_IC_POLARITY_RISING,.filter = 0,
+																			.countFreq = 16000000,.mode = CAPTURE_MODE_INTRPT,.bufferPtr = TIM9Buffer,.sampleNum = SAMPLE_NUM};
+CAPTURE_Handle_t TIM3CaptureHandle = {.TIMxPtr = TIM3,.CAPTUREConfigPtr = &TIM3CaptureConfig};
+CAPTURE_Handle_t TIM9CaptureHandle = {.TIMxPtr = TIM9,.CAPTUREConfigPtr = &TIM9CaptureConfig};
+
+CAPTURE_Stats_t TIM3Stats;
+CAPTURE_Stats_t TIM9Stats;
+
+void signal_init (void)
+{
+	uint32_t reloadVal = RCC_get_TIMCLK_value(APB1)/SIGNAL_FREQ - 1;
+	TIM_Config_t TIM4Config = {.reloadVal = reloadVal,.prescaler = 0};
+	TIM_Handle_t TIM4Handle = {TIM4,&TIM4Config};
+	TIM_init(&TIM4Handle);
+
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_PWM1,.compareVal = (reloadVal + 1)*SIGNAL_DUTY/100,
+															.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	TIM_OC_init(TIM4,&OCConfig);
+	TIM_ctr(TIM4,START);
+}
+
+uint8_t stats_check (CAPTURE_Stats_t *statsPtr)
+{
+	return statsPtr->sampleCount && !statsPtr->error && statsPtr->frequency == SIGNAL_FREQ
+				&& statsPtr->dutyAvg >= SIGNAL_DUTY*100 - 10 && statsPtr->dutyAvg <= SIGNAL_DUTY*100 + 10;
+}
+
+int main (void)
+{
+	/*TIM4 and TIM3 on AF2, TIM9 on AF3*/
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	GPIO_init_direct(GPIOE,GPIO_PIN_NO_5,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,3);
+	led_init(GPIOD,GPIO_PIN_NO_13);
+	led_init(GPIOD,GPIO_PIN_NO_14);
+	TIME_init();
+
+	signal_init();
+
+	CAPTURE_init(&TIM3CaptureHandle);
+	CAPTURE_init(&TIM9CaptureHandle);
+	TIM_intrpt_vector_ctr(IRQ_TIM1_BRK_TIM9,ENABLE);
+	CAPTURE_start(&TIM3CaptureHandle);
+	CAPTURE_start(&TIM9CaptureHandle);
+
+	while(1){
+		TIME_delay_ms(100);
+		CAPTURE_get_stats(&TIM3CaptureHandle,&TIM3Stats);
+		CAPTURE_get_stats(&TIM9CaptureHandle,&TIM9Stats);
+
+		if(stats_check(&TIM3Stats)){
+			led_on(GPIOD,GPIO_PIN_NO_13);
+		}else{
+			led_off(GPIOD,GPIO_PIN_NO_13);
+		}
+		if(stats_check(&TIM9Stats)){
+			led_on(GPIOD,GPIO_PIN_NO_14);
+		}else{
+			led_off(GPIOD,GPIO_PIN_NO_14);
+		}
+	}
+}
+
+void TIM1_BRK_TIM9_IRQHandler (void)
+{
+	CAPTURE_intrpt_handler(&TIM9CaptureHandle);
+}
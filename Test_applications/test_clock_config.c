@@ -0,0 +1,63 @@
+/**
+*@brief test clock tree configurator
+*
+*Each press of user button switch to next system clock of a list (168, 120, 100, 84 MHz from HSE, 16 MHz HSI), PLL factors are solved at run time.
+*SYSCLK/5 is output on MCO2 (PC9) to be checked with an oscilloscope or frequency counter, green led blink from a busy loop so that
+*its rate follow system clock, red led is turned on if a requirement has no exact solution.
+*Purpose is to test RCC clock configurator APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*MCO2 PC9
+*User_button PA0
+*Green_led PD12
+*Red_led PD14
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+const RCC_Clock_config_t clockList[] = {
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 168000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 120000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 100000000,.PLL48Clock = DISABLE},
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 84000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSI,.SYSCLKFreq = 16000000,.PLL48Clock = DISABLE},
+};
+
+int main (void)
+{
+	uint8_t clockIndex = 0;
+	uint8_t lastButton = 0;
+
+	RCC_MCO2_config(RCC_MCO2_SYSCLK,RCC_MCO_DIV5);
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	led_init(GPIOD,GPIO_PIN_NO_14);
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	if(RCC_clock_config(&clockList[clockIndex]) == -1){
+		led_on(GPIOD,GPIO_PIN_NO_14);
+	}
+
+	while(1){
+		for(volatile uint32_t i = 0; i < 2000000; i++);
+		led_toggle(GPIOD,GPIO_PIN_NO_12);
+
+		uint8_t button = button_read(GPIOA,GPIO_PIN_NO_0);
+		if(button && !lastButton){
+			clockIndex = (clockIndex + 1) % (sizeof(clockList)/sizeof(clockList[0]));
+			if(RCC_clock_config(&clockList[clockIndex]) == -1){
+				led_on(GPIOD,GPIO_PIN_NO_14);
+			}
+		}
+		lastButton = button;
+	}
+}
@@ -0,0 +1,84 @@
+/**
+*@brief test measurement of internal clocks and HSE calibration
+*
+*While system clock is still HSI (reset state), LSI and HSE are measured against HSI (HSE must be close to 8 MHz, within HSI accuracy).
+*System clock is then set to 168 MHz from HSE, LSE (32.768 kHz crystal, X3 footprint of discovery board) is started,
+*and every 2 seconds HSE is calibrated against LSE: HSE error in ppm is reported and UART baud rate is compensated.
+*USART2 report results at 921600 baud, where a crystal error of a few hundred ppm already eat part of receiver margin.
+*Without LSE crystal, only LSI and HSE measurements are reported.
+*Purpose is to test clock measure APIs and RCC_set_HSE_freq.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_clock_measure.h"
+
+#define LSE_STARTUP_US 3000000
+
+UART_Handle_t *UART2HandlePtr;
+char msg[128];
+
+void report_measure (const char *name, int8_t status, const CLOCK_Measure_t *measurePtr)
+{
+	if(status == -1){
+		sprintf(msg,"%s: measurement failed\r\n",name);
+	}else{
+		sprintf(msg,"%s: %lu Hz (%ld ppm, %lu captures)\r\n",name,(unsigned long)measurePtr->frequency,
+						(long)measurePtr->errorPpm,(unsigned long)measurePtr->captureNum);
+	}
+	UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+}
+
+int main (void)
+{
+	CLOCK_Measure_t LSIMeasure, HSEMeasure, LSEMeasure;
+	int8_t LSIStatus, HSEStatus, LSEStatus;
+	int32_t errorPpm;
+
+	/*HSE must be running but not used by system clock*/
+	RCC->CR |= RCC_CR_HSEON;
+	while(!(RCC->CR & RCC_CR_HSERDY));
+	LSIStatus = CLOCK_measure(CLOCK_SRC_LSI,500,&LSIMeasure);
+	HSEStatus = CLOCK_measure(CLOCK_SRC_HSE,500,&HSEMeasure);
+
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	TIME_init();
+	UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_921600,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+	report_measure("LSI",LSIStatus,&LSIMeasure);
+	report_measure("HSE (against HSI)",HSEStatus,&HSEMeasure);
+
+	/*LSE is in backup domain*/
+	RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+	PWR->CR |= PWR_CR_DBP;
+	RCC->BDCR |= RCC_BDCR_LSEON;
+	uint64_t startUs = TIME_get_us();
+	while(!(RCC->BDCR & RCC_BDCR_LSERDY) && !TIME_is_timeout(startUs,LSE_STARTUP_US));
+
+	while(1){
+		LSEStatus = CLOCK_measure(CLOCK_SRC_LSE,1000,&LSEMeasure);
+		report_measure("LSE (against HSE)",LSEStatus,&LSEMeasure);
+
+		if(CLOCK_calibrate_HSE(1000,&errorPpm) == -1){
+			sprintf(msg,"HSE calibration failed\r\n");
+		}else{
+			sprintf(msg,"HSE %lu Hz (%ld ppm), SYSCLK %ld, PCLK1 %ld\r\n",(unsigned long)RCC_get_HSE_freq(),(long)errorPpm,
+							(long)RCC_get_clock_freq()->SYSCLK,(long)RCC_get_clock_freq()->PCLK1);
+		}
+		UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+		TIME_delay_ms(2000);
+	}
+}
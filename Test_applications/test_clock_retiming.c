@@ -0,0 +1,88 @@
+/**
+*@brief test re-timing of peripheral drivers after system clock change
+*
+*USART2 send a line with current clock values every second at 115200 baud, TIM4 channel 1 (green led) toggle every second in output compare mode.
+*Each press of user button switch system clock between 168, 84 MHz (PLL) and 16 MHz (HSI): terminal output must stay readable
+*and led period must stay 2 s, since UART baud rate and timer prescaler are re-derived by RCC clock hooks.
+*An application hook count clock changes, count is printed with clock values.
+*Purpose is to test RCC clock snapshot and hook APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*User_button PA0
+*TIM4_CH1 (green led) PD12
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Device_drivers/inc/button.h"
+
+const RCC_Clock_config_t clockList[] = {
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 168000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSE,.SYSCLKFreq = 84000000,.PLL48Clock = ENABLE},
+	{.oscillator = RCC_OSC_HSI,.SYSCLKFreq = 16000000,.PLL48Clock = DISABLE},
+};
+
+RCC_Clock_hook_t appClockHook;
+volatile uint32_t clockChangeNum = 0;
+
+void app_clock_change (const RCC_Clock_freq_t *clockFreqPtr, void *argPtr)
+{
+	clockChangeNum++;
+}
+
+int main (void)
+{
+	uint8_t clockIndex = 0;
+	uint8_t lastButton = 0;
+	uint64_t lastPrint = 0;
+	char msg[96];
+
+	RCC_clock_hook_register(&appClockHook,app_clock_change,NULL);
+	TIME_init();
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+
+	/*TIM4 count at 10 kHz, channel 1 toggle when counter reach 0, every second*/
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	TIM_Config_t TIM4Config = {.reloadVal = 9999,.prescaler = RCC_get_TIMCLK_value(APB1)/10000 - 1};
+	TIM_Handle_t TIM4Handle = {TIM4,&TIM4Config};
+	TIM_init(&TIM4Handle);
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_TOGGLE,.compareVal = 0,
+															.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	TIM_OC_init(TIM4,&OCConfig);
+	TIM_ctr(TIM4,START);
+
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	while(1){
+		if(TIME_is_timeout(lastPrint,1000000)){
+			lastPrint = TIME_get_us();
+			const RCC_Clock_freq_t *clockFreqPtr = RCC_get_clock_freq();
+			sprintf(msg,"SYSCLK %ld HCLK %ld PCLK1 %ld PCLK2 %ld changes %lu\r\n",(long)clockFreqPtr->SYSCLK,(long)clockFreqPtr->HCLK,
+							(long)clockFreqPtr->PCLK1,(long)clockFreqPtr->PCLK2,(unsigned long)clockChangeNum);
+			UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+		}
+
+		uint8_t button = button_read(GPIOA,GPIO_PIN_NO_0);
+		if(button && !lastButton){
+			/*wait for last byte to leave shift register before baud rate change*/
+			while(!(USART2->SR & USART_SR_TC));
+			RCC_clock_config(&clockList[clockIndex]);
+			clockIndex = (clockIndex + 1) % (sizeof(clockList)/sizeof(clockList[0]));
+		}
+		lastButton = button;
+	}
+}
@@ -0,0 +1,119 @@
+/**
+*@brief test PCM streaming APIs of STM32F4xx DAC driver
+*
+*This stream a stored 8 bits voice prompt (mono) on both DAC channels at 8 kHz, using dual channel mode (stereo):
+*channel 1 (PA4) play the prompt, channel 2 (PA5) play the same prompt inverted.
+*Prompt is copied into a ping-pong buffer from DAC_application_event_callback, one half at a time, so CPU budget is fixed per block.
+*Oscilloscope is used to monitor both DAC outputs.
+*Purpose of this program is to confirm correctness of DAC PCM streaming APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*DAC_channel_1 PA4
+*DAC_channel_2 PA5
+*Green_led PD12
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_dac.h"
+#include "../Device_drivers/inc/led.h"
+
+#define SAMPLE_RATE 8000
+#define BLOCK_SIZE 128	/*samples in each half of ping-pong buffer*/
+
+/*short stored prompt: 8 bits unsigned PCM (a decaying 500 Hz burst sampled at 8 kHz)*/
+static const uint8_t voicePrompt[] = {
+	128,218,255,218,128,38,1,38,128,207,240,207,128,49,17,49,
+	128,197,225,197,128,59,31,59,128,188,212,188,128,68,44,68,
+	128,179,200,179,128,77,56,77,128,171,189,171,128,85,67,85,
+	128,164,179,164,128,92,77,92,128,158,170,158,128,98,86,98,
+	128,152,162,152,128,104,94,104,128,147,155,147,128,109,101,109,
+	128,142,148,142,128,114,108,114,128,138,142,138,128,118,114,118,
+	128,135,137,135,128,121,119,121,128,132,133,132,128,124,123,124,
+	128,130,130,130,128,126,126,126,128,128,128,128,128,128,128,128,
+};
+
+/*12 bits stereo samples, channel 1 in lower half-word, channel 2 in upper half-word*/
+static uint32_t pcmBuffer[2*BLOCK_SIZE];
+static uint32_t promptIndex = 0;
+
+DAC_Handle_t DAC_Handle;
+
+void fill_block (uint32_t *blockPtr);
+
+void DAC_GPIO_pins_init (void)
+{	
+	GPIO_Pin_config_t GPIO_DAC_pin_config = {.mode = GPIO_MODE_ANL,.speed = GPIO_OUTPUT_LOW_SPEED,.outType = GPIO_OUTPUT_TYPE_PP,.puPdr = GPIO_NO_PUPDR};
+	GPIO_Handle_t GPIO_DAC_pin_handle;
+	GPIO_DAC_pin_handle.GPIOxPtr = GPIOA;
+	
+	GPIO_DAC_pin_config.pinNumber = GPIO_PIN_NO_4;
+	GPIO_DAC_pin_handle.GPIO_Pin_config = GPIO_DAC_pin_config;
+	GPIO_init(&GPIO_DAC_pin_handle);
+	
+	GPIO_DAC_pin_config.pinNumber = GPIO_PIN_NO_5;
+	GPIO_DAC_pin_handle.GPIO_Pin_config = GPIO_DAC_pin_config;
+	GPIO_init(&GPIO_DAC_pin_handle);
+}
+
+void DAC_dual_init (void)
+{
+	static DAC_Config_t DAC_Config = {.channel = DAC_CHANNEL_DUAL, .resolution = DAC_RES_12_bits, .alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_TRIGGER_EV_TIM6,.outputBuffer = DAC_OBUFFER_EN};
+	DAC_Handle.DACxPtr = DAC1;
+	DAC_Handle.DACxConfigPtr = &DAC_Config; 
+	DAC_init(&DAC_Handle);
+}
+
+int main (void){
+	/*initilize green led on PD12*/
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	
+	/*initialize both DAC channels in dual mode triggered by TIM6*/
+	DAC_GPIO_pins_init();
+	DAC_dual_init();
+	
+	/*prefill both halves, then start streaming*/
+	fill_block(&pcmBuffer[0]);
+	fill_block(&pcmBuffer[BLOCK_SIZE]);
+	DAC_intrpt_vector_ctr(IRQ_DMA1_STREAM5,ENABLE);
+	if(DAC_PCM_start(&DAC_Handle,pcmBuffer,2*BLOCK_SIZE,SAMPLE_RATE) < 0){
+		led_on(GPIOD,GPIO_PIN_NO_12);
+	}
+		
+	while(1);
+}
+
+/*convert next block of 8 bits prompt into 12 bits stereo samples*/
+void fill_block (uint32_t *blockPtr)
+{
+	for(uint32_t i = 0; i < BLOCK_SIZE; i++){
+		uint32_t sample = voicePrompt[promptIndex] << 4;
+		blockPtr[i] = sample | ((0xFFF - sample) << 16);
+		promptIndex++;
+		if(promptIndex == sizeof(voicePrompt)){
+			promptIndex = 0;
+		}
+	}
+}
+
+void DAC_application_event_callback (DAC_Handle_t *DACxHandlePtr,uint8_t event)
+{
+	if(event == DAC_EV_DMA_HALF_CMPLT){
+		fill_block(&pcmBuffer[0]);
+	}else{
+		fill_block(&pcmBuffer[BLOCK_SIZE]);
+		led_toggle(GPIOD,GPIO_PIN_NO_12);
+	}
+}
+
+/*dual channel stream is served by DMA1 stream 5*/
+void DMA1_Stream5_IRQHandler (void)
+{
+	DAC_DMA_intrpt_handler(&DAC_Handle);
+}
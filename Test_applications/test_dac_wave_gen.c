@@ -0,0 +1,90 @@
+/**
+*@brief test hardware wave generation of STM32F4xx DAC driver
+*
+*This generate a triangle wave on DAC channel 1 (PA4) and LFSR noise on DAC channel 2 (PA5), both clocked by TIM6 at 100 kHz.
+*No CPU is used once both channels are started, button on PA0 move triangle offset with a single register store.
+*Oscilloscope is used to monitor both DAC outputs.
+*Purpose of this program is to confirm correctness of DAC wave generation APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*DAC_channel_1 PA4
+*DAC_channel_2 PA5
+*Green_led PD12
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_dac.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+DAC_Handle_t DAC_CH1_Handle;
+DAC_Handle_t DAC_CH2_Handle;
+
+void DAC_GPIO_pins_init (void)
+{	
+	GPIO_Pin_config_t GPIO_DAC_pin_config = {.mode = GPIO_MODE_ANL,.speed = GPIO_OUTPUT_LOW_SPEED,.outType = GPIO_OUTPUT_TYPE_PP,.puPdr = GPIO_NO_PUPDR};
+	GPIO_Handle_t GPIO_DAC_pin_handle;
+	GPIO_DAC_pin_handle.GPIOxPtr = GPIOA;
+	
+	GPIO_DAC_pin_config.pinNumber = GPIO_PIN_NO_4;
+	GPIO_DAC_pin_handle.GPIO_Pin_config = GPIO_DAC_pin_config;
+	GPIO_init(&GPIO_DAC_pin_handle);
+	
+	GPIO_DAC_pin_config.pinNumber = GPIO_PIN_NO_5;
+	GPIO_DAC_pin_handle.GPIO_Pin_config = GPIO_DAC_pin_config;
+	GPIO_init(&GPIO_DAC_pin_handle);
+}
+
+void DAC_channels_init (void)
+{
+	/*channel 1: triangle of amplitude 1023 on top of data holding register value*/
+	static DAC_Config_t DAC_CH1_Config = {.channel = DAC_CHANNEL_1, .resolution = DAC_RES_12_bits, .alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_TRIGGER_EV_TIM6,
+																				.outputBuffer = DAC_OBUFFER_EN, .waveGen = DAC_WAVE_TRIANGLE, .waveAmplitude = DAC_WAVE_AMPL_1023};
+	DAC_CH1_Handle.DACxPtr = DAC1;
+	DAC_CH1_Handle.DACxConfigPtr = &DAC_CH1_Config; 
+	DAC_init(&DAC_CH1_Handle);
+	
+	/*channel 2: 12 bits LFSR noise*/
+	static DAC_Config_t DAC_CH2_Config = {.channel = DAC_CHANNEL_2, .resolution = DAC_RES_12_bits, .alignment = DAC_ALIGNMENT_RIGHT, .triggerEV = DAC_TRIGGER_EV_TIM6,
+																				.outputBuffer = DAC_OBUFFER_EN, .waveGen = DAC_WAVE_NOISE, .waveAmplitude = DAC_WAVE_AMPL_4095};
+	DAC_CH2_Handle.DACxPtr = DAC1;
+	DAC_CH2_Handle.DACxConfigPtr = &DAC_CH2_Config; 
+	DAC_init(&DAC_CH2_Handle);
+}
+
+int main (void){
+	uint16_t offset = 0;
+	
+	/*initilize green led on PD12 and user button on PA0*/
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+	
+	DAC_GPIO_pins_init();
+	DAC_channels_init();
+	DAC_write(&DAC_CH1_Handle,offset);
+	DAC_write(&DAC_CH2_Handle,0);
+	
+	/*TIM6 clock both channels*/
+	if(DAC_sample_rate_config(&DAC_CH1_Handle,100000) < 0){
+		led_on(GPIOD,GPIO_PIN_NO_12);
+	}
+	TIM_ctr(TIM6,START);
+		
+	while(1){
+		if(button_read(GPIOA,GPIO_PIN_NO_0)){
+			while(button_read(GPIOA,GPIO_PIN_NO_0));
+			offset = (offset + 1024) & 0xFFF;
+			DAC_write(&DAC_CH1_Handle,offset);
+			led_toggle(GPIOD,GPIO_PIN_NO_12);
+		}
+	}
+}
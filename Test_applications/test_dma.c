@@ -0,0 +1,129 @@
+/**
+*@brief test generic DMA driver
+*
+*A DMA2 stream is allocated for memory to memory copies (word transfers, 4 beats bursts, FIFO full threshold) and a DMA1 stream
+*for USART2 TX. Every second a 1 kB buffer is copied by DMA, checked against source, and result, copy time and allocated
+*streams are sent through USART2 at 115200 baud by DMA. Completion of both transfers is reported by callback. Led on PD12
+*toggle on each report, led on PD14 is on if a copy mismatch or a DMA error occurred.
+*Purpose is to test DMA_init, DMA_start, DMA_get_IRQ_number and callbacks.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*green led PD12
+*red led PD14
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_dma.h"
+#include "../Device_drivers/inc/led.h"
+
+#define COPY_WORDS 256
+
+void copy_callback (uint8_t event, void *argPtr);
+void UART_DMA_callback (uint8_t event, void *argPtr);
+
+DMA_Config_t copyConfig = {.request = DMA_REQ_MEM2MEM,.direction = DMA_DIR_M2M,.periphSize = DMA_SIZE_WORD,.memSize = DMA_SIZE_WORD,
+													.periphInc = ENABLE,.memInc = ENABLE,.mode = DMA_MODE_NORMAL,.priority = DMA_PRIORITY_MEDIUM,
+													.FIFOThreshold = DMA_FIFO_FULL,.periphBurst = DMA_BURST_INC4,.memBurst = DMA_BURST_INC4,
+													.callback = copy_callback,.argPtr = NULL};
+DMA_Config_t UARTDMAConfig = {.request = DMA_REQ_USART2_TX,.direction = DMA_DIR_M2P,.periphSize = DMA_SIZE_BYTE,.memSize = DMA_SIZE_BYTE,
+														.periphInc = DISABLE,.memInc = ENABLE,.mode = DMA_MODE_NORMAL,.priority = DMA_PRIORITY_LOW,
+														.FIFOThreshold = DMA_FIFO_DIRECT,.periphBurst = DMA_BURST_SINGLE,.memBurst = DMA_BURST_SINGLE,
+														.callback = UART_DMA_callback,.argPtr = NULL};
+DMA_Handle_t copyHandle = {.DMAConfigPtr = &copyConfig};
+DMA_Handle_t UARTDMAHandle = {.DMAConfigPtr = &UARTDMAConfig};
+
+uint32_t source[COPY_WORDS];
+uint32_t destination[COPY_WORDS];
+char msg[128];
+volatile uint8_t copyDone = 0;
+volatile uint8_t UARTDone = 1;
+volatile uint8_t errorNum = 0;
+volatile uint64_t copyEndUs;
+
+int main (void)
+{
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	TIME_init();
+	led_init(GPIOD,12);
+	led_init(GPIOD,14);
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+	UART2HandlePtr->UARTxPtr->CR3 |= USART_CR3_DMAT;
+
+	int8_t copyStream = DMA_init(&copyHandle);
+	int8_t UARTStream = DMA_init(&UARTDMAHandle);
+	if(copyStream < 0 || UARTStream < 0){
+		led_on(GPIOD,14);
+		while(1);
+	}
+
+	for(uint16_t i = 0; i < COPY_WORDS; i++){
+		source[i] = 0x01010101*i ^ 0xA5A5A5A5;
+	}
+
+	while(1){
+		TIME_delay_ms(1000);
+
+		memset(destination,0,sizeof(destination));
+		copyDone = 0;
+		uint64_t startUs = TIME_get_us();
+		DMA_start(&copyHandle,source,destination,NULL,COPY_WORDS);
+		while(!copyDone);
+		uint32_t copyUs = copyEndUs - startUs;
+		uint8_t match = (memcmp(source,destination,sizeof(source)) == 0);
+		if(!match || errorNum){
+			led_on(GPIOD,14);
+		}
+
+		/*previous report must be sent before buffer is reused*/
+		while(!UARTDone);
+		sprintf(msg,"copy %s in %lu us, streams %d and %d, errors %u\r\n",match ? "ok" : "FAIL",(unsigned long)copyUs,copyStream,UARTStream,errorNum);
+		UARTDone = 0;
+		DMA_start(&UARTDMAHandle,&UART2HandlePtr->UARTxPtr->DR,msg,NULL,strlen(msg));
+		led_toggle(GPIOD,12);
+	}
+}
+
+void copy_callback (uint8_t event, void *argPtr)
+{
+	if(event == DMA_EV_CMPLT){
+		copyEndUs = TIME_get_us();
+		copyDone = 1;
+	}else if(event == DMA_EV_ERROR){
+		errorNum++;
+		copyDone = 1;
+	}
+}
+
+void UART_DMA_callback (uint8_t event, void *argPtr)
+{
+	if(event == DMA_EV_CMPLT){
+		UARTDone = 1;
+	}else if(event == DMA_EV_ERROR){
+		errorNum++;
+		UARTDone = 1;
+	}
+}
+
+/*memory to memory is allocated from DMA2 stream 7 down, USART2 TX is served by DMA1 stream 6 only*/
+void DMA2_Stream7_IRQHandler (void)
+{
+	DMA_intrpt_handler(IRQ_DMA2_STREAM7);
+}
+
+void DMA1_Stream6_IRQHandler (void)
+{
+	DMA_intrpt_handler(IRQ_DMA1_STREAM6);
+}
@@ -0,0 +1,113 @@
+/**
+*@brief test DMA memory copy and fill engine
+*
+*System run at 168 MHz. Every 2 seconds a 32 kB framebuffer band is cleared with DMAMEM_memset32 and copied with DMAMEM_memcpy
+*while CPU compute a checksum of an other buffer, then same work is done by CPU alone (memset, memcpy, checksum).
+*USART2 report both durations, result of copy check and number of completion callbacks at 115200 baud.
+*A short copy is also submitted to check CPU fallback. Led on PD14 is on if a check failed.
+*Purpose is to test DMAMEM_memcpy, DMAMEM_memset32, DMAMEM_wait and callbacks.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*red led PD14
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_dma_mem.h"
+#include "../Device_drivers/inc/led.h"
+
+#define BAND_WORDS 8192	/*320 x 51 pixels of 16 bits, about a fifth of a 320 x 240 frame*/
+#define WORK_WORDS 4096
+
+uint32_t band[BAND_WORDS];
+uint32_t frame[BAND_WORDS];
+uint32_t work[WORK_WORDS];
+DMAMEM_Request_t clearRequest;
+DMAMEM_Request_t copyRequest;
+DMAMEM_Request_t shortRequest;
+volatile uint32_t callbackNum = 0;
+char msg[128];
+
+void copy_done (void *argPtr)
+{
+	callbackNum++;
+}
+
+uint32_t checksum (const uint32_t *bufferPtr, uint32_t wordNum)
+{
+	uint32_t sum = 0;
+	for(uint32_t i = 0; i < wordNum; i++){
+		sum = (sum << 1 | sum >> 31) ^ bufferPtr[i];
+	}
+	return sum;
+}
+
+int main (void)
+{
+	uint8_t shortBuffer[16];
+
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	TIME_init();
+	led_init(GPIOD,14);
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+
+	if(DMAMEM_init() < 0){
+		led_on(GPIOD,14);
+		while(1);
+	}
+	for(uint32_t i = 0; i < WORK_WORDS; i++){
+		work[i] = i*0x9E3779B9;
+	}
+
+	while(1){
+		TIME_delay_ms(2000);
+
+		/*DMA: clear frame band, copy band into it, checksum run meanwhile*/
+		uint64_t startUs = TIME_get_us();
+		DMAMEM_memset32(&clearRequest,frame,0,BAND_WORDS,copy_done,NULL);
+		DMAMEM_memcpy(&copyRequest,frame,band,sizeof(band),copy_done,NULL);
+		uint32_t sum = checksum(work,WORK_WORDS);
+		int8_t result = DMAMEM_wait(&clearRequest) | DMAMEM_wait(&copyRequest);
+		uint32_t DMAUs = TIME_get_us() - startUs;
+		uint8_t match = (result == 0) && !memcmp(frame,band,sizeof(band));
+
+		/*CPU alone*/
+		startUs = TIME_get_us();
+		memset(frame,0,sizeof(frame));
+		memcpy(frame,band,sizeof(band));
+		sum ^= checksum(work,WORK_WORDS);
+		uint32_t CPUUs = TIME_get_us() - startUs;
+
+		/*short copy is done by CPU before function return*/
+		uint8_t fallback = (DMAMEM_memcpy(&shortRequest,shortBuffer,band,sizeof(shortBuffer),copy_done,NULL) == 1);
+
+		if(!match || !fallback || sum){
+			led_on(GPIOD,14);
+		}
+		sprintf(msg,"DMA %lu us, CPU %lu us, copy %s, fallback %s, callbacks %lu\r\n",(unsigned long)DMAUs,(unsigned long)CPUUs,
+						match ? "ok" : "FAIL",fallback ? "ok" : "FAIL",(unsigned long)callbackNum);
+		UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+
+		for(uint32_t i = 0; i < BAND_WORDS; i++){
+			band[i] += 0x00010001;
+		}
+	}
+}
+
+/*memory to memory is allocated from DMA2 stream 7 down*/
+void DMA2_Stream7_IRQHandler (void)
+{
+	DMA_intrpt_handler(IRQ_DMA2_STREAM7);
+}
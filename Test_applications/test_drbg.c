@@ -0,0 +1,195 @@
+/**
+*@brief test software random generators (ChaCha20 DRBG and xoshiro128**)
+*
+*Known answer tests are run first: ChaCha20 keystream of all zero key (RFC 8439 appendix A.1, test vectors 1 and 2) through
+*aligned and unaligned DRBG_fill and through DRBG_get, key replacement at end of DRBG_fill, and xoshiro128** reference output.
+*On target, both generators are then seeded from hardware RNG and throughput of DRBG_fill (4 kB requests) is reported
+*every 2 seconds through USART2 at 115200 baud.
+*Same file build on host for known answer tests only:
+*gcc -DDRBG_HOST -O2 -o test_drbg Test_applications/test_drbg.c Peripheral_drivers/src/stm32f407xx_drbg.c
+*Purpose is to test DRBG APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*/
+
+#ifndef DRBG_HOST
+#include "stm32f4xx.h"                  // Device header
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_drbg.h"
+#ifndef DRBG_HOST
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rng.h"
+#endif
+
+#define SPEED_SIZE 4096
+#define SPEED_LOOP 64
+
+/*RFC 8439 A.1 test vectors 1 and 2: all zero key and nonce, block counter 0 and 1*/
+const uint8_t chachaZeroKey[128] = {
+	0x76,0xb8,0xe0,0xad,0xa0,0xf1,0x3d,0x90,0x40,0x5d,0x6a,0xe5,0x53,0x86,0xbd,0x28,
+	0xbd,0xd2,0x19,0xb8,0xa0,0x8d,0xed,0x1a,0xa8,0x36,0xef,0xcc,0x8b,0x77,0x0d,0xc7,
+	0xda,0x41,0x59,0x7c,0x51,0x57,0x48,0x8d,0x77,0x24,0xe0,0x3f,0xb8,0xd8,0x4a,0x37,
+	0x6a,0x43,0xb8,0xf4,0x15,0x18,0xa1,0x1c,0xc3,0x87,0xb6,0x69,0xb2,0xee,0x65,0x86,
+	0x9f,0x07,0xe7,0xbe,0x55,0x51,0x38,0x7a,0x98,0xba,0x97,0x7c,0x73,0x2d,0x08,0x0d,
+	0xcb,0x0f,0x29,0xa0,0x48,0xe3,0x65,0x69,0x12,0xc6,0x53,0x3e,0x32,0xee,0x7a,0xed,
+	0x29,0xb7,0x21,0x76,0x9c,0xe6,0x4e,0x43,0xd5,0x71,0x33,0xb0,0x74,0xd8,0x39,0xd5,
+	0x31,0xed,0x1f,0x28,0x51,0x0a,0xfb,0x45,0xac,0xe1,0x0a,0x1f,0x4b,0x79,0x4d,0x6f,
+};
+
+/*keystream of key taken from block 2 of all zero key, block counter 0: output of second DRBG_fill*/
+const uint8_t chachaRekeyed[64] = {
+	0x0e,0x06,0xbb,0xd3,0xb1,0x0a,0xff,0x6a,0x8f,0x92,0x1e,0x24,0x56,0x08,0xb8,0xa7,
+	0x5f,0x4c,0x7e,0xf7,0xf2,0xb3,0xe1,0x06,0x7a,0x74,0xde,0x3d,0x96,0x54,0xe3,0x4e,
+	0x87,0x86,0x4d,0x95,0x94,0x2a,0x18,0x18,0x97,0xe2,0x33,0x66,0x26,0xdf,0xec,0x8a,
+	0xef,0x95,0x0b,0xf0,0x20,0xcd,0xc3,0x02,0x70,0x54,0x81,0xb0,0xa5,0x31,0x95,0xf2,
+};
+
+/*xoshiro128** reference implementation, state {1, 2, 3, 4}*/
+const uint32_t xoshiroRef[8] = {0x00002d00,0x00000000,0x005a7080,0x04389d80,0x79199d9b,0x61963b24,0x4cb9b57a,0xde9d7431};
+
+DRBG_Config_t chachaConfig = {.type = DRBG_TYPE_CHACHA20,.entropy = NULL,.reseedInterval = DRBG_RESEED_DEFAULT};
+DRBG_Config_t xoshiroConfig = {.type = DRBG_TYPE_XOSHIRO,.entropy = NULL,.reseedInterval = DRBG_RESEED_DEFAULT};
+DRBG_Handle_t chachaHandle = {.DRBGConfigPtr = &chachaConfig};
+DRBG_Handle_t xoshiroHandle = {.DRBGConfigPtr = &xoshiroConfig};
+
+uint32_t buffer[SPEED_SIZE/4 + 1];
+char msg[128];
+
+#ifdef DRBG_HOST
+void report (const char *strPtr)
+{
+	fputs(strPtr,stdout);
+}
+#else
+UART_Handle_t *UART2HandlePtr;
+
+void report (const char *strPtr)
+{
+	UART_send(UART2HandlePtr,(uint8_t*)strPtr,strlen(strPtr));
+}
+#endif
+
+/*return number of failed tests*/
+uint8_t known_answer_test (void)
+{
+	const uint32_t zeroKey[8] = {0};
+	const uint32_t xoshiroSeed[4] = {1,2,3,4};
+	uint8_t *bytePtr = (uint8_t*)buffer;
+	uint8_t failNum = 0;
+
+	/*aligned fill, whole blocks generated in place*/
+	DRBG_seed(&chachaHandle,zeroKey,8);
+	DRBG_fill(&chachaHandle,bytePtr,128);
+	if(memcmp(bytePtr,chachaZeroKey,128)){
+		report("FAIL chacha20 aligned fill\r\n");
+		failNum++;
+	}
+
+	/*key replaced at end of previous fill*/
+	DRBG_fill(&chachaHandle,bytePtr,64);
+	if(memcmp(bytePtr,chachaRekeyed,64)){
+		report("FAIL chacha20 key replacement\r\n");
+		failNum++;
+	}
+
+	/*unaligned fill, through block buffer*/
+	DRBG_seed(&chachaHandle,zeroKey,8);
+	DRBG_fill(&chachaHandle,&bytePtr[1],128);
+	if(memcmp(&bytePtr[1],chachaZeroKey,128)){
+		report("FAIL chacha20 unaligned fill\r\n");
+		failNum++;
+	}
+
+	/*successive words, little endian*/
+	DRBG_seed(&chachaHandle,zeroKey,8);
+	for(uint8_t i = 0; i < 32; i++){
+		uint32_t word = DRBG_get(&chachaHandle);
+		if(memcmp(&word,&chachaZeroKey[4*i],4)){
+			report("FAIL chacha20 get\r\n");
+			failNum++;
+			break;
+		}
+	}
+
+	DRBG_seed(&xoshiroHandle,xoshiroSeed,4);
+	for(uint8_t i = 0; i < 8; i++){
+		if(DRBG_get(&xoshiroHandle) != xoshiroRef[i]){
+			report("FAIL xoshiro128** get\r\n");
+			failNum++;
+			break;
+		}
+	}
+
+	DRBG_seed(&xoshiroHandle,xoshiroSeed,4);
+	DRBG_fill(&xoshiroHandle,&bytePtr[3],30);
+	if(memcmp(&bytePtr[3],xoshiroRef,30)){
+		report("FAIL xoshiro128** unaligned fill\r\n");
+		failNum++;
+	}
+
+	for(uint16_t i = 0; i < 1000; i++){
+		if(DRBG_get_range(&xoshiroHandle,7) >= 7 || DRBG_get_range(&chachaHandle,1000000007) >= 1000000007){
+			report("FAIL get range\r\n");
+			failNum++;
+			break;
+		}
+	}
+
+	sprintf(msg,"known answer tests: %s\r\n",failNum ? "FAIL" : "PASS");
+	report(msg);
+	return failNum;
+}
+
+#ifdef DRBG_HOST
+int main (void)
+{
+	return known_answer_test() ? 1 : 0;
+}
+#else
+/*bytes per microsecond is MB/s*/
+uint32_t speed_test (DRBG_Handle_t *DRBGHandlePtr)
+{
+	uint64_t startUs = TIME_get_us();
+	for(uint8_t i = 0; i < SPEED_LOOP; i++){
+		DRBG_fill(DRBGHandlePtr,buffer,SPEED_SIZE);
+	}
+	uint32_t elapsedUs = TIME_get_us() - startUs;
+	return ((uint64_t)SPEED_SIZE*SPEED_LOOP*1000)/elapsedUs;
+}
+
+int main (void)
+{
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	TIME_init();
+	UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+	RNG_init();
+
+	known_answer_test();
+
+	chachaConfig.entropy = RNG_get;
+	xoshiroConfig.entropy = RNG_get;
+	DRBG_init(&chachaHandle);
+	DRBG_init(&xoshiroHandle);
+
+	while(1){
+		uint32_t chachaKBs = speed_test(&chachaHandle);
+		uint32_t xoshiroKBs = speed_test(&xoshiroHandle);
+		sprintf(msg,"chacha20 %lu kB/s, xoshiro128** %lu kB/s, sample %08lx\r\n",(unsigned long)chachaKBs,(unsigned long)xoshiroKBs,
+						(unsigned long)DRBG_get(&chachaHandle));
+		report(msg);
+		TIME_delay_ms(2000);
+	}
+}
+#endif
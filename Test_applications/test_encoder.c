@@ -0,0 +1,118 @@
+/**
+*@brief test quadrature encoder interface and velocity estimator
+*
+*TIM4 channel 1 and 2 (PD12, PD13) generate quadrature signals in toggle mode (channel 2 lag channel 1 by a quarter of period),
+*which are wired to encoder inputs of TIM3 (PA6, PA7). TIM2 timestamp A edges, TIM7 call ENCODER_update at 100 Hz.
+*Quadrature signals are 500 Hz, so expected velocity is 2000 counts per second (200000) and speed is 120 rpm (12000) with 1000 counts per revolution.
+*Pressing user button reverse direction (channel 1 lag channel 2), velocity must then be negative.
+*Orange led (PD14) is on while velocity is within 1% of expected value, position and velocity are watched in debugger.
+*Purpose is to test encoder APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*TIM4_CH1 PD12
+*TIM4_CH2 PD13
+*TIM3_CH1 (encoder A) PA6 (connect to PD12)
+*TIM3_CH2 (encoder B) PA7 (connect to PD13)
+*Orange_led PD14
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_encoder.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+#define QUADRATURE_PERIOD 1000	/*TIM4 ticks at 1 MHz, each output toggle once per period: 500 Hz*/
+#define EXPECTED_VELOCITY 200000	/*in 0.01 count per second*/
+
+ENCODER_Config_t encoderConfig = {.mode = TIM_SLAVE_MODE_ENCODER_3,.polarityA = TIM_IC_POLARITY_RISING,.polarityB = TIM_IC_POLARITY_RISING,
+																	.filter = 2,.countsPerRev = 1000,.updateFreq = 100,.timestampTIMxPtr = TIM2,
+																	.timestampChannel = TIM_CHANNEL_1,.timestampFreq = 1000000};
+ENCODER_Handle_t encoderHandle = {.TIMxPtr = TIM3,.ENCODERConfigPtr = &encoderConfig};
+
+volatile int32_t position;
+volatile int32_t velocity;
+volatile int32_t rpm;
+
+void quadrature_init (void)
+{
+	TIM_Config_t TIM4Config = {.reloadVal = QUADRATURE_PERIOD - 1,.prescaler = RCC_get_TIMCLK_value(APB1)/1000000 - 1};
+	TIM_Handle_t TIM4Handle = {TIM4,&TIM4Config};
+	TIM_init(&TIM4Handle);
+
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_TOGGLE,.compareVal = 0,
+															.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	TIM_OC_init(TIM4,&OCConfig);
+	OCConfig.channel = TIM_CHANNEL_2;
+	OCConfig.compareVal = QUADRATURE_PERIOD/2;
+	TIM_OC_init(TIM4,&OCConfig);
+	TIM_ctr(TIM4,START);
+}
+
+void update_timer_init (void)
+{
+	/*10 kHz counter, 100 Hz update*/
+	TIM_Config_t TIM7Config = {.reloadVal = 99,.prescaler = RCC_get_TIMCLK_value(APB1)/10000 - 1};
+	TIM_Handle_t TIM7Handle = {TIM7,&TIM7Config};
+	TIM_init(&TIM7Handle);
+	TIM_interrupt_ctr(TIM7,ENABLE);
+	TIM_intrpt_vector_ctr(IRQ_TIM7,ENABLE);
+	TIM_ctr(TIM7,START);
+}
+
+int main (void)
+{
+	int8_t direction = 1;
+
+	/*TIM4 and TIM3 on AF2*/
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_13,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_7,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	led_init(GPIOD,GPIO_PIN_NO_14);
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	ENCODER_init(&encoderHandle);
+	quadrature_init();
+	update_timer_init();
+
+	while(1){
+		if(button_read(GPIOA,GPIO_PIN_NO_0)){
+			while(button_read(GPIOA,GPIO_PIN_NO_0));
+			/*swap phase of A and B*/
+			direction = -direction;
+			TIM_set_compare_val(TIM4,TIM_CHANNEL_1,(direction > 0) ? 0 : QUADRATURE_PERIOD/2);
+			TIM_set_compare_val(TIM4,TIM_CHANNEL_2,(direction > 0) ? QUADRATURE_PERIOD/2 : 0);
+		}
+
+		if(abs(velocity - direction*EXPECTED_VELOCITY) <= EXPECTED_VELOCITY/100){
+			led_on(GPIOD,GPIO_PIN_NO_14);
+		}else{
+			led_off(GPIOD,GPIO_PIN_NO_14);
+		}
+	}
+}
+
+void TIM_application_event_callback (TIM_TypeDef *TIMxPtr, uint8_t event)
+{
+	if(TIMxPtr == TIM7 && event == TIM_EV_UPDATE){
+		ENCODER_update(&encoderHandle);
+		position = ENCODER_get_position(&encoderHandle);
+		velocity = ENCODER_get_velocity(&encoderHandle);
+		rpm = ENCODER_get_rpm(&encoderHandle);
+	}
+}
+
+void TIM7_IRQHandler (void)
+{
+	TIM_intrpt_handler(TIM7);
+}
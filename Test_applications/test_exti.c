@@ -0,0 +1,91 @@
+/**
+*@brief test per-pin EXTI dispatch with timestamps and debouncing
+*
+*User button (PA0) is debounced (20 ms) on rising edge: each press toggle green led (PD12), press interval (in microsecond) is watched in debugger.
+*Two external buttons on PD5 and PD6 share EXTI9_5 vector: PD5 toggle orange led (PD13) on each falling edge without debouncing,
+*PD6 is oneshot: it turn red led (PD14) on and stay disarmed until user button re-arm it (red led off).
+*Purpose is to test EXTI APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*User_button PA0
+*External_button_1 PD5 (to ground)
+*External_button_2 PD6 (to ground)
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_exti.h"
+#include "../Device_drivers/inc/led.h"
+
+void user_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr);
+void external_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr);
+
+EXTI_Config_t userButtonConfig = {.GPIOxPtr = GPIOA,.edge = GPIO_MODE_INTRPT_RE,.oneshot = DISABLE,.debounceUs = 20000,
+																	.callback = user_button_callback,.argPtr = NULL};
+EXTI_Config_t toggleButtonConfig = {.GPIOxPtr = GPIOD,.edge = GPIO_MODE_INTRPT_FE,.oneshot = DISABLE,.debounceUs = 0,
+																		.callback = external_button_callback,.argPtr = NULL};
+EXTI_Config_t oneshotButtonConfig = {.GPIOxPtr = GPIOD,.edge = GPIO_MODE_INTRPT_FE,.oneshot = ENABLE,.debounceUs = 0,
+																		.callback = external_button_callback,.argPtr = NULL};
+
+volatile uint64_t lastPressUs = 0;
+volatile uint32_t pressIntervalUs = 0;
+
+void user_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr)
+{
+	pressIntervalUs = (uint32_t)(timestampUs - lastPressUs);
+	lastPressUs = timestampUs;
+	led_toggle(GPIOD,GPIO_PIN_NO_12);
+
+	if(!EXTI_is_armed(GPIO_PIN_NO_6)){
+		led_off(GPIOD,GPIO_PIN_NO_14);
+		EXTI_arm(GPIO_PIN_NO_6);
+	}
+}
+
+void external_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr)
+{
+	if(line == GPIO_PIN_NO_5){
+		led_toggle(GPIOD,GPIO_PIN_NO_13);
+	}else{
+		led_on(GPIOD,GPIO_PIN_NO_14);
+	}
+}
+
+int main (void)
+{
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	led_init(GPIOD,GPIO_PIN_NO_13);
+	led_init(GPIOD,GPIO_PIN_NO_14);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_0,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0);
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_5,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_PU,0);
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_6,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_PU,0);
+
+	SWTIM_init();
+	EXTI_register(GPIO_PIN_NO_0,&userButtonConfig);
+	EXTI_register(GPIO_PIN_NO_5,&toggleButtonConfig);
+	EXTI_register(GPIO_PIN_NO_6,&oneshotButtonConfig);
+
+	while(1){
+		/*do something*/
+	}
+}
+
+void EXTI0_IRQHandler (void)
+{
+	EXTI_intrpt_handler(IRQ_EXTI0);
+}
+
+void EXTI9_5_IRQHandler (void)
+{
+	EXTI_intrpt_handler(IRQ_EXTI9_5);
+}
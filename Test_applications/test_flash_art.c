@@ -0,0 +1,85 @@
+/**
+*@brief test flash ART accelerator, prefetch and RAM_FUNC placement
+*
+*System clock is 168 MHz (5 wait states). Same workload is timed running from flash with ART caches and prefetch disabled,
+*then enabled, and as a RAM_FUNC; USART2 report durations and where RAM_FUNC code actually run at 115200 baud every 2 seconds.
+*Without ART cache, flash code is expected to run several times slower.
+*RAM_FUNC code run from SRAM only if linker script of application place section ".RamFunc" there (refer to stm32f407xx_common_macro.h),
+*otherwise it is reported in flash and third result equal second one.
+*Purpose is to test FLASH_config and RAM_FUNC.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+
+#define WORK_LOOP 100000
+
+/*branchy integer work, mostly instruction fetch bound*/
+uint32_t work_flash (void)
+{
+	uint32_t x = 1;
+	for(uint32_t i = 0; i < WORK_LOOP; i++){
+		x = (x & 1) ? 3*x + 1 : x >> 1;
+		x ^= i;
+	}
+	return x;
+}
+
+RAM_FUNC uint32_t work_ram (void)
+{
+	uint32_t x = 1;
+	for(uint32_t i = 0; i < WORK_LOOP; i++){
+		x = (x & 1) ? 3*x + 1 : x >> 1;
+		x ^= i;
+	}
+	return x;
+}
+
+uint32_t time_work (uint32_t (*workPtr)(void))
+{
+	uint64_t startUs = TIME_get_us();
+	workPtr();
+	return TIME_get_us() - startUs;
+}
+
+int main (void)
+{
+	FLASH_Config_t flashConfig = {.VDDRange = FLASH_VDD_2V7_3V6,.prefetch = ENABLE,.instructionCache = ENABLE,.dataCache = ENABLE};
+	char msg[128];
+
+	RCC_set_SYSCLK_PLL_168_MHz();
+	TIME_init();
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+
+	while(1){
+		flashConfig.prefetch = flashConfig.instructionCache = flashConfig.dataCache = DISABLE;
+		FLASH_config(&flashConfig);
+		uint32_t noARTUs = time_work(work_flash);
+
+		flashConfig.prefetch = flashConfig.instructionCache = flashConfig.dataCache = ENABLE;
+		FLASH_config(&flashConfig);
+		uint32_t ARTUs = time_work(work_flash);
+		uint32_t RAMUs = time_work(work_ram);
+
+		/*SRAM start at 0x20000000, flash at 0x08000000*/
+		const char *placePtr = (((uint32_t)work_ram & 0xF0000000) == 0x20000000) ? "SRAM" : "flash";
+		sprintf(msg,"latency %d WS: flash %lu us, flash + ART %lu us, RAM_FUNC (in %s) %lu us\r\n",FLASH_get_latency(RCC_get_clock_freq()->HCLK),
+						(unsigned long)noARTUs,(unsigned long)ARTUs,placePtr,(unsigned long)RAMUs);
+		UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+		TIME_delay_ms(2000);
+	}
+}
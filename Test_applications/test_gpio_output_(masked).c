@@ -0,0 +1,56 @@
+/**
+*@brief test masked multi-pin GPIO writes
+*
+*Orange and blue leds (PD13, PD15) show a 2 bits counter written with one masked store, other pins of port D are untouched.
+*Pressing user button toggle green and red leds (PD12, PD14) together, PD0 is toggled as fast as possible by inline writes (watch on oscilloscope).
+*Purpose is to test BSRR based GPIO APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*Scope_probe PD0
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+
+#define COUNTER_MASK ((1<<GPIO_PIN_NO_13) | (1<<GPIO_PIN_NO_15))
+
+int main (void)
+{
+	uint8_t counter = 0;
+
+	for(uint8_t pin = GPIO_PIN_NO_12; pin <= GPIO_PIN_NO_15; pin++){
+		GPIO_init_direct(GPIOD,pin,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0);
+	}
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_0,GPIO_MODE_OUT,GPIO_OUTPUT_VERY_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_0,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0);
+	TIME_init();
+
+	while(1){
+		/*bit 0 on PD13, bit 1 on PD15*/
+		GPIO_write_masked(GPIOD,COUNTER_MASK,((counter & 0x01)<<GPIO_PIN_NO_13) | ((counter & 0x02)<<(GPIO_PIN_NO_15 - 1)));
+		counter++;
+
+		uint64_t start = TIME_get_us();
+		while(!TIME_is_timeout(start,500000)){
+			if(GPIO_read_pin(GPIOA,GPIO_PIN_NO_0)){
+				while(GPIO_read_pin(GPIOA,GPIO_PIN_NO_0));
+				GPIO_toggle_pins(GPIOD,(1<<GPIO_PIN_NO_12) | (1<<GPIO_PIN_NO_14));
+			}
+			/*each inline write is a single store: pulse width is a few cycles*/
+			GPIO_fast_set_pin(GPIOD,GPIO_PIN_NO_0);
+			GPIO_fast_clear_pin(GPIOD,GPIO_PIN_NO_0);
+		}
+	}
+}
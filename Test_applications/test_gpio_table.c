@@ -0,0 +1,65 @@
+/**
+*@brief test GPIO pin tables and pins pack conflict report
+*
+*Board pins (4 leds, user button) are configured from one pin table, each port register is written once.
+*Then USART3 is initialized on pins pack 2 (PC10, PC11) and UART4 on pins pack 2, which use the same pins:
+*second initialization must fail. Green led show board table was applied, red led show conflict was reported,
+*conflicting pins of a board table listing PC10 are watched in debugger (conflictPins[GPIO_PORT_C] must be 0x0400).
+*Purpose is to test GPIO table APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*User_button PA0
+*USART3_TX/UART4_TX PC10
+*USART3_RX/UART4_RX PC11
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+
+#define BOARD_PINS(X,port) \
+	X(port,GPIO_PORT_A,GPIO_PIN_NO_0,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_12,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_13,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_14,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0) \
+	X(port,GPIO_PORT_D,GPIO_PIN_NO_15,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0)
+
+#define DEBUG_PINS(X,port) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_VERY_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0) \
+	X(port,GPIO_PORT_C,GPIO_PIN_NO_10,GPIO_MODE_OUT,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0)
+
+static const GPIO_Port_table_t boardTable[] = {GPIO_PORT_TABLE(BOARD_PINS,GPIO_PORT_A),GPIO_PORT_TABLE(BOARD_PINS,GPIO_PORT_D)};
+static const GPIO_Port_table_t debugTable[] = {GPIO_PORT_TABLE(DEBUG_PINS,GPIO_PORT_C)};
+
+uint16_t conflictPins[GPIO_PORT_NUM];
+
+int main (void)
+{
+	if(GPIO_table_apply(boardTable,sizeof(boardTable)/sizeof(boardTable[0]),NULL) == 0){
+		GPIO_write_pin(GPIOD,GPIO_PIN_NO_12,SET);
+	}
+
+	UART_general_init(USART3,UART_pins_pack_2,UART_BDR_9600,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+	if(UART_general_init(UART4,UART_pins_pack_2,UART_BDR_9600,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL) == NULL){
+		GPIO_write_pin(GPIOD,GPIO_PIN_NO_14,SET);
+	}
+
+	/*PC10 is claimed by USART3, PC9 is not configured*/
+	if(GPIO_table_apply(debugTable,1,conflictPins) < 0){
+		GPIO_write_pin(GPIOD,GPIO_PIN_NO_15,SET);
+	}
+
+	while(1){
+		GPIO_write_pin(GPIOD,GPIO_PIN_NO_13,GPIO_read_pin(GPIOA,GPIO_PIN_NO_0));
+	}
+}
@@ -0,0 +1,63 @@
+/**
+*@brief test BCM led dimming engine
+*
+*The 4 leds of the board are dimmed with no CPU per refresh cycle: green and red leds breathe in opposite phase by fading,
+*orange led show a fixed low brightness, blue led brightness step up at each press of user button.
+*Purpose is to test led dimming APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*User_button PA0
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+#define BOARD_LEDS ((1<<GPIO_PIN_NO_12) | (1<<GPIO_PIN_NO_13) | (1<<GPIO_PIN_NO_14) | (1<<GPIO_PIN_NO_15))
+#define BREATHE_MS 1500
+
+const Button_Config_t buttons[] = {
+	{GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR,SET,BUTTON_HOLD_NONE},
+};
+
+int main (void)
+{
+	uint8_t blueLevel = 0;
+	Button_Event_t event;
+
+	SWTIM_init();
+	button_service_init(buttons,sizeof(buttons)/sizeof(buttons[0]));
+	led_dim_init(GPIOD,BOARD_LEDS);
+
+	led_set_brightness(GPIOD,GPIO_PIN_NO_13,8);
+	led_set_brightness(GPIOD,GPIO_PIN_NO_14,255);
+
+	while(1){
+		/*start next half breath when previous one end*/
+		if(!led_is_fading(GPIOD,GPIO_PIN_NO_12)){
+			uint8_t greenUp = (led_get_brightness(GPIOD,GPIO_PIN_NO_12) == 0);
+			led_fade(GPIOD,GPIO_PIN_NO_12,greenUp ? 255 : 0,BREATHE_MS);
+			led_fade(GPIOD,GPIO_PIN_NO_14,greenUp ? 0 : 255,BREATHE_MS);
+		}
+
+		while(button_get_event(&event)){
+			if(event.event == BUTTON_EV_PRESS){
+				/*brightness 0, 1, 3, 7 ... 255 then back to 0: each step double duty cycle*/
+				blueLevel = (blueLevel == 255) ? 0 : (blueLevel<<1) | 1;
+				led_set_brightness(GPIOD,GPIO_PIN_NO_15,blueLevel);
+			}
+		}
+	}
+}
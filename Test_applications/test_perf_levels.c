@@ -0,0 +1,95 @@
+/**
+*@brief test performance levels (dynamic frequency scaling)
+*
+*Application stay at low level (HSI 16 MHz) while idle and boost to high level (168 MHz) for a compute burst every second,
+*user button select medium level (84 MHz HCLK, same PLL) instead of high level for bursts.
+*USART2 report level, clock values and duration of burst at 115200 baud, TIM4 channel 1 (green led) toggle every second:
+*baud rate and led period must stay unchanged across switches, since drivers are re-timed by RCC clock hooks.
+*Purpose is to test performance level APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*User_button PA0
+*TIM4_CH1 (green led) PD12
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Device_drivers/inc/button.h"
+
+#define BURST_LOOP 200000
+
+const char *levelName[RCC_PERF_LEVEL_NUM] = {"HIGH","MEDIUM","LOW"};
+
+/*some integer work whose duration scale with HCLK*/
+uint32_t burst_work (void)
+{
+	uint32_t hash = 2166136261UL;
+	for(uint32_t i = 0; i < BURST_LOOP; i++){
+		hash = (hash ^ i) * 16777619UL;
+	}
+	return hash;
+}
+
+int main (void)
+{
+	uint8_t burstLevel = RCC_PERF_HIGH;
+	uint8_t lastButton = 0;
+	uint64_t lastBurst = 0;
+	char msg[128];
+
+	RCC_set_perf_level(RCC_PERF_LOW);
+	TIME_init();
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+
+	/*TIM4 count at 10 kHz, channel 1 toggle when counter reach 0, every second*/
+	GPIO_init_direct(GPIOD,GPIO_PIN_NO_12,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	TIM_Config_t TIM4Config = {.reloadVal = 9999,.prescaler = RCC_get_TIMCLK_value(APB1)/10000 - 1};
+	TIM_Handle_t TIM4Handle = {TIM4,&TIM4Config};
+	TIM_init(&TIM4Handle);
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_TOGGLE,.compareVal = 0,
+															.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	TIM_OC_init(TIM4,&OCConfig);
+	TIM_ctr(TIM4,START);
+
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	while(1){
+		if(TIME_is_timeout(lastBurst,1000000)){
+			lastBurst = TIME_get_us();
+
+			/*switch between transfers: wait for last byte to leave shift register*/
+			while(!(USART2->SR & USART_SR_TC));
+			RCC_set_perf_level(burstLevel);
+			const RCC_Clock_freq_t *clockFreqPtr = RCC_get_clock_freq();
+			int32_t burstHCLK = clockFreqPtr->HCLK;
+			uint64_t startUs = TIME_get_us();
+			uint32_t hash = burst_work();
+			uint64_t burstUs = TIME_get_us() - startUs;
+			RCC_set_perf_level(RCC_PERF_LOW);
+
+			sprintf(msg,"burst %s HCLK %ld: %lu us (hash %08lx), idle %s HCLK %ld\r\n",levelName[burstLevel],(long)burstHCLK,
+							(unsigned long)burstUs,(unsigned long)hash,levelName[RCC_get_perf_level()],(long)RCC_get_clock_freq()->HCLK);
+			UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+		}
+
+		uint8_t button = button_read(GPIOA,GPIO_PIN_NO_0);
+		if(button && !lastButton){
+			burstLevel = (burstLevel == RCC_PERF_HIGH) ? RCC_PERF_MEDIUM : RCC_PERF_HIGH;
+		}
+		lastButton = button;
+	}
+}
@@ -0,0 +1,109 @@
+/**
+*@brief test sleep and stop mode power manager
+*
+*System run at 168 MHz. Main loop call PWR_idle whenever it has nothing to do: core stay in stop mode while idle
+*and wake up on user button (EXTI line 0). Each press (debounced 20 ms) toggle green led and send a report through USART2 (interrupt based, 115200 baud);
+*software timer of debouncing and UART transfer hold stop locks, so core only sleep (WFI) until they end, then go back to stop mode.
+*Orange led (PD13) is on while core is out of stop mode, so current drop can be watched on the board IDD jumper.
+*Report show number of sleep and stop entries and SYSCLK after wake up (clock restored to 168 MHz).
+*Purpose is to test power manager APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*User_button PA0
+*Green_led PD12
+*Orange_led PD13
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_exti.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_pwr.h"
+#include "../Device_drivers/inc/led.h"
+
+void user_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr);
+
+EXTI_Config_t userButtonConfig = {.GPIOxPtr = GPIOA,.edge = GPIO_MODE_INTRPT_RE,.oneshot = DISABLE,.debounceUs = 20000,
+																	.callback = user_button_callback,.argPtr = NULL};
+PWR_Config_t PWRConfig = {.stopMode = ENABLE,.lowPowerRegulator = ENABLE,.flashPowerDown = DISABLE};
+
+UART_Handle_t *UART2HandlePtr;
+volatile uint8_t pressed = 0;
+uint32_t sleepNum = 0;
+uint32_t stopNum = 0;
+char msg[96];
+
+void user_button_callback (uint8_t line, uint8_t level, uint64_t timestampUs, void *argPtr)
+{
+	pressed = 1;
+}
+
+int main (void)
+{
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	led_init(GPIOD,GPIO_PIN_NO_13);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_0,GPIO_MODE_IN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,0);
+
+	UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+	UART_intrpt_vector_ctrl(IRQ_USART2,ENABLE);
+
+	SWTIM_init();
+	EXTI_register(GPIO_PIN_NO_0,&userButtonConfig);
+	PWR_init(&PWRConfig);
+
+	while(1){
+		if(pressed){
+			pressed = 0;
+			led_toggle(GPIOD,GPIO_PIN_NO_12);
+			/*previous report is dropped if it is still being sent*/
+			if(UART2HandlePtr->txState == UART_STATE_READY){
+				sprintf(msg,"sleep %lu stop %lu SYSCLK %ld locks %02x\r\n",(unsigned long)sleepNum,(unsigned long)stopNum,
+								(long)RCC_get_clock_freq()->SYSCLK,PWR_get_stop_locks());
+				UART_send_intrpt(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+			}
+		}
+
+		/*flag is checked with interrupts masked, interrupt which set it still wake core and run once PRIMASK is cleared*/
+		__disable_irq();
+		if(!pressed){
+			if(PWR_idle() == PWR_MODE_STOP){
+				stopNum++;
+			}else{
+				sleepNum++;
+			}
+		}
+		__enable_irq();
+	}
+}
+
+void PWR_application_event_callback (uint8_t event)
+{
+	if(event == PWR_EV_STOP_ENTER){
+		led_off(GPIOD,GPIO_PIN_NO_13);
+	}else{
+		led_on(GPIOD,GPIO_PIN_NO_13);
+	}
+}
+
+void EXTI0_IRQHandler (void)
+{
+	EXTI_intrpt_handler(IRQ_EXTI0);
+}
+
+void USART2_IRQHandler (void)
+{
+	UART_intrpt_handler(UART2HandlePtr);
+}
@@ -0,0 +1,112 @@
+/**
+*@brief test timer DMA burst pulse train with a WS2812 LED strip
+*
+*TIM3 channel 1 (PA6) output 800 kHz PWM, compare value of each period (one data bit) is streamed from memory by DMA.
+*Bit 0 is high for about 0.4 us, bit 1 for about 0.8 us, train end with a low reset time longer than 50 us (compare value 0).
+*A rainbow run along the strip, green led (PD12) toggle at each end of train.
+*Purpose is to test pulse train APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*TIM3_CH1 (WS2812 data in) PA6
+*Green_led PD12
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_pulse_train.h"
+#include "../Device_drivers/inc/led.h"
+
+#define LED_NUM 8
+#define BIT_FREQ 800000
+#define RESET_PERIODS 48	/*60 us at 800 kHz*/
+
+uint16_t bitPeriod;
+uint16_t pulseBuffer[LED_NUM*24 + RESET_PERIODS];
+
+PULSE_Config_t pulseConfig = {.baseReg = TIM_DMA_BASE_CCR1,.regNum = 1,.dataSize = PULSE_DATA_16_BITS};
+PULSE_Handle_t pulseHandle = {.TIMxPtr = TIM3,.PULSEConfigPtr = &pulseConfig};
+
+void ws2812_init (void)
+{
+	bitPeriod = RCC_get_TIMCLK_value(APB1)/BIT_FREQ;
+	TIM_Config_t TIM3Config = {.reloadVal = bitPeriod - 1,.prescaler = 0};
+	TIM_Handle_t TIM3Handle = {TIM3,&TIM3Config};
+	TIM_init(&TIM3Handle);
+
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_PWM1,.compareVal = 0,
+															.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	TIM_OC_init(TIM3,&OCConfig);
+	PULSE_init(&pulseHandle);
+}
+
+void ws2812_set_color (uint8_t ledNo, uint8_t red, uint8_t green, uint8_t blue)
+{
+	/*WS2812 expect green, red, blue, most significant bit first*/
+	uint32_t GRB = ((uint32_t)green << 16) | ((uint32_t)red << 8) | blue;
+	for(uint8_t i = 0; i < 24; i++){
+		pulseBuffer[ledNo*24 + i] = (GRB & (1UL << (23 - i))) ? (bitPeriod*2)/3 : bitPeriod/3;
+	}
+}
+
+void wheel (uint8_t pos, uint8_t *red, uint8_t *green, uint8_t *blue)
+{
+	if(pos < 85){
+		*red = 255 - pos*3; *green = pos*3; *blue = 0;
+	}else if(pos < 170){
+		pos -= 85;
+		*red = 0; *green = 255 - pos*3; *blue = pos*3;
+	}else{
+		pos -= 170;
+		*red = pos*3; *green = 0; *blue = 255 - pos*3;
+	}
+}
+
+int main (void)
+{
+	uint8_t offset = 0;
+	uint8_t red, green, blue;
+
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	TIME_init();
+	ws2812_init();
+
+	/*reset periods stay at 0 (low output), last one is also idle state*/
+	while(1){
+		while(PULSE_is_busy(&pulseHandle));
+		for(uint8_t i = 0; i < LED_NUM; i++){
+			wheel((uint8_t)(offset + i*256/LED_NUM),&red,&green,&blue);
+			/*divide by 8 to keep strip current low*/
+			ws2812_set_color(i,red/8,green/8,blue/8);
+		}
+		PULSE_start(&pulseHandle,pulseBuffer,LED_NUM*24 + RESET_PERIODS,PULSE_MODE_ONESHOT);
+		offset += 2;
+		TIME_delay_ms(20);
+	}
+}
+
+void PULSE_application_event_callback (PULSE_Handle_t *PULSEHandlePtr, uint8_t event)
+{
+	if(event == PULSE_EV_DONE){
+		led_toggle(GPIOD,GPIO_PIN_NO_12);
+	}
+}
+
+void DMA1_Stream2_IRQHandler (void)
+{
+	PULSE_DMA_intrpt_handler(&pulseHandle);
+}
+
+void TIM3_IRQHandler (void)
+{
+	PULSE_TIM_intrpt_handler(&pulseHandle);
+}
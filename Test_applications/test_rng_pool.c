@@ -0,0 +1,63 @@
+/**
+*@brief test RNG entropy pool
+*
+*System run at 168 MHz (RNG clock 48 MHz from PLL). RNG interrupt fill pool in background; every second a 32 bytes nonce
+*is read from pool as a handshake would, and USART2 report nonce, time taken by RNG_read, bytes left in pool and RNG errors
+*at 115200 baud. Pool is refilled between reads, so RNG_read is expected to return all bytes within a few microseconds.
+*Purpose is to test RNG_read, RNG_get_available and RNG_get_error.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*USART2_TX PA2
+*USART2_RX PA3
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include <stdio.h>
+#include <string.h>
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_uart.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rng.h"
+
+#define NONCE_SIZE 32
+
+int main (void)
+{
+	uint8_t nonce[NONCE_SIZE];
+	char msg[128];
+
+	RCC_set_perf_level(RCC_PERF_HIGH);
+	TIME_init();
+	UART_Handle_t *UART2HandlePtr = UART_general_init(USART2,UART_pins_pack_1,UART_BDR_115200,UART_STB_1,UART_WRDLEN_8_DT_BITS,UART_TX_RX,UART_NO_PARCTRL,UART_NO_FLOWCTRL);
+
+	RNG_init();
+	RNG_intrpt_vector_ctr(IRQ_HASH_RNG,ENABLE);
+	RNG_intrpt_ctr(ENABLE);
+
+	while(1){
+		TIME_delay_ms(1000);
+
+		uint64_t startUs = TIME_get_us();
+		uint32_t readNum = RNG_read(nonce,NONCE_SIZE);
+		uint32_t readUs = TIME_get_us() - startUs;
+
+		char *strPtr = msg;
+		for(uint32_t i = 0; i < readNum; i++){
+			strPtr += sprintf(strPtr,"%02x",nonce[i]);
+		}
+		sprintf(strPtr,"\r\n%lu bytes in %lu us, pool %lu bytes, error %02x\r\n",(unsigned long)readNum,(unsigned long)readUs,
+						(unsigned long)RNG_get_available(),RNG_get_error());
+		UART_send(UART2HandlePtr,(uint8_t*)msg,strlen(msg));
+	}
+}
+
+void HASH_RNG_IRQHandler (void)
+{
+	RNG_intrpt_handler();
+}
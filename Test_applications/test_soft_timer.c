@@ -0,0 +1,67 @@
+/**
+*@brief test software timer service
+*
+*This blink 4 leds (PD12-PD15) with 4 periodic software timers of different periods, all running on TIM5.
+*Pressing user button start a one-shot 3 seconds timeout which stop the blue led, pressing again within 3 seconds restart the timeout.
+*Logic analyzer is used to monitor led pins and to confirm periods of 100ms, 250ms, 500ms and 1s.
+*Purpose is to test software timer APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_soft_timer.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+static const uint32_t blinkPeriod[4] = {100,250,500,1000};
+static uint8_t ledPin[4] = {GPIO_PIN_NO_12,GPIO_PIN_NO_13,GPIO_PIN_NO_14,GPIO_PIN_NO_15};
+
+SWTIM_Timer_t blinkTimer[4];
+SWTIM_Timer_t timeoutTimer;
+
+void blink_callback (void *argPtr)
+{
+	led_toggle(GPIOD,*(uint8_t*)argPtr);
+}
+
+void timeout_callback (void *argPtr)
+{
+	SWTIM_cancel(&blinkTimer[3]);
+	led_off(GPIOD,GPIO_PIN_NO_15);
+}
+
+int main (void)
+{
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	SWTIM_init();
+	for(uint8_t i = 0; i < 4; i++){
+		led_init(GPIOD,ledPin[i]);
+		SWTIM_timer_init(&blinkTimer[i],blink_callback,&ledPin[i]);
+		SWTIM_start(&blinkTimer[i],SWTIM_MS_TO_TICKS(blinkPeriod[i]),SWTIM_MS_TO_TICKS(blinkPeriod[i]));
+	}
+	SWTIM_timer_init(&timeoutTimer,timeout_callback,NULL);
+
+	while(1){
+		if(button_read(GPIOA,GPIO_PIN_NO_0)){
+			while(button_read(GPIOA,GPIO_PIN_NO_0));
+			if(!SWTIM_is_active(&blinkTimer[3])){
+				SWTIM_start(&blinkTimer[3],SWTIM_MS_TO_TICKS(blinkPeriod[3]),SWTIM_MS_TO_TICKS(blinkPeriod[3]));
+			}
+			SWTIM_start(&timeoutTimer,SWTIM_MS_TO_TICKS(3000),0);
+		}
+	}
+}
@@ -0,0 +1,68 @@
+/**
+*@brief test time base and delays
+*
+*This toggle green led every 500ms with TIME_delay_ms, then toggle orange led 100 times every 100us with TIME_delay_us, first on HSI (16 MHz).
+*Pressing user button switch system clock to PLL (84 MHz), time base is re-timed by its RCC clock hook, toggling periods must stay the same.
+*Red led is turned on if timestamp ever goes backward, blue led is turned on if a 500ms wait measured by TIME_get_us is off by more than 1ms.
+*Logic analyzer is used to monitor led pins and to confirm periods before and after clock change.
+*Purpose is to test time base APIs.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*Green_led PD12
+*Orange_led PD13
+*Red_led PD14
+*Blue_led PD15
+*User_button PA0
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_time.h"
+#include "../Device_drivers/inc/led.h"
+#include "../Device_drivers/inc/button.h"
+
+int main (void)
+{
+	uint64_t lastTime = 0;
+	uint8_t clockChanged = 0;
+
+	led_init(GPIOD,GPIO_PIN_NO_12);
+	led_init(GPIOD,GPIO_PIN_NO_13);
+	led_init(GPIOD,GPIO_PIN_NO_14);
+	led_init(GPIOD,GPIO_PIN_NO_15);
+	button_init(GPIOA,GPIO_PIN_NO_0,GPIO_NO_PUPDR);
+
+	TIME_init();
+
+	while(1){
+		uint64_t startTime = TIME_get_us();
+		if(startTime < lastTime){
+			led_on(GPIOD,GPIO_PIN_NO_14);
+		}
+
+		TIME_delay_ms(500);
+		uint64_t elapsed = TIME_elapsed_us(startTime);
+		if(elapsed < 500000 || elapsed > 501000){
+			led_on(GPIOD,GPIO_PIN_NO_15);
+		}
+		led_toggle(GPIOD,GPIO_PIN_NO_12);
+
+		for(uint8_t i = 0; i < 100; i++){
+			led_toggle(GPIOD,GPIO_PIN_NO_13);
+			TIME_delay_us(100);
+		}
+		lastTime = TIME_get_us();
+
+		if(!clockChanged && button_read(GPIOA,GPIO_PIN_NO_0)){
+			RCC_set_SYSCLK_PLL_84_MHz();
+			clockChanged = 1;
+		}
+	}
+}
@@ -0,0 +1,117 @@
+/**
+*@brief test PWM, output compare and input capture APIs of STM32F407xx timer driver
+*
+*This fade 4 leds (PD12-PD15) with TIM4 PWM channel 1 to 4 and generate 20 kHz complementary PWM with 500 ns dead-time on TIM1 channel 1 (PE9/PE8).
+*TIM1 channel 1 output is wired to TIM3 channel 1 input (PA6), TIM3 capture rising edges with filter and measuredPeriod is watched in debugger (expected: TIMCLK/20 kHz).
+*Logic analyzer is used to monitor PE9, PE8 and dead-time between them.
+*Purpose is to test timer driver APIs for general purpose and advanced timers.
+*
+*@author Tran Thanh Nhan
+*@date 19/10/2026
+*/
+
+/*
+*@PIN_MAPPING
+*Pin mapping
+*TIM4_CH1-CH4 (leds) PD12-PD15
+*TIM1_CH1 PE9
+*TIM1_CH1N PE8
+*TIM3_CH1 PA6 (connect to PE9)
+*/
+
+#include "stm32f4xx.h"                  // Device header
+#include "../Peripheral_drivers/inc/stm32f407xx_gpio.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_rcc.h"
+#include "../Peripheral_drivers/inc/stm32f407xx_timer.h"
+
+#define LED_PWM_PERIOD 1000
+
+volatile uint32_t lastCapture = 0;
+volatile uint32_t measuredPeriod = 0;
+
+void timer_GPIO_pins_init (void)
+{
+	/*TIM4 on AF2, TIM1 on AF1, TIM3 on AF2*/
+	for(uint8_t pin = GPIO_PIN_NO_12; pin <= GPIO_PIN_NO_15; pin++){
+		GPIO_init_direct(GPIOD,pin,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+	}
+	GPIO_init_direct(GPIOE,GPIO_PIN_NO_9,GPIO_MODE_ALTFN,GPIO_OUTPUT_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,1);
+	GPIO_init_direct(GPIOE,GPIO_PIN_NO_8,GPIO_MODE_ALTFN,GPIO_OUTPUT_HIGH_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,1);
+	GPIO_init_direct(GPIOA,GPIO_PIN_NO_6,GPIO_MODE_ALTFN,GPIO_OUTPUT_LOW_SPEED,GPIO_OUTPUT_TYPE_PP,GPIO_NO_PUPDR,2);
+}
+
+void TIM4_PWM_init (void)
+{
+	/*1 MHz counter clock, 1 kHz PWM*/
+	TIM_Config_t TIM4Config = {.reloadVal = LED_PWM_PERIOD - 1,.prescaler = RCC_get_TIMCLK_value(APB1)/1000000 - 1};
+	TIM_Handle_t TIM4Handle = {TIM4,&TIM4Config};
+	TIM_init(&TIM4Handle);
+	
+	TIM_OC_Config_t OCConfig = {.mode = TIM_OC_MODE_PWM1,.compareVal = 0,.polarity = TIM_OC_POLARITY_HIGH,.complementary = DISABLE};
+	for(uint8_t channel = TIM_CHANNEL_1; channel <= TIM_CHANNEL_4; channel++){
+		OCConfig.channel = channel;
+		TIM_OC_init(TIM4,&OCConfig);
+	}
+	TIM_ctr(TIM4,START);
+}
+
+void TIM1_PWM_init (void)
+{
+	/*20 kHz PWM, 50% duty, complementary output with 500 ns dead-time*/
+	uint32_t reloadVal = RCC_get_TIMCLK_value(APB2)/20000 - 1;
+	TIM_Config_t TIM1Config = {.reloadVal = reloadVal,.prescaler = 0};
+	TIM_Handle_t TIM1Handle = {TIM1,&TIM1Config};
+	TIM_init(&TIM1Handle);
+	
+	TIM_OC_Config_t OCConfig = {.channel = TIM_CHANNEL_1,.mode = TIM_OC_MODE_PWM1,.compareVal = (reloadVal + 1)/2,.polarity = TIM_OC_POLARITY_HIGH,.complementary = ENABLE};
+	TIM_OC_init(TIM1,&OCConfig);
+	TIM_dead_time_config(TIM1,500);
+	TIM_ctr(TIM1,START);
+}
+
+void TIM3_IC_init (void)
+{
+	/*free running counter at timer clock, capture every rising edge of TI1 with 4 samples filter*/
+	TIM_Config_t TIM3Config = {.reloadVal = 0xFFFF,.prescaler = 0};
+	TIM_Handle_t TIM3Handle = {TIM3,&TIM3Config};
+	TIM_init(&TIM3Handle);
+	
+	TIM_IC_Config_t ICConfig = {.channel = TIM_CHANNEL_1,.selection = TIM_IC_DIRECT_TI,.polarity = TIM_IC_POLARITY_RISING,.prescaler = TIM_IC_PRESCALER_DIV1,.filter = 2};
+	TIM_IC_init(TIM3,&ICConfig);
+	TIM_channel_interrupt_ctr(TIM3,TIM_CHANNEL_1,ENABLE);
+	TIM_intrpt_vector_ctr(IRQ_TIM3,ENABLE);
+	TIM_ctr(TIM3,START);
+}
+
+int main (void){
+	uint32_t duty = 0;
+	
+	timer_GPIO_pins_init();
+	TIM4_PWM_init();
+	TIM1_PWM_init();
+	TIM3_IC_init();
+	
+	while(1){
+		/*shift fade phase of each led by a quarter of period*/
+		for(uint8_t channel = TIM_CHANNEL_1; channel <= TIM_CHANNEL_4; channel++){
+			uint32_t phase = (duty + (channel - 1)*LED_PWM_PERIOD/2) % (2*LED_PWM_PERIOD);
+			TIM_set_compare_val(TIM4,channel,(phase < LED_PWM_PERIOD) ? phase : 2*LED_PWM_PERIOD - phase);
+		}
+		duty = (duty + 1) % (2*LED_PWM_PERIOD);
+		for(uint32_t i = 0; i < 2000; i++);
+	}
+}
+
+void TIM_application_event_callback (TIM_TypeDef *TIMxPtr, uint8_t event)
+{
+	if(TIMxPtr == TIM3 && event == TIM_EV_CC1){
+		uint32_t capture = TIM_get_capture_val(TIM3,TIM_CHANNEL_1);
+		measuredPeriod = (capture - lastCapture) & 0xFFFF;
+		lastCapture = capture;
+	}
+}
+
+void TIM3_IRQHandler (void)
+{
+	TIM_intrpt_handler(TIM3);
+}